@@ -60,6 +60,11 @@ bool AnimatorView::init()
 	return true;
 }
 
+void AnimatorView::nextFrame()
+{
+	schedulePaint();
+}
+
 bool AnimatorView::doDraw(Canvas& canvas)
 {
 	if (nullptr != _imageQQ)
@@ -18,6 +18,9 @@ public:
 	// DemoView
 	virtual bool doDraw(Canvas& canvas) override;
 
+	// schedules the paint of the next frame, called on every animation tick.
+	void nextFrame();
+
 protected:
 	virtual Image* createImage() = 0;
 
@@ -14,6 +14,25 @@ DemoWidget::~DemoWidget()
 
 }
 
+void DemoWidget::onTimer()
+{
+	switch(_curState)
+	{
+	case SKIA_ANIMATE:
+		_SkiaAnimatorView.nextFrame();
+		break;
+
+	case GDIPLUS_ANIMATE:
+		_GdiplusAnimatorView.nextFrame();
+		break;
+
+	default:
+		break;
+	}
+
+	Widget::onTimer();
+}
+
 void DemoWidget::drawToWindow()
 {
 	++_frameCount;
@@ -29,6 +29,7 @@ public:
 
 protected:
 	// Widget
+	virtual void onTimer() override;
 	virtual void drawToWindow();
 	virtual LRESULT processKeyDown(WPARAM wparam, LPARAM lparam) override;
 
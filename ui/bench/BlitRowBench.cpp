@@ -0,0 +1,172 @@
+// times blending a solid color through the coverage runs of a glyph-like row, portable against sse2,
+// and through an lcd32 mask, the scalar loop of SkBlitMask_D32.cpp against the sse2 procs.
+
+#include "SkBlitRow.h"
+#include "SkColorPriv.h"
+#include "SkBlitRow_opts_SSE2.h"
+#include <stdio.h>
+#include <sys/time.h>
+
+const int ROW_WIDTH = 512;
+const int MASK_HEIGHT = 16;
+const int BLIT_COUNT = 20000;
+const int RUN_COUNT = 5;
+
+namespace
+{
+	double now()
+	{
+		timeval time;
+		gettimeofday(&time, nullptr);
+		return time.tv_sec * 1000.0 + time.tv_usec / 1000.0;
+	}
+
+	unsigned g_seed = 1;
+
+	unsigned nextRandom()
+	{
+		g_seed = g_seed * 1103515245 + 12345;
+		return g_seed >> 8;
+	}
+
+	SkPMColor g_row[ROW_WIDTH];
+	int16_t g_runs[ROW_WIDTH + 1];
+	SkAlpha g_antialias[ROW_WIDTH + 1];
+	SkPMColor g_pixels[ROW_WIDTH * MASK_HEIGHT];
+	SkPMColor g_mask[ROW_WIDTH * MASK_HEIGHT];
+
+	// the runs of a row of text: single pixel edges around spans of up to 6 covered pixels,
+	// and gaps between the glyphs.
+	void makeGlyphRow()
+	{
+		int x = 0;
+
+		while (x < ROW_WIDTH)
+		{
+			int kind = nextRandom() % 4;
+			int count = 0 == kind ? 1 + nextRandom() % 6 : 1;
+			count = count < ROW_WIDTH - x ? count : ROW_WIDTH - x;
+			g_runs[x] = count;
+			g_antialias[x] = 0 == kind ? (0 == nextRandom() % 2 ? 0 : 0xFF) : nextRandom() & 0xFF;
+			x += count;
+		}
+
+		g_runs[ROW_WIDTH] = 0;
+	}
+
+	// a subpixel text mask, a quarter of it empty.
+	void makeLcdMask()
+	{
+		for (int i = 0; i < ROW_WIDTH * MASK_HEIGHT; ++i)
+		{
+			g_mask[i] = 0 == nextRandom() % 4 ? 0 : SkPackARGB32(0, nextRandom() & 0xFF, nextRandom() & 0xFF,
+				nextRandom() & 0xFF);
+			g_pixels[i] = SK_ColorWHITE;
+		}
+	}
+
+	// blit_lcd32_row and blit_lcd32_opaque_row of SkBlitMask_D32.cpp, which are not exported.
+	void lcd32Portable(void* dst, size_t dstRB, const void* mask, size_t maskRB, SkColor color, int width,
+		int height)
+	{
+		int srcA = SkAlpha255To256(SkColorGetA(color));
+		int srcR = SkColorGetR(color);
+		int srcG = SkColorGetG(color);
+		int srcB = SkColorGetB(color);
+
+		for (int y = 0; y < height; ++y)
+		{
+			SkPMColor* dstRow = (SkPMColor*)((char*)dst + y * dstRB);
+			const SkPMColor* maskRow = (const SkPMColor*)((const char*)mask + y * maskRB);
+
+			for (int i = 0; i < width; ++i)
+			{
+				if (0 == maskRow[i])
+				{
+					continue;
+				}
+
+				int maskR = SkAlpha255To256(SkGetPackedR32(maskRow[i]));
+				int maskG = SkAlpha255To256(SkGetPackedG32(maskRow[i]));
+				int maskB = SkAlpha255To256(SkGetPackedB32(maskRow[i]));
+
+				// the opaque row of skia leaves the multiply out.
+				if (256 != srcA)
+				{
+					maskR = maskR * srcA >> 8;
+					maskG = maskG * srcA >> 8;
+					maskB = maskB * srcA >> 8;
+				}
+
+				SkPMColor d = dstRow[i];
+				dstRow[i] = SkPackARGB32(0xFF, SkAlphaBlend(srcR, SkGetPackedR32(d), maskR),
+					SkAlphaBlend(srcG, SkGetPackedG32(d), maskG), SkAlphaBlend(srcB, SkGetPackedB32(d), maskB));
+			}
+		}
+	}
+
+	typedef void (*LCD32_PROC)(void* dst, size_t dstRB, const void* mask, size_t maskRB, SkColor color,
+		int width, int height);
+
+	// nanoseconds per row of ROW_WIDTH pixels, the best of RUN_COUNT runs.
+	double antiHTime(SkBlitRow::ColorAntiHProc proc, SkPMColor color)
+	{
+		double best = 0;
+
+		for (int run = 0; run < RUN_COUNT; ++run)
+		{
+			double start = now();
+
+			for (int i = 0; i < BLIT_COUNT; ++i)
+			{
+				proc(g_row, g_antialias, g_runs, color);
+			}
+
+			double time = (now() - start) * 1000000.0 / BLIT_COUNT;
+			best = 0 == run || time < best ? time : best;
+		}
+
+		return best;
+	}
+
+	// nanoseconds per row of ROW_WIDTH mask pixels, the best of RUN_COUNT runs.
+	double lcd32Time(LCD32_PROC proc, SkColor color)
+	{
+		size_t rowBytes = ROW_WIDTH * sizeof(SkPMColor);
+		double best = 0;
+
+		for (int run = 0; run < RUN_COUNT; ++run)
+		{
+			double start = now();
+
+			for (int i = 0; i < BLIT_COUNT / MASK_HEIGHT; ++i)
+			{
+				proc(g_pixels, rowBytes, g_mask, rowBytes, color, ROW_WIDTH, MASK_HEIGHT);
+			}
+
+			double time = (now() - start) * 1000000.0 / (BLIT_COUNT / MASK_HEIGHT * MASK_HEIGHT);
+			best = 0 == run || time < best ? time : best;
+		}
+
+		return best;
+	}
+}
+
+int main()
+{
+	makeGlyphRow();
+	makeLcdMask();
+
+	SkPMColor opaque = SkPreMultiplyColor(0xFF204080);
+	SkPMColor translucent = SkPreMultiplyColor(0x80204080);
+	printf("run blend, opaque color: portable %.0f ns, sse2 %.0f ns per %d pixel row\n",
+		antiHTime(SkBlitRow::ColorAntiH32, opaque), antiHTime(ColorAntiH32_SSE2, opaque), ROW_WIDTH);
+	printf("run blend, translucent color: portable %.0f ns, sse2 %.0f ns per %d pixel row\n",
+		antiHTime(SkBlitRow::ColorAntiH32, translucent), antiHTime(ColorAntiH32_SSE2, translucent), ROW_WIDTH);
+
+	printf("lcd32 mask, opaque color: portable %.0f ns, sse2 %.0f ns per %d pixel row\n",
+		lcd32Time(lcd32Portable, 0xFF204080), lcd32Time(SkARGB32_LCD32_Opaque_BlitMask_SSE2, 0xFF204080), ROW_WIDTH);
+	printf("lcd32 mask, translucent color: portable %.0f ns, sse2 %.0f ns per %d pixel row\n",
+		lcd32Time(lcd32Portable, 0x80204080), lcd32Time(SkARGB32_LCD32_BlitMask_SSE2, 0x80204080), ROW_WIDTH);
+	return 0;
+}
@@ -0,0 +1,135 @@
+// times drawing a solid color or a scaled or rotated bitmap through the fused blitters against
+// SkARGB32_Shader_Blitter, for the tile modes and xfermodes the fused blitters cover.
+
+#include "SkBitmap.h"
+#include "SkColorPriv.h"
+#include "SkColorShader.h"
+#include "SkCoreBlitters.h"
+#include "SkMatrix.h"
+#include "SkPaint.h"
+#include "SkShader.h"
+#include "SkXfermode.h"
+#include <stdio.h>
+#include <sys/time.h>
+
+const int DEVICE_WIDTH = 512;
+const int DEVICE_HEIGHT = 64;
+const int BITMAP_SIZE = 256;
+const int BLIT_COUNT = 40;
+const int RUN_COUNT = 5;
+
+namespace
+{
+	double now()
+	{
+		timeval time;
+		gettimeofday(&time, nullptr);
+		return time.tv_sec * 1000.0 + time.tv_usec / 1000.0;
+	}
+
+	unsigned g_seed = 1;
+
+	unsigned nextRandom()
+	{
+		g_seed = g_seed * 1103515245 + 12345;
+		return g_seed >> 8;
+	}
+
+	SkBitmap g_device;
+	SkBitmap g_opaqueBitmap;
+	SkBitmap g_translucentBitmap;
+
+	void makeBitmap(SkBitmap* bitmap, bool opaque)
+	{
+		bitmap->setConfig(SkBitmap::kARGB_8888_Config, BITMAP_SIZE, BITMAP_SIZE);
+		bitmap->allocPixels();
+
+		for (int y = 0; y < BITMAP_SIZE; ++y)
+		{
+			for (int x = 0; x < BITMAP_SIZE; ++x)
+			{
+				*bitmap->getAddr32(x, y) = SkPreMultiplyColor(SkColorSetARGB(opaque ? 0xFF : nextRandom() & 0xFF,
+					nextRandom() & 0xFF, nextRandom() & 0xFF, nextRandom() & 0xFF));
+			}
+		}
+
+		bitmap->setIsOpaque(opaque);
+	}
+
+	void makeBitmaps()
+	{
+		g_device.setConfig(SkBitmap::kARGB_8888_Config, DEVICE_WIDTH, DEVICE_HEIGHT);
+		g_device.allocPixels();
+		g_device.eraseColor(SK_ColorWHITE);
+		makeBitmap(&g_opaqueBitmap, true);
+		makeBitmap(&g_translucentBitmap, false);
+	}
+
+	// nanoseconds per pixel drawn through the fused blitter, or through the shader blitter, the best
+	// of RUN_COUNT runs.
+	double blitTime(const SkPaint& paint, bool fused)
+	{
+		SkMatrix identity;
+		identity.reset();
+		uint32_t storage[256];
+		double best = 0;
+
+		for (int run = 0; run < RUN_COUNT; ++run)
+		{
+			double start = now();
+
+			for (int i = 0; i < BLIT_COUNT; ++i)
+			{
+				paint.getShader()->setContext(g_device, paint, identity);
+				SkBlitter* blitter = fused ? SkBlitter_ChooseFusedD32(g_device, paint, storage, sizeof(storage)) :
+					new (storage) SkARGB32_Shader_Blitter(g_device, paint);
+				blitter->blitRect(0, 0, DEVICE_WIDTH, DEVICE_HEIGHT);
+				blitter->~SkBlitter();
+			}
+
+			double time = (now() - start) * 1000000.0 / (BLIT_COUNT * DEVICE_WIDTH * DEVICE_HEIGHT);
+			best = 0 == run || time < best ? time : best;
+		}
+
+		return best;
+	}
+
+	void timeSolidCase(const char* name, SkColor color, SkXfermode::Mode mode)
+	{
+		SkPaint paint;
+		paint.setShader(SkNEW_ARGS(SkColorShader, (color)))->unref();
+		paint.setXfermodeMode(mode);
+		printf("%s: shader blitter %.2f ns, fused %.2f ns per pixel\n", name, blitTime(paint, false),
+			blitTime(paint, true));
+	}
+
+	void timeCase(const char* name, SkShader::TileMode tileMode, SkScalar degrees, bool opaque)
+	{
+		SkMatrix matrix;
+		matrix.setScale(SkFloatToScalar(1.37f), SkFloatToScalar(0.71f));
+		matrix.postRotate(degrees);
+		SkShader* shader = SkShader::CreateBitmapShader(opaque ? g_opaqueBitmap : g_translucentBitmap, tileMode,
+			tileMode);
+		shader->setLocalMatrix(matrix);
+
+		SkPaint paint;
+		paint.setShader(shader)->unref();
+		paint.setXfermodeMode(SkXfermode::kMultiply_Mode);
+
+		printf("%s: shader blitter %.2f ns, fused %.2f ns per pixel\n", name, blitTime(paint, false),
+			blitTime(paint, true));
+	}
+}
+
+int main()
+{
+	makeBitmaps();
+	timeCase("clamp scale, multiply", SkShader::kClamp_TileMode, 0, true);
+	timeCase("translucent clamp scale, multiply", SkShader::kClamp_TileMode, 0, false);
+	timeCase("clamp affine, multiply", SkShader::kClamp_TileMode, 30, true);
+	timeCase("repeat scale, multiply", SkShader::kRepeat_TileMode, 0, true);
+	timeCase("repeat affine, multiply", SkShader::kRepeat_TileMode, 30, true);
+	timeSolidCase("solid, src", 0x80204080, SkXfermode::kSrc_Mode);
+	timeSolidCase("solid, multiply", 0x80204080, SkXfermode::kMultiply_Mode);
+	return 0;
+}
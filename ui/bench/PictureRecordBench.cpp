@@ -0,0 +1,117 @@
+// times recording a picture whose ops share a paint, against ops that alternate between two
+// paints so none reuses the paint index of the op before it. also times the check that
+// decides the reuse, SkPaint::operator==, against the single compare a generation id needs.
+
+#include "SkCanvas.h"
+#include "SkPaint.h"
+#include "SkPicture.h"
+#include "SkRect.h"
+#include <stdio.h>
+#include <sys/time.h>
+
+const int OPS_PER_PICTURE = 1000;
+const int PICTURE_COUNT = 500;
+const int RUN_COUNT = 5;
+const int COMPARE_COUNT = 10000000;
+
+namespace
+{
+	double now()
+	{
+		timeval time;
+		gettimeofday(&time, nullptr);
+		return time.tv_sec * 1000.0 + time.tv_usec / 1000.0;
+	}
+
+	// milliseconds per picture of OPS_PER_PICTURE rects, drawn with paints[j % paintCount].
+	double recordRun(const SkPaint* paints, int paintCount)
+	{
+		double start = now();
+
+		for (int i = 0; i < PICTURE_COUNT; ++i)
+		{
+			SkPicture picture;
+			SkCanvas* canvas = picture.beginRecording(512, 512);
+
+			for (int j = 0; j < OPS_PER_PICTURE; ++j)
+			{
+				SkScalar x = SkIntToScalar(j % 64);
+				canvas->drawRect(SkRect::MakeXYWH(x, x, 16, 16), paints[j % paintCount]);
+			}
+
+			picture.endRecording();
+		}
+
+		return (now() - start) / PICTURE_COUNT;
+	}
+
+	// the best of RUN_COUNT runs, the others are slowed by whatever else the machine does.
+	double recordTime(const SkPaint* paints, int paintCount)
+	{
+		double best = 0;
+
+		for (int run = 0; run < RUN_COUNT; ++run)
+		{
+			double time = recordRun(paints, paintCount);
+			best = 0 == run || time < best ? time : best;
+		}
+
+		return best;
+	}
+
+	// nanoseconds per SkPaint::operator== of two equal paints.
+	double paintCompareTime(const SkPaint& a, const SkPaint& b)
+	{
+		const SkPaint* volatile left = &a;
+		const SkPaint* volatile right = &b;
+		int equal = 0;
+		double start = now();
+
+		for (int i = 0; i < COMPARE_COUNT; ++i)
+		{
+			equal += *left == *right;
+		}
+
+		double time = (now() - start) * 1000000.0 / COMPARE_COUNT;
+		return COMPARE_COUNT == equal ? time : -1;
+	}
+
+	// nanoseconds per compare of two generation ids.
+	double generationCompareTime(uint32_t a, uint32_t b)
+	{
+		const volatile uint32_t* left = &a;
+		const volatile uint32_t* right = &b;
+		int equal = 0;
+		double start = now();
+
+		for (int i = 0; i < COMPARE_COUNT; ++i)
+		{
+			equal += *left == *right;
+		}
+
+		double time = (now() - start) * 1000000.0 / COMPARE_COUNT;
+		return COMPARE_COUNT == equal ? time : -1;
+	}
+}
+
+int main()
+{
+	SkPaint paints[2];
+	paints[0].setAntiAlias(true);
+	paints[0].setColor(SK_ColorRED);
+	paints[1].setAntiAlias(true);
+	paints[1].setColor(SK_ColorBLUE);
+
+	// warms the per thread op block and the allocator.
+	recordTime(paints, 1);
+
+	double shared = recordTime(paints, 1);
+	double alternating = recordTime(paints, 2);
+	printf("record %d rects, one paint: %.3f ms, two alternating paints: %.3f ms\n", OPS_PER_PICTURE, shared,
+		alternating);
+
+	SkPaint copy(paints[0]);
+	printf("paint compare: %.2f ns, generation id compare: %.2f ns, sizeof(SkPaint) %d\n",
+		paintCompareTime(paints[0], copy), generationCompareTime(7, 7), (int)sizeof(SkPaint));
+	return 0;
+}
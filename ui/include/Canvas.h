@@ -9,6 +9,8 @@ class KBrush;
 class KString;
 class KFont;
 class KPoint;
+class KPath;
+class TileImageSource;
 class CanvasDelegate;
 
 class AK_API Canvas
@@ -18,6 +20,10 @@ public:
     ~Canvas();
     
     bool init(int width, int height, int canvasType);
+
+	// ak::SkiaGraphics drawing straight into pixels owned by the caller, such as the
+	// shared memory of a window. pixels are 32 bit premultiplied, rowBytes apart.
+	bool init(int width, int height, void* pixels, int rowBytes);
     void* lockBits();
 	void unlockBits();
 	ak::GraphicsType getGraphicsType() const;
@@ -27,13 +33,66 @@ public:
     Size getCanvasSize();
     bool drawLine(KPen* pen, int x1, int y1, int x2, int y2);
     bool drawImage(Image* image, int x, int y, int nAlpha = 255);
+	bool drawImage(Image* image, const KRect& rect, int nAlpha = 255);
 	bool drawImage(Image* image, int x, int y, float degrees);
+	bool drawMesh(Image* image, const float* vertices, const float* texCoords, int vertexCount,
+		const unsigned short* indices, int indexCount, int nAlpha = 255);
     bool drawRect(KPen* pen, KRect& rect);
 	bool fillRect(KBrush* brush, KRect& rect);
+	bool drawPath(KPen* pen, const KPath& path);
+	bool fillPath(KBrush* brush, const KPath& path);
 	bool drawString(const KString& str, int len, const KFont& font, const KPoint& pt, KBrush* brush);
 	bool setClip(const KRect& rect, ak::opMode mode);
+	// clips to rect with antialiased corners of radius, a radius of 0 is setClip(rect, mode).
+	bool setClip(const KRect& rect, int radius, ak::opMode mode);
 	bool resetClip();
 
+	// caches the drawing of key (usually a view) as a layer, see View::setLayerCached.
+	bool beginCacheLayer(const void* key, const KRect& rect);
+	bool endCacheLayer();
+	bool drawCacheLayer(const void* key);
+	void removeCacheLayer(const void* key);
+
+	// records the drawing of key as a display list, see View::setPictureCached.
+	bool beginCachePicture(const void* key);
+	bool endCachePicture();
+	bool drawCachePicture(const void* key);
+	void removeCachePicture(const void* key);
+
+	// fades the drawing between begin and end, see View::setOpacity.
+	bool beginOpacityLayer(const KRect& rect, int opacity, bool opaqueContent);
+	bool endOpacityLayer();
+
+	// limits the drawing of a frame to the invalidated area.
+	bool setDamageClip(const KRect& rect);
+	bool resetDamageClip();
+
+	// draws the visible tiles of a pyramid, see TileImageView.
+	bool drawTiledImage(const void* key, const TileImageSource& source, const KRect& rect,
+		float zoom, float originX, float originY, bool* pending);
+	void removeTiledImage(const void* key);
+	void setTiledImageBudget(size_t bytes);
+
+	// the key of a tiled image that got sharper tiles since it was drawn, each returned once,
+	// nullptr when there are none. tiles load on worker threads, poll while isLoadingTiledImages.
+	const void* takeLoadedTiledImage();
+	bool isLoadingTiledImages();
+
+	// ak::PdfGraphics only, every page has the size the canvas was created with.
+	// saveDocument writes the pages drawn so far, drawing afterwards starts a new document.
+	bool newPage();
+	bool saveDocument(const KString& path);
+
+	// counts the writes to every pixel, see RootView::setDebugOverlay.
+	// the heatmap is drawn over rect and is not counted itself.
+	bool setOverdrawCounting(bool enable);
+	void resetOverdraw();
+	bool getOverdraw(const KRect& rect, int* pixels, int* writes, int* maxWrites);
+	bool drawOverdrawHeatmap(const KRect& rect);
+
+	// called by the root view once a frame is drawn.
+	void advanceFrame();
+
 private:
     CanvasDelegate* _canvasDelegate;
 };
\ No newline at end of file
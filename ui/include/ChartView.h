@@ -0,0 +1,35 @@
+#pragma once
+
+#include "View.h"
+#include "Color.h"
+
+class ChartViewDelegate;
+
+// plots time series with millions of samples. every series keeps a min/max pyramid,
+// level k holds the extremes of buckets of 4^k samples and grows as samples append.
+// a frame reads the level whose buckets are just below a pixel wide, so the work
+// follows the view width and not the number of visible samples.
+class AK_API ChartView : public View
+{
+public:
+	ChartView();
+	virtual ~ChartView();
+
+	// returns the index of the new series.
+	int addSeries(const Color& color);
+	bool appendSamples(int series, const float* samples, int count);
+	bool appendSample(int series, float sample);
+	bool clearSeries(int series);
+	int getSampleCount(int series);
+
+	// x axis in samples, firstSample may be fractional while panning.
+	void setVisibleRange(double firstSample, double sampleCount);
+	void setValueRange(float minValue, float maxValue);
+	void setBackground(const Color& color);
+
+	// View
+	virtual bool draw(Canvas& canvas) override;
+
+private:
+	ChartViewDelegate* _chartViewDelegate;
+};
\ No newline at end of file
@@ -34,6 +34,14 @@ public:
 	KFontUnit getFontUnit() const;
 	int getFontSize() const;
 
+	// writes the glyphs drawn so far to path, so that the next run draws its first frame
+	// without rasterizing them again. the glyphs of a graphics still alive are not written.
+	static bool saveGlyphCache(const char* path);
+
+	// adds the glyphs written by saveGlyphCache to the glyph cache, the fonts that are gone or
+	// have changed since are skipped. returns the number of font sizes loaded.
+	static int loadGlyphCache(const char* path);
+
 private:
 	KFontFamily* _fontFamily;
 	KFontStyle _fontStyle;
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "UIDefine.h"
+
+typedef enum
+{
+	KPathVerbMove,
+	KPathVerbLine,
+	KPathVerbQuad,
+	KPathVerbCubic,
+	KPathVerbClose,
+} KPathVerb;
+
+class KPathDelegate;
+
+// a backend independent outline. points are stored as x, y pairs, move and line
+// take one point, quad two, cubic three and close none.
+class AK_API KPath
+{
+public:
+	KPath();
+	KPath(const KPath& path);
+	~KPath();
+
+	const KPath& operator = (const KPath& path);
+
+	void moveTo(float x, float y);
+	void lineTo(float x, float y);
+	void quadTo(float x1, float y1, float x2, float y2);
+	void cubicTo(float x1, float y1, float x2, float y2, float x3, float y3);
+	void close();
+
+	// keeps the allocated storage, a path rebuilt every frame does not reallocate.
+	void reset();
+	void reserve(int verbCount, int pointCount);
+	bool isEmpty() const;
+
+	int countVerbs() const;
+	KPathVerb getVerb(int index) const;
+	int countPoints() const;
+
+	// count points as x, y pairs.
+	const float* getPoints() const;
+
+	// changes whenever the path is edited, copies of the path share it. never 0.
+	unsigned int getGenerationID() const;
+
+	// measures the contours one after the other. the measured segments are cached per
+	// generation id, so measuring an unchanged path again, every frame for instance, is a lookup.
+	float getLength() const;
+
+	// the positions and tangents at count distances along the path, as x, y pairs. distances
+	// are pinned to [0, getLength()], either output may be null. returns false if the path
+	// has no length.
+	bool getPosTan(const float* distances, int count, float* positions, float* tangents) const;
+
+private:
+	KPathDelegate* _pathDelegate;
+};
\ No newline at end of file
@@ -21,7 +21,7 @@ public:
 
     }
 
-    void KRect::set(int left, int top, int right, int bottom)
+    void set(int left, int top, int right, int bottom)
     {
         _left = left;
         _top = top;
@@ -29,7 +29,7 @@ public:
         _bottom = bottom;
     }
 
-	void KRect::set(const KRect& rect)
+	void set(const KRect& rect)
 	{
 		_left = rect._left;
 		_top = rect._top;
@@ -52,6 +52,41 @@ public:
         return _bottom - _top;
     }
 
+	bool isEmpty() const
+	{
+		return _left >= _right || _top >= _bottom;
+	}
+
+	bool intersects(const KRect& rect) const
+	{
+		return _left < rect._right && rect._left < _right && _top < rect._bottom && rect._top < _bottom;
+	}
+
+	bool contains(int x, int y) const
+	{
+		return x >= _left && x < _right && y >= _top && y < _bottom;
+	}
+
+	// grows this rect to contain rect, empty rects are ignored.
+	void join(const KRect& rect)
+	{
+		if (rect.isEmpty())
+		{
+			return;
+		}
+
+		if (isEmpty())
+		{
+			set(rect);
+			return;
+		}
+
+		_left = _left < rect._left ? _left : rect._left;
+		_top = _top < rect._top ? _top : rect._top;
+		_right = _right > rect._right ? _right : rect._right;
+		_bottom = _bottom > rect._bottom ? _bottom : rect._bottom;
+	}
+
 public:
     int _left;
     int _top;
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <string>
+
+class KString;
+class MemoryTrackerDelegate;
+
+// attributes the memory of the ui to the subsystem that owns it, such as canvas surfaces
+// or decoded images, and within a subsystem to an owner such as the file an image came from.
+// the current and the highest byte counts are kept for every subsystem and owner.
+// all methods can be called from any thread.
+class AK_API MemoryTracker
+{
+public:
+	static MemoryTracker* getInstance();
+
+	// owner can be null when a subsystem does not tell its owners apart.
+	void add(ak::MemorySubsystem subsystem, const char* owner, size_t bytes);
+	void remove(ak::MemorySubsystem subsystem, const char* owner, size_t bytes);
+
+	// measured subsystems, such as the glyph cache, are sampled by a function called
+	// before every report. a sampler replaces the bytes of its subsystem with clear and add.
+	typedef void (*Sampler)(MemoryTracker* tracker);
+	void addSampler(Sampler sampler);
+	void clear(ak::MemorySubsystem subsystem);
+
+	size_t getBytes(ak::MemorySubsystem subsystem);
+	size_t getHighWater(ak::MemorySubsystem subsystem);
+	size_t getTotalBytes();
+	size_t getTotalHighWater();
+	void resetHighWater();
+
+	// one line per subsystem with its bytes and high water mark, followed by
+	// its largest owners, and the totals.
+	std::string dump(int ownersPerSubsystem = 8);
+	bool dumpToFile(const KString& path, int ownersPerSubsystem = 8);
+
+	static const char* getSubsystemName(ak::MemorySubsystem subsystem);
+
+private:
+	MemoryTracker();
+	~MemoryTracker();
+
+	void sample();
+
+private:
+	MemoryTrackerDelegate* _memoryTrackerDelegate;
+};
\ No newline at end of file
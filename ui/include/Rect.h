@@ -21,7 +21,7 @@ public:
 
     }
 
-    void Rect::set(int left, int top, int right, int bottom)
+    void set(int left, int top, int right, int bottom)
     {
         _left = left;
         _top = top;
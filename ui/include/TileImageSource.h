@@ -0,0 +1,38 @@
+#pragma once
+
+#include "UIDefine.h"
+#include <string>
+
+// a tile pyramid on disk. level 0 is the full resolution image and every level halves
+// the one below it, until the whole image fits in one tile.
+// tile (level, column, row) is read from "<directory>/<level>/<column>_<row>.<extension>".
+class AK_API TileImageSource
+{
+public:
+	TileImageSource();
+	TileImageSource(const char* directory, const char* extension, int width, int height, int tileSize);
+	~TileImageSource();
+
+	bool isValid() const;
+	int width() const;
+	int height() const;
+	int getTileSize() const;
+	int getLevelCount() const;
+
+	// size of the image at level, in pixels of that level.
+	int getLevelWidth(int level) const;
+	int getLevelHeight(int level) const;
+	int getColumnCount(int level) const;
+	int getRowCount(int level) const;
+
+	std::string getTilePath(int level, int column, int row) const;
+	const std::string& getDirectory() const;
+
+private:
+	std::string _directory;
+	std::string _extension;
+	int _width;
+	int _height;
+	int _tileSize;
+	int _levelCount;
+};
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "View.h"
+
+class TileImageSource;
+class TileImageViewDelegate;
+
+// shows a very large image from a tile pyramid, see TileImageSource. only the tiles in
+// view are decoded, at the level matching the zoom, so memory stays bounded whatever
+// the size of the image. needs the skia graphics.
+class AK_API TileImageView : public View
+{
+public:
+	TileImageView();
+	virtual ~TileImageView();
+
+	void setSource(const TileImageSource& source);
+
+	// view pixels per image pixel, 1 shows the full resolution.
+	void setZoom(float zoom);
+	float getZoom();
+
+	// the image point shown at the top left of the view.
+	void setOrigin(float x, float y);
+
+	// zooms keeping the image point under (x, y), in window coordinates, in place.
+	void zoomAt(float zoom, int x, int y);
+
+	// called by the root view when tiles drawn from a coarser level have loaded.
+	void onTilesLoaded();
+
+	// View
+	virtual bool draw(Canvas& canvas) override;
+
+private:
+	TileImageViewDelegate* _tileImageViewDelegate;
+};
\ No newline at end of file
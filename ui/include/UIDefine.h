@@ -13,6 +13,7 @@ namespace ak
         GdiGraphics,
         GdiPlusGraphics,
         SkiaGraphics,
+        PdfGraphics,
     } GraphicsType;
 
 	typedef enum
@@ -31,6 +32,84 @@ namespace ak
 		kModeExclude,
 		kModeComplement, 
 	};
+
+	// debug overlays drawn by the root view over every frame, can be combined.
+	enum DebugOverlay
+	{
+		kOverlayNone = 0,
+		kOverlayOverdraw = 1,
+		kOverlayPaintFlash = 2,
+		kOverlayDamage = 4,
+	};
+
+	// owners of the memory reported by MemoryTracker.
+	enum MemorySubsystem
+	{
+		kMemorySurfaces,
+		kMemoryImages,
+		kMemoryTiles,
+		kMemoryGlyphCache,
+		kMemoryPictures,
+		kMemoryLayers,
+		kMemoryThreadStacks,
+		kMemoryViews,
+		kMemoryStrings,
+		kMemorySubsystemCount,
+	};
+
+	// plane layouts of a YuvImage, both 4:2:0.
+	enum YuvFormat
+	{
+		kYuvI420,
+		kYuvNV12,
+	};
+
+	// matrices converting a YuvImage to rgb.
+	enum YuvColorSpace
+	{
+		kYuvRec601,
+		kYuvRec709,
+		kYuvJpeg,
+	};
+
+	// input events queued by EventHandler.
+	enum EventType
+	{
+		kEventMouseDown,
+		kEventMouseUp,
+		kEventMouseMove,
+		kEventMouseWheel,
+		kEventKeyDown,
+		kEventKeyUp,
+	};
+
+	// buttons and modifier keys held after an event, can be combined.
+	enum EventFlags
+	{
+		kEventLeftButton = 1,
+		kEventRightButton = 2,
+		kEventMiddleButton = 4,
+		kEventShift = 8,
+		kEventControl = 16,
+		kEventAlt = 32,
+		kEventButtons = kEventLeftButton | kEventRightButton | kEventMiddleButton,
+	};
+
+	// summary of the frames drawn since the debug overlays were set.
+	struct DebugStats
+	{
+		int _frames;
+
+		// pixels repainted by the last frame, and by all of them.
+		int _damagePixels;
+		double _totalDamagePixels;
+
+		// pixel writes per repainted pixel, for the last frame and for all of them.
+		// only counted with kOverlayOverdraw.
+		float _overdraw;
+		float _averageOverdraw;
+		int _maxOverdraw;
+	};
 }
 
 typedef unsigned char byte;
@@ -5,6 +5,7 @@
 
 class ViewDelegate;
 class Canvas;
+struct InputEvent;
 
 class AK_API View
 {
@@ -14,6 +15,13 @@ public:
 
     virtual bool init();
     virtual bool initCanvas(int canvasType = ak::SkiaGraphics);
+
+	// a skia canvas drawing into pixels owned by the caller, see Canvas::init.
+	bool initCanvas(void* pixels, int rowBytes);
+
+	// deletes the canvas of initCanvas, draw() does nothing until the next initCanvas.
+	void releaseCanvas();
+
     virtual bool draw();
     virtual bool draw(Canvas& canvas);
     virtual bool addView(View* view);
@@ -24,11 +32,53 @@ public:
 	void setRect(KRect rect);
     Canvas* getCanvas();
 
+	// keeps the drawing of this view as a cached layer until schedulePaint is called.
+	// idle layers are compressed, useful for pages that are shown again later.
+	void setLayerCached(bool cached);
+	bool isLayerCached();
+
+	// keeps the drawing of this view as a display list until schedulePaint is called.
+	// a small invalidation only replays the ops that intersect it.
+	void setPictureCached(bool cached);
+	bool isPictureCached();
+
+	// fades the view to opacity, 0 to 255, through a layer as tight as its rect.
+	// opaqueContent promises the view covers each pixel at most once, as a single image
+	// or children that do not overlap, so the fade goes to each draw and no layer is used.
+	void setOpacity(int opacity, bool opaqueContent = false);
+	int getOpacity();
+
+	// the deepest shown view containing the point, in window coordinates. the children drawn
+	// last are on top. returns this view if no child contains it, nullptr if it is outside.
+	virtual View* hitTest(int x, int y);
+	View* getParent();
+
+	// the children in the order they are drawn.
+	int getChildCount();
+	View* getChildAt(int index);
+
+	// input delivered by EventHandler. the ancestors of the target may take an event in
+	// onInterceptEvent, from the root down, then onEvent goes from the target up to the
+	// root. returning true stops the event.
+	virtual bool onInterceptEvent(const InputEvent& event) {return false;}
+	virtual bool onEvent(const InputEvent& event) {return false;}
+
 protected:
     virtual bool isUsedCanvas() {return false;}
 	virtual void schedulePaint(KRect* rect = nullptr);
 	bool getRect(KRect& rect);
 	void setParent(View* parent);
+	bool drawChild(Canvas& canvas, View* child);
+	bool drawChildLayer(Canvas& canvas, View* child);
+	bool drawChildPicture(Canvas& canvas, View* child);
+	bool drawChildContent(Canvas& canvas, View* child);
+
+	// called on the root for a view being destroyed and for each view under it, which the
+	// root stops drawing. anything kept for them must go, a new view may reuse the address.
+	virtual void onViewDestroyed(View* view) {}
+
+private:
+	void notifyDestroyed(View* root);
 
 protected:
     ViewDelegate* _viewDelegate;
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Image.h"
+
+class YuvImageDelegate;
+
+// a planar 4:2:0 frame, such as decoded video or a camera capture, that ak::SkiaGraphics
+// converts to rgb and scales in one pass as it is drawn.
+// the planes are either owned by the image and written through getWritablePlane, or owned
+// by the caller and wrapped with setPlanes, so a frame can be updated in place every frame.
+class AK_API YuvImage : public Image
+{
+public:
+	YuvImage(int width, int height, ak::YuvFormat format, ak::YuvColorSpace colorSpace = ak::kYuvRec601);
+	virtual ~YuvImage();
+
+	ak::YuvFormat getFormat() const;
+	ak::YuvColorSpace getColorSpace() const;
+	void setColorSpace(ak::YuvColorSpace colorSpace);
+
+	// plane 0 is y, 1 is u, or u and v interleaved for ak::kYuvNV12, and 2 is v.
+	// chroma planes are half the width and height, rounded up.
+	// the planes of the image are allocated by the first call and drawn from then on.
+	unsigned char* getWritablePlane(int plane, int* rowBytes);
+	const unsigned char* getPlane(int plane, int* rowBytes) const;
+
+	// draws from planes owned by the caller until the next getWritablePlane, which must
+	// outlive the draws. v is null for ak::kYuvNV12.
+	bool setPlanes(const unsigned char* y, int yRowBytes, const unsigned char* u, const unsigned char* v,
+		int uvRowBytes);
+
+	// Image
+	virtual int width() override;
+	virtual int height() override;
+
+private:
+	YuvImageDelegate* _yuvImageDelegate;
+};
\ No newline at end of file
@@ -1,8 +1,77 @@
 #pragma once
 
-class EventHandler
+#include "UIDefine.h"
+#include "KPoint.h"
+
+class View;
+class EventHandlerDelegate;
+
+// an input event as delivered to View::onEvent, positions are in window coordinates.
+struct InputEvent
+{
+	ak::EventType _type;
+
+	// a combination of ak::EventFlags.
+	int _flags;
+
+	// the button pressed or released, one of the button flags.
+	int _button;
+	int _x;
+	int _y;
+
+	// in multiples of 120 per notch, positive away from the user.
+	int _wheelDelta;
+
+	// a virtual key on windows, a KeySym on x11.
+	unsigned long _keyCode;
+
+	// milliseconds, as stamped by the window system.
+	unsigned long _time;
+
+	// the positions of the mouse moves merged into this one, oldest first, without _x and _y.
+	// only valid while the event is delivered.
+	const KPoint* _history;
+	int _historyCount;
+
+	// the view the event was hit tested or captured to.
+	View* _target;
+};
+
+class AK_API EventHandler
 {
 public:
     EventHandler();
     virtual ~EventHandler();
+
+	// queues an event until the next dispatchEvents. a mouse move following a move with the
+	// same flags replaces it and keeps its position as history, wheel events add up.
+	void postEvent(const InputEvent& event);
+	bool hasPendingEvents() const;
+
+	// delivers the queued events to the views of root, once per frame before it is drawn.
+	// returns the number of events delivered.
+	int dispatchEvents(View* root);
+
+	// mouse events go to the capture view instead of the view under the mouse. a button press
+	// captures its target until every button is released.
+	void setCaptureView(View* view);
+	View* getCaptureView() const;
+
+	// key events go to the focus view, the last one pressed, or to the root.
+	void setFocusView(View* view);
+	View* getFocusView() const;
+
+	// called as view is destroyed, the capture and focus views stop pointing at it.
+	void removeView(View* view);
+
+	// the events merged by postEvent since the handler was created.
+	int getCoalescedCount() const;
+
+protected:
+	// calls onInterceptEvent from the root down to the parent of the target, then onEvent
+	// from the target up to the root, until a view handles the event.
+	virtual bool deliverEvent(InputEvent& event);
+
+private:
+	EventHandlerDelegate* _delegate;
 };
\ No newline at end of file
@@ -1,9 +1,14 @@
 #pragma once
 
+#ifdef _WIN32
 #include <windows.h>
+#else
+union _XEvent;
+#endif
 
 class View;
 class KRect;
+class EventHandler;
 class WidgetDelegate;
 
 class AK_API Widget
@@ -26,17 +31,43 @@ public:
 
 	void schedualPaint(const KRect& rect);
 
+	// input is queued as it arrives and delivered to the views once per frame, before the
+	// frame is drawn, so a fast mouse does not call the views for every move.
+	EventHandler* getEventHandler();
+	void dispatchEvents();
+
+	// tiled images decode on worker threads, the widget polls for the tiles that landed
+	// while some are loading and paints the views showing them.
+	void updateTiledImages();
+
+	// debug overlays of the root view, a combination of ak::DebugOverlay.
+	void setDebugOverlay(int overlays);
+	void getDebugStats(ak::DebugStats& stats);
+
     /**
      *  ʼƿ
      */
     virtual bool initCanvas(int canvasType);
 
+#ifdef _WIN32
     LRESULT wndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam);
+#else
+	void processEvent(_XEvent& event);
+
+	// the event loop of the x11 backend, waits for events or the next animation tick and
+	// dispatches them to every widget. returns false once a widget asked to quit.
+	static bool processEvents();
+#endif
 
     static Widget* createWindow(int x, int y, int width, int height);
 
 protected:
+#ifdef _WIN32
 	virtual LRESULT processKeyDown(WPARAM wparam, LPARAM lparam);
+#else
+	// keysym is an x11 KeySym, returns true if the key was handled.
+	virtual bool processKeyDown(unsigned long keysym);
+#endif
 	virtual void init(int x, int y, int width, int height);
 
 private:
@@ -1,21 +1,24 @@
 #include "UIDefine.h"
 #include "Canvas.h"
 #include "SkiaGraphics.h"
+#ifdef _WIN32
 #include "GdiPlusGraphics.h"
 #include "GdiGraphics.h"
+#endif
+#include "SkiaPdfGraphics.h"
 #include "Size.h"
 
 class CanvasDelegate 
 {
 public:
-    CanvasDelegate::CanvasDelegate()
+    CanvasDelegate()
         : _pGraphics(nullptr)
 		, _graphicsType(ak::GdiGraphics)
     {
 
     }
 
-    CanvasDelegate::~CanvasDelegate()
+    ~CanvasDelegate()
     {
         if (nullptr != _pGraphics)
         {
@@ -36,7 +39,11 @@ Canvas::Canvas()
 
 Canvas::~Canvas()
 {
-
+	if (nullptr != _canvasDelegate)
+	{
+		delete _canvasDelegate;
+		_canvasDelegate = nullptr;
+	}
 }
 
 bool Canvas::init(int width, int height, int canvasType)
@@ -46,7 +53,7 @@ bool Canvas::init(int width, int height, int canvasType)
 	if (nullptr != _canvasDelegate->_pGraphics)
 	{
 		delete _canvasDelegate->_pGraphics;
-		_canvasDelegate = nullptr;
+		_canvasDelegate->_pGraphics = nullptr;
 	}
 
     switch(canvasType)
@@ -56,6 +63,7 @@ bool Canvas::init(int width, int height, int canvasType)
         _canvasDelegate->_pGraphics = new SkiaGraphics(width, height);
         break;
 
+#ifdef _WIN32
     case ak::GdiPlusGraphics:
 		_canvasDelegate->_graphicsType = ak::GdiPlusGraphics;
 		_canvasDelegate->_pGraphics = new GdiPlusGraphics(width, height);
@@ -65,6 +73,12 @@ bool Canvas::init(int width, int height, int canvasType)
 		_canvasDelegate->_graphicsType = ak::GdiGraphics;
 		_canvasDelegate->_pGraphics = new GdiGraphics(width, height);
         break;
+#endif
+
+	case ak::PdfGraphics:
+		_canvasDelegate->_graphicsType = ak::PdfGraphics;
+		_canvasDelegate->_pGraphics = new SkiaPdfGraphics(width, height);
+		break;
 
     default:
         return false;
@@ -73,6 +87,22 @@ bool Canvas::init(int width, int height, int canvasType)
     return true;
 }
 
+bool Canvas::init(int width, int height, void* pixels, int rowBytes)
+{
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate);
+	INVALID_POINTER_RETURN_FALSE(pixels);
+
+	if (nullptr != _canvasDelegate->_pGraphics)
+	{
+		delete _canvasDelegate->_pGraphics;
+		_canvasDelegate->_pGraphics = nullptr;
+	}
+
+	_canvasDelegate->_graphicsType = ak::SkiaGraphics;
+	_canvasDelegate->_pGraphics = new SkiaGraphics(width, height, pixels, rowBytes);
+	return true;
+}
+
 void* Canvas::lockBits()
 {
     INVALID_POINTER_RETURN_NULL(_canvasDelegate);
@@ -122,6 +152,13 @@ bool Canvas::drawImage(Image* image, int x, int y, int nAlpha)
     return _canvasDelegate->_pGraphics->drawImage(image, x, y, nAlpha);
 }
 
+bool Canvas::drawImage(Image* image, const KRect& rect, int nAlpha)
+{
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate);
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate->_pGraphics);
+	return _canvasDelegate->_pGraphics->drawImage(image, rect, nAlpha);
+}
+
 bool Canvas::drawImage(Image* image, int x, int y, float degrees)
 {
 	INVALID_POINTER_RETURN_FALSE(_canvasDelegate);
@@ -129,6 +166,14 @@ bool Canvas::drawImage(Image* image, int x, int y, float degrees)
 	return _canvasDelegate->_pGraphics->drawImage(image, x, y, degrees);
 }
 
+bool Canvas::drawMesh(Image* image, const float* vertices, const float* texCoords, int vertexCount,
+	const unsigned short* indices, int indexCount, int nAlpha)
+{
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate);
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate->_pGraphics);
+	return _canvasDelegate->_pGraphics->drawMesh(image, vertices, texCoords, vertexCount, indices, indexCount, nAlpha);
+}
+
 bool Canvas::drawRect(KPen* pen, KRect& rect)
 {
     INVALID_POINTER_RETURN_FALSE(_canvasDelegate);
@@ -143,6 +188,20 @@ bool Canvas::fillRect(KBrush* brush, KRect& rect)
 	return _canvasDelegate->_pGraphics->fillRect(brush, rect);
 }
 
+bool Canvas::drawPath(KPen* pen, const KPath& path)
+{
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate);
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate->_pGraphics);
+	return _canvasDelegate->_pGraphics->drawPath(pen, path);
+}
+
+bool Canvas::fillPath(KBrush* brush, const KPath& path)
+{
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate);
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate->_pGraphics);
+	return _canvasDelegate->_pGraphics->fillPath(brush, path);
+}
+
 bool Canvas::drawString(const KString& str, int len, const KFont& font, const KPoint& pt, KBrush* brush)
 {
 	INVALID_POINTER_RETURN_FALSE(_canvasDelegate);
@@ -157,9 +216,191 @@ bool Canvas::setClip(const KRect& rect, ak::opMode mode)
 	return _canvasDelegate->_pGraphics->setClip(rect, mode);
 }
 
+bool Canvas::setClip(const KRect& rect, int radius, ak::opMode mode)
+{
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate);
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate->_pGraphics);
+
+	if (radius <= 0)
+	{
+		return _canvasDelegate->_pGraphics->setClip(rect, mode);
+	}
+
+	return _canvasDelegate->_pGraphics->setClip(rect, radius, mode);
+}
+
 bool Canvas::resetClip()
 {
 	INVALID_POINTER_RETURN_FALSE(_canvasDelegate);
 	INVALID_POINTER_RETURN_FALSE(_canvasDelegate->_pGraphics);
 	return _canvasDelegate->_pGraphics->resetClip();
+}
+
+bool Canvas::beginCacheLayer(const void* key, const KRect& rect)
+{
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate);
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate->_pGraphics);
+	return _canvasDelegate->_pGraphics->beginCacheLayer(key, rect);
+}
+
+bool Canvas::endCacheLayer()
+{
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate);
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate->_pGraphics);
+	return _canvasDelegate->_pGraphics->endCacheLayer();
+}
+
+bool Canvas::drawCacheLayer(const void* key)
+{
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate);
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate->_pGraphics);
+	return _canvasDelegate->_pGraphics->drawCacheLayer(key);
+}
+
+void Canvas::removeCacheLayer(const void* key)
+{
+	INVALID_POINTER_RETURN(_canvasDelegate);
+	INVALID_POINTER_RETURN(_canvasDelegate->_pGraphics);
+	_canvasDelegate->_pGraphics->removeCacheLayer(key);
+}
+
+bool Canvas::beginOpacityLayer(const KRect& rect, int opacity, bool opaqueContent)
+{
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate);
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate->_pGraphics);
+	return _canvasDelegate->_pGraphics->beginOpacityLayer(rect, opacity, opaqueContent);
+}
+
+bool Canvas::endOpacityLayer()
+{
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate);
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate->_pGraphics);
+	return _canvasDelegate->_pGraphics->endOpacityLayer();
+}
+
+bool Canvas::drawTiledImage(const void* key, const TileImageSource& source, const KRect& rect,
+	float zoom, float originX, float originY, bool* pending)
+{
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate);
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate->_pGraphics);
+	return _canvasDelegate->_pGraphics->drawTiledImage(key, source, rect, zoom, originX, originY, pending);
+}
+
+void Canvas::removeTiledImage(const void* key)
+{
+	INVALID_POINTER_RETURN(_canvasDelegate);
+	INVALID_POINTER_RETURN(_canvasDelegate->_pGraphics);
+	_canvasDelegate->_pGraphics->removeTiledImage(key);
+}
+
+void Canvas::setTiledImageBudget(size_t bytes)
+{
+	INVALID_POINTER_RETURN(_canvasDelegate);
+	INVALID_POINTER_RETURN(_canvasDelegate->_pGraphics);
+	_canvasDelegate->_pGraphics->setTiledImageBudget(bytes);
+}
+
+const void* Canvas::takeLoadedTiledImage()
+{
+	INVALID_POINTER_RETURN_NULL(_canvasDelegate);
+	INVALID_POINTER_RETURN_NULL(_canvasDelegate->_pGraphics);
+	return _canvasDelegate->_pGraphics->takeLoadedTiledImage();
+}
+
+bool Canvas::isLoadingTiledImages()
+{
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate);
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate->_pGraphics);
+	return _canvasDelegate->_pGraphics->isLoadingTiledImages();
+}
+
+bool Canvas::newPage()
+{
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate);
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate->_pGraphics);
+	return _canvasDelegate->_pGraphics->newPage();
+}
+
+bool Canvas::saveDocument(const KString& path)
+{
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate);
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate->_pGraphics);
+	return _canvasDelegate->_pGraphics->saveDocument(path);
+}
+
+bool Canvas::setOverdrawCounting(bool enable)
+{
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate);
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate->_pGraphics);
+	return _canvasDelegate->_pGraphics->setOverdrawCounting(enable);
+}
+
+void Canvas::resetOverdraw()
+{
+	INVALID_POINTER_RETURN(_canvasDelegate);
+	INVALID_POINTER_RETURN(_canvasDelegate->_pGraphics);
+	_canvasDelegate->_pGraphics->resetOverdraw();
+}
+
+bool Canvas::getOverdraw(const KRect& rect, int* pixels, int* writes, int* maxWrites)
+{
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate);
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate->_pGraphics);
+	return _canvasDelegate->_pGraphics->getOverdraw(rect, pixels, writes, maxWrites);
+}
+
+bool Canvas::drawOverdrawHeatmap(const KRect& rect)
+{
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate);
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate->_pGraphics);
+	return _canvasDelegate->_pGraphics->drawOverdrawHeatmap(rect);
+}
+
+void Canvas::advanceFrame()
+{
+	INVALID_POINTER_RETURN(_canvasDelegate);
+	INVALID_POINTER_RETURN(_canvasDelegate->_pGraphics);
+	_canvasDelegate->_pGraphics->advanceFrame();
+}
+
+bool Canvas::beginCachePicture(const void* key)
+{
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate);
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate->_pGraphics);
+	return _canvasDelegate->_pGraphics->beginCachePicture(key);
+}
+
+bool Canvas::endCachePicture()
+{
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate);
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate->_pGraphics);
+	return _canvasDelegate->_pGraphics->endCachePicture();
+}
+
+bool Canvas::drawCachePicture(const void* key)
+{
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate);
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate->_pGraphics);
+	return _canvasDelegate->_pGraphics->drawCachePicture(key);
+}
+
+void Canvas::removeCachePicture(const void* key)
+{
+	INVALID_POINTER_RETURN(_canvasDelegate);
+	INVALID_POINTER_RETURN(_canvasDelegate->_pGraphics);
+	_canvasDelegate->_pGraphics->removeCachePicture(key);
+}
+
+bool Canvas::setDamageClip(const KRect& rect)
+{
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate);
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate->_pGraphics);
+	return _canvasDelegate->_pGraphics->setDamageClip(rect);
+}
+
+bool Canvas::resetDamageClip()
+{
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate);
+	INVALID_POINTER_RETURN_FALSE(_canvasDelegate->_pGraphics);
+	return _canvasDelegate->_pGraphics->resetDamageClip();
 }
\ No newline at end of file
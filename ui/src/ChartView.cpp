@@ -0,0 +1,417 @@
+#include "UIDefine.h"
+#include "ChartView.h"
+#include "Canvas.h"
+#include "KPath.h"
+#include "KPen.h"
+#include "KSolidBrush.h"
+#include <vector>
+#include <cmath>
+
+namespace
+{
+	// every level groups 4 buckets of the level below.
+	const int kLevelShift = 2;
+
+	struct ChartSeries
+	{
+		Color _color;
+		std::vector<float> _samples;
+
+		// _mins[k] and _maxs[k] hold level k + 1.
+		std::vector<std::vector<float> > _mins;
+		std::vector<std::vector<float> > _maxs;
+
+		void append(float sample)
+		{
+			size_t index = _samples.size();
+			_samples.push_back(sample);
+
+			for (size_t level = 0; ; ++level)
+			{
+				size_t bucket = index >> ((level + 1) * kLevelShift);
+
+				if (level == _mins.size())
+				{
+					// a new top level once the previous one needs more than one bucket.
+					if (0 == bucket)
+					{
+						break;
+					}
+
+					_mins.push_back(std::vector<float>());
+					_maxs.push_back(std::vector<float>());
+					rebuildLevel(level);
+					continue;
+				}
+
+				std::vector<float>& mins = _mins[level];
+				std::vector<float>& maxs = _maxs[level];
+
+				if (bucket == mins.size())
+				{
+					mins.push_back(sample);
+					maxs.push_back(sample);
+				}
+				else
+				{
+					mins[bucket] = mins[bucket] < sample ? mins[bucket] : sample;
+					maxs[bucket] = maxs[bucket] > sample ? maxs[bucket] : sample;
+				}
+			}
+		}
+
+		// fills a level created after its samples were appended.
+		void rebuildLevel(size_t level)
+		{
+			std::vector<float>& mins = _mins[level];
+			std::vector<float>& maxs = _maxs[level];
+			size_t bucketCount = ((_samples.size() - 1) >> ((level + 1) * kLevelShift)) + 1;
+			mins.resize(bucketCount);
+			maxs.resize(bucketCount);
+
+			for (size_t bucket = 0; bucket < bucketCount; ++bucket)
+			{
+				float minValue = 0;
+				float maxValue = 0;
+				getBucket(level, bucket << kLevelShift, ((bucket + 1) << kLevelShift), &minValue, &maxValue);
+				mins[bucket] = minValue;
+				maxs[bucket] = maxValue;
+			}
+		}
+
+		// extremes of buckets [first, last) of the level below level + 1, level 0 being the samples.
+		bool getBucket(size_t level, size_t first, size_t last, float* minValue, float* maxValue) const
+		{
+			const float* mins = nullptr;
+			const float* maxs = nullptr;
+			size_t count = 0;
+
+			if (0 == level)
+			{
+				mins = maxs = _samples.empty() ? nullptr : &_samples[0];
+				count = _samples.size();
+			}
+			else
+			{
+				mins = &_mins[level - 1][0];
+				maxs = &_maxs[level - 1][0];
+				count = _mins[level - 1].size();
+			}
+
+			last = last < count ? last : count;
+
+			if (first >= last)
+			{
+				return false;
+			}
+
+			*minValue = mins[first];
+			*maxValue = maxs[first];
+
+			for (size_t i = first + 1; i < last; ++i)
+			{
+				*minValue = *minValue < mins[i] ? *minValue : mins[i];
+				*maxValue = *maxValue > maxs[i] ? *maxValue : maxs[i];
+			}
+
+			return true;
+		}
+
+		void clear()
+		{
+			_samples.clear();
+			_mins.clear();
+			_maxs.clear();
+		}
+	};
+}
+
+class ChartViewDelegate
+{
+public:
+	ChartViewDelegate()
+		: _firstSample(0)
+		, _sampleCount(0)
+		, _minValue(0)
+		, _maxValue(1)
+		, _background(0xff, 0xff, 0xff, 0xff)
+	{
+
+	}
+
+	~ChartViewDelegate()
+	{
+
+	}
+
+	bool isValidSeries(int series)
+	{
+		return series >= 0 && series < (int)_series.size();
+	}
+
+public:
+	std::vector<ChartSeries> _series;
+	double _firstSample;
+	double _sampleCount;
+	float _minValue;
+	float _maxValue;
+	Color _background;
+
+	// reused every frame, panning does not reallocate.
+	KPath _path;
+	std::vector<float> _columnTops;
+	std::vector<float> _columnBottoms;
+};
+
+ChartView::ChartView()
+{
+	_chartViewDelegate = new ChartViewDelegate;
+}
+
+ChartView::~ChartView()
+{
+	if (nullptr != _chartViewDelegate)
+	{
+		delete _chartViewDelegate;
+		_chartViewDelegate = nullptr;
+	}
+}
+
+int ChartView::addSeries(const Color& color)
+{
+	INVALID_POINTER_RETURN_PARAM(_chartViewDelegate, -1);
+
+	ChartSeries series;
+	series._color = color;
+	_chartViewDelegate->_series.push_back(series);
+	return (int)_chartViewDelegate->_series.size() - 1;
+}
+
+bool ChartView::appendSamples(int series, const float* samples, int count)
+{
+	INVALID_POINTER_RETURN_FALSE(_chartViewDelegate);
+	INVALID_POINTER_RETURN_FALSE(samples);
+	VALUE_FALSE_RETURN_FALSE(_chartViewDelegate->isValidSeries(series));
+
+	ChartSeries& chartSeries = _chartViewDelegate->_series[series];
+	chartSeries._samples.reserve(chartSeries._samples.size() + count);
+
+	for (int i = 0; i < count; ++i)
+	{
+		chartSeries.append(samples[i]);
+	}
+
+	schedulePaint();
+	return true;
+}
+
+bool ChartView::appendSample(int series, float sample)
+{
+	return appendSamples(series, &sample, 1);
+}
+
+bool ChartView::clearSeries(int series)
+{
+	INVALID_POINTER_RETURN_FALSE(_chartViewDelegate);
+	VALUE_FALSE_RETURN_FALSE(_chartViewDelegate->isValidSeries(series));
+
+	_chartViewDelegate->_series[series].clear();
+	schedulePaint();
+	return true;
+}
+
+int ChartView::getSampleCount(int series)
+{
+	INVALID_POINTER_RETURN_PARAM(_chartViewDelegate, 0);
+
+	if (!_chartViewDelegate->isValidSeries(series))
+	{
+		return 0;
+	}
+
+	return (int)_chartViewDelegate->_series[series]._samples.size();
+}
+
+void ChartView::setVisibleRange(double firstSample, double sampleCount)
+{
+	INVALID_POINTER_RETURN(_chartViewDelegate);
+	_chartViewDelegate->_firstSample = firstSample;
+	_chartViewDelegate->_sampleCount = sampleCount;
+	schedulePaint();
+}
+
+void ChartView::setValueRange(float minValue, float maxValue)
+{
+	INVALID_POINTER_RETURN(_chartViewDelegate);
+	_chartViewDelegate->_minValue = minValue;
+	_chartViewDelegate->_maxValue = maxValue;
+	schedulePaint();
+}
+
+void ChartView::setBackground(const Color& color)
+{
+	INVALID_POINTER_RETURN(_chartViewDelegate);
+	_chartViewDelegate->_background = color;
+	schedulePaint();
+}
+
+bool ChartView::draw(Canvas& canvas)
+{
+	INVALID_POINTER_RETURN_FALSE(_chartViewDelegate);
+
+	KRect rect;
+	VALUE_FALSE_RETURN_FALSE(getRect(rect));
+
+	if (rect.isEmpty())
+	{
+		return View::draw(canvas);
+	}
+
+	KSolidBrush background(_chartViewDelegate->_background);
+	canvas.fillRect(&background, rect);
+	canvas.setClip(rect, ak::kModeIntersect);
+
+	int width = rect.width();
+	double firstSample = _chartViewDelegate->_firstSample;
+	double sampleCount = _chartViewDelegate->_sampleCount;
+	double samplesPerPixel = sampleCount / width;
+	float valueRange = _chartViewDelegate->_maxValue - _chartViewDelegate->_minValue;
+	float yScale = valueRange != 0 ? rect.height() / valueRange : 0;
+	float yBase = (float)rect._bottom;
+	KPath& path = _chartViewDelegate->_path;
+
+	for (size_t i = 0; i < _chartViewDelegate->_series.size() && sampleCount > 0; ++i)
+	{
+		const ChartSeries& series = _chartViewDelegate->_series[i];
+
+		if (series._samples.empty())
+		{
+			continue;
+		}
+
+		// the largest level whose buckets still fit in a pixel, a column then reads a handful of buckets.
+		size_t level = 0;
+
+		while (level < series._mins.size() && samplesPerPixel >= (double)((size_t)1 << ((level + 1) * kLevelShift)))
+		{
+			++level;
+		}
+
+		path.reset();
+
+		if (samplesPerPixel <= 1)
+		{
+			// zoomed in past one sample per pixel, plot the samples themselves as a polyline.
+			int first = (int)std::floor(firstSample);
+			int last = (int)std::ceil(firstSample + sampleCount);
+			first = first > 0 ? first : 0;
+			last = last < (int)series._samples.size() - 1 ? last : (int)series._samples.size() - 1;
+
+			for (int sample = first; sample <= last; ++sample)
+			{
+				float x = rect._left + (float)((sample - firstSample) / samplesPerPixel);
+				float y = yBase - (series._samples[sample] - _chartViewDelegate->_minValue) * yScale;
+
+				if (sample == first)
+				{
+					path.moveTo(x, y);
+				}
+				else
+				{
+					path.lineTo(x, y);
+				}
+			}
+
+			if (!path.isEmpty())
+			{
+				KPen pen(series._color, 1);
+				canvas.drawPath(&pen, path);
+			}
+
+			continue;
+		}
+
+		// one min/max pair per pixel column, then the envelope as a single closed path.
+		std::vector<float>& tops = _chartViewDelegate->_columnTops;
+		std::vector<float>& bottoms = _chartViewDelegate->_columnBottoms;
+		tops.resize(width);
+		bottoms.resize(width);
+		size_t bucketShift = level * kLevelShift;
+		int firstColumn = -1;
+		int lastColumn = -1;
+
+		for (int column = 0; column < width; ++column)
+		{
+			double columnFirst = firstSample + column * samplesPerPixel;
+			double columnLast = columnFirst + samplesPerPixel;
+
+			if (columnLast <= 0)
+			{
+				continue;
+			}
+
+			size_t first = (size_t)(columnFirst > 0 ? columnFirst : 0) >> bucketShift;
+			size_t last = ((size_t)std::ceil(columnLast) + ((size_t)1 << bucketShift) - 1) >> bucketShift;
+			float minValue = 0;
+			float maxValue = 0;
+
+			if (!series.getBucket(level, first, last, &minValue, &maxValue))
+			{
+				break;
+			}
+
+			float top = yBase - (maxValue - _chartViewDelegate->_minValue) * yScale;
+			float bottom = yBase - (minValue - _chartViewDelegate->_minValue) * yScale;
+
+			// a flat stretch still covers a pixel row.
+			if (bottom - top < 1)
+			{
+				float center = (top + bottom) / 2;
+				top = center - 0.5f;
+				bottom = center + 0.5f;
+			}
+
+			tops[column] = top;
+			bottoms[column] = bottom;
+			firstColumn = firstColumn < 0 ? column : firstColumn;
+			lastColumn = column;
+		}
+
+		if (firstColumn < 0)
+		{
+			continue;
+		}
+
+		path.reserve((lastColumn - firstColumn + 1) * 4 + 2, (lastColumn - firstColumn + 1) * 4);
+
+		for (int column = firstColumn; column <= lastColumn; ++column)
+		{
+			float x = (float)(rect._left + column);
+
+			if (column == firstColumn)
+			{
+				path.moveTo(x, tops[column]);
+			}
+			else
+			{
+				path.lineTo(x, tops[column]);
+			}
+
+			path.lineTo(x + 1, tops[column]);
+		}
+
+		for (int column = lastColumn; column >= firstColumn; --column)
+		{
+			float x = (float)(rect._left + column);
+			path.lineTo(x + 1, bottoms[column]);
+			path.lineTo(x, bottoms[column]);
+		}
+
+		path.close();
+		KSolidBrush brush(series._color);
+		canvas.fillPath(&brush, path);
+	}
+
+	canvas.resetClip();
+	return View::draw(canvas);
+}
\ No newline at end of file
@@ -1,8 +1,10 @@
 #include "UIDefine.h"
 #include "Image.h"
 #include "SkiaImage.h"
+#ifdef _WIN32
 #include "GdiPlusImage.h"
 #include "GdiImage.h"
+#endif
 
 Image::Image()
 {
@@ -26,6 +28,7 @@ Image* Image::createImage(int graphicsType)
 		}
 		break;
 
+#ifdef _WIN32
 	case ak::GdiPlusGraphics:
 		{
 			image = new GdiplusImage;
@@ -37,6 +40,7 @@ Image* Image::createImage(int graphicsType)
 			image = new GdiImage;
 		}
 		break;
+#endif
 
 	default:
 		break;
@@ -57,6 +61,7 @@ Image* Image::createImage(int width, int height, int graphicsType)
 		}
 		break;
 
+#ifdef _WIN32
 	case ak::GdiPlusGraphics:
 		{
 			image = new GdiplusImage(width, height);
@@ -68,6 +73,7 @@ Image* Image::createImage(int width, int height, int graphicsType)
 			image = new GdiImage(width, height);
 		}
 		break;
+#endif
 
 	default:
 		break;
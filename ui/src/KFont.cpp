@@ -1,6 +1,7 @@
 #include "UIDefine.h"
 #include "KFont.h"
 #include "KFontFamily.h"
+#include "SkGraphics.h"
 
 KFont::KFont(KFontFamily* fontFamily, int fontSize, KFontStyle fontStyle, KFontUnit fontUnit)
 	: _fontFamily(fontFamily)
@@ -34,4 +35,16 @@ KFontUnit KFont::getFontUnit() const
 int KFont::getFontSize() const
 {
 	return _fontSize;
+}
+
+bool KFont::saveGlyphCache(const char* path)
+{
+	INVALID_POINTER_RETURN_FALSE(path);
+	return SkGraphics::WriteFontCacheSnapshot(path);
+}
+
+int KFont::loadGlyphCache(const char* path)
+{
+	INVALID_POINTER_RETURN_PARAM(path, 0);
+	return SkGraphics::LoadFontCacheSnapshot(path);
 }
\ No newline at end of file
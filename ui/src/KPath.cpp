@@ -0,0 +1,297 @@
+#include "UIDefine.h"
+#include "KPath.h"
+#include "SkiaHelper.h"
+#include "SkPathMeasure.h"
+#include "SkThread.h"
+#include <vector>
+
+namespace
+{
+	int32_t gPathGenerationID;
+}
+
+class KPathDelegate
+{
+public:
+	KPathDelegate()
+		: _generationID(0)
+		, _skiaPathGenerationID(0)
+	{
+
+	}
+
+	~KPathDelegate()
+	{
+
+	}
+
+	void addPoint(float x, float y)
+	{
+		_points.push_back(x);
+		_points.push_back(y);
+	}
+
+	// the skia path is rebuilt only when the path changed, it keeps its own generation id and
+	// with it the measure cache entry.
+	const SkPath& getSkiaPath(const KPath& path)
+	{
+		unsigned int generationID = path.getGenerationID();
+
+		if (_skiaPathGenerationID != generationID)
+		{
+			SkiaHelper::pathToSkiaPath(path, &_skiaPath);
+			_skiaPathGenerationID = generationID;
+		}
+
+		return _skiaPath;
+	}
+
+public:
+	std::vector<KPathVerb> _verbs;
+	std::vector<float> _points;
+
+	// 0 until asked for after an edit.
+	unsigned int _generationID;
+	SkPath _skiaPath;
+	unsigned int _skiaPathGenerationID;
+};
+
+KPath::KPath()
+{
+	_pathDelegate = new KPathDelegate;
+}
+
+KPath::KPath(const KPath& path)
+{
+	_pathDelegate = new KPathDelegate(*path._pathDelegate);
+}
+
+KPath::~KPath()
+{
+	if (nullptr != _pathDelegate)
+	{
+		delete _pathDelegate;
+		_pathDelegate = nullptr;
+	}
+}
+
+const KPath& KPath::operator = (const KPath& path)
+{
+	if (this != &path)
+	{
+		*_pathDelegate = *path._pathDelegate;
+	}
+
+	return *this;
+}
+
+void KPath::moveTo(float x, float y)
+{
+	_pathDelegate->_generationID = 0;
+	_pathDelegate->_verbs.push_back(KPathVerbMove);
+	_pathDelegate->addPoint(x, y);
+}
+
+void KPath::lineTo(float x, float y)
+{
+	_pathDelegate->_generationID = 0;
+	if (_pathDelegate->_verbs.empty())
+	{
+		moveTo(0, 0);
+	}
+
+	_pathDelegate->_verbs.push_back(KPathVerbLine);
+	_pathDelegate->addPoint(x, y);
+}
+
+void KPath::quadTo(float x1, float y1, float x2, float y2)
+{
+	_pathDelegate->_generationID = 0;
+	if (_pathDelegate->_verbs.empty())
+	{
+		moveTo(0, 0);
+	}
+
+	_pathDelegate->_verbs.push_back(KPathVerbQuad);
+	_pathDelegate->addPoint(x1, y1);
+	_pathDelegate->addPoint(x2, y2);
+}
+
+void KPath::cubicTo(float x1, float y1, float x2, float y2, float x3, float y3)
+{
+	_pathDelegate->_generationID = 0;
+	if (_pathDelegate->_verbs.empty())
+	{
+		moveTo(0, 0);
+	}
+
+	_pathDelegate->_verbs.push_back(KPathVerbCubic);
+	_pathDelegate->addPoint(x1, y1);
+	_pathDelegate->addPoint(x2, y2);
+	_pathDelegate->addPoint(x3, y3);
+}
+
+void KPath::close()
+{
+	if (!_pathDelegate->_verbs.empty() && KPathVerbClose != _pathDelegate->_verbs.back())
+	{
+		_pathDelegate->_verbs.push_back(KPathVerbClose);
+		_pathDelegate->_generationID = 0;
+	}
+}
+
+void KPath::reset()
+{
+	_pathDelegate->_generationID = 0;
+	_pathDelegate->_verbs.clear();
+	_pathDelegate->_points.clear();
+}
+
+void KPath::reserve(int verbCount, int pointCount)
+{
+	_pathDelegate->_verbs.reserve(verbCount);
+	_pathDelegate->_points.reserve(pointCount * 2);
+}
+
+bool KPath::isEmpty() const
+{
+	return _pathDelegate->_verbs.empty();
+}
+
+int KPath::countVerbs() const
+{
+	return (int)_pathDelegate->_verbs.size();
+}
+
+KPathVerb KPath::getVerb(int index) const
+{
+	return _pathDelegate->_verbs[index];
+}
+
+int KPath::countPoints() const
+{
+	return (int)_pathDelegate->_points.size() / 2;
+}
+
+const float* KPath::getPoints() const
+{
+	return _pathDelegate->_points.empty() ? nullptr : &_pathDelegate->_points[0];
+}
+
+unsigned int KPath::getGenerationID() const
+{
+	if (0 == _pathDelegate->_generationID)
+	{
+		_pathDelegate->_generationID = (unsigned int)sk_atomic_inc(&gPathGenerationID) + 1;
+
+		// 0 is never handed out, even after wrapping.
+		if (0 == _pathDelegate->_generationID)
+		{
+			_pathDelegate->_generationID = (unsigned int)sk_atomic_inc(&gPathGenerationID) + 1;
+		}
+	}
+
+	return _pathDelegate->_generationID;
+}
+
+float KPath::getLength() const
+{
+	SkPathMeasure measure(_pathDelegate->getSkiaPath(*this), false);
+	SkScalar length = 0;
+
+	do
+	{
+		length += measure.getLength();
+	} while (measure.nextContour());
+
+	return SkScalarToFloat(length);
+}
+
+bool KPath::getPosTan(const float* distances, int count, float* positions, float* tangents) const
+{
+	INVALID_POINTER_RETURN_FALSE(distances);
+
+	SkPathMeasure measure(_pathDelegate->getSkiaPath(*this), false);
+	std::vector<bool> pending(count, true);
+	std::vector<int> indices;
+	std::vector<SkScalar> contourDistances;
+	std::vector<SkPoint> contourPositions(count);
+	std::vector<SkVector> contourTangents(count);
+	SkScalar start = 0;
+	SkPoint endPosition;
+	SkVector endTangent;
+	bool measured = false;
+
+	// each contour takes the distances that end on it, the first one those before the path.
+	do
+	{
+		SkScalar length = measure.getLength();
+
+		if (length <= 0)
+		{
+			continue;
+		}
+
+		indices.clear();
+		contourDistances.clear();
+
+		for (int i = 0; i < count; ++i)
+		{
+			if (pending[i] && SkFloatToScalar(distances[i]) <= start + length)
+			{
+				indices.push_back(i);
+				contourDistances.push_back(SkFloatToScalar(distances[i]) - start);
+				pending[i] = false;
+			}
+		}
+
+		if (!indices.empty() && measure.getPosTan(&contourDistances[0], (int)indices.size(),
+			&contourPositions[0], &contourTangents[0]))
+		{
+			for (size_t i = 0; i < indices.size(); ++i)
+			{
+				int index = indices[i];
+
+				if (nullptr != positions)
+				{
+					positions[index * 2] = SkScalarToFloat(contourPositions[i].fX);
+					positions[index * 2 + 1] = SkScalarToFloat(contourPositions[i].fY);
+				}
+
+				if (nullptr != tangents)
+				{
+					tangents[index * 2] = SkScalarToFloat(contourTangents[i].fX);
+					tangents[index * 2 + 1] = SkScalarToFloat(contourTangents[i].fY);
+				}
+			}
+		}
+
+		measured = measure.getPosTan(length, &endPosition, &endTangent) || measured;
+		start += length;
+	} while (measure.nextContour());
+
+	VALUE_FALSE_RETURN_FALSE(measured);
+
+	// past the end of the path.
+	for (int i = 0; i < count; ++i)
+	{
+		if (!pending[i])
+		{
+			continue;
+		}
+
+		if (nullptr != positions)
+		{
+			positions[i * 2] = SkScalarToFloat(endPosition.fX);
+			positions[i * 2 + 1] = SkScalarToFloat(endPosition.fY);
+		}
+
+		if (nullptr != tangents)
+		{
+			tangents[i * 2] = SkScalarToFloat(endTangent.fX);
+			tangents[i * 2 + 1] = SkScalarToFloat(endTangent.fY);
+		}
+	}
+
+	return true;
+}
\ No newline at end of file
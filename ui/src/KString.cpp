@@ -1,6 +1,11 @@
 #include "UIDefine.h"
 #include "KString.h"
 #include "StringHelper.h"
+#include <wchar.h>
+
+#ifndef _WIN32
+#define swprintf_s swprintf
+#endif
 
 const int MAX_NUMBER_LEN = 32;
 
@@ -0,0 +1,351 @@
+#include "UIDefine.h"
+#include "MemoryTracker.h"
+#include "SkThread.h"
+#include <map>
+#include <vector>
+#include <algorithm>
+#include <stdio.h>
+
+namespace
+{
+	const char* SUBSYSTEM_NAMES[ak::kMemorySubsystemCount] =
+	{
+		"surfaces",
+		"images",
+		"tiles",
+		"glyph cache",
+		"pictures",
+		"layers",
+		"thread stacks",
+		"views",
+		"strings",
+	};
+
+	struct MemoryCount
+	{
+		MemoryCount()
+			: _bytes(0)
+			, _highWater(0)
+		{
+
+		}
+
+		void add(size_t bytes)
+		{
+			_bytes += bytes;
+			_highWater = std::max(_highWater, _bytes);
+		}
+
+		void remove(size_t bytes)
+		{
+			_bytes -= std::min(_bytes, bytes);
+		}
+
+		size_t _bytes;
+		size_t _highWater;
+	};
+
+	typedef std::map<std::string, MemoryCount> MAP_OWNER;
+
+	struct Subsystem
+	{
+		MemoryCount _count;
+		MAP_OWNER _owners;
+	};
+
+	bool largerOwner(const MAP_OWNER::value_type* left, const MAP_OWNER::value_type* right)
+	{
+		return left->second._bytes > right->second._bytes;
+	}
+}
+
+class MemoryTrackerDelegate
+{
+public:
+	MemoryTrackerDelegate()
+	{
+
+	}
+
+	~MemoryTrackerDelegate()
+	{
+
+	}
+
+public:
+	SkMutex _mutex;
+	Subsystem _subsystems[ak::kMemorySubsystemCount];
+	MemoryCount _total;
+	std::vector<MemoryTracker::Sampler> _samplers;
+};
+
+MemoryTracker* MemoryTracker::getInstance()
+{
+	static MemoryTracker memoryTracker;
+	return &memoryTracker;
+}
+
+MemoryTracker::MemoryTracker()
+{
+	_memoryTrackerDelegate = new MemoryTrackerDelegate;
+}
+
+MemoryTracker::~MemoryTracker()
+{
+	if (nullptr != _memoryTrackerDelegate)
+	{
+		delete _memoryTrackerDelegate;
+		_memoryTrackerDelegate = nullptr;
+	}
+}
+
+void MemoryTracker::add(ak::MemorySubsystem subsystem, const char* owner, size_t bytes)
+{
+	INVALID_POINTER_RETURN(_memoryTrackerDelegate);
+
+	if (subsystem < 0 || subsystem >= ak::kMemorySubsystemCount || 0 == bytes)
+	{
+		return;
+	}
+
+	SkAutoMutexAcquire lock(_memoryTrackerDelegate->_mutex);
+	Subsystem& entry = _memoryTrackerDelegate->_subsystems[subsystem];
+	entry._count.add(bytes);
+	entry._owners[nullptr != owner ? owner : ""].add(bytes);
+	_memoryTrackerDelegate->_total.add(bytes);
+}
+
+void MemoryTracker::remove(ak::MemorySubsystem subsystem, const char* owner, size_t bytes)
+{
+	INVALID_POINTER_RETURN(_memoryTrackerDelegate);
+
+	if (subsystem < 0 || subsystem >= ak::kMemorySubsystemCount || 0 == bytes)
+	{
+		return;
+	}
+
+	SkAutoMutexAcquire lock(_memoryTrackerDelegate->_mutex);
+	Subsystem& entry = _memoryTrackerDelegate->_subsystems[subsystem];
+	MAP_OWNER::iterator iter = entry._owners.find(nullptr != owner ? owner : "");
+
+	if (iter == entry._owners.end())
+	{
+		return;
+	}
+
+	// never more than the owner was given, so a stray remove cannot wrap the counts.
+	size_t removed = std::min(bytes, iter->second._bytes);
+	iter->second.remove(removed);
+	entry._count.remove(removed);
+	_memoryTrackerDelegate->_total.remove(removed);
+
+	// owners keep their high water mark, only those that never mattered are dropped.
+	if (0 == iter->second._bytes && 0 == iter->second._highWater)
+	{
+		entry._owners.erase(iter);
+	}
+}
+
+void MemoryTracker::addSampler(Sampler sampler)
+{
+	INVALID_POINTER_RETURN(_memoryTrackerDelegate);
+	INVALID_POINTER_RETURN(sampler);
+
+	SkAutoMutexAcquire lock(_memoryTrackerDelegate->_mutex);
+	std::vector<Sampler>& samplers = _memoryTrackerDelegate->_samplers;
+
+	if (std::find(samplers.begin(), samplers.end(), sampler) == samplers.end())
+	{
+		samplers.push_back(sampler);
+	}
+}
+
+void MemoryTracker::clear(ak::MemorySubsystem subsystem)
+{
+	INVALID_POINTER_RETURN(_memoryTrackerDelegate);
+
+	if (subsystem < 0 || subsystem >= ak::kMemorySubsystemCount)
+	{
+		return;
+	}
+
+	SkAutoMutexAcquire lock(_memoryTrackerDelegate->_mutex);
+	Subsystem& entry = _memoryTrackerDelegate->_subsystems[subsystem];
+	_memoryTrackerDelegate->_total.remove(entry._count._bytes);
+	entry._count._bytes = 0;
+
+	MAP_OWNER::iterator iter = entry._owners.begin();
+
+	for (; iter != entry._owners.end(); ++iter)
+	{
+		iter->second._bytes = 0;
+	}
+}
+
+size_t MemoryTracker::getBytes(ak::MemorySubsystem subsystem)
+{
+	INVALID_POINTER_RETURN_PARAM(_memoryTrackerDelegate, 0);
+
+	if (subsystem < 0 || subsystem >= ak::kMemorySubsystemCount)
+	{
+		return 0;
+	}
+
+	sample();
+	SkAutoMutexAcquire lock(_memoryTrackerDelegate->_mutex);
+	return _memoryTrackerDelegate->_subsystems[subsystem]._count._bytes;
+}
+
+size_t MemoryTracker::getHighWater(ak::MemorySubsystem subsystem)
+{
+	INVALID_POINTER_RETURN_PARAM(_memoryTrackerDelegate, 0);
+
+	if (subsystem < 0 || subsystem >= ak::kMemorySubsystemCount)
+	{
+		return 0;
+	}
+
+	sample();
+	SkAutoMutexAcquire lock(_memoryTrackerDelegate->_mutex);
+	return _memoryTrackerDelegate->_subsystems[subsystem]._count._highWater;
+}
+
+size_t MemoryTracker::getTotalBytes()
+{
+	INVALID_POINTER_RETURN_PARAM(_memoryTrackerDelegate, 0);
+	sample();
+	SkAutoMutexAcquire lock(_memoryTrackerDelegate->_mutex);
+	return _memoryTrackerDelegate->_total._bytes;
+}
+
+size_t MemoryTracker::getTotalHighWater()
+{
+	INVALID_POINTER_RETURN_PARAM(_memoryTrackerDelegate, 0);
+	sample();
+	SkAutoMutexAcquire lock(_memoryTrackerDelegate->_mutex);
+	return _memoryTrackerDelegate->_total._highWater;
+}
+
+void MemoryTracker::resetHighWater()
+{
+	INVALID_POINTER_RETURN(_memoryTrackerDelegate);
+	SkAutoMutexAcquire lock(_memoryTrackerDelegate->_mutex);
+
+	for (int i = 0; i < ak::kMemorySubsystemCount; ++i)
+	{
+		Subsystem& entry = _memoryTrackerDelegate->_subsystems[i];
+		entry._count._highWater = entry._count._bytes;
+		MAP_OWNER::iterator iter = entry._owners.begin();
+
+		while (iter != entry._owners.end())
+		{
+			if (0 == iter->second._bytes)
+			{
+				iter = entry._owners.erase(iter);
+			}
+			else
+			{
+				iter->second._highWater = iter->second._bytes;
+				++iter;
+			}
+		}
+	}
+
+	_memoryTrackerDelegate->_total._highWater = _memoryTrackerDelegate->_total._bytes;
+}
+
+std::string MemoryTracker::dump(int ownersPerSubsystem)
+{
+	INVALID_POINTER_RETURN_PARAM(_memoryTrackerDelegate, std::string());
+	sample();
+
+	SkAutoMutexAcquire lock(_memoryTrackerDelegate->_mutex);
+	std::string report;
+	char line[512] = {0};
+
+	snprintf(line, sizeof(line), "%-32s %14s %14s\n", "subsystem", "bytes", "high water");
+	report += line;
+
+	for (int i = 0; i < ak::kMemorySubsystemCount; ++i)
+	{
+		const Subsystem& entry = _memoryTrackerDelegate->_subsystems[i];
+		snprintf(line, sizeof(line), "%-32s %14lu %14lu\n", SUBSYSTEM_NAMES[i],
+			(unsigned long)entry._count._bytes, (unsigned long)entry._count._highWater);
+		report += line;
+
+		// the largest owners, an owner is only worth a line if it has a name.
+		std::vector<const MAP_OWNER::value_type*> owners;
+		MAP_OWNER::const_iterator iter = entry._owners.begin();
+
+		for (; iter != entry._owners.end(); ++iter)
+		{
+			if (!iter->first.empty())
+			{
+				owners.push_back(&*iter);
+			}
+		}
+
+		std::sort(owners.begin(), owners.end(), largerOwner);
+
+		for (int j = 0; j < (int)owners.size() && j < ownersPerSubsystem; ++j)
+		{
+			snprintf(line, sizeof(line), "  %-30.30s %14lu %14lu\n", owners[j]->first.c_str(),
+				(unsigned long)owners[j]->second._bytes, (unsigned long)owners[j]->second._highWater);
+			report += line;
+		}
+
+		if ((int)owners.size() > ownersPerSubsystem)
+		{
+			snprintf(line, sizeof(line), "  (%d more)\n", (int)owners.size() - ownersPerSubsystem);
+			report += line;
+		}
+	}
+
+	snprintf(line, sizeof(line), "%-32s %14lu %14lu\n", "total",
+		(unsigned long)_memoryTrackerDelegate->_total._bytes, (unsigned long)_memoryTrackerDelegate->_total._highWater);
+	report += line;
+	return report;
+}
+
+bool MemoryTracker::dumpToFile(const KString& path, int ownersPerSubsystem)
+{
+	std::string report = dump(ownersPerSubsystem);
+
+#ifdef _WIN32
+	FILE* file = _wfopen(path.c_str(), L"wb");
+#else
+	FILE* file = fopen(path.getUtf8(), "wb");
+#endif
+
+	INVALID_POINTER_RETURN_FALSE(file);
+	bool written = fwrite(report.c_str(), 1, report.size(), file) == report.size();
+	fclose(file);
+	return written;
+}
+
+const char* MemoryTracker::getSubsystemName(ak::MemorySubsystem subsystem)
+{
+	if (subsystem < 0 || subsystem >= ak::kMemorySubsystemCount)
+	{
+		return "";
+	}
+
+	return SUBSYSTEM_NAMES[subsystem];
+}
+
+void MemoryTracker::sample()
+{
+	INVALID_POINTER_RETURN(_memoryTrackerDelegate);
+	std::vector<Sampler> samplers;
+
+	{
+		SkAutoMutexAcquire lock(_memoryTrackerDelegate->_mutex);
+		samplers = _memoryTrackerDelegate->_samplers;
+	}
+
+	// samplers call back into add, so they run unlocked.
+	for (size_t i = 0; i < samplers.size(); ++i)
+	{
+		samplers[i](this);
+	}
+}
\ No newline at end of file
@@ -1,10 +1,55 @@
 #include "UIDefine.h"
 #include "RootView.h"
 #include "widget.h"
+#include "Canvas.h"
+#include "KPen.h"
+#include "KSolidBrush.h"
+#include "Color.h"
+#include "TileImageView.h"
+#include "eventHandler.h"
+#include <string.h>
 
-RootView::RootView()
+// paint flashing cycles through these so consecutive repaints of a rect stand out.
+const int PAINT_FLASH_COLOR_COUNT = 4;
+const unsigned int PAINT_FLASH_COLORS[PAINT_FLASH_COLOR_COUNT] =
+{
+	0x60FF00FF,
+	0x6000FFFF,
+	0x60FFFF00,
+	0x6000FF00,
+};
+
+namespace
 {
+	View* findView(View* view, const void* key)
+	{
+		if (view == key)
+		{
+			return view;
+		}
+
+		int count = view->getChildCount();
+
+		for (int i = 0; i < count; ++i)
+		{
+			View* found = findView(view->getChildAt(i), key);
 
+			if (nullptr != found)
+			{
+				return found;
+			}
+		}
+
+		return nullptr;
+	}
+}
+
+RootView::RootView()
+	: _widget(nullptr)
+	, _debugOverlay(ak::kOverlayNone)
+	, _totalWrites(0)
+{
+	memset(&_debugStats, 0, sizeof(_debugStats));
 }
 
 RootView::~RootView()
@@ -22,7 +67,178 @@ void RootView::init(Widget* widget, int width, int height)
 
 void RootView::OnDraw()
 {
+	Canvas* canvas = getCanvas();
+	bool damageClip = false;
+
+	KRect frameRect;
+	getRect(frameRect);
+
+	if (0 != (_debugOverlay & ak::kOverlayOverdraw))
+	{
+		_damageRect.set(0, 0, 0, 0);
+	}
+	else if (!_damageRect.isEmpty())
+	{
+		// erases the overlays of the last frame.
+		_damageRect.join(_overlayRect);
+	}
+
+	_overlayRect.set(0, 0, 0, 0);
+
+	// views invalidated while drawing, such as images still loading, go to the next frame.
+	KRect damageRect = _damageRect;
+	_damageRect.set(0, 0, 0, 0);
+
+	if (nullptr != canvas)
+	{
+		if (0 != (_debugOverlay & ak::kOverlayOverdraw) && canvas->setOverdrawCounting(true))
+		{
+			canvas->resetOverdraw();
+		}
+		else
+		{
+			canvas->setOverdrawCounting(false);
+		}
+	}
+
+	if (nullptr != canvas && !damageRect.isEmpty())
+	{
+		damageClip = canvas->setDamageClip(damageRect);
+	}
+
+	_drawnRect.set(damageClip ? damageRect : frameRect);
+
     draw();
+
+	if (nullptr != canvas)
+	{
+		if (ak::kOverlayNone != _debugOverlay)
+		{
+			drawDebugOverlay(canvas, damageClip ? damageRect : frameRect);
+		}
+
+		if (damageClip)
+		{
+			canvas->resetDamageClip();
+		}
+
+		canvas->advanceFrame();
+	}
+
+	_invalidRects.clear();
+}
+
+void RootView::addDamage(const KRect& rect)
+{
+	_damageRect.join(rect);
+
+	if (0 != (_debugOverlay & ak::kOverlayDamage) && !rect.isEmpty())
+	{
+		_invalidRects.push_back(rect);
+	}
+}
+
+bool RootView::hasDamage() const
+{
+	return !_damageRect.isEmpty();
+}
+
+const KRect& RootView::getDrawnRect() const
+{
+	return _drawnRect;
+}
+
+bool RootView::updateTiledImages()
+{
+	Canvas* canvas = getCanvas();
+	INVALID_POINTER_RETURN_FALSE(canvas);
+
+	const void* key = canvas->takeLoadedTiledImage();
+
+	for (; nullptr != key; key = canvas->takeLoadedTiledImage())
+	{
+		// the keys are the views that drew the images, only the ones still shown here paint.
+		TileImageView* view = dynamic_cast<TileImageView*>(findView(this, key));
+
+		if (nullptr != view)
+		{
+			view->onTilesLoaded();
+		}
+	}
+
+	return canvas->isLoadingTiledImages();
+}
+
+void RootView::setDebugOverlay(int overlays)
+{
+	_debugOverlay = overlays;
+	memset(&_debugStats, 0, sizeof(_debugStats));
+	_totalWrites = 0;
+	_invalidRects.clear();
+
+	// the overlays of the old mode go with a full repaint.
+	schedulePaint();
+}
+
+int RootView::getDebugOverlay() const
+{
+	return _debugOverlay;
+}
+
+void RootView::getDebugStats(ak::DebugStats& stats) const
+{
+	stats = _debugStats;
+}
+
+void RootView::drawDebugOverlay(Canvas* canvas, const KRect& frameRect)
+{
+	int pixels = frameRect.width() * frameRect.height();
+	_debugStats._frames += 1;
+	_debugStats._damagePixels = pixels;
+	_debugStats._totalDamagePixels += pixels;
+
+	int writes = 0;
+	int maxWrites = 0;
+
+	if (0 != (_debugOverlay & ak::kOverlayOverdraw)
+		&& canvas->getOverdraw(frameRect, &pixels, &writes, &maxWrites))
+	{
+		_totalWrites += writes;
+		_debugStats._overdraw = pixels > 0 ? (float)writes / pixels : 0.0f;
+		_debugStats._averageOverdraw = _debugStats._totalDamagePixels > 0
+			? (float)(_totalWrites / _debugStats._totalDamagePixels) : 0.0f;
+		_debugStats._maxOverdraw = maxWrites;
+		canvas->drawOverdrawHeatmap(frameRect);
+	}
+
+	if (0 != (_debugOverlay & ak::kOverlayPaintFlash))
+	{
+		Color color;
+		color.setValue(PAINT_FLASH_COLORS[_debugStats._frames % PAINT_FLASH_COLOR_COUNT]);
+		KSolidBrush brush(color);
+		KRect rect(frameRect);
+		canvas->fillRect(&brush, rect);
+		_overlayRect.join(frameRect);
+	}
+
+	if (0 != (_debugOverlay & ak::kOverlayDamage))
+	{
+		// each invalidation in green, the rect they were coalesced into in red.
+		KPen invalidPen(Color(0xFF, 0x00, 0xC0, 0x00));
+		std::vector<KRect>::iterator iter = _invalidRects.begin();
+
+		for (; iter != _invalidRects.end(); ++iter)
+		{
+			KRect rect((*iter)._left, (*iter)._top, (*iter).width() - 1, (*iter).height() - 1);
+			canvas->drawRect(&invalidPen, rect);
+			_overlayRect.join(*iter);
+		}
+
+		KPen damagePen(Color(0xFF, 0xFF, 0x00, 0x00), 2);
+		KRect rect(frameRect._left + 1, frameRect._top + 1, frameRect.width() - 2, frameRect.height() - 2);
+		canvas->drawRect(&damagePen, rect);
+		_overlayRect.join(frameRect);
+	}
 }
 
 void RootView::schedulePaint(KRect* rect)
@@ -33,10 +249,28 @@ void RootView::schedulePaint(KRect* rect)
 	{
 		KRect rcRootView;
 		getRect(rcRootView);
+		addDamage(rcRootView);
 		_widget->schedualPaint(rcRootView);
 	}
 	else
 	{
+		addDamage(*rect);
 		_widget->schedualPaint(*rect);
 	}
 }
+
+void RootView::onViewDestroyed(View* view)
+{
+	EventHandler* eventHandler = nullptr != _widget ? _widget->getEventHandler() : nullptr;
+
+	if (nullptr != eventHandler)
+	{
+		eventHandler->removeView(view);
+	}
+
+	Canvas* canvas = getCanvas();
+	INVALID_POINTER_RETURN(canvas);
+	canvas->removeCacheLayer(view);
+	canvas->removeCachePicture(view);
+	canvas->removeTiledImage(view);
+}
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "View.h"
+#include <vector>
 
 class Widget;
 
@@ -15,11 +16,46 @@ public:
 public:
     void OnDraw();
 
+	// marks rect to be drawn by the next OnDraw without asking the widget for a paint.
+	void addDamage(const KRect& rect);
+	bool hasDamage() const;
+
+	// a combination of ak::DebugOverlay, setting it resets the stats.
+	// overlays are drawn into the frame and erased by the next one, the overdraw
+	// heatmap makes every frame draw the whole view so the counts cover it.
+	void setDebugOverlay(int overlays);
+	int getDebugOverlay() const;
+	void getDebugStats(ak::DebugStats& stats) const;
+
+	// the area the last OnDraw repainted, overlays included.
+	const KRect& getDrawnRect() const;
+
+	// paints again the tiled image views whose sharper tiles finished loading. the widget
+	// calls it while tiles load, it returns false once none are left loading.
+	bool updateTiledImages();
+
 protected:
     // view
     virtual bool isUsedCanvas() override {return true;}
 	virtual void schedulePaint(KRect* rect = nullptr) override;
+	virtual void onViewDestroyed(View* view) override;
 
 private:
+	void drawDebugOverlay(Canvas* canvas, const KRect& frameRect);
+
     Widget* _widget;
+
+	// union of the rects invalidated since the last frame, empty draws everything.
+	KRect _damageRect;
+
+	int _debugOverlay;
+	ak::DebugStats _debugStats;
+	double _totalWrites;
+
+	// the rects invalidated since the last frame, kept for kOverlayDamage.
+	std::vector<KRect> _invalidRects;
+
+	// area covered by the overlays of the last frame, the next frame redraws it.
+	KRect _overlayRect;
+	KRect _drawnRect;
 };
@@ -1,8 +1,66 @@
+#include "UIDefine.h"
 #include "StringHelper.h"
+#include "MemoryTracker.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
 #include <windows.h>
+#endif
 
 const int DEFAULT_BUFFER_LEN = 1024;
 
+#ifndef _WIN32
+namespace
+{
+	// wchar_t is utf-32 outside windows. writes the utf-8 of string to buffer when it is not
+	// null and returns the length including the terminating zero.
+	int encodeUtf8(const wchar_t* string, char* buffer)
+	{
+		int len = 0;
+
+		for (; 0 != *string; ++string)
+		{
+			unsigned int c = (unsigned int)*string;
+			char bytes[4];
+			int count = 0;
+
+			if (c < 0x80)
+			{
+				bytes[count++] = (char)c;
+			}
+			else if (c < 0x800)
+			{
+				bytes[count++] = (char)(0xC0 | (c >> 6));
+				bytes[count++] = (char)(0x80 | (c & 0x3F));
+			}
+			else if (c < 0x10000)
+			{
+				bytes[count++] = (char)(0xE0 | (c >> 12));
+				bytes[count++] = (char)(0x80 | ((c >> 6) & 0x3F));
+				bytes[count++] = (char)(0x80 | (c & 0x3F));
+			}
+			else
+			{
+				bytes[count++] = (char)(0xF0 | ((c >> 18) & 0x07));
+				bytes[count++] = (char)(0x80 | ((c >> 12) & 0x3F));
+				bytes[count++] = (char)(0x80 | ((c >> 6) & 0x3F));
+				bytes[count++] = (char)(0x80 | (c & 0x3F));
+			}
+
+			if (nullptr != buffer)
+			{
+				memcpy(buffer + len, bytes, count);
+			}
+
+			len += count;
+		}
+
+		return len + 1;
+	}
+}
+#endif
+
 StringHelper::StringHelper()
 	: _charLen(0)
 	, _charBuf(nullptr)
@@ -13,34 +71,48 @@ StringHelper::StringHelper()
 	_charBuf = (char*)malloc(DEFAULT_BUFFER_LEN * sizeof(char));
 	_wcharLen = DEFAULT_BUFFER_LEN;
 	_wcharBuf = (wchar_t*)malloc(DEFAULT_BUFFER_LEN * sizeof(wchar_t));
+	MemoryTracker::getInstance()->add(ak::kMemoryStrings, nullptr, _charLen * sizeof(char) + _wcharLen * sizeof(wchar_t));
 }
 
 StringHelper::~StringHelper()
 {
+	MemoryTracker::getInstance()->remove(ak::kMemoryStrings, nullptr, _charLen * sizeof(char) + _wcharLen * sizeof(wchar_t));
 	free(_charBuf);
 	free(_wcharBuf);
 }
 
 char* StringHelper::utf16ToUtf8(const wchar_t* utf16String)
 {
+#ifdef _WIN32
 	int len = WideCharToMultiByte(CP_UTF8, 0, utf16String, -1, nullptr, 0, nullptr, nullptr);
 	resizeCharBuf(len + 1);
 	WideCharToMultiByte(CP_UTF8, 0, utf16String, -1, _charBuf, len, nullptr, nullptr);
+#else
+	int len = encodeUtf8(utf16String, nullptr);
+	resizeCharBuf(len + 1);
+	encodeUtf8(utf16String, _charBuf);
+#endif
 	return _charBuf;
 }
 
 char* StringHelper::utf16ToAnsi(const wchar_t* utf16String)
 {
+#ifdef _WIN32
 	int len = WideCharToMultiByte(CP_ACP, 0, utf16String, -1, nullptr, 0, nullptr, nullptr);
 	resizeCharBuf(len + 1);
 	WideCharToMultiByte(CP_ACP, 0, utf16String, -1, _charBuf, len, nullptr, nullptr);
 	return _charBuf;
+#else
+	// the locale of the other platforms is utf-8.
+	return utf16ToUtf8(utf16String);
+#endif
 }
 
 void StringHelper::resizeCharBuf(int len)
 {
 	if (len > _charLen)
 	{
+		MemoryTracker::getInstance()->add(ak::kMemoryStrings, nullptr, (len - _charLen) * sizeof(char));
 		_charLen = len;
 		_charBuf = (char*)realloc(_charBuf, len * sizeof(char));
 	}
@@ -52,6 +124,7 @@ void StringHelper::resizeWCharBuf(int len)
 {
 	if (len > _wcharLen)
 	{
+		MemoryTracker::getInstance()->add(ak::kMemoryStrings, nullptr, (len - _wcharLen) * sizeof(wchar_t));
 		_wcharLen = len;
 		_wcharBuf = (wchar_t*)realloc(_wcharBuf, len * sizeof(wchar_t));
 	}
@@ -0,0 +1,95 @@
+#include "UIDefine.h"
+#include "TileImageSource.h"
+#include <stdio.h>
+
+TileImageSource::TileImageSource()
+	: _width(0)
+	, _height(0)
+	, _tileSize(0)
+	, _levelCount(0)
+{
+
+}
+
+TileImageSource::TileImageSource(const char* directory, const char* extension, int width, int height, int tileSize)
+	: _directory(nullptr != directory ? directory : "")
+	, _extension(nullptr != extension ? extension : "")
+	, _width(width)
+	, _height(height)
+	, _tileSize(tileSize)
+	, _levelCount(0)
+{
+	if (!isValid())
+	{
+		return;
+	}
+
+	_levelCount = 1;
+
+	while (getLevelWidth(_levelCount - 1) > _tileSize || getLevelHeight(_levelCount - 1) > _tileSize)
+	{
+		++_levelCount;
+	}
+}
+
+TileImageSource::~TileImageSource()
+{
+
+}
+
+bool TileImageSource::isValid() const
+{
+	return !_directory.empty() && _width > 0 && _height > 0 && _tileSize > 0;
+}
+
+int TileImageSource::width() const
+{
+	return _width;
+}
+
+int TileImageSource::height() const
+{
+	return _height;
+}
+
+int TileImageSource::getTileSize() const
+{
+	return _tileSize;
+}
+
+int TileImageSource::getLevelCount() const
+{
+	return _levelCount;
+}
+
+int TileImageSource::getLevelWidth(int level) const
+{
+	return (int)(((long long)_width + (1LL << level) - 1) >> level);
+}
+
+int TileImageSource::getLevelHeight(int level) const
+{
+	return (int)(((long long)_height + (1LL << level) - 1) >> level);
+}
+
+int TileImageSource::getColumnCount(int level) const
+{
+	return (getLevelWidth(level) + _tileSize - 1) / _tileSize;
+}
+
+int TileImageSource::getRowCount(int level) const
+{
+	return (getLevelHeight(level) + _tileSize - 1) / _tileSize;
+}
+
+std::string TileImageSource::getTilePath(int level, int column, int row) const
+{
+	char name[64] = { 0 };
+	snprintf(name, sizeof(name), "/%d/%d_%d.", level, column, row);
+	return _directory + name + _extension;
+}
+
+const std::string& TileImageSource::getDirectory() const
+{
+	return _directory;
+}
\ No newline at end of file
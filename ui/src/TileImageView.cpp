@@ -0,0 +1,119 @@
+#include "UIDefine.h"
+#include "TileImageView.h"
+#include "TileImageSource.h"
+#include "Canvas.h"
+
+class TileImageViewDelegate
+{
+public:
+	TileImageViewDelegate()
+		: _zoom(1)
+		, _originX(0)
+		, _originY(0)
+	{
+
+	}
+
+	~TileImageViewDelegate()
+	{
+
+	}
+
+public:
+	TileImageSource _source;
+	float _zoom;
+	float _originX;
+	float _originY;
+};
+
+TileImageView::TileImageView()
+{
+	_tileImageViewDelegate = new TileImageViewDelegate;
+}
+
+TileImageView::~TileImageView()
+{
+	// the root view drops the tiles, see RootView::onViewDestroyed.
+	if (nullptr != _tileImageViewDelegate)
+	{
+		delete _tileImageViewDelegate;
+		_tileImageViewDelegate = nullptr;
+	}
+}
+
+void TileImageView::setSource(const TileImageSource& source)
+{
+	INVALID_POINTER_RETURN(_tileImageViewDelegate);
+	_tileImageViewDelegate->_source = source;
+	schedulePaint();
+}
+
+void TileImageView::setZoom(float zoom)
+{
+	INVALID_POINTER_RETURN(_tileImageViewDelegate);
+
+	if (zoom <= 0)
+	{
+		return;
+	}
+
+	_tileImageViewDelegate->_zoom = zoom;
+	schedulePaint();
+}
+
+float TileImageView::getZoom()
+{
+	INVALID_POINTER_RETURN_PARAM(_tileImageViewDelegate, 1);
+	return _tileImageViewDelegate->_zoom;
+}
+
+void TileImageView::setOrigin(float x, float y)
+{
+	INVALID_POINTER_RETURN(_tileImageViewDelegate);
+	_tileImageViewDelegate->_originX = x;
+	_tileImageViewDelegate->_originY = y;
+	schedulePaint();
+}
+
+void TileImageView::zoomAt(float zoom, int x, int y)
+{
+	INVALID_POINTER_RETURN(_tileImageViewDelegate);
+
+	KRect rect;
+
+	if (zoom <= 0 || !getRect(rect))
+	{
+		return;
+	}
+
+	float oldZoom = _tileImageViewDelegate->_zoom;
+	float imageX = _tileImageViewDelegate->_originX + (x - rect._left) / oldZoom;
+	float imageY = _tileImageViewDelegate->_originY + (y - rect._top) / oldZoom;
+	_tileImageViewDelegate->_zoom = zoom;
+	_tileImageViewDelegate->_originX = imageX - (x - rect._left) / zoom;
+	_tileImageViewDelegate->_originY = imageY - (y - rect._top) / zoom;
+	schedulePaint();
+}
+
+void TileImageView::onTilesLoaded()
+{
+	schedulePaint();
+}
+
+bool TileImageView::draw(Canvas& canvas)
+{
+	INVALID_POINTER_RETURN_FALSE(_tileImageViewDelegate);
+
+	KRect rect;
+	VALUE_FALSE_RETURN_FALSE(getRect(rect));
+
+	if (_tileImageViewDelegate->_source.isValid())
+	{
+		// coarser tiles stand in for the ones still decoding, the root view paints again
+		// once they land.
+		canvas.drawTiledImage(this, _tileImageViewDelegate->_source, rect, _tileImageViewDelegate->_zoom,
+			_tileImageViewDelegate->_originX, _tileImageViewDelegate->_originY, nullptr);
+	}
+
+	return View::draw(canvas);
+}
\ No newline at end of file
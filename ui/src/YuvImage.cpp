@@ -0,0 +1,158 @@
+#include "UIDefine.h"
+#include "YuvImage.h"
+#include "MemoryTracker.h"
+#include <vector>
+
+class YuvImageDelegate
+{
+public:
+	YuvImageDelegate(int width, int height, ak::YuvFormat format, ak::YuvColorSpace colorSpace)
+		: _width(width)
+		, _height(height)
+		, _format(format)
+		, _colorSpace(colorSpace)
+		, _yRowBytes(0)
+		, _uvRowBytes(0)
+	{
+		_planes[0] = _planes[1] = _planes[2] = nullptr;
+	}
+
+	~YuvImageDelegate()
+	{
+		MemoryTracker::getInstance()->remove(ak::kMemoryImages, "yuv image", _pixels.size());
+	}
+
+	int chromaWidth() const { return (_width + 1) / 2; }
+	int chromaHeight() const { return (_height + 1) / 2; }
+
+	// lays the three planes out one after the other, the chroma rows of nv12 are twice as wide.
+	// the pixels are allocated once and kept while the caller's planes are drawn.
+	void usePixels()
+	{
+		int chromaRowBytes = ak::kYuvNV12 == _format ? chromaWidth() * 2 : chromaWidth();
+		size_t ySize = (size_t)_width * _height;
+		size_t chromaSize = (size_t)chromaRowBytes * chromaHeight();
+
+		if (_pixels.empty())
+		{
+			_pixels.resize(ySize + chromaSize * (ak::kYuvNV12 == _format ? 1 : 2));
+			MemoryTracker::getInstance()->add(ak::kMemoryImages, "yuv image", _pixels.size());
+		}
+
+		unsigned char* pixels = &_pixels[0];
+		_planes[0] = pixels;
+		_planes[1] = pixels + ySize;
+		_planes[2] = ak::kYuvNV12 == _format ? nullptr : pixels + ySize + chromaSize;
+		_yRowBytes = _width;
+		_uvRowBytes = chromaRowBytes;
+	}
+
+public:
+	int _width;
+	int _height;
+	ak::YuvFormat _format;
+	ak::YuvColorSpace _colorSpace;
+
+	// point into _pixels, or into the planes of the caller after setPlanes.
+	const unsigned char* _planes[3];
+	int _yRowBytes;
+	int _uvRowBytes;
+	std::vector<unsigned char> _pixels;
+};
+
+YuvImage::YuvImage(int width, int height, ak::YuvFormat format, ak::YuvColorSpace colorSpace)
+{
+	_yuvImageDelegate = new YuvImageDelegate(width, height, format, colorSpace);
+}
+
+YuvImage::~YuvImage()
+{
+	if (nullptr != _yuvImageDelegate)
+	{
+		delete _yuvImageDelegate;
+		_yuvImageDelegate = nullptr;
+	}
+}
+
+ak::YuvFormat YuvImage::getFormat() const
+{
+	INVALID_POINTER_RETURN_PARAM(_yuvImageDelegate, ak::kYuvI420);
+	return _yuvImageDelegate->_format;
+}
+
+ak::YuvColorSpace YuvImage::getColorSpace() const
+{
+	INVALID_POINTER_RETURN_PARAM(_yuvImageDelegate, ak::kYuvRec601);
+	return _yuvImageDelegate->_colorSpace;
+}
+
+void YuvImage::setColorSpace(ak::YuvColorSpace colorSpace)
+{
+	INVALID_POINTER_RETURN(_yuvImageDelegate);
+	_yuvImageDelegate->_colorSpace = colorSpace;
+}
+
+unsigned char* YuvImage::getWritablePlane(int plane, int* rowBytes)
+{
+	INVALID_POINTER_RETURN_NULL(_yuvImageDelegate);
+
+	if (_yuvImageDelegate->_width <= 0 || _yuvImageDelegate->_height <= 0)
+	{
+		return nullptr;
+	}
+
+	_yuvImageDelegate->usePixels();
+	return (unsigned char*)getPlane(plane, rowBytes);
+}
+
+const unsigned char* YuvImage::getPlane(int plane, int* rowBytes) const
+{
+	INVALID_POINTER_RETURN_NULL(_yuvImageDelegate);
+
+	if (plane < 0 || plane > 2)
+	{
+		return nullptr;
+	}
+
+	if (nullptr != rowBytes)
+	{
+		*rowBytes = 0 == plane ? _yuvImageDelegate->_yRowBytes : _yuvImageDelegate->_uvRowBytes;
+	}
+
+	return _yuvImageDelegate->_planes[plane];
+}
+
+bool YuvImage::setPlanes(const unsigned char* y, int yRowBytes, const unsigned char* u, const unsigned char* v,
+	int uvRowBytes)
+{
+	INVALID_POINTER_RETURN_FALSE(_yuvImageDelegate);
+	INVALID_POINTER_RETURN_FALSE(y);
+	INVALID_POINTER_RETURN_FALSE(u);
+
+	bool nv12 = ak::kYuvNV12 == _yuvImageDelegate->_format;
+	bool hasV = nv12 || nullptr != v;
+	VALUE_FALSE_RETURN_FALSE(hasV);
+
+	int chromaRowBytes = nv12 ? _yuvImageDelegate->chromaWidth() * 2 : _yuvImageDelegate->chromaWidth();
+	bool rowsFit = yRowBytes >= _yuvImageDelegate->_width && uvRowBytes >= chromaRowBytes;
+	VALUE_FALSE_RETURN_FALSE(rowsFit);
+
+	_yuvImageDelegate->_planes[0] = y;
+	_yuvImageDelegate->_planes[1] = u;
+	_yuvImageDelegate->_planes[2] = nv12 ? nullptr : v;
+	_yuvImageDelegate->_yRowBytes = yRowBytes;
+	_yuvImageDelegate->_uvRowBytes = uvRowBytes;
+	return true;
+}
+
+int YuvImage::width()
+{
+	INVALID_POINTER_RETURN_PARAM(_yuvImageDelegate, 0);
+	return _yuvImageDelegate->_width;
+}
+
+int YuvImage::height()
+{
+	INVALID_POINTER_RETURN_PARAM(_yuvImageDelegate, 0);
+	return _yuvImageDelegate->_height;
+}
\ No newline at end of file
@@ -1,11 +1,224 @@
 #include "eventHandler.h"
+#include "View.h"
+#include <deque>
+#include <vector>
 
-EventHandler::EventHandler()
+// positions kept per merged mouse move, the oldest go first. a 1000 Hz mouse makes about
+// 16 of them per frame.
+const size_t MAX_HISTORY_POINTS = 64;
+
+namespace
+{
+	struct QueuedEvent
+	{
+		InputEvent _event;
+		std::vector<KPoint> _history;
+	};
+}
+
+class EventHandlerDelegate
 {
+public:
+	EventHandlerDelegate()
+		: _captureView(nullptr)
+		, _focusView(nullptr)
+		, _coalescedCount(0)
+	{
+	}
+
+public:
+	std::deque<QueuedEvent> _queue;
+	View* _captureView;
+	View* _focusView;
+	int _coalescedCount;
+};
 
+EventHandler::EventHandler()
+{
+	_delegate = new EventHandlerDelegate;
 }
 
 EventHandler::~EventHandler()
 {
+	if (nullptr != _delegate)
+	{
+		delete _delegate;
+		_delegate = nullptr;
+	}
+}
+
+void EventHandler::postEvent(const InputEvent& event)
+{
+	INVALID_POINTER_RETURN(_delegate);
+
+	if (!_delegate->_queue.empty())
+	{
+		QueuedEvent& last = _delegate->_queue.back();
+		bool sameState = last._event._type == event._type && last._event._flags == event._flags;
+
+		if (sameState && ak::kEventMouseMove == event._type)
+		{
+			if (last._history.size() >= MAX_HISTORY_POINTS)
+			{
+				last._history.erase(last._history.begin());
+			}
+
+			last._history.push_back(KPoint(last._event._x, last._event._y));
+			last._event._x = event._x;
+			last._event._y = event._y;
+			last._event._time = event._time;
+			++_delegate->_coalescedCount;
+			return;
+		}
+
+		if (sameState && ak::kEventMouseWheel == event._type)
+		{
+			last._event._wheelDelta += event._wheelDelta;
+			last._event._x = event._x;
+			last._event._y = event._y;
+			last._event._time = event._time;
+			++_delegate->_coalescedCount;
+			return;
+		}
+	}
+
+	QueuedEvent queued;
+	queued._event = event;
+	_delegate->_queue.push_back(queued);
+}
+
+bool EventHandler::hasPendingEvents() const
+{
+	INVALID_POINTER_RETURN_FALSE(_delegate);
+	return !_delegate->_queue.empty();
+}
+
+int EventHandler::dispatchEvents(View* root)
+{
+	INVALID_POINTER_RETURN_PARAM(_delegate, 0);
+	INVALID_POINTER_RETURN_PARAM(root, 0);
+
+	int delivered = 0;
+
+	// views may post events while handling one, those wait for the next frame.
+	std::deque<QueuedEvent> queue;
+	queue.swap(_delegate->_queue);
+
+	for (; !queue.empty(); queue.pop_front())
+	{
+		QueuedEvent& queued = queue.front();
+		InputEvent& event = queued._event;
+		event._history = queued._history.empty() ? nullptr : &queued._history[0];
+		event._historyCount = (int)queued._history.size();
+
+		bool keyEvent = ak::kEventKeyDown == event._type || ak::kEventKeyUp == event._type;
+
+		if (keyEvent)
+		{
+			event._target = nullptr != _delegate->_focusView ? _delegate->_focusView : root;
+		}
+		else if (nullptr != _delegate->_captureView)
+		{
+			event._target = _delegate->_captureView;
+		}
+		else
+		{
+			event._target = root->hitTest(event._x, event._y);
+		}
+
+		if (ak::kEventMouseDown == event._type && nullptr != event._target)
+		{
+			_delegate->_captureView = event._target;
+			_delegate->_focusView = event._target;
+		}
+
+		if (nullptr != event._target)
+		{
+			deliverEvent(event);
+			++delivered;
+		}
+
+		if (ak::kEventMouseUp == event._type && 0 == (event._flags & ak::kEventButtons))
+		{
+			_delegate->_captureView = nullptr;
+		}
+	}
+
+	return delivered;
+}
+
+void EventHandler::setCaptureView(View* view)
+{
+	INVALID_POINTER_RETURN(_delegate);
+	_delegate->_captureView = view;
+}
+
+View* EventHandler::getCaptureView() const
+{
+	INVALID_POINTER_RETURN_NULL(_delegate);
+	return _delegate->_captureView;
+}
+
+void EventHandler::setFocusView(View* view)
+{
+	INVALID_POINTER_RETURN(_delegate);
+	_delegate->_focusView = view;
+}
+
+View* EventHandler::getFocusView() const
+{
+	INVALID_POINTER_RETURN_NULL(_delegate);
+	return _delegate->_focusView;
+}
+
+void EventHandler::removeView(View* view)
+{
+	INVALID_POINTER_RETURN(_delegate);
+
+	if (view == _delegate->_captureView)
+	{
+		_delegate->_captureView = nullptr;
+	}
+
+	if (view == _delegate->_focusView)
+	{
+		_delegate->_focusView = nullptr;
+	}
+}
+
+int EventHandler::getCoalescedCount() const
+{
+	INVALID_POINTER_RETURN_PARAM(_delegate, 0);
+	return _delegate->_coalescedCount;
+}
+
+bool EventHandler::deliverEvent(InputEvent& event)
+{
+	INVALID_POINTER_RETURN_FALSE(event._target);
+
+	// the target first, the root last.
+	std::vector<View*> path;
+
+	for (View* view = event._target; nullptr != view; view = view->getParent())
+	{
+		path.push_back(view);
+	}
+
+	for (size_t i = path.size() - 1; i > 0; --i)
+	{
+		if (path[i]->onInterceptEvent(event))
+		{
+			return true;
+		}
+	}
+
+	for (size_t i = 0; i < path.size(); ++i)
+	{
+		if (path[i]->onEvent(event))
+		{
+			return true;
+		}
+	}
 
+	return false;
 }
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include "KFont.h"
 #include "KFontFamily.h"
 #include "KPoint.h"
+#include "KPath.h"
 #include "GdiHelper.h"
 #include "GdiImage.h"
 #include <Windows.h>
@@ -185,6 +186,45 @@ bool GdiGraphics::fillRect(KBrush* brush, KRect& rect)
 	return true;
 }
 
+bool GdiGraphics::drawPath(KPen* pen, const KPath& path)
+{
+	INVALID_POINTER_RETURN_FALSE(_gdiGraphicsDelegate);
+	INVALID_POINTER_RETURN_FALSE(pen);
+
+	HDC hMemDc = _gdiGraphicsDelegate->_hMemDc;
+	VALUE_FALSE_RETURN_FALSE(GdiHelper::pathToGdiPath(hMemDc, path));
+
+	Color color = pen->getColor();
+	COLORREF gdiColor = RGB(color.getR(), color.getG(), color.getB());
+	HPEN gdiPen = ::CreatePen(PS_SOLID, pen->getWidth(), gdiColor);
+	HPEN oldPen = (HPEN)::SelectObject(hMemDc, gdiPen);
+	::StrokePath(hMemDc);
+	::SelectObject(hMemDc, oldPen);
+	::DeleteObject(gdiPen);
+	return true;
+}
+
+bool GdiGraphics::fillPath(KBrush* brush, const KPath& path)
+{
+	INVALID_POINTER_RETURN_FALSE(_gdiGraphicsDelegate);
+	INVALID_POINTER_RETURN_FALSE(brush);
+
+	KSolidBrush* solidBrush = dynamic_cast<KSolidBrush*>(brush);
+	INVALID_POINTER_RETURN_FALSE(solidBrush);
+
+	HDC hMemDc = _gdiGraphicsDelegate->_hMemDc;
+	VALUE_FALSE_RETURN_FALSE(GdiHelper::pathToGdiPath(hMemDc, path));
+
+	Color color = solidBrush->getColor();
+	COLORREF gdiColor = RGB(color.getR(), color.getG(), color.getB());
+	HBRUSH gdiBrush = ::CreateSolidBrush(gdiColor);
+	HBRUSH gdiOldBrush = (HBRUSH)::SelectObject(hMemDc, gdiBrush);
+	::FillPath(hMemDc);
+	::SelectObject(hMemDc, gdiOldBrush);
+	::DeleteObject(gdiBrush);
+	return true;
+}
+
 bool GdiGraphics::drawString(const KString& str, int len, const KFont& font, const KPoint& pt, KBrush* brush)
 {
 	INVALID_POINTER_RETURN_FALSE(_gdiGraphicsDelegate);
@@ -17,6 +17,8 @@ public:
 	virtual bool drawImage(Image* image, int x, int y, int nAlpha = 255) override;
 	virtual bool drawRect(KPen* pen, KRect& rect) override;
 	virtual bool fillRect(KBrush* brush, KRect& rect) override;
+	virtual bool drawPath(KPen* pen, const KPath& path) override;
+	virtual bool fillPath(KBrush* brush, const KPath& path) override;
 	virtual bool drawString(const KString& str, int len, const KFont& font, const KPoint& pt, KBrush* brush);
 	virtual bool setClip(const KRect& rect, ak::opMode mode) override;
 	virtual bool resetClip() override;
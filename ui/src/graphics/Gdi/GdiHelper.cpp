@@ -1,5 +1,6 @@
 #include "UIDefine.h"
 #include "GdiHelper.h"
+#include "KPath.h"
 
 #include <Windows.h>
 #include <Wingdi.h>
@@ -41,4 +42,77 @@ namespace GdiHelper
 
 		return opMode;
 	}
+
+	bool pathToGdiPath(HDC hdc, const KPath& path)
+	{
+		const float* points = path.getPoints();
+		int count = path.countVerbs();
+		POINT current = { 0, 0 };
+
+		if (!::BeginPath(hdc))
+		{
+			return false;
+		}
+
+		for (int i = 0; i < count; ++i)
+		{
+			switch(path.getVerb(i))
+			{
+			case KPathVerbMove:
+				current.x = (LONG)(points[0] + 0.5f);
+				current.y = (LONG)(points[1] + 0.5f);
+				::MoveToEx(hdc, current.x, current.y, nullptr);
+				points += 2;
+				break;
+
+			case KPathVerbLine:
+				current.x = (LONG)(points[0] + 0.5f);
+				current.y = (LONG)(points[1] + 0.5f);
+				::LineTo(hdc, current.x, current.y);
+				points += 2;
+				break;
+
+			case KPathVerbQuad:
+				{
+					// gdi has no quadratic segment, elevate it to a cubic.
+					POINT bezier[3];
+					bezier[2].x = (LONG)(points[2] + 0.5f);
+					bezier[2].y = (LONG)(points[3] + 0.5f);
+					bezier[0].x = (LONG)(current.x + (points[0] - current.x) * 2 / 3 + 0.5f);
+					bezier[0].y = (LONG)(current.y + (points[1] - current.y) * 2 / 3 + 0.5f);
+					bezier[1].x = (LONG)(bezier[2].x + (points[0] - bezier[2].x) * 2 / 3 + 0.5f);
+					bezier[1].y = (LONG)(bezier[2].y + (points[1] - bezier[2].y) * 2 / 3 + 0.5f);
+					::PolyBezierTo(hdc, bezier, 3);
+					current = bezier[2];
+					points += 4;
+				}
+				break;
+
+			case KPathVerbCubic:
+				{
+					POINT bezier[3];
+
+					for (int j = 0; j < 3; ++j)
+					{
+						bezier[j].x = (LONG)(points[j * 2] + 0.5f);
+						bezier[j].y = (LONG)(points[j * 2 + 1] + 0.5f);
+					}
+
+					::PolyBezierTo(hdc, bezier, 3);
+					current = bezier[2];
+					points += 6;
+				}
+				break;
+
+			case KPathVerbClose:
+				::CloseFigure(hdc);
+				break;
+
+			default:
+				break;
+			}
+		}
+
+		return TRUE == ::EndPath(hdc);
+	}
 }
\ No newline at end of file
@@ -1,8 +1,14 @@
 #pragma once
 
 #include "UIDefine.h"
+#include <windows.h>
+
+class KPath;
 
 namespace GdiHelper
 {
 	int opModeToGdiOp(ak::opMode mode);
+
+	// records path into the path bracket of hdc, ready for StrokePath or FillPath.
+	bool pathToGdiPath(HDC hdc, const KPath& path);
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "Size.h"
 #include "KPen.h"
 #include "KRect.h"
+#include "KPath.h"
 #include "KSolidBrush.h"
 #include "GdiPlusImage.h"
 #include "GdiplusRegion.h"
@@ -130,6 +131,36 @@ bool GdiPlusGraphics::fillRect(KBrush* brush, KRect& rect)
 	return true;
 }
 
+bool GdiPlusGraphics::drawPath(KPen* pen, const KPath& path)
+{
+	INVALID_POINTER_RETURN_FALSE(_gdiPlusGraphicsDelegate);
+	INVALID_POINTER_RETURN_FALSE(_gdiPlusGraphicsDelegate->_graphics);
+	INVALID_POINTER_RETURN_FALSE(pen);
+
+	Gdiplus::GraphicsPath gpPath;
+	GdiplusHelper::pathToGdiplusPath(path, &gpPath);
+	Gdiplus::Color gpColor = GdiplusHelper::colorToGdiplusColor(pen->getColor());
+	Gdiplus::Pen gpPen(gpColor, pen->getWidth());
+	_gdiPlusGraphicsDelegate->_graphics->DrawPath(&gpPen, &gpPath);
+	return true;
+}
+
+bool GdiPlusGraphics::fillPath(KBrush* brush, const KPath& path)
+{
+	INVALID_POINTER_RETURN_FALSE(_gdiPlusGraphicsDelegate);
+	INVALID_POINTER_RETURN_FALSE(_gdiPlusGraphicsDelegate->_graphics);
+	INVALID_POINTER_RETURN_FALSE(brush);
+
+	Gdiplus::Brush* gpBrush = GdiplusHelper::brushToGdiplusBrush(brush);
+	INVALID_POINTER_RETURN_FALSE(gpBrush);
+
+	Gdiplus::GraphicsPath gpPath;
+	GdiplusHelper::pathToGdiplusPath(path, &gpPath);
+	_gdiPlusGraphicsDelegate->_graphics->FillPath(gpBrush, &gpPath);
+	delete gpBrush;
+	return true;
+}
+
 bool GdiPlusGraphics::drawImage(Image* image, int x, int y, int nAlpha)
 {
 	INVALID_POINTER_RETURN_FALSE(_gdiPlusGraphicsDelegate);
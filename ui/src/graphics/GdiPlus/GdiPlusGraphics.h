@@ -17,6 +17,8 @@ public:
 	virtual bool drawLine(KPen* pen, int x1, int y1, int x2, int y2) override;
 	virtual bool drawRect(KPen* pen, KRect& rect) override;
 	virtual bool fillRect(KBrush* brush, KRect& rect) override;
+	virtual bool drawPath(KPen* pen, const KPath& path) override;
+	virtual bool fillPath(KBrush* brush, const KPath& path) override;
 	virtual bool drawImage(Image* image, int x, int y, int nAlpha = 255) override;
 	virtual bool drawImage(Image* image, int x, int y, float degrees) override;
 	virtual bool drawString(const KString& str, int len, const KFont& font, const KPoint& pt, KBrush* brush) override;
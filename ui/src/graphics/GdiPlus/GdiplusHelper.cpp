@@ -2,6 +2,7 @@
 
 #include "KFontFamily.h"
 #include "KSolidBrush.h"
+#include "KPath.h"
 
 namespace GdiplusHelper
 {
@@ -73,4 +74,55 @@ namespace GdiplusHelper
 
 		return opMode;
 	}
+
+	void pathToGdiplusPath(const KPath& path, Gdiplus::GraphicsPath* gdiplusPath)
+	{
+		gdiplusPath->Reset();
+		const float* points = path.getPoints();
+		int count = path.countVerbs();
+		Gdiplus::PointF current;
+
+		for (int i = 0; i < count; ++i)
+		{
+			switch(path.getVerb(i))
+			{
+			case KPathVerbMove:
+				gdiplusPath->StartFigure();
+				current = Gdiplus::PointF(points[0], points[1]);
+				points += 2;
+				break;
+
+			case KPathVerbLine:
+				gdiplusPath->AddLine(current.X, current.Y, points[0], points[1]);
+				current = Gdiplus::PointF(points[0], points[1]);
+				points += 2;
+				break;
+
+			case KPathVerbQuad:
+				{
+					// gdi+ has no quadratic segment, elevate it to a cubic.
+					Gdiplus::PointF end(points[2], points[3]);
+					Gdiplus::PointF control1(current.X + (points[0] - current.X) * 2 / 3, current.Y + (points[1] - current.Y) * 2 / 3);
+					Gdiplus::PointF control2(end.X + (points[0] - end.X) * 2 / 3, end.Y + (points[1] - end.Y) * 2 / 3);
+					gdiplusPath->AddBezier(current, control1, control2, end);
+					current = end;
+					points += 4;
+				}
+				break;
+
+			case KPathVerbCubic:
+				gdiplusPath->AddBezier(current.X, current.Y, points[0], points[1], points[2], points[3], points[4], points[5]);
+				current = Gdiplus::PointF(points[4], points[5]);
+				points += 6;
+				break;
+
+			case KPathVerbClose:
+				gdiplusPath->CloseFigure();
+				break;
+
+			default:
+				break;
+			}
+		}
+	}
 }
\ No newline at end of file
@@ -8,6 +8,8 @@
 #include "KPoint.h"
 #include "Brush.h"
 
+class KPath;
+
 namespace GdiplusHelper
 {
 	Gdiplus::Color colorToGdiplusColor(Color color);
@@ -15,4 +17,5 @@ namespace GdiplusHelper
 	Gdiplus::PointF pointToGdiplusPointF(const KPoint& point);
 	Gdiplus::Brush* brushToGdiplusBrush(KBrush* brush);
 	Gdiplus::CombineMode opModeToGdiplusCombineMode(ak::opMode mode);
+	void pathToGdiplusPath(const KPath& path, Gdiplus::GraphicsPath* gdiplusPath);
 }
\ No newline at end of file
@@ -10,6 +10,8 @@ class Image;
 class KString;
 class KPoint;
 class KRegion;
+class KPath;
+class TileImageSource;
 
 class Graphics
 {
@@ -26,15 +28,66 @@ public:
     virtual bool drawLine(KPen* pen, int x1, int y1, int x2, int y2) { return false; }
     virtual bool drawImage(Image* image, int x, int y, int nAlpha = 255) { return false; }
     virtual bool drawImage(Image* image, int x, int y, float degrees) { return false; }
+
+	// draws image scaled to fill rect, filtered.
+	virtual bool drawImage(Image* image, const KRect& rect, int nAlpha = 255) { return false; }
+
+	// draws image mapped onto triangles, for warps and page curls. vertices and texCoords are
+	// x, y pairs, texCoords in image pixels. indices may be null to use every three vertices.
+	virtual bool drawMesh(Image* image, const float* vertices, const float* texCoords, int vertexCount,
+		const unsigned short* indices, int indexCount, int nAlpha = 255) { return false; }
 	virtual bool drawRect(KPen* pen, KRect& rect) {return false;}
     virtual bool fillRect(KBrush* brush, KRect& rect) = 0;
+	virtual bool drawPath(KPen* pen, const KPath& path) { return false; }
+	virtual bool fillPath(KBrush* brush, const KPath& path) { return false; }
 
 	// the len parameter can be set to -1 if the string is null terminated.
 	virtual bool drawString(const KString& str, int len, const KFont& font, const KPoint& pt, KBrush* brush) { return false; }
 
 	virtual bool setClip(const KRect& rect, ak::opMode mode) { return false; }
+	virtual bool setClip(const KRect& rect, int radius, ak::opMode mode) { return false; }
 	virtual bool resetClip() { return false; }
 
+	// view layer cache, drawing between begin and end goes into the layer of key.
+	virtual bool beginCacheLayer(const void* key, const KRect& rect) { return false; }
+	virtual bool endCacheLayer() { return false; }
+	virtual bool drawCacheLayer(const void* key) { return false; }
+	virtual void removeCacheLayer(const void* key) {}
+	virtual void advanceFrame() {}
+
+	// view display lists, playback only replays the ops inside the clip.
+	virtual bool beginCachePicture(const void* key) { return false; }
+	virtual bool endCachePicture() { return false; }
+	virtual bool drawCachePicture(const void* key) { return false; }
+	virtual void removeCachePicture(const void* key) {}
+
+	// drawing between begin and end is faded to opacity (0 to 255) inside rect. with
+	// opaqueContent the caller promises to cover each pixel at most once.
+	virtual bool beginOpacityLayer(const KRect& rect, int opacity, bool opaqueContent) { return false; }
+	virtual bool endOpacityLayer() { return false; }
+
+	// clip of the area invalidated since the last frame, resetClip goes back to it.
+	virtual bool setDamageClip(const KRect& rect) { return false; }
+	virtual bool resetDamageClip() { return false; }
+
+	// deep zoom images, pending is set while sharper tiles are still loading.
+	virtual bool drawTiledImage(const void* key, const TileImageSource& source, const KRect& rect,
+		float zoom, float originX, float originY, bool* pending) { return false; }
+	virtual void removeTiledImage(const void* key) {}
+	virtual void setTiledImageBudget(size_t bytes) {}
+	virtual const void* takeLoadedTiledImage() { return nullptr; }
+	virtual bool isLoadingTiledImages() { return false; }
+
+	// paged documents, drawing goes to the current page.
+	virtual bool newPage() { return false; }
+	virtual bool saveDocument(const KString& path) { return false; }
+
+	// overdraw debugging, every pixel written is counted until resetOverdraw.
+	virtual bool setOverdrawCounting(bool enable) { return false; }
+	virtual void resetOverdraw() {}
+	virtual bool getOverdraw(const KRect& rect, int* pixels, int* writes, int* maxWrites) { return false; }
+	virtual bool drawOverdrawHeatmap(const KRect& rect) { return false; }
+
 protected:
     int _width;
     int _height;
@@ -0,0 +1,192 @@
+#include "UIDefine.h"
+#include "SkiaFontCache.h"
+#include "SkiaHelper.h"
+#include "KFont.h"
+#include "KFontFamily.h"
+#include "SkPaint.h"
+#include "SkMatrix.h"
+#include "SkTypeface.h"
+#include "SkGlyphStrike.h"
+#include "SkThread.h"
+#include "MemoryTracker.h"
+#include <set>
+#include <stdio.h>
+
+// a strike keeps its glyph cache out of skia's purgeable list, so only this many are kept,
+// the least recently used one makes room for a new one.
+const size_t MAX_STRIKE_COUNT = 32;
+
+namespace
+{
+	// guards the list of font caches and their strike maps against the sampler, which runs
+	// on whichever thread asks for a memory report.
+	SK_DECLARE_STATIC_MUTEX(g_strikeMutex);
+
+	std::set<SkiaFontCache*>& fontCaches()
+	{
+		static std::set<SkiaFontCache*> caches;
+		return caches;
+	}
+}
+
+bool SkiaFontCache::TypefaceKey::operator < (const TypefaceKey& key) const
+{
+	if (_style != key._style)
+	{
+		return _style < key._style;
+	}
+
+	return _family < key._family;
+}
+
+bool SkiaFontCache::StrikeKey::operator < (const StrikeKey& key) const
+{
+	if (_typeface != key._typeface)
+	{
+		return _typeface < key._typeface;
+	}
+
+	if (_size != key._size)
+	{
+		return _size < key._size;
+	}
+
+	return _color < key._color;
+}
+
+SkiaFontCache::SkiaFontCache()
+{
+	SkAutoMutexAcquire lock(g_strikeMutex);
+	fontCaches().insert(this);
+}
+
+SkiaFontCache::~SkiaFontCache()
+{
+	{
+		SkAutoMutexAcquire lock(g_strikeMutex);
+		fontCaches().erase(this);
+	}
+
+	clear();
+}
+
+bool SkiaFontCache::applyFont(const KFont& font, SkPaint* paint)
+{
+	INVALID_POINTER_RETURN_FALSE(paint);
+	KFontFamily* fontFamily = font.getFontFamily();
+	INVALID_POINTER_RETURN_FALSE(fontFamily);
+
+	TypefaceKey key;
+	key._family = fontFamily->getFamilyName().getUtf8();
+	key._style = SkiaHelper::fontStyleToSkiaFontStyle(font.getFontStyle());
+
+	SkTypeface* typeface = nullptr;
+	MAP_TYPEFACE::iterator iter = _typefaces.find(key);
+
+	if (iter != _typefaces.end())
+	{
+		typeface = iter->second;
+	}
+	else
+	{
+		// the cache owns the reference CreateFromName returns, nullptr is the default typeface.
+		typeface = SkTypeface::CreateFromName(key._family.c_str(), (SkTypeface::Style)key._style);
+		_typefaces[key] = typeface;
+	}
+
+	paint->setTypeface(typeface);
+	paint->setTextSize(SkIntToScalar(font.getFontSize()));
+	return true;
+}
+
+SkGlyphStrike* SkiaFontCache::getStrike(const SkPaint& paint, const SkMatrix& matrix)
+{
+	StrikeKey key;
+	key._typeface = paint.getTypeface();
+	key._size = SkScalarToFloat(paint.getTextSize());
+	key._color = paint.getColor();
+
+	MAP_STRIKE::iterator iter = _strikeMap.find(key);
+
+	if (iter != _strikeMap.end())
+	{
+		SkGlyphStrike* strike = iter->second->second;
+
+		if (strike->matches(paint, matrix))
+		{
+			// the sampler reads the strikes through the map, moving the entry leaves it alone.
+			_strikes.splice(_strikes.begin(), _strikes, iter->second);
+			return strike;
+		}
+
+		SkAutoMutexAcquire lock(g_strikeMutex);
+		removeStrike(iter);
+	}
+
+	SkGlyphStrike* strike = new SkGlyphStrike(paint, matrix);
+	SkAutoMutexAcquire lock(g_strikeMutex);
+
+	if (_strikes.size() >= MAX_STRIKE_COUNT)
+	{
+		removeStrike(_strikeMap.find(_strikes.back().first));
+	}
+
+	_strikes.push_front(std::make_pair(key, strike));
+	_strikeMap[key] = _strikes.begin();
+	return strike;
+}
+
+void SkiaFontCache::clear()
+{
+	clearStrikes();
+
+	MAP_TYPEFACE::iterator iter = _typefaces.begin();
+
+	for (; iter != _typefaces.end(); ++iter)
+	{
+		SkSafeUnref(iter->second);
+	}
+
+	_typefaces.clear();
+}
+
+void SkiaFontCache::removeStrike(MAP_STRIKE::iterator iter)
+{
+	iter->second->second->unref();
+	_strikes.erase(iter->second);
+	_strikeMap.erase(iter);
+}
+
+void SkiaFontCache::clearStrikes()
+{
+	SkAutoMutexAcquire lock(g_strikeMutex);
+	LIST_STRIKE::iterator iter = _strikes.begin();
+
+	for (; iter != _strikes.end(); ++iter)
+	{
+		iter->second->unref();
+	}
+
+	_strikes.clear();
+	_strikeMap.clear();
+}
+
+void SkiaFontCache::sampleStrikes(MemoryTracker* tracker)
+{
+	INVALID_POINTER_RETURN(tracker);
+	SkAutoMutexAcquire lock(g_strikeMutex);
+	std::set<SkiaFontCache*>::iterator cache = fontCaches().begin();
+
+	for (; cache != fontCaches().end(); ++cache)
+	{
+		MAP_STRIKE::iterator iter = (*cache)->_strikeMap.begin();
+
+		for (; iter != (*cache)->_strikeMap.end(); ++iter)
+		{
+			char owner[64] = {0};
+			snprintf(owner, sizeof(owner), "font %u, %gpx", SkTypeface::UniqueID(iter->first._typeface),
+				iter->first._size);
+			tracker->add(ak::kMemoryGlyphCache, owner, iter->second->second->getMemoryUsed());
+		}
+	}
+}
\ No newline at end of file
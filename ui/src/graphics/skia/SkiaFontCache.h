@@ -0,0 +1,67 @@
+#pragma once
+
+#include "SkColor.h"
+#include <list>
+#include <map>
+#include <string>
+
+class KFont;
+class MemoryTracker;
+class SkPaint;
+class SkMatrix;
+class SkTypeface;
+class SkGlyphStrike;
+
+// typefaces and glyph strikes of the fonts drawn by a graphics.
+// a strike pins the glyph cache of one font state, so drawing a string with it skips
+// the descriptor and cache lookup skia otherwise does for every call.
+class SkiaFontCache
+{
+public:
+	SkiaFontCache();
+	~SkiaFontCache();
+
+	// sets the typeface and size of font on paint.
+	bool applyFont(const KFont& font, SkPaint* paint);
+
+	// strike for drawing with paint under matrix, paint must have been set up by applyFont.
+	// the strike is rebuilt when the matrix scale or the text flags changed since it was made.
+	SkGlyphStrike* getStrike(const SkPaint& paint, const SkMatrix& matrix);
+	void clear();
+
+	// adds the glyphs pinned by the strikes of every font cache to the glyph cache subsystem.
+	// skia's own glyph cache list leaves them out while they are held.
+	static void sampleStrikes(MemoryTracker* tracker);
+
+private:
+	struct TypefaceKey
+	{
+		std::string _family;
+		int _style;
+
+		bool operator < (const TypefaceKey& key) const;
+	};
+
+	struct StrikeKey
+	{
+		SkTypeface* _typeface;
+		float _size;
+		SkColor _color;
+
+		bool operator < (const StrikeKey& key) const;
+	};
+
+	typedef std::map<TypefaceKey, SkTypeface*> MAP_TYPEFACE;
+	typedef std::list<std::pair<StrikeKey, SkGlyphStrike*> > LIST_STRIKE;
+	typedef std::map<StrikeKey, LIST_STRIKE::iterator> MAP_STRIKE;
+
+	// the caller holds the strike lock.
+	void removeStrike(MAP_STRIKE::iterator iter);
+	void clearStrikes();
+
+private:
+	MAP_TYPEFACE _typefaces;
+	// most recently used first.
+	LIST_STRIKE _strikes;
+	MAP_STRIKE _strikeMap;
+};
\ No newline at end of file
@@ -4,38 +4,184 @@
 #include "SkDevice.h"
 #include "SkiaHelper.h"
 #include "SkRegion.h"
+#include "SkRRect.h"
 #include "Size.h"
 #include "KPen.h"
 #include "KFont.h"
 #include "KPoint.h"
+#include "KPath.h"
 #include "KFontFamily.h"
 #include "KSolidBrush.h"
 #include "SkiaImage.h"
 #include "SkiaRegion.h"
+#include "SkiaLayerCache.h"
+#include "SkiaPictureCache.h"
+#include "SkiaTileImageCache.h"
+#include "SkiaFontCache.h"
+#include "SkiaMeshRenderer.h"
+#include "SkiaYuvRenderer.h"
+#include "YuvImage.h"
+#include "SkGlyphStrike.h"
+#include "SkNWayCanvas.h"
+#include "SkOverdrawCounter.h"
+#include "SkGraphics.h"
+#include "MemoryTracker.h"
+#include <stdio.h>
+#include <vector>
+
+namespace
+{
+	void reportFontCache(uint32_t fontID, SkScalar textSize, size_t bytesUsed, void* context)
+	{
+		char owner[64] = {0};
+		snprintf(owner, sizeof(owner), "font %u, %gpx", fontID, SkScalarToFloat(textSize));
+		((MemoryTracker*)context)->add(ak::kMemoryGlyphCache, owner, bytesUsed);
+	}
+
+	// glyph caches come and go with every string drawn, so they are measured when reported.
+	void sampleGlyphCache(MemoryTracker* tracker)
+	{
+		tracker->clear(ak::kMemoryGlyphCache);
+		SkGraphics::VisitFontCaches(reportFontCache, tracker);
+		SkiaFontCache::sampleStrikes(tracker);
+	}
+}
 
 class SkiaGraphicsDelegate
 {
 public:
     SkiaGraphicsDelegate(int width, int height)
+		: _clipSaveCount(1)
+		, _targetCanvas(nullptr)
+		, _overdrawCounter(nullptr)
+		, _surfaceBytes(0)
+		, _layerRawBytes(0)
+		, _layerPackedBytes(0)
     {
         SkBitmap bitmap;
         bitmap.setConfig(SkBitmap::kARGB_8888_Config, width, height);
         bitmap.allocPixels();
         _canvas = new SkCanvas(bitmap);
+
+		_surfaceBytes = bitmap.getSize();
+		MemoryTracker::getInstance()->add(ak::kMemorySurfaces, "skia canvas", _surfaceBytes);
+		MemoryTracker::getInstance()->addSampler(sampleGlyphCache);
     }
 
+	SkiaGraphicsDelegate(int width, int height, void* pixels, int rowBytes)
+		: _clipSaveCount(1)
+		, _targetCanvas(nullptr)
+		, _overdrawCounter(nullptr)
+		, _surfaceBytes(0)
+		, _layerRawBytes(0)
+		, _layerPackedBytes(0)
+	{
+		SkBitmap bitmap;
+		bitmap.setConfig(SkBitmap::kARGB_8888_Config, width, height, rowBytes);
+		bitmap.setPixels(pixels);
+		_canvas = new SkCanvas(bitmap);
+		MemoryTracker::getInstance()->addSampler(sampleGlyphCache);
+	}
+
+	SkiaGraphicsDelegate(SkCanvas* canvas)
+		: _canvas(canvas)
+		, _clipSaveCount(1)
+		, _targetCanvas(nullptr)
+		, _overdrawCounter(nullptr)
+		, _surfaceBytes(0)
+		, _layerRawBytes(0)
+		, _layerPackedBytes(0)
+	{
+
+	}
+
     ~SkiaGraphicsDelegate()
     {
+		if (!_canvasStack.empty())
+		{
+			_canvas = _canvasStack.front();
+			_canvasStack.clear();
+			_cacheSaveCounts.clear();
+			_layerCache.endLayer();
+			_pictureCache.endPicture();
+		}
+
+		stopOverdrawCounting();
+
 		if (nullptr != _canvas)
 		{
 			delete _canvas;
 			_canvas = nullptr;
 		}
+
+		MemoryTracker::getInstance()->remove(ak::kMemorySurfaces, "skia canvas", _surfaceBytes);
+		reportLayers(0, 0);
     }
 
 public:
     SkCanvas* _canvas;
     SkPaint _paint;
+
+	// reused by the path calls so a path drawn every frame does not reallocate.
+	SkPath _path;
+
+	// canvases replaced while a view layer or picture is recorded,
+	// _canvas then points into the layer or picture cache.
+	std::vector<SkCanvas*> _canvasStack;
+	SkiaLayerCache _layerCache;
+	SkiaPictureCache _pictureCache;
+	SkiaTileImageCache _tileImageCache;
+	SkiaFontCache _fontCache;
+	SkiaMeshRenderer _meshRenderer;
+	SkiaYuvRenderer _yuvRenderer;
+
+	// glyphs of the string being drawn, reused between calls.
+	std::vector<uint16_t> _glyphs;
+
+	// resetClip restores to this count, which keeps the damage clip.
+	int _clipSaveCount;
+
+	// the clip save counts of the opacity layers being drawn, the top one is restored
+	// by endOpacityLayer.
+	std::vector<int> _opacitySaveCounts;
+
+	// the clip save counts of the canvases in _canvasStack, restored with them.
+	std::vector<int> _cacheSaveCounts;
+
+	// while overdraw is counted _canvas draws into both the target canvas and the counter.
+	SkCanvas* _targetCanvas;
+	SkOverdrawCounter* _overdrawCounter;
+
+	// layer tiles are measured once a frame, the tracker gets the difference.
+	size_t _surfaceBytes;
+	size_t _layerRawBytes;
+	size_t _layerPackedBytes;
+
+	void reportLayers(size_t rawBytes, size_t packedBytes)
+	{
+		MemoryTracker* tracker = MemoryTracker::getInstance();
+		tracker->remove(ak::kMemoryLayers, "bitmaps", _layerRawBytes);
+		tracker->remove(ak::kMemoryLayers, "run length encoded", _layerPackedBytes);
+		tracker->add(ak::kMemoryLayers, "bitmaps", rawBytes);
+		tracker->add(ak::kMemoryLayers, "run length encoded", packedBytes);
+		_layerRawBytes = rawBytes;
+		_layerPackedBytes = packedBytes;
+	}
+
+	void stopOverdrawCounting()
+	{
+		if (nullptr == _targetCanvas)
+		{
+			return;
+		}
+
+		// the n-way canvas holds a reference to the target, it has to go first.
+		delete _canvas;
+		_canvas = _targetCanvas;
+		_targetCanvas = nullptr;
+		delete _overdrawCounter;
+		_overdrawCounter = nullptr;
+	}
 };
 
 SkiaGraphics::SkiaGraphics(int width, int height)
@@ -44,6 +190,18 @@ SkiaGraphics::SkiaGraphics(int width, int height)
     _skiaGraphicsDelegate = new SkiaGraphicsDelegate(width, height);
 }
 
+SkiaGraphics::SkiaGraphics(int width, int height, void* pixels, int rowBytes)
+	: Graphics(width, height)
+{
+	_skiaGraphicsDelegate = new SkiaGraphicsDelegate(width, height, pixels, rowBytes);
+}
+
+SkiaGraphics::SkiaGraphics(int width, int height, SkCanvas* canvas)
+	: Graphics(width, height)
+{
+	_skiaGraphicsDelegate = new SkiaGraphicsDelegate(canvas);
+}
+
 SkiaGraphics::~SkiaGraphics()
 {
     if (_skiaGraphicsDelegate)
@@ -58,7 +216,14 @@ void* SkiaGraphics::lockBits()
     INVALID_POINTER_RETURN_NULL(_skiaGraphicsDelegate);
     INVALID_POINTER_RETURN_NULL(_skiaGraphicsDelegate->_canvas);
 
-    SkDevice* device = _skiaGraphicsDelegate->_canvas->getDevice();
+    SkCanvas* canvas = _skiaGraphicsDelegate->_canvas;
+
+    if (nullptr != _skiaGraphicsDelegate->_targetCanvas)
+    {
+        canvas = _skiaGraphicsDelegate->_targetCanvas;
+    }
+
+    SkDevice* device = canvas->getDevice();
 
     if (device)
     {
@@ -74,7 +239,8 @@ void SkiaGraphics::clear(const Color& color)
 	INVALID_POINTER_RETURN(_skiaGraphicsDelegate);
 	INVALID_POINTER_RETURN(_skiaGraphicsDelegate->_canvas);
 	SkColor skColor = SkiaHelper::colorToSkiaColor(color);
-	_skiaGraphicsDelegate->_canvas->clear(skColor);
+	// SkCanvas::clear ignores the clip, which would wipe what is outside the damage rect.
+	_skiaGraphicsDelegate->_canvas->drawColor(skColor, SkXfermode::kSrc_Mode);
 }
 
 bool SkiaGraphics::drawLine(KPen* pen, int x1, int y1, int x2, int y2)
@@ -95,6 +261,13 @@ bool SkiaGraphics::drawImage(Image* image, int x, int y, int nAlpha)
     INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate);
     INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate->_canvas);
 
+    YuvImage* yuvImage = dynamic_cast<YuvImage*>(image);
+
+    if (nullptr != yuvImage)
+    {
+        return drawImage(image, KRect(x, y, yuvImage->width(), yuvImage->height()), nAlpha);
+    }
+
     SkiaImage* skiaImage = dynamic_cast<SkiaImage*>(image);
     INVALID_POINTER_RETURN_FALSE(skiaImage);
     SkBitmap* bitmap = skiaImage->getSkiaBitmap();
@@ -104,6 +277,35 @@ bool SkiaGraphics::drawImage(Image* image, int x, int y, int nAlpha)
     return true;
 }
 
+bool SkiaGraphics::drawImage(Image* image, const KRect& rect, int nAlpha)
+{
+    INVALID_POINTER_RETURN_FALSE(image);
+    INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate);
+    INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate->_canvas);
+
+    SkPaint paint;
+    paint.setAlpha(nAlpha);
+    paint.setFilterBitmap(true);
+    SkRect dst = SkiaHelper::rectToSkiaRect(rect);
+
+    // video frames are converted as they are drawn, straight into the pixels unless the overdraw
+    // counter or an opacity layer has to see the draw, as for drawMesh.
+    YuvImage* yuvImage = dynamic_cast<YuvImage*>(image);
+
+    if (nullptr != yuvImage)
+    {
+        bool rasterize = nullptr == _skiaGraphicsDelegate->_overdrawCounter && _skiaGraphicsDelegate->_opacitySaveCounts.empty();
+        return _skiaGraphicsDelegate->_yuvRenderer.drawImage(_skiaGraphicsDelegate->_canvas, yuvImage, dst, paint, rasterize);
+    }
+
+    SkiaImage* skiaImage = dynamic_cast<SkiaImage*>(image);
+    INVALID_POINTER_RETURN_FALSE(skiaImage);
+    SkBitmap* bitmap = skiaImage->getSkiaBitmap();
+    INVALID_POINTER_RETURN_FALSE(bitmap);
+    _skiaGraphicsDelegate->_canvas->drawBitmapRect(*bitmap, dst, &paint);
+    return true;
+}
+
 bool SkiaGraphics::drawImage(Image* image, int x, int y, float degrees)
 {
 	INVALID_POINTER_RETURN_FALSE(image);
@@ -120,6 +322,45 @@ bool SkiaGraphics::drawImage(Image* image, int x, int y, float degrees)
 	return true;
 }
 
+bool SkiaGraphics::drawMesh(Image* image, const float* vertices, const float* texCoords, int vertexCount,
+	const unsigned short* indices, int indexCount, int nAlpha)
+{
+	INVALID_POINTER_RETURN_FALSE(image);
+	INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate);
+	INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate->_canvas);
+
+	SkiaImage* skiaImage = dynamic_cast<SkiaImage*>(image);
+	INVALID_POINTER_RETURN_FALSE(skiaImage);
+	SkBitmap* bitmap = skiaImage->getSkiaBitmap();
+	INVALID_POINTER_RETURN_FALSE(bitmap);
+
+	SkPaint paint;
+	paint.setAlpha(nAlpha);
+	paint.setFilterBitmap(true);
+
+	// the rasterizer writes pixels itself, which the overdraw counter and opacity layers
+	// that fade each draw instead of compositing would not see.
+	bool rasterize = nullptr == _skiaGraphicsDelegate->_overdrawCounter && _skiaGraphicsDelegate->_opacitySaveCounts.empty();
+	return _skiaGraphicsDelegate->_meshRenderer.drawMesh(_skiaGraphicsDelegate->_canvas, *bitmap, vertices, texCoords,
+		vertexCount, indices, indexCount, paint, rasterize);
+}
+
+bool SkiaGraphics::drawRect(KPen* pen, KRect& rect)
+{
+	INVALID_POINTER_RETURN_FALSE(pen);
+	INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate);
+	INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate->_canvas);
+
+	SkPaint& paint = _skiaGraphicsDelegate->_paint;
+	paint.setColor(SkiaHelper::colorToSkiaColor(pen->getColor()));
+	paint.setStyle(SkPaint::kStroke_Style);
+	paint.setStrokeWidth(SkIntToScalar(pen->getWidth()));
+	_skiaGraphicsDelegate->_canvas->drawRect(SkiaHelper::rectToSkiaRect(rect), paint);
+	paint.setStyle(SkPaint::kFill_Style);
+	paint.setStrokeWidth(0);
+	return true;
+}
+
 bool SkiaGraphics::fillRect(KBrush* brush, KRect& rect)
 {
     INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate);
@@ -143,19 +384,52 @@ bool SkiaGraphics::fillRect(KBrush* brush, KRect& rect)
     return true;
 }
 
+bool SkiaGraphics::drawPath(KPen* pen, const KPath& path)
+{
+	INVALID_POINTER_RETURN_FALSE(pen);
+	INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate);
+	INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate->_canvas);
+
+	SkPaint& paint = _skiaGraphicsDelegate->_paint;
+	SkiaHelper::pathToSkiaPath(path, &_skiaGraphicsDelegate->_path);
+	paint.setColor(SkiaHelper::colorToSkiaColor(pen->getColor()));
+	paint.setStyle(SkPaint::kStroke_Style);
+	paint.setStrokeWidth(SkIntToScalar(pen->getWidth()));
+	paint.setAntiAlias(true);
+	_skiaGraphicsDelegate->_canvas->drawPath(_skiaGraphicsDelegate->_path, paint);
+	paint.setStyle(SkPaint::kFill_Style);
+	paint.setStrokeWidth(0);
+	paint.setAntiAlias(false);
+	return true;
+}
+
+bool SkiaGraphics::fillPath(KBrush* brush, const KPath& path)
+{
+	INVALID_POINTER_RETURN_FALSE(brush);
+	INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate);
+	INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate->_canvas);
+
+	KSolidBrush* solidBrush = dynamic_cast<KSolidBrush*>(brush);
+	INVALID_POINTER_RETURN_FALSE(solidBrush);
+
+	SkPaint& paint = _skiaGraphicsDelegate->_paint;
+	SkiaHelper::pathToSkiaPath(path, &_skiaGraphicsDelegate->_path);
+	paint.setColor(SkiaHelper::colorToSkiaColor(solidBrush->getColor()));
+	paint.setAntiAlias(true);
+	_skiaGraphicsDelegate->_canvas->drawPath(_skiaGraphicsDelegate->_path, paint);
+	paint.setAntiAlias(false);
+	return true;
+}
+
 bool SkiaGraphics::drawString(const KString& str, int len, const KFont& font, const KPoint& pt, KBrush* brush)
 {
 	INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate);
 	INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate->_canvas);
 
-	KFontFamily* fontFamily = font.getFontFamily();
-	INVALID_POINTER_RETURN_FALSE(fontFamily);
-	SkTypeface::Style style = SkiaHelper::fontStyleToSkiaFontStyle(font.getFontStyle());
-	SkTypeface* typeFace = SkTypeface::CreateFromName(fontFamily->getFamilyName().getUtf8(), style);
-	_skiaGraphicsDelegate->_paint.setTypeface(typeFace);
-	_skiaGraphicsDelegate->_paint.setTextSize(SkIntToScalar(font.getFontSize()));
-	_skiaGraphicsDelegate->_paint.setAntiAlias(true);
-	_skiaGraphicsDelegate->_paint.setLCDRenderText(true);
+	SkPaint& paint = _skiaGraphicsDelegate->_paint;
+	VALUE_FALSE_RETURN_FALSE(_skiaGraphicsDelegate->_fontCache.applyFont(font, &paint));
+	paint.setAntiAlias(true);
+	paint.setLCDRenderText(true);
 
 	if (nullptr != brush)
 	{
@@ -163,7 +437,7 @@ bool SkiaGraphics::drawString(const KString& str, int len, const KFont& font, co
 		{
 			KSolidBrush* solidBrush = dynamic_cast<KSolidBrush*>(brush);
 			SkColor color = SkiaHelper::colorToSkiaColor(solidBrush->getColor());
-			_skiaGraphicsDelegate->_paint.setColor(color);
+			paint.setColor(color);
 		}
 	}
 
@@ -175,7 +449,19 @@ bool SkiaGraphics::drawString(const KString& str, int len, const KFont& font, co
 		drawLen = strlen(utf8Str);
 	}
 
-	_skiaGraphicsDelegate->_canvas->drawText((const void*)utf8Str, drawLen, SkIntToScalar(pt._x), SkIntToScalar(pt._y), _skiaGraphicsDelegate->_paint);
+	if (drawLen <= 0)
+	{
+		return true;
+	}
+
+	SkCanvas* canvas = _skiaGraphicsDelegate->_canvas;
+	SkGlyphStrike* strike = _skiaGraphicsDelegate->_fontCache.getStrike(paint, canvas->getTotalMatrix());
+
+	// a utf8 string never has more characters than bytes.
+	std::vector<uint16_t>& glyphs = _skiaGraphicsDelegate->_glyphs;
+	glyphs.resize(drawLen);
+	int count = strike->textToGlyphs(utf8Str, drawLen, SkPaint::kUTF8_TextEncoding, &glyphs[0]);
+	canvas->drawGlyphs(strike, &glyphs[0], count, SkIntToScalar(pt._x), SkIntToScalar(pt._y), paint);
 	return true;
 }
 
@@ -190,10 +476,318 @@ bool SkiaGraphics::setClip(const KRect& rect, ak::opMode mode)
 	return true;
 }
 
+bool SkiaGraphics::setClip(const KRect& rect, int radius, ak::opMode mode)
+{
+	INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate);
+	INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate->_canvas);
+
+	// an intersect with an integral rect is kept as a round rect by the raster clip, only the
+	// corners are antialiased while drawing.
+	SkRRect rrect;
+	rrect.setRectXY(SkiaHelper::rectToSkiaRect(rect), SkIntToScalar(radius), SkIntToScalar(radius));
+	SkRegion::Op skOp = SkiaHelper::opModeToSkiaOp(mode);
+	_skiaGraphicsDelegate->_canvas->save(SkCanvas::kClip_SaveFlag);
+	_skiaGraphicsDelegate->_canvas->clipRRect(rrect, skOp, true);
+	return true;
+}
+
 bool SkiaGraphics::resetClip()
+{
+	INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate);
+	INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate->_canvas);
+	_skiaGraphicsDelegate->_canvas->restoreToCount(_skiaGraphicsDelegate->_clipSaveCount);
+	return true;
+}
+
+bool SkiaGraphics::beginCacheLayer(const void* key, const KRect& rect)
+{
+	INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate);
+	INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate->_canvas);
+
+	SkCanvas* layerCanvas = _skiaGraphicsDelegate->_layerCache.beginLayer(key, rect);
+	INVALID_POINTER_RETURN_FALSE(layerCanvas);
+
+	// resetClip inside the cache restores its own canvas, not the one drawn into before.
+	_skiaGraphicsDelegate->_canvasStack.push_back(_skiaGraphicsDelegate->_canvas);
+	_skiaGraphicsDelegate->_cacheSaveCounts.push_back(_skiaGraphicsDelegate->_clipSaveCount);
+	_skiaGraphicsDelegate->_canvas = layerCanvas;
+	_skiaGraphicsDelegate->_clipSaveCount = layerCanvas->getSaveCount();
+	return true;
+}
+
+bool SkiaGraphics::endCacheLayer()
+{
+	INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate);
+	VALUE_FALSE_RETURN_FALSE(!_skiaGraphicsDelegate->_canvasStack.empty());
+
+	_skiaGraphicsDelegate->_canvas = _skiaGraphicsDelegate->_canvasStack.back();
+	_skiaGraphicsDelegate->_canvasStack.pop_back();
+	_skiaGraphicsDelegate->_clipSaveCount = _skiaGraphicsDelegate->_cacheSaveCounts.back();
+	_skiaGraphicsDelegate->_cacheSaveCounts.pop_back();
+	_skiaGraphicsDelegate->_layerCache.endLayer();
+	return true;
+}
+
+bool SkiaGraphics::drawCacheLayer(const void* key)
+{
+	INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate);
+	INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate->_canvas);
+	return _skiaGraphicsDelegate->_layerCache.drawLayer(key, _skiaGraphicsDelegate->_canvas);
+}
+
+void SkiaGraphics::removeCacheLayer(const void* key)
+{
+	INVALID_POINTER_RETURN(_skiaGraphicsDelegate);
+	_skiaGraphicsDelegate->_layerCache.removeLayer(key);
+}
+
+void SkiaGraphics::advanceFrame()
+{
+	INVALID_POINTER_RETURN(_skiaGraphicsDelegate);
+	_skiaGraphicsDelegate->_layerCache.advanceFrame();
+	_skiaGraphicsDelegate->_tileImageCache.advanceFrame();
+
+	size_t rawBytes = 0;
+	size_t packedBytes = 0;
+	_skiaGraphicsDelegate->_layerCache.getMemory(&rawBytes, &packedBytes);
+	_skiaGraphicsDelegate->reportLayers(rawBytes, packedBytes);
+}
+
+bool SkiaGraphics::beginCachePicture(const void* key)
+{
+	INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate);
+	INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate->_canvas);
+
+	SkCanvas* pictureCanvas = _skiaGraphicsDelegate->_pictureCache.beginPicture(key, _width, _height);
+	INVALID_POINTER_RETURN_FALSE(pictureCanvas);
+
+	// resetClip inside the cache restores its own canvas, not the one drawn into before.
+	_skiaGraphicsDelegate->_canvasStack.push_back(_skiaGraphicsDelegate->_canvas);
+	_skiaGraphicsDelegate->_cacheSaveCounts.push_back(_skiaGraphicsDelegate->_clipSaveCount);
+	_skiaGraphicsDelegate->_canvas = pictureCanvas;
+	_skiaGraphicsDelegate->_clipSaveCount = pictureCanvas->getSaveCount();
+	return true;
+}
+
+bool SkiaGraphics::endCachePicture()
+{
+	INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate);
+	VALUE_FALSE_RETURN_FALSE(!_skiaGraphicsDelegate->_canvasStack.empty());
+
+	_skiaGraphicsDelegate->_canvas = _skiaGraphicsDelegate->_canvasStack.back();
+	_skiaGraphicsDelegate->_canvasStack.pop_back();
+	_skiaGraphicsDelegate->_clipSaveCount = _skiaGraphicsDelegate->_cacheSaveCounts.back();
+	_skiaGraphicsDelegate->_cacheSaveCounts.pop_back();
+	_skiaGraphicsDelegate->_pictureCache.endPicture();
+	return true;
+}
+
+bool SkiaGraphics::drawCachePicture(const void* key)
+{
+	INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate);
+	INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate->_canvas);
+	return _skiaGraphicsDelegate->_pictureCache.drawPicture(key, _skiaGraphicsDelegate->_canvas);
+}
+
+void SkiaGraphics::removeCachePicture(const void* key)
+{
+	INVALID_POINTER_RETURN(_skiaGraphicsDelegate);
+	_skiaGraphicsDelegate->_pictureCache.removePicture(key);
+}
+
+bool SkiaGraphics::beginOpacityLayer(const KRect& rect, int opacity, bool opaqueContent)
+{
+	INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate);
+	INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate->_canvas);
+
+	// the layer is only as large as rect inside the clip, opaque content skips it
+	// and fades each draw instead.
+	SkCanvas* canvas = _skiaGraphicsDelegate->_canvas;
+	SkRect bounds = SkiaHelper::rectToSkiaRect(rect);
+	int flags = SkCanvas::kARGB_ClipLayer_SaveFlag;
+
+	if (opaqueContent)
+	{
+		flags |= SkCanvas::kModulateAlpha_SaveFlag;
+	}
+
+	canvas->saveLayerAlpha(&bounds, opacity, (SkCanvas::SaveFlags)flags);
+
+	// resetClip inside the layer must not restore past it.
+	_skiaGraphicsDelegate->_opacitySaveCounts.push_back(_skiaGraphicsDelegate->_clipSaveCount);
+	_skiaGraphicsDelegate->_clipSaveCount = canvas->getSaveCount();
+	return true;
+}
+
+bool SkiaGraphics::endOpacityLayer()
+{
+	INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate);
+	INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate->_canvas);
+	VALUE_FALSE_RETURN_FALSE(!_skiaGraphicsDelegate->_opacitySaveCounts.empty());
+
+	_skiaGraphicsDelegate->_canvas->restoreToCount(_skiaGraphicsDelegate->_clipSaveCount - 1);
+	_skiaGraphicsDelegate->_clipSaveCount = _skiaGraphicsDelegate->_opacitySaveCounts.back();
+	_skiaGraphicsDelegate->_opacitySaveCounts.pop_back();
+	return true;
+}
+
+bool SkiaGraphics::setDamageClip(const KRect& rect)
+{
+	INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate);
+	INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate->_canvas);
+
+	SkCanvas* canvas = _skiaGraphicsDelegate->_canvas;
+	canvas->restoreToCount(1);
+	canvas->save(SkCanvas::kClip_SaveFlag);
+	canvas->clipRect(SkiaHelper::rectToSkiaRect(rect), SkRegion::kReplace_Op);
+	_skiaGraphicsDelegate->_clipSaveCount = canvas->getSaveCount();
+	return true;
+}
+
+bool SkiaGraphics::resetDamageClip()
 {
 	INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate);
 	INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate->_canvas);
 	_skiaGraphicsDelegate->_canvas->restoreToCount(1);
+	_skiaGraphicsDelegate->_clipSaveCount = 1;
 	return true;
+}
+
+bool SkiaGraphics::drawTiledImage(const void* key, const TileImageSource& source, const KRect& rect,
+	float zoom, float originX, float originY, bool* pending)
+{
+	INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate);
+	INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate->_canvas);
+	return _skiaGraphicsDelegate->_tileImageCache.drawImage(key, source, rect, zoom, originX, originY, _skiaGraphicsDelegate->_canvas, pending);
+}
+
+void SkiaGraphics::removeTiledImage(const void* key)
+{
+	INVALID_POINTER_RETURN(_skiaGraphicsDelegate);
+	_skiaGraphicsDelegate->_tileImageCache.removeImage(key);
+}
+
+void SkiaGraphics::setTiledImageBudget(size_t bytes)
+{
+	INVALID_POINTER_RETURN(_skiaGraphicsDelegate);
+	_skiaGraphicsDelegate->_tileImageCache.setBudget(bytes);
+}
+
+const void* SkiaGraphics::takeLoadedTiledImage()
+{
+	INVALID_POINTER_RETURN_NULL(_skiaGraphicsDelegate);
+	return _skiaGraphicsDelegate->_tileImageCache.takeLoadedImage();
+}
+
+bool SkiaGraphics::isLoadingTiledImages()
+{
+	INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate);
+	return _skiaGraphicsDelegate->_tileImageCache.isLoading();
+}
+
+bool SkiaGraphics::setOverdrawCounting(bool enable)
+{
+	INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate);
+	INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate->_canvas);
+
+	// the canvas can only be swapped between frames.
+	VALUE_FALSE_RETURN_FALSE(_skiaGraphicsDelegate->_canvasStack.empty());
+
+	if (!enable)
+	{
+		_skiaGraphicsDelegate->stopOverdrawCounting();
+		return true;
+	}
+
+	if (nullptr != _skiaGraphicsDelegate->_targetCanvas)
+	{
+		return true;
+	}
+
+	// pdf pages and other canvases without pixels have nothing to count.
+	INVALID_POINTER_RETURN_FALSE(lockBits());
+
+	SkOverdrawCounter* counter = new SkOverdrawCounter(_width, _height);
+	SkNWayCanvas* canvas = new SkNWayCanvas(_width, _height);
+	canvas->addCanvas(_skiaGraphicsDelegate->_canvas);
+	canvas->addCanvas(counter->getCanvas());
+
+	_skiaGraphicsDelegate->_targetCanvas = _skiaGraphicsDelegate->_canvas;
+	_skiaGraphicsDelegate->_overdrawCounter = counter;
+	_skiaGraphicsDelegate->_canvas = canvas;
+	_skiaGraphicsDelegate->_clipSaveCount = 1;
+	return true;
+}
+
+void SkiaGraphics::resetOverdraw()
+{
+	INVALID_POINTER_RETURN(_skiaGraphicsDelegate);
+	INVALID_POINTER_RETURN(_skiaGraphicsDelegate->_overdrawCounter);
+	_skiaGraphicsDelegate->_overdrawCounter->reset();
+}
+
+bool SkiaGraphics::getOverdraw(const KRect& rect, int* pixels, int* writes, int* maxWrites)
+{
+	INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate);
+	INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate->_overdrawCounter);
+
+	SkOverdrawCounter::Stats stats;
+	SkIRect area = SkIRect::MakeLTRB(rect._left, rect._top, rect._right, rect._bottom);
+	_skiaGraphicsDelegate->_overdrawCounter->getStats(area, &stats);
+
+	if (nullptr != pixels)
+	{
+		*pixels = stats.fPixels;
+	}
+
+	if (nullptr != writes)
+	{
+		*writes = stats.fWrites;
+	}
+
+	if (nullptr != maxWrites)
+	{
+		*maxWrites = stats.fMaxWrites;
+	}
+
+	return true;
+}
+
+bool SkiaGraphics::drawOverdrawHeatmap(const KRect& rect)
+{
+	INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate);
+	INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate->_overdrawCounter);
+	INVALID_POINTER_RETURN_FALSE(_skiaGraphicsDelegate->_targetCanvas);
+
+	// straight to the target so the heatmap does not count itself.
+	SkIRect area = SkIRect::MakeLTRB(rect._left, rect._top, rect._right, rect._bottom);
+	_skiaGraphicsDelegate->_overdrawCounter->drawHeatmap(_skiaGraphicsDelegate->_targetCanvas, area);
+	return true;
+}
+
+SkCanvas* SkiaGraphics::getSkiaCanvas() const
+{
+	INVALID_POINTER_RETURN_NULL(_skiaGraphicsDelegate);
+	return _skiaGraphicsDelegate->_canvas;
+}
+
+void SkiaGraphics::setSkiaCanvas(SkCanvas* canvas)
+{
+	INVALID_POINTER_RETURN(_skiaGraphicsDelegate);
+
+	// only valid outside of a layer or picture recording.
+	if (!_skiaGraphicsDelegate->_canvasStack.empty())
+	{
+		return;
+	}
+
+	_skiaGraphicsDelegate->stopOverdrawCounting();
+
+	if (nullptr != _skiaGraphicsDelegate->_canvas)
+	{
+		delete _skiaGraphicsDelegate->_canvas;
+	}
+
+	_skiaGraphicsDelegate->_canvas = canvas;
+	_skiaGraphicsDelegate->_clipSaveCount = 1;
 }
\ No newline at end of file
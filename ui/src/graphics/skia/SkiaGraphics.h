@@ -2,12 +2,16 @@
 
 #include "Graphics.h"
 
+class SkCanvas;
 class SkiaGraphicsDelegate;
 
 class SkiaGraphics : public Graphics
 {
 public:
     SkiaGraphics(int width, int height);
+
+	// draws into pixels owned by the caller, 32 bit premultiplied and rowBytes apart.
+	SkiaGraphics(int width, int height, void* pixels, int rowBytes);
     virtual ~SkiaGraphics();
 
     // Graphics
@@ -16,10 +20,46 @@ public:
     virtual bool drawLine(KPen* pen, int x1, int y1, int x2, int y2) override;
     virtual bool drawImage(Image* image, int x, int y, int nAlpha = 255) override;
     virtual bool drawImage(Image* image, int x, int y, float degrees) override;
+	virtual bool drawImage(Image* image, const KRect& rect, int nAlpha = 255) override;
+	virtual bool drawMesh(Image* image, const float* vertices, const float* texCoords, int vertexCount,
+		const unsigned short* indices, int indexCount, int nAlpha = 255) override;
+	virtual bool drawRect(KPen* pen, KRect& rect) override;
     virtual bool fillRect(KBrush* brush, KRect& rect) override;
+	virtual bool drawPath(KPen* pen, const KPath& path) override;
+	virtual bool fillPath(KBrush* brush, const KPath& path) override;
 	virtual bool drawString(const KString& str, int len, const KFont& font, const KPoint& pt, KBrush* brush) override;
 	virtual bool setClip(const KRect& rect, ak::opMode mode) override;
+	virtual bool setClip(const KRect& rect, int radius, ak::opMode mode) override;
 	virtual bool resetClip() override;
+	virtual bool beginCacheLayer(const void* key, const KRect& rect) override;
+	virtual bool endCacheLayer() override;
+	virtual bool drawCacheLayer(const void* key) override;
+	virtual void removeCacheLayer(const void* key) override;
+	virtual void advanceFrame() override;
+	virtual bool beginCachePicture(const void* key) override;
+	virtual bool endCachePicture() override;
+	virtual bool drawCachePicture(const void* key) override;
+	virtual void removeCachePicture(const void* key) override;
+	virtual bool beginOpacityLayer(const KRect& rect, int opacity, bool opaqueContent) override;
+	virtual bool endOpacityLayer() override;
+	virtual bool setDamageClip(const KRect& rect) override;
+	virtual bool resetDamageClip() override;
+	virtual bool drawTiledImage(const void* key, const TileImageSource& source, const KRect& rect,
+		float zoom, float originX, float originY, bool* pending) override;
+	virtual void removeTiledImage(const void* key) override;
+	virtual void setTiledImageBudget(size_t bytes) override;
+	virtual const void* takeLoadedTiledImage() override;
+	virtual bool isLoadingTiledImages() override;
+	virtual bool setOverdrawCounting(bool enable) override;
+	virtual void resetOverdraw() override;
+	virtual bool getOverdraw(const KRect& rect, int* pixels, int* writes, int* maxWrites) override;
+	virtual bool drawOverdrawHeatmap(const KRect& rect) override;
+
+protected:
+	// draws into canvas instead of a bitmap, the graphics takes ownership of it.
+	SkiaGraphics(int width, int height, SkCanvas* canvas);
+	SkCanvas* getSkiaCanvas() const;
+	void setSkiaCanvas(SkCanvas* canvas);
 
 private:
     SkiaGraphicsDelegate* _skiaGraphicsDelegate;
@@ -1,4 +1,5 @@
 #include "SkiaHelper.h"
+#include "KPath.h"
 
 namespace SkiaHelper
 {
@@ -74,4 +75,48 @@ namespace SkiaHelper
 
 		return skOp;
 	}
+
+	void pathToSkiaPath(const KPath& path, SkPath* skPath)
+	{
+		skPath->rewind();
+		skPath->incReserve(path.countPoints());
+		const float* points = path.getPoints();
+		int count = path.countVerbs();
+
+		for (int i = 0; i < count; ++i)
+		{
+			switch(path.getVerb(i))
+			{
+			case KPathVerbMove:
+				skPath->moveTo(SkFloatToScalar(points[0]), SkFloatToScalar(points[1]));
+				points += 2;
+				break;
+
+			case KPathVerbLine:
+				skPath->lineTo(SkFloatToScalar(points[0]), SkFloatToScalar(points[1]));
+				points += 2;
+				break;
+
+			case KPathVerbQuad:
+				skPath->quadTo(SkFloatToScalar(points[0]), SkFloatToScalar(points[1]),
+					SkFloatToScalar(points[2]), SkFloatToScalar(points[3]));
+				points += 4;
+				break;
+
+			case KPathVerbCubic:
+				skPath->cubicTo(SkFloatToScalar(points[0]), SkFloatToScalar(points[1]),
+					SkFloatToScalar(points[2]), SkFloatToScalar(points[3]),
+					SkFloatToScalar(points[4]), SkFloatToScalar(points[5]));
+				points += 6;
+				break;
+
+			case KPathVerbClose:
+				skPath->close();
+				break;
+
+			default:
+				break;
+			}
+		}
+	}
 }
\ No newline at end of file
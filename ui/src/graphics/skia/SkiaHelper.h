@@ -8,6 +8,9 @@
 #include "KFont.h"
 #include "SkTypeface.h"
 #include "SkRegion.h"
+#include "SkPath.h"
+
+class KPath;
 
 namespace SkiaHelper
 {
@@ -15,4 +18,5 @@ namespace SkiaHelper
     SkRect rectToSkiaRect(const KRect& rect);
 	SkTypeface::Style fontStyleToSkiaFontStyle(KFontStyle fontStyle);
 	SkRegion::Op opModeToSkiaOp(ak::opMode opMode);
+	void pathToSkiaPath(const KPath& path, SkPath* skPath);
 }
\ No newline at end of file
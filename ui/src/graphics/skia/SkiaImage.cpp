@@ -3,29 +3,50 @@
 #include "SkStream.h"
 #include "SkBitmap.h"
 #include "SkImageDecoder.h"
+#include "MemoryTracker.h"
 
 class SkiaImageDelegate
 {
 public:
     SkiaImageDelegate()
+		: _trackedBytes(0)
     {
 //         _bitmap.setConfig(SkBitmap::kARGB_8888_Config, width, height);
 //         _bitmap.allocPixels();
     }
 
 	SkiaImageDelegate(int width, int height)
+		: _trackedBytes(0)
 	{
 		_bitmap.setConfig(SkBitmap::kARGB_8888_Config, width, height);
 		_bitmap.allocPixels();
+		track("");
 	}
 
     ~SkiaImageDelegate()
     {
-
+		untrack();
     }
 
+	// pixels are reported under the file they were decoded from.
+	void track(const std::string& source)
+	{
+		untrack();
+		_source = source;
+		MemoryTracker::getInstance()->add(ak::kMemoryImages, _source.c_str(), _bitmap.getSize());
+		_trackedBytes = _bitmap.getSize();
+	}
+
+	void untrack()
+	{
+		MemoryTracker::getInstance()->remove(ak::kMemoryImages, _source.c_str(), _trackedBytes);
+		_trackedBytes = 0;
+	}
+
 public:
      SkBitmap _bitmap;
+	std::string _source;
+	size_t _trackedBytes;
 };
 
 SkiaImage::SkiaImage()
@@ -40,6 +61,11 @@ SkiaImage::SkiaImage(int width, int height)
 
 SkiaImage::~SkiaImage()
 {
+	if (nullptr != _skiaImageDelegate)
+	{
+		delete _skiaImageDelegate;
+		_skiaImageDelegate = nullptr;
+	}
 }
 
 SkBitmap* SkiaImage::getSkiaBitmap()
@@ -56,6 +82,7 @@ bool SkiaImage::fromFile(char* file)
 
     if (decoder->decode(&fileStream, &_skiaImageDelegate->_bitmap, SkBitmap::kARGB_8888_Config, SkImageDecoder::kDecodePixels_Mode))
     {
+		_skiaImageDelegate->track(file);
         return true;
     }
 
@@ -0,0 +1,518 @@
+#include "UIDefine.h"
+#include "SkiaLayerCache.h"
+#include "SkiaWorkerPool.h"
+#include "SkCanvas.h"
+#include "SkBitmap.h"
+#include "SkRefCnt.h"
+#include "SkThread.h"
+#include "SkUtils.h"
+#include "SkRunnable.h"
+
+const int LAYER_TILE_SIZE = 256;
+const int DEFAULT_IDLE_FRAMES = 60;
+
+// a packed stream is a list of blocks, each starts with a header word.
+// header with RUN_FLAG set: one pixel repeated (header & ~RUN_FLAG) times.
+// header without RUN_FLAG: header pixels copied literally.
+const uint32_t RUN_FLAG = 0x80000000;
+const int MIN_RUN_LENGTH = 3;
+
+namespace
+{
+	// dst must hold count + 1 words, a run never costs more than the pixels it replaces
+	// so only the first literal header is extra.
+	int packPixels(const uint32_t* src, int count, uint32_t* dst)
+	{
+		uint32_t* start = dst;
+		uint32_t* literalHeader = nullptr;
+		int i = 0;
+
+		while (i < count)
+		{
+			int run = 1;
+
+			while (i + run < count && src[i + run] == src[i])
+			{
+				++run;
+			}
+
+			if (run >= MIN_RUN_LENGTH)
+			{
+				*dst++ = RUN_FLAG | run;
+				*dst++ = src[i];
+				literalHeader = nullptr;
+			}
+			else
+			{
+				if (nullptr == literalHeader)
+				{
+					literalHeader = dst++;
+					*literalHeader = 0;
+				}
+
+				for (int j = 0; j < run; ++j)
+				{
+					*dst++ = src[i + j];
+				}
+
+				*literalHeader += run;
+			}
+
+			i += run;
+		}
+
+		return (int)(dst - start);
+	}
+
+	void unpackPixels(const uint32_t* src, int srcCount, uint32_t* dst)
+	{
+		const uint32_t* end = src + srcCount;
+
+		while (src < end)
+		{
+			uint32_t header = *src++;
+			int count = (int)(header & ~RUN_FLAG);
+
+			if (header & RUN_FLAG)
+			{
+				sk_memset32(dst, *src++, count);
+			}
+			else
+			{
+				memcpy(dst, src, count * sizeof(uint32_t));
+				src += count;
+			}
+
+			dst += count;
+		}
+	}
+}
+
+class SkiaLayerTile : public SkRefCnt
+{
+public:
+	enum State
+	{
+		kRaw_State,
+		kPacking_State,
+		kPacked_State,
+	};
+
+	SkiaLayerTile(const SkIRect& bounds, int frame)
+		: _bounds(bounds)
+		, _packed(nullptr)
+		, _packedCount(0)
+		, _state(kRaw_State)
+		, _packQueued(false)
+		, _incompressible(false)
+		, _lastDrawnFrame(frame)
+	{
+		_bitmap.setConfig(SkBitmap::kARGB_8888_Config, bounds.width(), bounds.height());
+		_bitmap.allocPixels();
+	}
+
+	virtual ~SkiaLayerTile()
+	{
+		sk_free(_packed);
+	}
+
+	// ui thread, makes the pixels available for drawing.
+	bool prepareDraw(int frame)
+	{
+		SkAutoMutexAcquire lock(_mutex);
+		_lastDrawnFrame = frame;
+
+		if (kPacking_State == _state)
+		{
+			// the worker still reads the pixels, it drops its result when it sees the raw state.
+			_state = kRaw_State;
+			return true;
+		}
+
+		if (kPacked_State == _state)
+		{
+			_bitmap.setConfig(SkBitmap::kARGB_8888_Config, _bounds.width(), _bounds.height());
+
+			if (!_bitmap.allocPixels())
+			{
+				return false;
+			}
+
+			unpackPixels(_packed, _packedCount, _bitmap.getAddr32(0, 0));
+			sk_free(_packed);
+			_packed = nullptr;
+			_packedCount = 0;
+			_state = kRaw_State;
+		}
+
+		return true;
+	}
+
+	// ui thread, returns true when a pack task has to be scheduled.
+	// a draw takes a tile back while it is packed, the tile is not packed again before that task
+	// is done with its pixels.
+	bool schedulePack(int frame, int idleFrames)
+	{
+		SkAutoMutexAcquire lock(_mutex);
+
+		if (kRaw_State != _state || _packQueued || _incompressible || frame - _lastDrawnFrame < idleFrames)
+		{
+			return false;
+		}
+
+		_state = kPacking_State;
+		_packQueued = true;
+		return true;
+	}
+
+	// worker thread.
+	void pack()
+	{
+		const uint32_t* pixels = nullptr;
+		int count = 0;
+
+		{
+			SkAutoMutexAcquire lock(_mutex);
+
+			if (kPacking_State != _state)
+			{
+				_packQueued = false;
+				return;
+			}
+
+			// the pixels stay alive while packing, only the task that reads them releases them.
+			pixels = _bitmap.getAddr32(0, 0);
+			count = _bitmap.width() * _bitmap.height();
+		}
+
+		uint32_t* packed = (uint32_t*)sk_malloc_throw((count + 1) * sizeof(uint32_t));
+		int packedCount = packPixels(pixels, count, packed);
+
+		SkAutoMutexAcquire lock(_mutex);
+		_packQueued = false;
+
+		if (kPacking_State != _state)
+		{
+			sk_free(packed);
+			return;
+		}
+
+		// photos and gradients do not shrink, keep them raw and never try again.
+		if (packedCount * 4 > count * 3)
+		{
+			sk_free(packed);
+			_incompressible = true;
+			_state = kRaw_State;
+			return;
+		}
+
+		_packed = (uint32_t*)sk_realloc_throw(packed, packedCount * sizeof(uint32_t));
+		_packedCount = packedCount;
+		_bitmap.reset();
+		_state = kPacked_State;
+	}
+
+	void getMemory(size_t* rawBytes, size_t* packedBytes)
+	{
+		SkAutoMutexAcquire lock(_mutex);
+
+		if (kPacked_State == _state)
+		{
+			*packedBytes += _packedCount * sizeof(uint32_t);
+		}
+		else
+		{
+			*rawBytes += _bitmap.getSize();
+		}
+	}
+
+public:
+	SkIRect _bounds;
+	SkBitmap _bitmap;
+
+private:
+	uint32_t* _packed;
+	int _packedCount;
+	State _state;
+	bool _packQueued;
+	bool _incompressible;
+	int _lastDrawnFrame;
+	SkMutex _mutex;
+};
+
+class PackTileTask : public SkRunnable
+{
+public:
+	PackTileTask(SkiaLayerTile* tile)
+		: _tile(tile)
+	{
+		_tile->ref();
+	}
+
+	virtual ~PackTileTask()
+	{
+		_tile->unref();
+	}
+
+	virtual void run() override
+	{
+		_tile->pack();
+		delete this;
+	}
+
+private:
+	SkiaLayerTile* _tile;
+};
+
+class SkiaLayerCache::Layer
+{
+public:
+	Layer()
+	{
+
+	}
+
+	~Layer()
+	{
+		releaseTiles();
+	}
+
+	void releaseTiles()
+	{
+		std::vector<SkiaLayerTile*>::iterator iter = _tiles.begin();
+
+		for (; iter != _tiles.end(); ++iter)
+		{
+			(*iter)->unref();
+		}
+
+		_tiles.clear();
+	}
+
+public:
+	KRect _rect;
+	SkBitmap _recordBitmap;
+	std::vector<SkiaLayerTile*> _tiles;
+};
+
+SkiaLayerCache::SkiaLayerCache()
+	: _recordingLayer(nullptr)
+	, _recordingCanvas(nullptr)
+	, _frame(0)
+	, _idleFrames(DEFAULT_IDLE_FRAMES)
+{
+
+}
+
+SkiaLayerCache::~SkiaLayerCache()
+{
+	endLayer();
+	clear();
+}
+
+SkCanvas* SkiaLayerCache::beginLayer(const void* key, const KRect& rect)
+{
+	// nested cached views are drawn straight into the layer being recorded.
+	if (nullptr != _recordingLayer)
+	{
+		return nullptr;
+	}
+
+	if (rect.width() <= 0 || rect.height() <= 0)
+	{
+		return nullptr;
+	}
+
+	Layer* layer = nullptr;
+	MAP_LAYER::iterator iter = _layers.find(key);
+
+	if (iter != _layers.end())
+	{
+		layer = iter->second;
+		layer->releaseTiles();
+	}
+	else
+	{
+		layer = new Layer;
+		_layers.insert(std::make_pair(key, layer));
+	}
+
+	layer->_rect = rect;
+	layer->_recordBitmap.setConfig(SkBitmap::kARGB_8888_Config, rect.width(), rect.height());
+
+	if (!layer->_recordBitmap.allocPixels())
+	{
+		return nullptr;
+	}
+
+	layer->_recordBitmap.eraseColor(0);
+	_recordingLayer = layer;
+	_recordingCanvas = new SkCanvas(layer->_recordBitmap);
+	_recordingCanvas->translate(SkIntToScalar(-rect._left), SkIntToScalar(-rect._top));
+	return _recordingCanvas;
+}
+
+void SkiaLayerCache::endLayer()
+{
+	INVALID_POINTER_RETURN(_recordingLayer);
+
+	if (nullptr != _recordingCanvas)
+	{
+		delete _recordingCanvas;
+		_recordingCanvas = nullptr;
+	}
+
+	splitLayer(_recordingLayer);
+	_recordingLayer = nullptr;
+}
+
+bool SkiaLayerCache::drawLayer(const void* key, SkCanvas* canvas)
+{
+	INVALID_POINTER_RETURN_FALSE(canvas);
+
+	MAP_LAYER::iterator iter = _layers.find(key);
+
+	if (iter == _layers.end() || iter->second->_tiles.empty())
+	{
+		return false;
+	}
+
+	Layer* layer = iter->second;
+	SkRect clipBounds;
+
+	if (!canvas->getClipBounds(&clipBounds))
+	{
+		return true;
+	}
+
+	std::vector<SkiaLayerTile*>::iterator tileIter = layer->_tiles.begin();
+
+	for (; tileIter != layer->_tiles.end(); ++tileIter)
+	{
+		SkiaLayerTile* tile = *tileIter;
+		SkRect tileRect;
+		tileRect.set(tile->_bounds);
+		tileRect.offset(SkIntToScalar(layer->_rect._left), SkIntToScalar(layer->_rect._top));
+
+		// only the tiles touched by the draw are decoded.
+		if (!SkRect::Intersects(tileRect, clipBounds))
+		{
+			continue;
+		}
+
+		if (tile->prepareDraw(_frame))
+		{
+			canvas->drawBitmap(tile->_bitmap, tileRect.fLeft, tileRect.fTop);
+		}
+	}
+
+	return true;
+}
+
+void SkiaLayerCache::removeLayer(const void* key)
+{
+	MAP_LAYER::iterator iter = _layers.find(key);
+
+	if (iter == _layers.end())
+	{
+		return;
+	}
+
+	if (_recordingLayer == iter->second)
+	{
+		return;
+	}
+
+	delete iter->second;
+	_layers.erase(iter);
+}
+
+void SkiaLayerCache::clear()
+{
+	MAP_LAYER::iterator iter = _layers.begin();
+
+	for (; iter != _layers.end(); ++iter)
+	{
+		delete iter->second;
+	}
+
+	_layers.clear();
+}
+
+void SkiaLayerCache::advanceFrame()
+{
+	++_frame;
+
+	MAP_LAYER::iterator iter = _layers.begin();
+
+	for (; iter != _layers.end(); ++iter)
+	{
+		std::vector<SkiaLayerTile*>::iterator tileIter = iter->second->_tiles.begin();
+
+		for (; tileIter != iter->second->_tiles.end(); ++tileIter)
+		{
+			if ((*tileIter)->schedulePack(_frame, _idleFrames))
+			{
+				SkiaWorkerPool::getInstance()->add(new PackTileTask(*tileIter));
+			}
+		}
+	}
+}
+
+void SkiaLayerCache::setIdleFrames(int frames)
+{
+	_idleFrames = frames > 0 ? frames : 1;
+}
+
+void SkiaLayerCache::getMemory(size_t* rawBytes, size_t* packedBytes) const
+{
+	INVALID_POINTER_RETURN(rawBytes);
+	INVALID_POINTER_RETURN(packedBytes);
+
+	*rawBytes = 0;
+	*packedBytes = 0;
+	MAP_LAYER::const_iterator iter = _layers.begin();
+
+	for (; iter != _layers.end(); ++iter)
+	{
+		std::vector<SkiaLayerTile*>::const_iterator tileIter = iter->second->_tiles.begin();
+
+		for (; tileIter != iter->second->_tiles.end(); ++tileIter)
+		{
+			(*tileIter)->getMemory(rawBytes, packedBytes);
+		}
+	}
+}
+
+void SkiaLayerCache::splitLayer(Layer* layer)
+{
+	INVALID_POINTER_RETURN(layer);
+
+	const SkBitmap& source = layer->_recordBitmap;
+	int width = source.width();
+	int height = source.height();
+
+	for (int y = 0; y < height; y += LAYER_TILE_SIZE)
+	{
+		for (int x = 0; x < width; x += LAYER_TILE_SIZE)
+		{
+			SkIRect bounds = SkIRect::MakeXYWH(x, y, SkMin32(LAYER_TILE_SIZE, width - x), SkMin32(LAYER_TILE_SIZE, height - y));
+			SkiaLayerTile* tile = new SkiaLayerTile(bounds, _frame);
+
+			if (nullptr == tile->_bitmap.getPixels())
+			{
+				tile->unref();
+				continue;
+			}
+
+			for (int row = 0; row < bounds.height(); ++row)
+			{
+				memcpy(tile->_bitmap.getAddr32(0, row), source.getAddr32(x, y + row), bounds.width() * sizeof(uint32_t));
+			}
+
+			layer->_tiles.push_back(tile);
+		}
+	}
+
+	layer->_recordBitmap.reset();
+}
\ No newline at end of file
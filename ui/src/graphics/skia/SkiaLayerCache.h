@@ -0,0 +1,45 @@
+#pragma once
+
+#include "KRect.h"
+#include <map>
+#include <vector>
+
+class SkCanvas;
+class SkiaLayerTile;
+
+// caches the rendered content of views as tiled bitmaps.
+// tiles that have not been drawn for a number of frames are run length encoded on
+// the worker pool, and decoded again on demand when a draw intersects them.
+class SkiaLayerCache
+{
+public:
+	SkiaLayerCache();
+	~SkiaLayerCache();
+
+	// returns a canvas that records into the layer of key, positioned at rect.
+	SkCanvas* beginLayer(const void* key, const KRect& rect);
+	void endLayer();
+	bool drawLayer(const void* key, SkCanvas* canvas);
+	void removeLayer(const void* key);
+	void clear();
+
+	// called once per frame, ages the tiles and schedules the compression of idle ones.
+	void advanceFrame();
+	void setIdleFrames(int frames);
+
+	// bytes held by tiles kept as bitmaps and by run length encoded tiles.
+	void getMemory(size_t* rawBytes, size_t* packedBytes) const;
+
+private:
+	class Layer;
+	typedef std::map<const void*, Layer*> MAP_LAYER;
+
+	void splitLayer(Layer* layer);
+
+private:
+	MAP_LAYER _layers;
+	Layer* _recordingLayer;
+	SkCanvas* _recordingCanvas;
+	int _frame;
+	int _idleFrames;
+};
\ No newline at end of file
@@ -0,0 +1,248 @@
+#include "UIDefine.h"
+#include "SkiaMeshRenderer.h"
+#include "SkiaWorkerPool.h"
+#include "SkCanvas.h"
+#include "SkCondVar.h"
+#include "SkDevice.h"
+#include "SkRunnable.h"
+#include "SkShader.h"
+#include "SkThread.h"
+
+// meshes covering fewer pixels are drawn on the calling thread.
+const int MIN_PARALLEL_PIXELS = 256 * 256;
+
+// bands are never thinner than this many rows.
+const int MIN_BAND_ROWS = 32;
+
+// bands per thread, so a thread that is late to start does not hold up the others.
+const int BANDS_PER_THREAD = 2;
+
+namespace
+{
+	// the bands of one mesh, drawn by whichever thread claims them first.
+	// a task that starts after all the bands are claimed only releases its reference,
+	// so the caller waits for the drawing and not for busy workers.
+	class MeshJob : public SkRefCnt
+	{
+	public:
+		MeshJob(const SkMeshRasterizer* rasterizer, const SkBitmap& device, const SkIRect& rows, int bandCount)
+			: _rasterizer(rasterizer)
+			, _device(device)
+			, _rows(rows)
+			, _bandCount(bandCount)
+			, _nextBand(0)
+			, _finishedBands(0)
+		{
+
+		}
+
+		void drawBands()
+		{
+			for (;;)
+			{
+				int band = sk_atomic_inc(&_nextBand);
+
+				if (band >= _bandCount)
+				{
+					return;
+				}
+
+				int top = _rows.fTop + _rows.height() * band / _bandCount;
+				int bottom = _rows.fTop + _rows.height() * (band + 1) / _bandCount;
+				_rasterizer->drawRows(_device, _rows, top, bottom);
+
+				_condVar.lock();
+				++_finishedBands;
+
+				if (_finishedBands == _bandCount)
+				{
+					_condVar.broadcast();
+				}
+
+				_condVar.unlock();
+			}
+		}
+
+		void wait()
+		{
+			_condVar.lock();
+
+			while (_finishedBands < _bandCount)
+			{
+				_condVar.wait();
+			}
+
+			_condVar.unlock();
+		}
+
+	private:
+		const SkMeshRasterizer* _rasterizer;
+		SkBitmap _device;
+		SkIRect _rows;
+		int _bandCount;
+		int32_t _nextBand;
+		int _finishedBands;
+		SkCondVar _condVar;
+	};
+
+	class DrawBandsTask : public SkRunnable
+	{
+	public:
+		DrawBandsTask(MeshJob* job)
+			: _job(job)
+		{
+			_job->ref();
+		}
+
+		virtual ~DrawBandsTask()
+		{
+			_job->unref();
+		}
+
+		virtual void run() override
+		{
+			_job->drawBands();
+			delete this;
+		}
+
+	private:
+		MeshJob* _job;
+	};
+}
+
+SkiaMeshRenderer::SkiaMeshRenderer()
+{
+
+}
+
+SkiaMeshRenderer::~SkiaMeshRenderer()
+{
+
+}
+
+bool SkiaMeshRenderer::drawMesh(SkCanvas* canvas, const SkBitmap& bitmap, const float* vertices, const float* texCoords,
+	int vertexCount, const unsigned short* indices, int indexCount, const SkPaint& paint, bool rasterize)
+{
+	INVALID_POINTER_RETURN_FALSE(canvas);
+	INVALID_POINTER_RETURN_FALSE(vertices);
+	INVALID_POINTER_RETURN_FALSE(texCoords);
+
+	if (vertexCount < 3)
+	{
+		return true;
+	}
+
+	// both paths read the vertices through the indices, one out of range fails the whole mesh.
+	if (nullptr != indices)
+	{
+		bool countValid = indexCount >= 0;
+		VALUE_FALSE_RETURN_FALSE(countValid);
+
+		for (int i = 0; i < indexCount; ++i)
+		{
+			bool indexValid = indices[i] < vertexCount;
+			VALUE_FALSE_RETURN_FALSE(indexValid);
+		}
+	}
+
+	_vertices.resize(vertexCount);
+	_texCoords.resize(vertexCount);
+
+	for (int i = 0; i < vertexCount; ++i)
+	{
+		_vertices[i].set(SkFloatToScalar(vertices[i * 2]), SkFloatToScalar(vertices[i * 2 + 1]));
+		_texCoords[i].set(SkFloatToScalar(texCoords[i * 2]), SkFloatToScalar(texCoords[i * 2 + 1]));
+	}
+
+	if (rasterize && rasterizeMesh(canvas, bitmap, indices, indexCount, paint))
+	{
+		return true;
+	}
+
+	SkPaint meshPaint(paint);
+	SkShader* shader = SkShader::CreateBitmapShader(bitmap, SkShader::kClamp_TileMode, SkShader::kClamp_TileMode);
+	meshPaint.setShader(shader)->unref();
+	canvas->drawVertices(SkCanvas::kTriangles_VertexMode, vertexCount, &_vertices[0], &_texCoords[0],
+		nullptr, nullptr, indices, nullptr == indices ? 0 : indexCount, meshPaint);
+	return true;
+}
+
+bool SkiaMeshRenderer::rasterizeMesh(SkCanvas* canvas, const SkBitmap& bitmap, const unsigned short* indices, int indexCount,
+	const SkPaint& paint)
+{
+	// the rasterizer only blends src over, and only clips to a rect.
+	bool plainPaint = nullptr == paint.getShader() && nullptr == paint.getColorFilter() &&
+		nullptr == paint.getXfermode() && nullptr == paint.getMaskFilter() && nullptr == paint.getLooper() &&
+		nullptr == canvas->getDrawFilter();
+	VALUE_FALSE_RETURN_FALSE(plainPaint);
+
+	SkCanvas::ClipType clipType = canvas->getClipType();
+
+	if (SkCanvas::kEmpty_ClipType == clipType)
+	{
+		return true;
+	}
+
+	bool rectClip = SkCanvas::kRect_ClipType == clipType;
+	VALUE_FALSE_RETURN_FALSE(rectClip);
+
+	// picture and pdf canvases have no pixels.
+	SkDevice* device = canvas->getTopDevice();
+	INVALID_POINTER_RETURN_FALSE(device);
+	const SkBitmap& deviceBitmap = device->accessBitmap(true);
+	bool rasterDevice = SkBitmap::kARGB_8888_Config == deviceBitmap.config();
+	VALUE_FALSE_RETURN_FALSE(rasterDevice);
+	INVALID_POINTER_RETURN_FALSE(deviceBitmap.getPixels());
+
+	// the matrix and the clip are in the coordinates of the bottom device, a layer is offset.
+	const SkIPoint& origin = device->getOrigin();
+	SkMatrix matrix = canvas->getTotalMatrix();
+	matrix.postTranslate(SkIntToScalar(-origin.fX), SkIntToScalar(-origin.fY));
+
+	SkIRect clip;
+	canvas->getClipDeviceBounds(&clip);
+	clip.offset(-origin.fX, -origin.fY);
+
+	if (!clip.intersect(0, 0, deviceBitmap.width(), deviceBitmap.height()))
+	{
+		return true;
+	}
+
+	VALUE_FALSE_RETURN_FALSE(_rasterizer.setMesh(bitmap, matrix, &_vertices[0], &_texCoords[0],
+		(int)_vertices.size(), indices, indexCount));
+	_rasterizer.setAlpha(paint.getAlpha());
+	_rasterizer.setFilterBitmap(paint.isFilterBitmap());
+
+	SkIRect rows = clip;
+
+	if (!rows.intersect(_rasterizer.getBounds()))
+	{
+		return true;
+	}
+
+	int threadCount = SkiaWorkerPool::getInstance()->getThreadCount();
+	int bandCount = SkMin32((threadCount + 1) * BANDS_PER_THREAD, rows.height() / MIN_BAND_ROWS);
+
+	if (rows.width() * rows.height() < MIN_PARALLEL_PIXELS || bandCount < 2)
+	{
+		_rasterizer.draw(deviceBitmap, clip);
+		return true;
+	}
+
+	// the bands are whole rows of the clip, each one only writes its own pixels.
+	rows.fLeft = clip.fLeft;
+	rows.fRight = clip.fRight;
+
+	MeshJob* job = new MeshJob(&_rasterizer, deviceBitmap, rows, bandCount);
+	int taskCount = SkMin32(threadCount, bandCount - 1);
+
+	for (int i = 0; i < taskCount; ++i)
+	{
+		SkiaWorkerPool::getInstance()->add(new DrawBandsTask(job));
+	}
+
+	job->drawBands();
+	job->wait();
+	job->unref();
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "SkMeshRasterizer.h"
+#include "SkPoint.h"
+#include <vector>
+
+class SkCanvas;
+class SkPaint;
+
+// draws textured triangle meshes, the warps and page curls of Canvas::drawMesh.
+// meshes drawn into a raster canvas clipped to a rect are rasterized directly, large ones
+// in bands of rows shared between the worker pool and the calling thread.
+// anything else is drawn with SkCanvas::drawVertices.
+class SkiaMeshRenderer
+{
+public:
+	SkiaMeshRenderer();
+	~SkiaMeshRenderer();
+
+	// vertices and texCoords are x, y pairs, indices may be null to draw every three vertices.
+	// fails without drawing when an index is past the vertices.
+	// rasterize is false when the canvas is also drawn by something the rasterizer would skip.
+	bool drawMesh(SkCanvas* canvas, const SkBitmap& bitmap, const float* vertices, const float* texCoords,
+		int vertexCount, const unsigned short* indices, int indexCount, const SkPaint& paint, bool rasterize);
+
+private:
+	bool rasterizeMesh(SkCanvas* canvas, const SkBitmap& bitmap, const unsigned short* indices, int indexCount,
+		const SkPaint& paint);
+
+private:
+	SkMeshRasterizer _rasterizer;
+
+	// reused between calls so a mesh animated every frame does not reallocate.
+	std::vector<SkPoint> _vertices;
+	std::vector<SkPoint> _texCoords;
+};
\ No newline at end of file
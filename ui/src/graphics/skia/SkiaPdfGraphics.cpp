@@ -0,0 +1,164 @@
+#include "UIDefine.h"
+#include "SkiaPdfGraphics.h"
+#include "SkCanvas.h"
+#include "SkPDFDevice.h"
+#include "SkPDFDocument.h"
+#include "SkStream.h"
+#include <stdio.h>
+
+namespace
+{
+	// pdf pages are measured in points, 72 per inch.
+	const SkScalar kPointsPerPixel = SkFloatToScalar(72.0f / 96.0f);
+
+	// images are embedded at no more than this resolution for the size they are printed at.
+	const SkScalar kImageDpi = SkIntToScalar(300);
+
+	// SkFILEWStream only takes narrow paths.
+	class FileWStream : public SkWStream
+	{
+	public:
+		explicit FileWStream(const KString& path)
+		{
+#ifdef _WIN32
+			_file = _wfopen(path.c_str(), L"wb");
+#else
+			_file = fopen(path.getUtf8(), "wb");
+#endif
+		}
+
+		virtual ~FileWStream()
+		{
+			if (nullptr != _file)
+			{
+				fclose(_file);
+				_file = nullptr;
+			}
+		}
+
+		bool isValid() const
+		{
+			return nullptr != _file;
+		}
+
+		virtual bool write(const void* buffer, size_t size) override
+		{
+			return nullptr != _file && fwrite(buffer, 1, size, _file) == size;
+		}
+
+		virtual void flush() override
+		{
+			if (nullptr != _file)
+			{
+				fflush(_file);
+			}
+		}
+
+	private:
+		FILE* _file;
+	};
+}
+
+class SkiaPdfGraphicsDelegate
+{
+public:
+	SkiaPdfGraphicsDelegate()
+		: _document(new SkPDFDocument)
+		, _page(nullptr)
+	{
+
+	}
+
+	~SkiaPdfGraphicsDelegate()
+	{
+		SkSafeUnref(_page);
+		_page = nullptr;
+
+		if (nullptr != _document)
+		{
+			delete _document;
+			_document = nullptr;
+		}
+	}
+
+public:
+	SkPDFDocument* _document;
+
+	// the page being drawn, it is added to the document once it is done.
+	SkPDFDevice* _page;
+};
+
+SkiaPdfGraphics::SkiaPdfGraphics(int width, int height)
+	: SkiaGraphics(width, height, nullptr)
+{
+	_pdfGraphicsDelegate = new SkiaPdfGraphicsDelegate;
+	startPage();
+}
+
+SkiaPdfGraphics::~SkiaPdfGraphics()
+{
+	if (nullptr != _pdfGraphicsDelegate)
+	{
+		delete _pdfGraphicsDelegate;
+		_pdfGraphicsDelegate = nullptr;
+	}
+}
+
+void* SkiaPdfGraphics::lockBits()
+{
+	return nullptr;
+}
+
+bool SkiaPdfGraphics::beginCacheLayer(const void* key, const KRect& rect)
+{
+	// layers are bitmaps, views draw directly so the page keeps their vectors.
+	return false;
+}
+
+bool SkiaPdfGraphics::newPage()
+{
+	INVALID_POINTER_RETURN_FALSE(_pdfGraphicsDelegate);
+	INVALID_POINTER_RETURN_FALSE(_pdfGraphicsDelegate->_page);
+	VALUE_FALSE_RETURN_FALSE(_pdfGraphicsDelegate->_document->appendPage(_pdfGraphicsDelegate->_page));
+	startPage();
+	return true;
+}
+
+bool SkiaPdfGraphics::saveDocument(const KString& path)
+{
+	INVALID_POINTER_RETURN_FALSE(_pdfGraphicsDelegate);
+	INVALID_POINTER_RETURN_FALSE(_pdfGraphicsDelegate->_page);
+
+	FileWStream stream(path);
+	VALUE_FALSE_RETURN_FALSE(stream.isValid());
+
+	// a document refusing the page has been emitted already, it is not written again.
+	bool saved = _pdfGraphicsDelegate->_document->appendPage(_pdfGraphicsDelegate->_page) &&
+		_pdfGraphicsDelegate->_document->emitPDF(&stream);
+
+	// a document is emitted only once, drawing from now on goes to a new one.
+	delete _pdfGraphicsDelegate->_document;
+	_pdfGraphicsDelegate->_document = new SkPDFDocument;
+	startPage();
+	return saved;
+}
+
+void SkiaPdfGraphics::startPage()
+{
+	INVALID_POINTER_RETURN(_pdfGraphicsDelegate);
+
+	SkMatrix initialTransform;
+	initialTransform.setScale(kPointsPerPixel, kPointsPerPixel);
+	SkISize pageSize = SkISize::Make(SkScalarCeilToInt(SkIntToScalar(_width) * kPointsPerPixel),
+		SkScalarCeilToInt(SkIntToScalar(_height) * kPointsPerPixel));
+
+	SkPDFDevice* page = new SkPDFDevice(pageSize, pageSize, initialTransform);
+	// the images are downsampled on threads of the document, which stop when it is deleted.
+	page->setImageDownsampleDpi(kImageDpi, _pdfGraphicsDelegate->_document->getImagePool());
+
+	SkSafeUnref(_pdfGraphicsDelegate->_page);
+	_pdfGraphicsDelegate->_page = page;
+
+	// the canvas takes its own reference to the page.
+	setSkiaCanvas(new SkCanvas(page));
+}
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "SkiaGraphics.h"
+
+class SkiaPdfGraphicsDelegate;
+
+// draws into the pages of a pdf document, paths and text stay vectors and
+// fonts are embedded as subsets of the glyphs used.
+// width and height are in pixels, a pixel is printed at 1/96 inch.
+class SkiaPdfGraphics : public SkiaGraphics
+{
+public:
+	SkiaPdfGraphics(int width, int height);
+	virtual ~SkiaPdfGraphics();
+
+	// Graphics
+	virtual void* lockBits() override;
+	virtual bool beginCacheLayer(const void* key, const KRect& rect) override;
+	virtual bool newPage() override;
+	virtual bool saveDocument(const KString& path) override;
+
+private:
+	void startPage();
+
+private:
+	SkiaPdfGraphicsDelegate* _pdfGraphicsDelegate;
+};
\ No newline at end of file
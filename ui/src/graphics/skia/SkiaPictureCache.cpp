@@ -0,0 +1,85 @@
+#include "UIDefine.h"
+#include "SkiaPictureCache.h"
+#include "SkPicture.h"
+#include "SkCanvas.h"
+#include "MemoryTracker.h"
+
+SkiaPictureCache::SkiaPictureCache()
+	: _recordingPicture(nullptr)
+{
+
+}
+
+SkiaPictureCache::~SkiaPictureCache()
+{
+	endPicture();
+	clear();
+}
+
+SkCanvas* SkiaPictureCache::beginPicture(const void* key, int width, int height)
+{
+	if (nullptr != _recordingPicture || width <= 0 || height <= 0)
+	{
+		return nullptr;
+	}
+
+	removePicture(key);
+
+	SkPicture* picture = new SkPicture;
+	_pictures.insert(std::make_pair(key, picture));
+	_recordingPicture = picture;
+
+	// the r-tree is bulk loaded when recording ends, playback then walks the
+	// SkPictureStateTree so skipped ops keep the right save/restore state.
+	return picture->beginRecording(width, height, SkPicture::kOptimizeForClippedPlayback_RecordingFlag);
+}
+
+void SkiaPictureCache::endPicture()
+{
+	INVALID_POINTER_RETURN(_recordingPicture);
+	_recordingPicture->endRecording();
+	MemoryTracker::getInstance()->add(ak::kMemoryPictures, nullptr, _recordingPicture->approximateBytesUsed());
+	_recordingPicture = nullptr;
+}
+
+bool SkiaPictureCache::drawPicture(const void* key, SkCanvas* canvas)
+{
+	INVALID_POINTER_RETURN_FALSE(canvas);
+
+	MAP_PICTURE::iterator iter = _pictures.find(key);
+
+	if (iter == _pictures.end() || iter->second == _recordingPicture)
+	{
+		return false;
+	}
+
+	canvas->drawPicture(*iter->second);
+	return true;
+}
+
+void SkiaPictureCache::removePicture(const void* key)
+{
+	MAP_PICTURE::iterator iter = _pictures.find(key);
+
+	if (iter == _pictures.end() || iter->second == _recordingPicture)
+	{
+		return;
+	}
+
+	MemoryTracker::getInstance()->remove(ak::kMemoryPictures, nullptr, iter->second->approximateBytesUsed());
+	iter->second->unref();
+	_pictures.erase(iter);
+}
+
+void SkiaPictureCache::clear()
+{
+	MAP_PICTURE::iterator iter = _pictures.begin();
+
+	for (; iter != _pictures.end(); ++iter)
+	{
+		MemoryTracker::getInstance()->remove(ak::kMemoryPictures, nullptr, iter->second->approximateBytesUsed());
+		iter->second->unref();
+	}
+
+	_pictures.clear();
+}
\ No newline at end of file
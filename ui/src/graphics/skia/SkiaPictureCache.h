@@ -0,0 +1,28 @@
+#pragma once
+
+#include <map>
+
+class SkCanvas;
+class SkPicture;
+
+// keeps the drawing of views as display lists recorded with a bounding box hierarchy,
+// playback only replays the ops that intersect the clip of the target canvas.
+class SkiaPictureCache
+{
+public:
+	SkiaPictureCache();
+	~SkiaPictureCache();
+
+	// the picture is recorded in canvas coordinates, width and height are the canvas size.
+	SkCanvas* beginPicture(const void* key, int width, int height);
+	void endPicture();
+	bool drawPicture(const void* key, SkCanvas* canvas);
+	void removePicture(const void* key);
+	void clear();
+
+private:
+	typedef std::map<const void*, SkPicture*> MAP_PICTURE;
+
+	MAP_PICTURE _pictures;
+	SkPicture* _recordingPicture;
+};
\ No newline at end of file
@@ -0,0 +1,492 @@
+#include "UIDefine.h"
+#include "SkiaTileImageCache.h"
+#include "SkiaWorkerPool.h"
+#include "TileImageSource.h"
+#include "MemoryTracker.h"
+#include "SkCanvas.h"
+#include "SkBitmap.h"
+#include "SkImageDecoder.h"
+#include "SkRefCnt.h"
+#include "SkThread.h"
+#include "SkRunnable.h"
+#include <math.h>
+#include <vector>
+#include <algorithm>
+
+const size_t DEFAULT_TILE_BUDGET = 64 * 1024 * 1024;
+
+// the tiles still loading, and the images that got a tile since the ui thread last looked.
+// it outlives the cache while a worker holds a tile.
+class SkiaTileLandings : public SkRefCnt
+{
+public:
+	SkiaTileLandings()
+		: _loading(0)
+	{
+
+	}
+
+	void startLoad()
+	{
+		SkAutoMutexAcquire lock(_mutex);
+		++_loading;
+	}
+
+	// worker thread.
+	void endLoad(const void* image, bool landed)
+	{
+		SkAutoMutexAcquire lock(_mutex);
+		--_loading;
+
+		if (landed && _images.end() == std::find(_images.begin(), _images.end(), image))
+		{
+			_images.push_back(image);
+		}
+	}
+
+	const void* take()
+	{
+		SkAutoMutexAcquire lock(_mutex);
+
+		if (_images.empty())
+		{
+			return nullptr;
+		}
+
+		const void* image = _images.back();
+		_images.pop_back();
+		return image;
+	}
+
+	void forget(const void* image)
+	{
+		SkAutoMutexAcquire lock(_mutex);
+		_images.erase(std::remove(_images.begin(), _images.end(), image), _images.end());
+	}
+
+	bool isLoading()
+	{
+		SkAutoMutexAcquire lock(_mutex);
+		return _loading > 0;
+	}
+
+private:
+	std::vector<const void*> _images;
+	int _loading;
+	SkMutex _mutex;
+};
+
+class SkiaImageTile : public SkRefCnt
+{
+public:
+	enum State
+	{
+		kLoading_State,
+		kReady_State,
+		kFailed_State,
+	};
+
+	SkiaImageTile(const void* image, size_t bytes, int frame, SkiaTileLandings* landings)
+		: _bytes(bytes)
+		, _lastDrawnFrame(frame)
+		, _image(image)
+		, _landings(landings)
+		, _state(kLoading_State)
+		, _cancelled(false)
+	{
+		_landings->ref();
+		_landings->startLoad();
+	}
+
+	virtual ~SkiaImageTile()
+	{
+		_landings->unref();
+	}
+
+	// worker thread.
+	void load(const std::string& path)
+	{
+		{
+			SkAutoMutexAcquire lock(_mutex);
+
+			// dropped from the cache before a worker got to it.
+			if (_cancelled)
+			{
+				_landings->endLoad(_image, false);
+				return;
+			}
+		}
+
+		SkBitmap bitmap;
+		bool decoded = SkImageDecoder::DecodeFile(path.c_str(), &bitmap, SkBitmap::kARGB_8888_Config, SkImageDecoder::kDecodePixels_Mode);
+
+		SkAutoMutexAcquire lock(_mutex);
+
+		if (decoded)
+		{
+			// the ui thread only reads the bitmap once it sees the ready state.
+			_bitmap.swap(bitmap);
+			_state = kReady_State;
+		}
+		else
+		{
+			_state = kFailed_State;
+		}
+
+		// a failed tile is drawn from a coarser one as before, nothing to repaint.
+		_landings->endLoad(_image, decoded && !_cancelled);
+	}
+
+	State getState()
+	{
+		SkAutoMutexAcquire lock(_mutex);
+		return _state;
+	}
+
+	void cancel()
+	{
+		SkAutoMutexAcquire lock(_mutex);
+		_cancelled = true;
+	}
+
+public:
+	SkBitmap _bitmap;
+	size_t _bytes;
+	int _lastDrawnFrame;
+
+private:
+	const void* _image;
+	SkiaTileLandings* _landings;
+	State _state;
+	bool _cancelled;
+	SkMutex _mutex;
+};
+
+class LoadTileTask : public SkRunnable
+{
+public:
+	LoadTileTask(SkiaImageTile* tile, const std::string& path)
+		: _tile(tile)
+		, _path(path)
+	{
+		_tile->ref();
+	}
+
+	virtual ~LoadTileTask()
+	{
+		_tile->unref();
+	}
+
+	virtual void run() override
+	{
+		_tile->load(_path);
+		delete this;
+	}
+
+private:
+	SkiaImageTile* _tile;
+	std::string _path;
+};
+
+bool SkiaTileImageCache::TileKey::operator < (const TileKey& key) const
+{
+	if (_image != key._image)
+	{
+		return _image < key._image;
+	}
+
+	if (_level != key._level)
+	{
+		return _level < key._level;
+	}
+
+	if (_row != key._row)
+	{
+		return _row < key._row;
+	}
+
+	return _column < key._column;
+}
+
+SkiaTileImageCache::SkiaTileImageCache()
+	: _landings(new SkiaTileLandings)
+	, _budget(DEFAULT_TILE_BUDGET)
+	, _memory(0)
+	, _frame(0)
+	, _loadsThisFrame(0)
+{
+
+}
+
+SkiaTileImageCache::~SkiaTileImageCache()
+{
+	clear();
+	_landings->unref();
+}
+
+bool SkiaTileImageCache::drawImage(const void* key, const TileImageSource& source, const KRect& rect,
+	float zoom, float originX, float originY, SkCanvas* canvas, bool* pending)
+{
+	INVALID_POINTER_RETURN_FALSE(canvas);
+	VALUE_FALSE_RETURN_FALSE(source.isValid());
+
+	if (zoom <= 0)
+	{
+		return false;
+	}
+
+	// the same view pointed at another pyramid, its old tiles are of no use.
+	MAP_SOURCE::iterator sourceIter = _sources.find(key);
+
+	if (sourceIter != _sources.end() && sourceIter->second != source.getDirectory())
+	{
+		removeImage(key);
+		sourceIter = _sources.end();
+	}
+
+	if (sourceIter == _sources.end())
+	{
+		_sources.insert(std::make_pair(key, source.getDirectory()));
+	}
+
+	SkRect clipBounds;
+
+	if (!canvas->getClipBounds(&clipBounds))
+	{
+		return true;
+	}
+
+	SkRect viewRect = SkRect::MakeLTRB(SkIntToScalar(rect._left), SkIntToScalar(rect._top), SkIntToScalar(rect._right), SkIntToScalar(rect._bottom));
+
+	if (!clipBounds.intersect(viewRect))
+	{
+		return true;
+	}
+
+	// the sharpest level that is not finer than the screen, at most 2x oversampled.
+	int topLevel = source.getLevelCount() - 1;
+	int level = zoom >= 1 ? 0 : (int)floor(log(1 / zoom) / log(2.0));
+	level = level < topLevel ? level : topLevel;
+
+	int tileSize = source.getTileSize();
+	float levelScale = (float)(1 << level);
+	float tileExtent = tileSize * levelScale;
+
+	// visible area in image pixels.
+	float imageLeft = originX + (clipBounds.fLeft - rect._left) / zoom;
+	float imageTop = originY + (clipBounds.fTop - rect._top) / zoom;
+	float imageRight = originX + (clipBounds.fRight - rect._left) / zoom;
+	float imageBottom = originY + (clipBounds.fBottom - rect._top) / zoom;
+
+	int firstColumn = (int)floor(imageLeft / tileExtent);
+	int firstRow = (int)floor(imageTop / tileExtent);
+	int lastColumn = (int)floor(imageRight / tileExtent);
+	int lastRow = (int)floor(imageBottom / tileExtent);
+	firstColumn = firstColumn > 0 ? firstColumn : 0;
+	firstRow = firstRow > 0 ? firstRow : 0;
+	lastColumn = lastColumn < source.getColumnCount(level) - 1 ? lastColumn : source.getColumnCount(level) - 1;
+	lastRow = lastRow < source.getRowCount(level) - 1 ? lastRow : source.getRowCount(level) - 1;
+
+	// the single tile of the top level backs every other one, keep it around.
+	TileKey topKey = { key, topLevel, 0, 0 };
+	requestTile(topKey, source);
+
+	SkPaint paint;
+	paint.setFilterBitmap(true);
+	bool sharp = true;
+
+	for (int row = firstRow; row <= lastRow; ++row)
+	{
+		for (int column = firstColumn; column <= lastColumn; ++column)
+		{
+			// image area of the tile, clipped to the image.
+			float tileLeft = column * tileExtent;
+			float tileTop = row * tileExtent;
+			float tileRight = tileLeft + tileExtent < source.width() ? tileLeft + tileExtent : source.width();
+			float tileBottom = tileTop + tileExtent < source.height() ? tileTop + tileExtent : source.height();
+			SkRect dstRect = SkRect::MakeLTRB(rect._left + (tileLeft - originX) * zoom, rect._top + (tileTop - originY) * zoom,
+				rect._left + (tileRight - originX) * zoom, rect._top + (tileBottom - originY) * zoom);
+
+			TileKey tileKey = { key, level, column, row };
+			requestTile(tileKey, source);
+
+			// the tile itself, or the closest coarser one scaled up while it loads.
+			for (int coarseLevel = level; coarseLevel <= topLevel; ++coarseLevel)
+			{
+				int shift = coarseLevel - level;
+				TileKey coarseKey = { key, coarseLevel, column >> shift, row >> shift };
+				SkiaImageTile* tile = findTile(coarseKey);
+				SkiaImageTile::State state = nullptr != tile ? tile->getState() : SkiaImageTile::kLoading_State;
+
+				if (SkiaImageTile::kReady_State != state)
+				{
+					// a tile missing on disk is not worth another frame.
+					if (SkiaImageTile::kLoading_State == state && coarseLevel == level)
+					{
+						sharp = false;
+					}
+
+					continue;
+				}
+
+				float coarseScale = (float)(1 << coarseLevel);
+				float coarseLeft = coarseKey._column * tileSize * coarseScale;
+				float coarseTop = coarseKey._row * tileSize * coarseScale;
+				SkRect srcRect = SkRect::MakeLTRB((tileLeft - coarseLeft) / coarseScale, (tileTop - coarseTop) / coarseScale,
+					(tileRight - coarseLeft) / coarseScale, (tileBottom - coarseTop) / coarseScale);
+				SkRect bitmapRect = SkRect::MakeWH(SkIntToScalar(tile->_bitmap.width()), SkIntToScalar(tile->_bitmap.height()));
+
+				if (srcRect.intersect(bitmapRect))
+				{
+					canvas->drawBitmapRectToRect(tile->_bitmap, &srcRect, dstRect, &paint);
+				}
+
+				break;
+			}
+		}
+	}
+
+	trim();
+
+	if (nullptr != pending)
+	{
+		*pending = !sharp;
+	}
+
+	return true;
+}
+
+void SkiaTileImageCache::removeImage(const void* key)
+{
+	TileKey firstKey = { key, 0, 0, 0 };
+	MAP_TILE::iterator iter = _tileMap.lower_bound(firstKey);
+
+	while (iter != _tileMap.end() && iter->first._image == key)
+	{
+		MAP_TILE::iterator next = iter;
+		++next;
+		removeTile(iter);
+		iter = next;
+	}
+
+	_sources.erase(key);
+	_landings->forget(key);
+}
+
+void SkiaTileImageCache::clear()
+{
+	while (!_tileMap.empty())
+	{
+		removeTile(_tileMap.begin());
+	}
+
+	_sources.clear();
+
+	while (nullptr != _landings->take())
+	{
+	}
+}
+
+const void* SkiaTileImageCache::takeLoadedImage()
+{
+	return _landings->take();
+}
+
+bool SkiaTileImageCache::isLoading() const
+{
+	return _landings->isLoading();
+}
+
+void SkiaTileImageCache::advanceFrame()
+{
+	++_frame;
+	_loadsThisFrame = 0;
+}
+
+void SkiaTileImageCache::setBudget(size_t bytes)
+{
+	_budget = bytes;
+	trim();
+}
+
+size_t SkiaTileImageCache::getMemory() const
+{
+	return _memory;
+}
+
+SkiaImageTile* SkiaTileImageCache::findTile(const TileKey& key)
+{
+	MAP_TILE::iterator iter = _tileMap.find(key);
+
+	if (iter == _tileMap.end())
+	{
+		return nullptr;
+	}
+
+	SkiaImageTile* tile = iter->second->second;
+	tile->_lastDrawnFrame = _frame;
+	_tiles.splice(_tiles.begin(), _tiles, iter->second);
+	return tile;
+}
+
+SkiaImageTile* SkiaTileImageCache::requestTile(const TileKey& key, const TileImageSource& source)
+{
+	SkiaImageTile* tile = findTile(key);
+
+	if (nullptr != tile)
+	{
+		return tile;
+	}
+
+	// a fast pan must not queue every tile it crosses, the rest is asked for on later frames.
+	if (_loadsThisFrame >= SkiaWorkerPool::getInstance()->getThreadCount() * 2)
+	{
+		return nullptr;
+	}
+
+	// budgeted at full tile size, edge tiles are smaller.
+	size_t bytes = (size_t)source.getTileSize() * source.getTileSize() * 4;
+	tile = new SkiaImageTile(key._image, bytes, _frame, _landings);
+	_tiles.push_front(std::make_pair(key, tile));
+	_tileMap.insert(std::make_pair(key, _tiles.begin()));
+	_memory += bytes;
+	++_loadsThisFrame;
+	MemoryTracker::getInstance()->add(ak::kMemoryTiles, source.getDirectory().c_str(), bytes);
+
+	SkiaWorkerPool::getInstance()->add(new LoadTileTask(tile, source.getTilePath(key._level, key._column, key._row)));
+	return tile;
+}
+
+void SkiaTileImageCache::removeTile(MAP_TILE::iterator iter)
+{
+	SkiaImageTile* tile = iter->second->second;
+	_memory -= tile->_bytes;
+
+	MAP_SOURCE::iterator sourceIter = _sources.find(iter->first._image);
+
+	if (sourceIter != _sources.end())
+	{
+		MemoryTracker::getInstance()->remove(ak::kMemoryTiles, sourceIter->second.c_str(), tile->_bytes);
+	}
+
+	_tiles.erase(iter->second);
+	_tileMap.erase(iter);
+	tile->cancel();
+	tile->unref();
+}
+
+void SkiaTileImageCache::trim()
+{
+	while (_memory > _budget && !_tiles.empty())
+	{
+		SkiaImageTile* tile = _tiles.back().second;
+
+		// everything left is on screen, going over the budget beats flickering.
+		if (tile->_lastDrawnFrame == _frame)
+		{
+			break;
+		}
+
+		removeTile(_tileMap.find(_tiles.back().first));
+	}
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "KRect.h"
+#include <map>
+#include <list>
+#include <string>
+
+class SkCanvas;
+class SkiaImageTile;
+class SkiaTileLandings;
+class TileImageSource;
+
+// tiles of deep zoom images. only the tiles a draw needs are decoded, on the worker pool,
+// and the least recently drawn ones are dropped once the cache is over its budget.
+// a tile that is still loading is replaced by the closest coarser level already cached.
+class SkiaTileImageCache
+{
+public:
+	SkiaTileImageCache();
+	~SkiaTileImageCache();
+
+	// draws the part of source seen through rect. zoom is the number of device pixels per image
+	// pixel and (originX, originY) the image point drawn at the top left of rect.
+	// pending is set when some of the tiles drawn were not sharp yet.
+	bool drawImage(const void* key, const TileImageSource& source, const KRect& rect,
+		float zoom, float originX, float originY, SkCanvas* canvas, bool* pending);
+	void removeImage(const void* key);
+	void clear();
+
+	// the key of an image with tiles loaded since it was last drawn, each returned once,
+	// nullptr when there are none. the image should be drawn again to show them.
+	const void* takeLoadedImage();
+
+	// true while tiles are decoding on the worker pool.
+	bool isLoading() const;
+
+	// called once per frame, tiles drawn in the current frame are never dropped.
+	void advanceFrame();
+	void setBudget(size_t bytes);
+	size_t getMemory() const;
+
+private:
+	struct TileKey
+	{
+		const void* _image;
+		int _level;
+		int _column;
+		int _row;
+
+		bool operator < (const TileKey& key) const;
+	};
+
+	typedef std::list<std::pair<TileKey, SkiaImageTile*> > LIST_TILE;
+	typedef std::map<TileKey, LIST_TILE::iterator> MAP_TILE;
+	typedef std::map<const void*, std::string> MAP_SOURCE;
+
+	SkiaImageTile* findTile(const TileKey& key);
+	SkiaImageTile* requestTile(const TileKey& key, const TileImageSource& source);
+	void removeTile(MAP_TILE::iterator iter);
+	void trim();
+
+private:
+	// most recently drawn first.
+	LIST_TILE _tiles;
+	MAP_TILE _tileMap;
+	MAP_SOURCE _sources;
+
+	// shared with the tiles, which report to it from the workers.
+	SkiaTileLandings* _landings;
+	size_t _budget;
+	size_t _memory;
+	int _frame;
+	int _loadsThisFrame;
+};
\ No newline at end of file
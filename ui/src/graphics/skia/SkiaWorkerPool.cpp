@@ -0,0 +1,72 @@
+#include "UIDefine.h"
+#include "SkiaWorkerPool.h"
+#include "SkThreadPool.h"
+#include "SkRunnable.h"
+#include "MemoryTracker.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+// threads are created with the default stack, which reserves this much address space.
+const size_t THREAD_STACK_RESERVE = 1024 * 1024;
+
+namespace
+{
+	int getProcessorCount()
+	{
+#ifdef _WIN32
+		SYSTEM_INFO systemInfo;
+		::GetSystemInfo(&systemInfo);
+		return (int)systemInfo.dwNumberOfProcessors;
+#else
+		return (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+	}
+}
+
+SkiaWorkerPool* SkiaWorkerPool::getInstance()
+{
+	static SkiaWorkerPool workerPool;
+	return &workerPool;
+}
+
+SkiaWorkerPool::SkiaWorkerPool()
+	: _threadPool(nullptr)
+	, _threadCount(0)
+{
+	// keep one core for the ui thread.
+	_threadCount = getProcessorCount() - 1;
+
+	if (_threadCount < 1)
+	{
+		_threadCount = 1;
+	}
+
+	_threadPool = new SkThreadPool(_threadCount);
+	MemoryTracker::getInstance()->add(ak::kMemoryThreadStacks, "skia worker pool", _threadCount * THREAD_STACK_RESERVE);
+}
+
+SkiaWorkerPool::~SkiaWorkerPool()
+{
+	if (nullptr != _threadPool)
+	{
+		delete _threadPool;
+		_threadPool = nullptr;
+		MemoryTracker::getInstance()->remove(ak::kMemoryThreadStacks, "skia worker pool", _threadCount * THREAD_STACK_RESERVE);
+	}
+}
+
+void SkiaWorkerPool::add(SkRunnable* runnable)
+{
+	INVALID_POINTER_RETURN(runnable);
+	INVALID_POINTER_RETURN(_threadPool);
+	_threadPool->add(runnable);
+}
+
+int SkiaWorkerPool::getThreadCount() const
+{
+	return _threadCount;
+}
\ No newline at end of file
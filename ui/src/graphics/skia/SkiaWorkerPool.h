@@ -0,0 +1,23 @@
+#pragma once
+
+class SkRunnable;
+class SkThreadPool;
+
+// process wide worker threads shared by the skia backend.
+// runnables are not owned by the pool, a task deletes itself at the end of run().
+class SkiaWorkerPool
+{
+public:
+	static SkiaWorkerPool* getInstance();
+
+	void add(SkRunnable* runnable);
+	int getThreadCount() const;
+
+private:
+	SkiaWorkerPool();
+	~SkiaWorkerPool();
+
+private:
+	SkThreadPool* _threadPool;
+	int _threadCount;
+};
\ No newline at end of file
@@ -0,0 +1,155 @@
+#include "UIDefine.h"
+#include "SkiaYuvRenderer.h"
+#include "YuvImage.h"
+#include "MemoryTracker.h"
+#include "SkCanvas.h"
+#include "SkDevice.h"
+
+namespace
+{
+	SkYUVConverter::ColorSpace toSkiaColorSpace(ak::YuvColorSpace colorSpace)
+	{
+		switch (colorSpace)
+		{
+		case ak::kYuvRec709:
+			return SkYUVConverter::kRec709_ColorSpace;
+
+		case ak::kYuvJpeg:
+			return SkYUVConverter::kJPEG_ColorSpace;
+
+		default:
+			return SkYUVConverter::kRec601_ColorSpace;
+		}
+	}
+}
+
+SkiaYuvRenderer::SkiaYuvRenderer()
+	: _frameBytes(0)
+{
+
+}
+
+SkiaYuvRenderer::~SkiaYuvRenderer()
+{
+	MemoryTracker::getInstance()->remove(ak::kMemoryImages, "yuv frame", _frameBytes);
+}
+
+bool SkiaYuvRenderer::drawImage(SkCanvas* canvas, YuvImage* image, const SkRect& dst, const SkPaint& paint,
+	bool rasterize)
+{
+	INVALID_POINTER_RETURN_FALSE(canvas);
+	INVALID_POINTER_RETURN_FALSE(image);
+	VALUE_FALSE_RETURN_FALSE(setFrame(image));
+
+	if (dst.isEmpty())
+	{
+		return true;
+	}
+
+	if (rasterize && rasterizeImage(canvas, dst, paint))
+	{
+		return true;
+	}
+
+	VALUE_FALSE_RETURN_FALSE(convertFrame(image->width(), image->height()));
+
+	SkPaint framePaint(paint);
+	framePaint.setFilterBitmap(true);
+	canvas->drawBitmapRect(_frame, dst, &framePaint);
+	return true;
+}
+
+bool SkiaYuvRenderer::setFrame(YuvImage* image)
+{
+	SkYUVConverter::Planes planes;
+	int yRowBytes = 0;
+	int uvRowBytes = 0;
+	planes.fY = image->getPlane(0, &yRowBytes);
+	planes.fU = image->getPlane(1, &uvRowBytes);
+	planes.fV = image->getPlane(2, nullptr);
+	planes.fYRowBytes = yRowBytes;
+	planes.fUVRowBytes = uvRowBytes;
+
+	SkYUVConverter::Format format = ak::kYuvNV12 == image->getFormat() ?
+		SkYUVConverter::kNV12_Format : SkYUVConverter::kI420_Format;
+	return _converter.setFrame(format, toSkiaColorSpace(image->getColorSpace()), image->width(), image->height(),
+		planes);
+}
+
+bool SkiaYuvRenderer::rasterizeImage(SkCanvas* canvas, const SkRect& dst, const SkPaint& paint)
+{
+	// the converter only blends src over, and only clips to a rect.
+	bool plainPaint = nullptr == paint.getShader() && nullptr == paint.getColorFilter() &&
+		nullptr == paint.getXfermode() && nullptr == paint.getMaskFilter() && nullptr == paint.getLooper() &&
+		nullptr == canvas->getDrawFilter();
+	VALUE_FALSE_RETURN_FALSE(plainPaint);
+
+	// scaled and moved only, a rotated or mirrored frame goes through the canvas.
+	const SkMatrix& matrix = canvas->getTotalMatrix();
+	bool scaleTranslate = (matrix.getType() & ~(SkMatrix::kScale_Mask | SkMatrix::kTranslate_Mask)) == 0 &&
+		matrix.getScaleX() > 0 && matrix.getScaleY() > 0;
+	VALUE_FALSE_RETURN_FALSE(scaleTranslate);
+
+	SkCanvas::ClipType clipType = canvas->getClipType();
+
+	if (SkCanvas::kEmpty_ClipType == clipType)
+	{
+		return true;
+	}
+
+	bool rectClip = SkCanvas::kRect_ClipType == clipType;
+	VALUE_FALSE_RETURN_FALSE(rectClip);
+
+	// picture and pdf canvases have no pixels.
+	SkDevice* device = canvas->getTopDevice();
+	INVALID_POINTER_RETURN_FALSE(device);
+	const SkBitmap& deviceBitmap = device->accessBitmap(true);
+	bool rasterDevice = SkBitmap::kARGB_8888_Config == deviceBitmap.config();
+	VALUE_FALSE_RETURN_FALSE(rasterDevice);
+	INVALID_POINTER_RETURN_FALSE(deviceBitmap.getPixels());
+
+	// the matrix and the clip are in the coordinates of the bottom device, a layer is offset.
+	const SkIPoint& origin = device->getOrigin();
+	SkRect mapped;
+	matrix.mapRect(&mapped, dst);
+	SkIRect rect;
+	mapped.round(&rect);
+	rect.offset(-origin.fX, -origin.fY);
+
+	if (rect.isEmpty())
+	{
+		return true;
+	}
+
+	VALUE_FALSE_RETURN_FALSE(_converter.setDstRect(rect));
+	_converter.setAlpha(paint.getAlpha());
+
+	SkIRect clip;
+	canvas->getClipDeviceBounds(&clip);
+	clip.offset(-origin.fX, -origin.fY);
+	_converter.draw(deviceBitmap, clip);
+	return true;
+}
+
+bool SkiaYuvRenderer::convertFrame(int width, int height)
+{
+	if (_frame.width() != width || _frame.height() != height || nullptr == _frame.getPixels())
+	{
+		MemoryTracker::getInstance()->remove(ak::kMemoryImages, "yuv frame", _frameBytes);
+		_frameBytes = 0;
+		_frame.setConfig(SkBitmap::kARGB_8888_Config, width, height);
+		VALUE_FALSE_RETURN_FALSE(_frame.allocPixels());
+		_frame.setIsOpaque(true);
+		_frameBytes = _frame.getSize();
+		MemoryTracker::getInstance()->add(ak::kMemoryImages, "yuv frame", _frameBytes);
+	}
+
+	SkIRect bounds = SkIRect::MakeWH(width, height);
+	VALUE_FALSE_RETURN_FALSE(_converter.setDstRect(bounds));
+	_converter.setAlpha(0xFF);
+	_converter.draw(_frame, bounds);
+
+	// the canvas may keep the bitmap, a picture copies it unless it is immutable.
+	_frame.notifyPixelsChanged();
+	return true;
+}
\ No newline at end of file
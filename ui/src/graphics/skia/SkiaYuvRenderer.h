@@ -0,0 +1,36 @@
+#pragma once
+
+#include "SkBitmap.h"
+#include "SkYUVConverter.h"
+
+class SkCanvas;
+class SkPaint;
+struct SkRect;
+class YuvImage;
+
+// draws YuvImage frames, such as video and camera captures.
+// a frame drawn into a raster canvas clipped to a rect, unrotated, is converted and scaled
+// in one pass straight into the device. anything else is converted into a bitmap reused
+// from frame to frame, then drawn with SkCanvas::drawBitmapRect.
+class SkiaYuvRenderer
+{
+public:
+	SkiaYuvRenderer();
+	~SkiaYuvRenderer();
+
+	// draws image scaled to fill dst, in the coordinates of the canvas.
+	// rasterize is false when the canvas is also drawn by something the converter would skip.
+	bool drawImage(SkCanvas* canvas, YuvImage* image, const SkRect& dst, const SkPaint& paint, bool rasterize);
+
+private:
+	bool setFrame(YuvImage* image);
+	bool rasterizeImage(SkCanvas* canvas, const SkRect& dst, const SkPaint& paint);
+	bool convertFrame(int width, int height);
+
+private:
+	SkYUVConverter _converter;
+
+	// the last frame drawn through the canvas, kept at its size so the next frame does not reallocate.
+	SkBitmap _frame;
+	size_t _frameBytes;
+};
\ No newline at end of file
@@ -1,24 +1,39 @@
-#include "view.h"
+#include "View.h"
 #include "UIDefine.h"
 #include "Canvas.h"
+#include "MemoryTracker.h"
 #include <vector>
+#include <algorithm>
 
 typedef std::vector<View*> VECTOR_VIEW;
 
+const int MAX_OPACITY = 255;
+
 class ViewDelegate
 {
 public:
-    ViewDelegate::ViewDelegate()
+    ViewDelegate()
         : _canvas(nullptr)
         , _isShow(true)
 		, _parent(nullptr)
+		, _layerCached(false)
+		, _pictureCached(false)
+		, _cacheDirty(true)
+		, _opacity(MAX_OPACITY)
+		, _opaqueContent(false)
     {
-
+		MemoryTracker::getInstance()->add(ak::kMemoryViews, nullptr, sizeof(ViewDelegate));
     }
 
-    ViewDelegate::~ViewDelegate()
+    ~ViewDelegate()
     {
+		if (nullptr != _canvas)
+		{
+			delete _canvas;
+			_canvas = nullptr;
+		}
 
+		MemoryTracker::getInstance()->remove(ak::kMemoryViews, nullptr, sizeof(ViewDelegate));
     }
 
 public:
@@ -28,6 +43,11 @@ public:
     VECTOR_VIEW _children;
     bool _isShow;
 	View* _parent;
+	bool _layerCached;
+	bool _pictureCached;
+	bool _cacheDirty;
+	int _opacity;
+	bool _opaqueContent;
 };
 
 View::View()
@@ -37,7 +57,62 @@ View::View()
 
 View::~View()
 {
+	if (nullptr == _viewDelegate)
+	{
+		return;
+	}
+
+	View* root = this;
+
+	while (nullptr != root->getParent())
+	{
+		root = root->getParent();
+	}
+
+	if (root != this)
+	{
+		notifyDestroyed(root);
+	}
 
+	// the parent stops drawing this view, the children are left without one.
+	if (nullptr != _viewDelegate->_parent && nullptr != _viewDelegate->_parent->_viewDelegate)
+	{
+		VECTOR_VIEW& siblings = _viewDelegate->_parent->_viewDelegate->_children;
+		VECTOR_VIEW::iterator iter = std::find(siblings.begin(), siblings.end(), this);
+
+		if (iter != siblings.end())
+		{
+			siblings.erase(iter);
+		}
+	}
+
+	VECTOR_VIEW::iterator iter = _viewDelegate->_children.begin();
+
+	for (; iter != _viewDelegate->_children.end(); ++iter)
+	{
+		if (nullptr != (*iter)->_viewDelegate)
+		{
+			(*iter)->_viewDelegate->_parent = nullptr;
+		}
+	}
+
+	delete _viewDelegate;
+	_viewDelegate = nullptr;
+}
+
+void View::notifyDestroyed(View* root)
+{
+	root->onViewDestroyed(this);
+
+	VECTOR_VIEW::iterator iter = _viewDelegate->_children.begin();
+
+	for (; iter != _viewDelegate->_children.end(); ++iter)
+	{
+		if (nullptr != (*iter)->_viewDelegate)
+		{
+			(*iter)->notifyDestroyed(root);
+		}
+	}
 }
 
 bool View::draw()
@@ -59,7 +134,7 @@ bool View::draw(Canvas& canvas)
     {
         if ((*iter)->isShow())
         {
-            (*iter)->draw(canvas);
+            drawChild(canvas, *iter);
         }
     }
 
@@ -129,9 +204,36 @@ bool View::initCanvas(int canvasType)
     return _viewDelegate->_canvas->init(_viewDelegate->_rect.width(), _viewDelegate->_rect.height(), canvasType);
 }
 
+bool View::initCanvas(void* pixels, int rowBytes)
+{
+	VALUE_FALSE_RETURN_FALSE(isUsedCanvas());
+	INVALID_POINTER_RETURN_FALSE(_viewDelegate);
+
+	if (nullptr != _viewDelegate->_canvas)
+	{
+		delete _viewDelegate->_canvas;
+		_viewDelegate->_canvas = nullptr;
+	}
+
+	_viewDelegate->_canvas = new Canvas;
+	return _viewDelegate->_canvas->init(_viewDelegate->_rect.width(), _viewDelegate->_rect.height(), pixels, rowBytes);
+}
+
+void View::releaseCanvas()
+{
+	INVALID_POINTER_RETURN(_viewDelegate);
+
+	if (nullptr != _viewDelegate->_canvas)
+	{
+		delete _viewDelegate->_canvas;
+		_viewDelegate->_canvas = nullptr;
+	}
+}
+
 void View::schedulePaint(KRect* rect)
 {
 	INVALID_POINTER_RETURN(_viewDelegate);
+	_viewDelegate->_cacheDirty = true;
 	INVALID_POINTER_RETURN(_viewDelegate->_parent);
 
 	if (nullptr == rect)
@@ -155,6 +257,7 @@ void View::setRect(KRect rect)
 {
     INVALID_POINTER_RETURN(_viewDelegate);
     _viewDelegate->_rect = rect;
+	_viewDelegate->_cacheDirty = true;
 }
 
 void View::setParent(View* parent)
@@ -163,4 +266,177 @@ void View::setParent(View* parent)
 	INVALID_POINTER_RETURN(parent);
 
 	_viewDelegate->_parent = parent;
+}
+
+View* View::getParent()
+{
+	INVALID_POINTER_RETURN_NULL(_viewDelegate);
+	return _viewDelegate->_parent;
+}
+
+int View::getChildCount()
+{
+	INVALID_POINTER_RETURN_PARAM(_viewDelegate, 0);
+	return (int)_viewDelegate->_children.size();
+}
+
+View* View::getChildAt(int index)
+{
+	INVALID_POINTER_RETURN_NULL(_viewDelegate);
+
+	if (index < 0 || index >= (int)_viewDelegate->_children.size())
+	{
+		return nullptr;
+	}
+
+	return _viewDelegate->_children[index];
+}
+
+View* View::hitTest(int x, int y)
+{
+	INVALID_POINTER_RETURN_NULL(_viewDelegate);
+
+	if (!_viewDelegate->_isShow || !_viewDelegate->_rect.contains(x, y))
+	{
+		return nullptr;
+	}
+
+	VECTOR_VIEW::reverse_iterator iter = _viewDelegate->_children.rbegin();
+
+	for (; iter != _viewDelegate->_children.rend(); ++iter)
+	{
+		View* hit = (*iter)->hitTest(x, y);
+
+		if (nullptr != hit)
+		{
+			return hit;
+		}
+	}
+
+	return this;
+}
+
+void View::setLayerCached(bool cached)
+{
+	INVALID_POINTER_RETURN(_viewDelegate);
+	_viewDelegate->_layerCached = cached;
+	_viewDelegate->_cacheDirty = true;
+}
+
+bool View::isLayerCached()
+{
+	INVALID_POINTER_RETURN_FALSE(_viewDelegate);
+	return _viewDelegate->_layerCached;
+}
+
+void View::setPictureCached(bool cached)
+{
+	INVALID_POINTER_RETURN(_viewDelegate);
+	_viewDelegate->_pictureCached = cached;
+	_viewDelegate->_cacheDirty = true;
+}
+
+bool View::isPictureCached()
+{
+	INVALID_POINTER_RETURN_FALSE(_viewDelegate);
+	return _viewDelegate->_pictureCached;
+}
+
+void View::setOpacity(int opacity, bool opaqueContent)
+{
+	INVALID_POINTER_RETURN(_viewDelegate);
+	_viewDelegate->_opacity = opacity < 0 ? 0 : (opacity > MAX_OPACITY ? MAX_OPACITY : opacity);
+	_viewDelegate->_opaqueContent = opaqueContent;
+}
+
+int View::getOpacity()
+{
+	INVALID_POINTER_RETURN_PARAM(_viewDelegate, MAX_OPACITY);
+	return _viewDelegate->_opacity;
+}
+
+bool View::drawChild(Canvas& canvas, View* child)
+{
+	INVALID_POINTER_RETURN_FALSE(child);
+	ViewDelegate* childDelegate = child->_viewDelegate;
+	INVALID_POINTER_RETURN_FALSE(childDelegate);
+
+	if (MAX_OPACITY == childDelegate->_opacity)
+	{
+		return drawChildContent(canvas, child);
+	}
+
+	if (0 == childDelegate->_opacity)
+	{
+		return true;
+	}
+
+	// graphics without opacity layers draw the view opaque.
+	bool faded = canvas.beginOpacityLayer(childDelegate->_rect, childDelegate->_opacity, childDelegate->_opaqueContent);
+	bool result = drawChildContent(canvas, child);
+
+	if (faded)
+	{
+		canvas.endOpacityLayer();
+	}
+
+	return result;
+}
+
+bool View::drawChildContent(Canvas& canvas, View* child)
+{
+	ViewDelegate* childDelegate = child->_viewDelegate;
+
+	if (childDelegate->_layerCached)
+	{
+		return drawChildLayer(canvas, child);
+	}
+
+	if (childDelegate->_pictureCached)
+	{
+		return drawChildPicture(canvas, child);
+	}
+
+	return child->draw(canvas);
+}
+
+bool View::drawChildLayer(Canvas& canvas, View* child)
+{
+	ViewDelegate* childDelegate = child->_viewDelegate;
+
+	if (!childDelegate->_cacheDirty && canvas.drawCacheLayer(child))
+	{
+		return true;
+	}
+
+	// graphics without a layer cache, or a layer nested in another one being recorded.
+	if (!canvas.beginCacheLayer(child, childDelegate->_rect))
+	{
+		return child->draw(canvas);
+	}
+
+	child->draw(canvas);
+	canvas.endCacheLayer();
+	childDelegate->_cacheDirty = false;
+	return canvas.drawCacheLayer(child);
+}
+
+bool View::drawChildPicture(Canvas& canvas, View* child)
+{
+	ViewDelegate* childDelegate = child->_viewDelegate;
+
+	if (!childDelegate->_cacheDirty && canvas.drawCachePicture(child))
+	{
+		return true;
+	}
+
+	if (!canvas.beginCachePicture(child))
+	{
+		return child->draw(canvas);
+	}
+
+	child->draw(canvas);
+	canvas.endCachePicture();
+	childDelegate->_cacheDirty = false;
+	return canvas.drawCachePicture(child);
 }
\ No newline at end of file
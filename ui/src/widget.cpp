@@ -1,10 +1,14 @@
+#ifdef _WIN32
+
 #include "UIDefine.h"
-#include "Widget.h"
+#include "widget.h"
 #include "RootView.h"
 #include "KRect.h"
 #include "Size.h"
 #include "Canvas.h"
+#include "eventHandler.h"
 #include <map>
+#include <string.h>
 
 extern HINSTANCE g_hInst;								// ǰʵ
 #define MAX_LOADSTRING 100
@@ -13,14 +17,108 @@ wchar_t szWindowClass[MAX_LOADSTRING] = L"WIDGET";			// 
 
 const int TIME_ID = 1;
 
+// delivers the input queued while the window does not animate, one frame after it arrived.
+const int INPUT_TIME_ID = 2;
+const int INPUT_INTERVAL = 15;
+
+// polls for decoded tiles while tiled images load.
+const int TILE_TIME_ID = 3;
+const int TILE_INTERVAL = 15;
+
 LRESULT CALLBACK	WndProc(HWND, UINT, WPARAM, LPARAM);
 
 std::map<HWND, Widget*> g_mapHwnd2Widget;
 
+void CALLBACK inputTimerProc(HWND hwnd, UINT uMsg, UINT_PTR idEvent, DWORD dwTime);
+void CALLBACK tileTimerProc(HWND hwnd, UINT uMsg, UINT_PTR idEvent, DWORD dwTime);
+
+namespace
+{
+	int keyFlags()
+	{
+		int flags = 0;
+		flags |= ::GetKeyState(VK_SHIFT) < 0 ? ak::kEventShift : 0;
+		flags |= ::GetKeyState(VK_CONTROL) < 0 ? ak::kEventControl : 0;
+		flags |= ::GetKeyState(VK_MENU) < 0 ? ak::kEventAlt : 0;
+		return flags;
+	}
+
+	// the buttons and keys of a mouse message, wParam holds them as they are after it.
+	int mouseFlags(WPARAM wParam)
+	{
+		int flags = ::GetKeyState(VK_MENU) < 0 ? ak::kEventAlt : 0;
+		flags |= 0 != (wParam & MK_LBUTTON) ? ak::kEventLeftButton : 0;
+		flags |= 0 != (wParam & MK_RBUTTON) ? ak::kEventRightButton : 0;
+		flags |= 0 != (wParam & MK_MBUTTON) ? ak::kEventMiddleButton : 0;
+		flags |= 0 != (wParam & MK_SHIFT) ? ak::kEventShift : 0;
+		flags |= 0 != (wParam & MK_CONTROL) ? ak::kEventControl : 0;
+		return flags;
+	}
+
+	bool makeMouseEvent(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam, InputEvent& event)
+	{
+		memset(&event, 0, sizeof(event));
+		event._x = (short)LOWORD(lParam);
+		event._y = (short)HIWORD(lParam);
+		event._flags = mouseFlags(wParam);
+		event._time = ::GetMessageTime();
+
+		switch (message)
+		{
+		case WM_MOUSEMOVE:
+			event._type = ak::kEventMouseMove;
+			break;
+		case WM_LBUTTONDOWN:
+		case WM_RBUTTONDOWN:
+		case WM_MBUTTONDOWN:
+			event._type = ak::kEventMouseDown;
+			break;
+		case WM_LBUTTONUP:
+		case WM_RBUTTONUP:
+		case WM_MBUTTONUP:
+			event._type = ak::kEventMouseUp;
+			break;
+		case WM_MOUSEWHEEL:
+			{
+				// wheel messages are in screen coordinates.
+				POINT pt = {event._x, event._y};
+				::ScreenToClient(hWnd, &pt);
+				event._x = pt.x;
+				event._y = pt.y;
+				event._type = ak::kEventMouseWheel;
+				event._wheelDelta = GET_WHEEL_DELTA_WPARAM(wParam);
+			}
+			return true;
+		default:
+			return false;
+		}
+
+		switch (message)
+		{
+		case WM_LBUTTONDOWN:
+		case WM_LBUTTONUP:
+			event._button = ak::kEventLeftButton;
+			break;
+		case WM_RBUTTONDOWN:
+		case WM_RBUTTONUP:
+			event._button = ak::kEventRightButton;
+			break;
+		case WM_MBUTTONDOWN:
+		case WM_MBUTTONUP:
+			event._button = ak::kEventMiddleButton;
+			break;
+		default:
+			break;
+		}
+
+		return true;
+	}
+}
+
 class WidgetDelegate
 {
 public:
-    WidgetDelegate::WidgetDelegate(int x, int y, int width, int height)
+    WidgetDelegate(int x, int y, int width, int height)
         : _x(x)
         , _y(y)
         , _width(width)
@@ -28,10 +126,13 @@ public:
         , _hwnd(nullptr)
         , _bitmap(nullptr)
         , _bits(nullptr)
+		, _animating(false)
+		, _inputTimer(false)
+		, _tileTimer(false)
     {
     }
 
-    WidgetDelegate::~WidgetDelegate()
+    ~WidgetDelegate()
     {
 
     }
@@ -45,6 +146,25 @@ public:
     HWND _hwnd;
     HBITMAP _bitmap;
     void* _bits;
+
+	EventHandler _eventHandler;
+	bool _animating;
+
+	// the input timer is set, the queued events wait for it or for the next frame.
+	bool _inputTimer;
+	bool _tileTimer;
+
+	void postEvent(const InputEvent& event)
+	{
+		_eventHandler.postEvent(event);
+
+		// animation frames deliver the input themselves.
+		if (!_animating && !_inputTimer)
+		{
+			::SetTimer(_hwnd, INPUT_TIME_ID, INPUT_INTERVAL, inputTimerProc);
+			_inputTimer = true;
+		}
+	}
 };
 
 void CALLBACK timerProc(
@@ -62,6 +182,26 @@ void CALLBACK timerProc(
     }
 }
 
+void CALLBACK inputTimerProc(HWND hwnd, UINT uMsg, UINT_PTR idEvent, DWORD dwTime)
+{
+    std::map<HWND, Widget*>::iterator iter = g_mapHwnd2Widget.find(hwnd);
+
+    if (iter != g_mapHwnd2Widget.end() && nullptr != iter->second)
+    {
+	    iter->second->dispatchEvents();
+    }
+}
+
+void CALLBACK tileTimerProc(HWND hwnd, UINT uMsg, UINT_PTR idEvent, DWORD dwTime)
+{
+    std::map<HWND, Widget*>::iterator iter = g_mapHwnd2Widget.find(hwnd);
+
+    if (iter != g_mapHwnd2Widget.end() && nullptr != iter->second)
+    {
+	    iter->second->updateTiledImages();
+    }
+}
+
 Widget::Widget()
     : _widgetDeleget(nullptr)
 {
@@ -167,13 +307,20 @@ bool Widget::addView(View* view)
 void Widget::startAnimate()
 {
 	INVALID_POINTER_RETURN(_widgetDeleget);
+	_widgetDeleget->_animating = true;
 	::SetTimer(_widgetDeleget->_hwnd, TIME_ID, 15, timerProc);
 }
 
 void Widget::stopAnimate()
 {
 	INVALID_POINTER_RETURN(_widgetDeleget);
+	_widgetDeleget->_animating = false;
 	::KillTimer(_widgetDeleget->_hwnd, TIME_ID);
+
+	if (_widgetDeleget->_eventHandler.hasPendingEvents())
+	{
+		dispatchEvents();
+	}
 }
 
 bool Widget::initCanvas(int canvasType)
@@ -200,8 +347,52 @@ LRESULT Widget::wndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
         break;
 
     case WM_KEYDOWN:
+    case WM_KEYUP:
+        {
+            InputEvent event;
+            memset(&event, 0, sizeof(event));
+            event._type = WM_KEYDOWN == message ? ak::kEventKeyDown : ak::kEventKeyUp;
+            event._flags = keyFlags();
+            event._keyCode = (unsigned long)wParam;
+            event._time = ::GetMessageTime();
+
+            if (nullptr != _widgetDeleget)
+            {
+                _widgetDeleget->postEvent(event);
+            }
+
+            if (WM_KEYDOWN == message)
+            {
+                lResult = processKeyDown(wParam, lParam);
+            }
+        }
+        break;
+
+    case WM_MOUSEMOVE:
+    case WM_LBUTTONDOWN:
+    case WM_LBUTTONUP:
+    case WM_RBUTTONDOWN:
+    case WM_RBUTTONUP:
+    case WM_MBUTTONDOWN:
+    case WM_MBUTTONUP:
+    case WM_MOUSEWHEEL:
         {
-            lResult = processKeyDown(wParam, lParam);
+            InputEvent event;
+
+            if (nullptr != _widgetDeleget && makeMouseEvent(hWnd, message, wParam, lParam, event))
+            {
+                _widgetDeleget->postEvent(event);
+
+                // keeps the moves coming while a button is held outside the window.
+                if (ak::kEventMouseDown == event._type)
+                {
+                    ::SetCapture(hWnd);
+                }
+                else if (ak::kEventMouseUp == event._type && 0 == (event._flags & ak::kEventButtons))
+                {
+                    ::ReleaseCapture();
+                }
+            }
         }
         break;
 
@@ -218,7 +409,14 @@ LRESULT Widget::wndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
         break;
 
     case WM_NCHITTEST:
-        lResult = HTCAPTION;
+        {
+            // the window is dragged by its background, the views get the mouse.
+            POINT pt = {(short)LOWORD(lParam), (short)HIWORD(lParam)};
+            ::ScreenToClient(hWnd, &pt);
+            View* hit = nullptr != _widgetDeleget ? _widgetDeleget->_rootView.hitTest(pt.x, pt.y) : nullptr;
+            bool background = nullptr == hit || hit == &_widgetDeleget->_rootView;
+            lResult = background ? HTCAPTION : HTCLIENT;
+        }
         break;
 
     default:
@@ -305,14 +503,28 @@ LRESULT Widget::processKeyDown(WPARAM wparam, LPARAM lparam)
 
 void Widget::onTimer()
 {
-	drawToWindow();
+	INVALID_POINTER_RETURN(_widgetDeleget);
+
+	// animated views schedule the paints of what they move, a tick draws only those.
+	dispatchEvents();
+
+	if (_widgetDeleget->_rootView.hasDamage())
+	{
+		drawToWindow();
+	}
 }
 
 void Widget::drawToWindow()
 {
 	if (_widgetDeleget)
 	{
+		dispatchEvents();
+
+		// the damage of the paints scheduled so far is drawn below, their WM_PAINT would
+		// draw again. paints scheduled while drawing still get one.
+		::ValidateRect(_widgetDeleget->_hwnd, NULL);
 		_widgetDeleget->_rootView.OnDraw();
+		updateTiledImages();
 		Canvas* canvas = _widgetDeleget->_rootView.getCanvas();
 
 		if (canvas)
@@ -352,8 +564,61 @@ void Widget::drawToWindow()
 	}
 }
 
+void Widget::setDebugOverlay(int overlays)
+{
+	INVALID_POINTER_RETURN(_widgetDeleget);
+	_widgetDeleget->_rootView.setDebugOverlay(overlays);
+}
+
+void Widget::getDebugStats(ak::DebugStats& stats)
+{
+	INVALID_POINTER_RETURN(_widgetDeleget);
+	_widgetDeleget->_rootView.getDebugStats(stats);
+}
+
 void Widget::schedualPaint(const KRect& rect)
 {
 	RECT updateRect = {rect._left, rect._top, rect._right, rect._bottom};
 	::InvalidateRect(_widgetDeleget->_hwnd, &updateRect, FALSE);
-}
\ No newline at end of file
+}
+
+EventHandler* Widget::getEventHandler()
+{
+	INVALID_POINTER_RETURN_NULL(_widgetDeleget);
+	return &_widgetDeleget->_eventHandler;
+}
+
+void Widget::dispatchEvents()
+{
+	INVALID_POINTER_RETURN(_widgetDeleget);
+
+	if (_widgetDeleget->_inputTimer)
+	{
+		::KillTimer(_widgetDeleget->_hwnd, INPUT_TIME_ID);
+		_widgetDeleget->_inputTimer = false;
+	}
+
+	// views handling the events schedule their paints, which the frame after picks up.
+	_widgetDeleget->_eventHandler.dispatchEvents(&_widgetDeleget->_rootView);
+}
+
+void Widget::updateTiledImages()
+{
+	INVALID_POINTER_RETURN(_widgetDeleget);
+
+	// the views painted again get a WM_PAINT, whose frame may start more tiles.
+	bool loading = _widgetDeleget->_rootView.updateTiledImages();
+
+	if (loading && !_widgetDeleget->_tileTimer)
+	{
+		::SetTimer(_widgetDeleget->_hwnd, TILE_TIME_ID, TILE_INTERVAL, tileTimerProc);
+		_widgetDeleget->_tileTimer = true;
+	}
+	else if (!loading && _widgetDeleget->_tileTimer)
+	{
+		::KillTimer(_widgetDeleget->_hwnd, TILE_TIME_ID);
+		_widgetDeleget->_tileTimer = false;
+	}
+}
+
+#endif
\ No newline at end of file
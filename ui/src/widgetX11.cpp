@@ -0,0 +1,892 @@
+#ifndef _WIN32
+
+#include "UIDefine.h"
+#include "widget.h"
+#include "RootView.h"
+#include "KRect.h"
+#include "Canvas.h"
+#include "MemoryTracker.h"
+#include "eventHandler.h"
+#include "SkTypes.h"
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <X11/keysym.h>
+#include <X11/extensions/XShm.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <sys/time.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <map>
+
+// the animation tick of startAnimate, the same as the timer of the windows widget.
+const int ANIMATE_INTERVAL = 15;
+
+const char WIDGET_TITLE[] = "WIDGET";
+
+// every widget shares one connection, opened by the first of them.
+Display* g_display = nullptr;
+Atom g_deleteWindowAtom = None;
+int g_shmCompletionEvent = -1;
+bool g_quit = false;
+
+std::map<Window, Widget*> g_mapWindow2Widget;
+
+namespace
+{
+	bool g_shmAttachFailed = false;
+
+	int shmErrorHandler(Display* display, XErrorEvent* event)
+	{
+		g_shmAttachFailed = true;
+		return 0;
+	}
+
+	long long now()
+	{
+		timeval time;
+		gettimeofday(&time, nullptr);
+		return (long long)time.tv_sec * 1000 + time.tv_usec / 1000;
+	}
+
+	bool openDisplay()
+	{
+		if (nullptr != g_display)
+		{
+			return true;
+		}
+
+		g_display = ::XOpenDisplay(nullptr);
+		INVALID_POINTER_RETURN_FALSE(g_display);
+
+		g_deleteWindowAtom = ::XInternAtom(g_display, "WM_DELETE_WINDOW", False);
+
+		if (::XShmQueryExtension(g_display))
+		{
+			g_shmCompletionEvent = ::XShmGetEventBase(g_display) + ShmCompletion;
+		}
+
+		return true;
+	}
+
+	// the buttons and keys of an x11 state mask.
+	int eventFlags(unsigned int state)
+	{
+		int flags = 0;
+		flags |= 0 != (state & Button1Mask) ? ak::kEventLeftButton : 0;
+		flags |= 0 != (state & Button2Mask) ? ak::kEventMiddleButton : 0;
+		flags |= 0 != (state & Button3Mask) ? ak::kEventRightButton : 0;
+		flags |= 0 != (state & ShiftMask) ? ak::kEventShift : 0;
+		flags |= 0 != (state & ControlMask) ? ak::kEventControl : 0;
+		flags |= 0 != (state & Mod1Mask) ? ak::kEventAlt : 0;
+		return flags;
+	}
+
+	int buttonFlag(unsigned int button)
+	{
+		switch (button)
+		{
+		case Button1:
+			return ak::kEventLeftButton;
+		case Button2:
+			return ak::kEventMiddleButton;
+		case Button3:
+			return ak::kEventRightButton;
+		default:
+			return 0;
+		}
+	}
+
+	Bool isShmCompletion(Display* display, XEvent* event, XPointer arg)
+	{
+		return event->type == g_shmCompletionEvent
+			&& ((XShmCompletionEvent*)event)->drawable == *(Window*)arg;
+	}
+}
+
+class WidgetDelegate
+{
+public:
+	WidgetDelegate(int x, int y, int width, int height)
+		: _x(x)
+		, _y(y)
+		, _width(width)
+		, _height(height)
+		, _window(0)
+		, _gc(nullptr)
+		, _image(nullptr)
+		, _useShm(false)
+		, _shmPending(false)
+		, _pixels(nullptr)
+		, _imageBytes(0)
+		, _hasFrame(false)
+		, _wantsCanvas(false)
+		, _animating(false)
+		, _nextTick(0)
+		, _nextInput(0)
+		, _loadingTiles(false)
+	{
+		memset(&_shmInfo, 0, sizeof(_shmInfo));
+		_shmInfo.shmid = -1;
+	}
+
+	~WidgetDelegate()
+	{
+		destroyImage();
+
+		if (nullptr != _gc)
+		{
+			::XFreeGC(g_display, _gc);
+			_gc = nullptr;
+		}
+
+		if (0 != _window)
+		{
+			g_mapWindow2Widget.erase(_window);
+			::XDestroyWindow(g_display, _window);
+			_window = 0;
+		}
+	}
+
+	// the image the canvas draws into. it lives in shared memory when the server supports
+	// it, so presenting a frame does not copy the pixels through the connection.
+	bool createImage()
+	{
+		destroyImage();
+
+		Visual* visual = DefaultVisual(g_display, DefaultScreen(g_display));
+		int depth = DefaultDepth(g_display, DefaultScreen(g_display));
+
+		// skia writes 32 bit pixels, other visuals would need a conversion on every frame.
+		bool directColor = (24 == depth || 32 == depth) && 0xFF0000 == visual->red_mask
+			&& 0xFF00 == visual->green_mask && 0xFF == visual->blue_mask;
+		VALUE_FALSE_RETURN_FALSE(directColor);
+
+		if (g_shmCompletionEvent >= 0)
+		{
+			_useShm = createShmImage(visual, depth);
+		}
+
+		if (!_useShm)
+		{
+			char* data = (char*)malloc(_width * _height * 4);
+			INVALID_POINTER_RETURN_FALSE(data);
+			_image = ::XCreateImage(g_display, visual, depth, ZPixmap, 0, data, _width, _height, 32, _width * 4);
+
+			if (nullptr == _image)
+			{
+				free(data);
+				return false;
+			}
+		}
+
+		_imageBytes = _image->bytes_per_line * _image->height;
+		MemoryTracker::getInstance()->add(ak::kMemorySurfaces, "x11 window", _imageBytes);
+
+		// skia keeps red at bit 16 only when the port says so, otherwise it draws to a
+		// buffer of its own which is swizzled into the image for the rects presented.
+		_pixels = _image->data;
+
+		if (16 != SK_R32_SHIFT || 0 != SK_B32_SHIFT)
+		{
+			_pixels = (char*)malloc(_imageBytes);
+
+			if (nullptr == _pixels)
+			{
+				_pixels = _image->data;
+				destroyImage();
+				return false;
+			}
+
+			MemoryTracker::getInstance()->add(ak::kMemorySurfaces, "x11 window", _imageBytes);
+		}
+
+		return true;
+	}
+
+	void destroyImage()
+	{
+		INVALID_POINTER_RETURN(_image);
+		waitForShm();
+
+		if (_pixels != _image->data)
+		{
+			free(_pixels);
+			MemoryTracker::getInstance()->remove(ak::kMemorySurfaces, "x11 window", _imageBytes);
+		}
+
+		_pixels = nullptr;
+
+		if (_useShm)
+		{
+			::XShmDetach(g_display, &_shmInfo);
+			::XSync(g_display, False);
+			::shmdt(_shmInfo.shmaddr);
+			_image->data = nullptr;
+			_shmInfo.shmid = -1;
+			_shmInfo.shmaddr = nullptr;
+		}
+
+		// frees the malloc'd data of a plain image too.
+		XDestroyImage(_image);
+		_image = nullptr;
+		_useShm = false;
+
+		MemoryTracker::getInstance()->remove(ak::kMemorySurfaces, "x11 window", _imageBytes);
+		_imageBytes = 0;
+	}
+
+	// copies rect of the image to the window, the image must not be drawn into until
+	// the server has read it, see waitForShm.
+	void present(const KRect& rect)
+	{
+		INVALID_POINTER_RETURN(_image);
+
+		int left = rect._left < 0 ? 0 : rect._left;
+		int top = rect._top < 0 ? 0 : rect._top;
+		int right = rect._right > _width ? _width : rect._right;
+		int bottom = rect._bottom > _height ? _height : rect._bottom;
+
+		if (left >= right || top >= bottom)
+		{
+			return;
+		}
+
+		waitForShm();
+
+		if (_pixels != _image->data)
+		{
+			swizzle(left, top, right, bottom);
+		}
+
+		if (_useShm)
+		{
+			::XShmPutImage(g_display, _window, _gc, _image, left, top, left, top, right - left, bottom - top, True);
+			_shmPending = true;
+		}
+		else
+		{
+			::XPutImage(g_display, _window, _gc, _image, left, top, left, top, right - left, bottom - top);
+		}
+
+		::XFlush(g_display);
+	}
+
+	void waitForShm()
+	{
+		if (!_shmPending)
+		{
+			return;
+		}
+
+		XEvent event;
+		::XIfEvent(g_display, &event, isShmCompletion, (XPointer)&_window);
+		_shmPending = false;
+	}
+
+private:
+	bool createShmImage(Visual* visual, int depth)
+	{
+		_image = ::XShmCreateImage(g_display, visual, depth, ZPixmap, nullptr, &_shmInfo, _width, _height);
+		INVALID_POINTER_RETURN_FALSE(_image);
+
+		_shmInfo.shmid = ::shmget(IPC_PRIVATE, _image->bytes_per_line * _image->height, IPC_CREAT | 0600);
+
+		if (_shmInfo.shmid < 0)
+		{
+			XDestroyImage(_image);
+			_image = nullptr;
+			return false;
+		}
+
+		_shmInfo.shmaddr = (char*)::shmat(_shmInfo.shmid, nullptr, 0);
+		_shmInfo.readOnly = False;
+		_image->data = _shmInfo.shmaddr;
+
+		// a remote server accepts the extension but fails to attach, the error arrives
+		// asynchronously so it is caught around a round trip.
+		g_shmAttachFailed = false;
+		XErrorHandler oldHandler = ::XSetErrorHandler(shmErrorHandler);
+		bool attached = (char*)-1 != _shmInfo.shmaddr && ::XShmAttach(g_display, &_shmInfo);
+		::XSync(g_display, False);
+		::XSetErrorHandler(oldHandler);
+
+		// the segment goes away with the last detach, even if the process dies.
+		::shmctl(_shmInfo.shmid, IPC_RMID, nullptr);
+
+		if (!attached || g_shmAttachFailed)
+		{
+			if ((char*)-1 != _shmInfo.shmaddr)
+			{
+				::shmdt(_shmInfo.shmaddr);
+			}
+
+			_image->data = nullptr;
+			XDestroyImage(_image);
+			_image = nullptr;
+			_shmInfo.shmid = -1;
+			_shmInfo.shmaddr = nullptr;
+			return false;
+		}
+
+		return true;
+	}
+
+	void swizzle(int left, int top, int right, int bottom)
+	{
+		int rowBytes = _image->bytes_per_line;
+
+		for (int y = top; y < bottom; ++y)
+		{
+			const unsigned char* src = (const unsigned char*)_pixels + y * rowBytes + left * 4;
+			unsigned char* dst = (unsigned char*)_image->data + y * rowBytes + left * 4;
+
+			for (int x = left; x < right; ++x, src += 4, dst += 4)
+			{
+				unsigned int pixel = *(const unsigned int*)src;
+				*(unsigned int*)dst = ((pixel >> SK_A32_SHIFT) & 0xFF) << 24
+					| ((pixel >> SK_R32_SHIFT) & 0xFF) << 16
+					| ((pixel >> SK_G32_SHIFT) & 0xFF) << 8
+					| ((pixel >> SK_B32_SHIFT) & 0xFF);
+			}
+		}
+	}
+
+public:
+	int _x;
+	int _y;
+	int _width;
+	int _height;
+	RootView _rootView;
+	Window _window;
+	GC _gc;
+	XImage* _image;
+	XShmSegmentInfo _shmInfo;
+	bool _useShm;
+
+	// an XShmPutImage the server has not finished reading.
+	bool _shmPending;
+
+	// the pixels the canvas draws into, the image data unless they need a swizzle.
+	char* _pixels;
+	size_t _imageBytes;
+
+	// the image holds a complete frame, exposes are served from it without drawing.
+	bool _hasFrame;
+	KRect _exposeRect;
+
+	// initCanvas was called, a new image gets a new canvas.
+	bool _wantsCanvas;
+
+	// paints scheduled by the views, drawn once the pending events are handled.
+	KRect _pendingPaint;
+
+	bool _animating;
+	long long _nextTick;
+
+	// events are delivered at most once per animation interval, the ones arriving in
+	// between are merged by the handler.
+	EventHandler _eventHandler;
+	long long _nextInput;
+
+	// tiles are decoding, the loop wakes every interval to paint the ones that landed.
+	bool _loadingTiles;
+};
+
+Widget::Widget()
+	: _widgetDeleget(nullptr)
+{
+}
+
+Widget::~Widget()
+{
+	if (nullptr != _widgetDeleget)
+	{
+		delete _widgetDeleget;
+		_widgetDeleget = nullptr;
+	}
+}
+
+void Widget::init(int x, int y, int width, int height)
+{
+	VALUE_FALSE_RETURN(openDisplay());
+	_widgetDeleget = new WidgetDelegate(x, y, width, height);
+	registerClass();
+
+	int screen = DefaultScreen(g_display);
+	_widgetDeleget->_window = ::XCreateSimpleWindow(g_display, RootWindow(g_display, screen),
+		x, y, width, height, 0, BlackPixel(g_display, screen), BlackPixel(g_display, screen));
+
+	if (0 == _widgetDeleget->_window)
+	{
+		return;
+	}
+
+	// the window is painted from the image only, the server must not clear it first.
+	XSetWindowAttributes attributes;
+	attributes.background_pixmap = None;
+	attributes.bit_gravity = NorthWestGravity;
+	::XChangeWindowAttributes(g_display, _widgetDeleget->_window, CWBackPixmap | CWBitGravity, &attributes);
+
+	::XSelectInput(g_display, _widgetDeleget->_window, ExposureMask | StructureNotifyMask | KeyPressMask | KeyReleaseMask
+		| ButtonPressMask | ButtonReleaseMask | PointerMotionMask);
+	::XStoreName(g_display, _widgetDeleget->_window, WIDGET_TITLE);
+	::XSetWMProtocols(g_display, _widgetDeleget->_window, &g_deleteWindowAtom, 1);
+	_widgetDeleget->_gc = ::XCreateGC(g_display, _widgetDeleget->_window, 0, nullptr);
+
+	_widgetDeleget->createImage();
+
+	g_mapWindow2Widget.insert(std::make_pair(_widgetDeleget->_window, this));
+
+	_widgetDeleget->_rootView.init(this, width, height);
+}
+
+void Widget::show()
+{
+	INVALID_POINTER_RETURN(_widgetDeleget);
+	INVALID_POINTER_RETURN(g_display);
+	::XMapWindow(g_display, _widgetDeleget->_window);
+	::XFlush(g_display);
+}
+
+void Widget::center()
+{
+	INVALID_POINTER_RETURN(_widgetDeleget);
+	INVALID_POINTER_RETURN(g_display);
+
+	int screen = DefaultScreen(g_display);
+	int x = (DisplayWidth(g_display, screen) - _widgetDeleget->_width) / 2;
+	int y = (DisplayHeight(g_display, screen) - _widgetDeleget->_height) / 2;
+
+	moveWindow(x, y, _widgetDeleget->_width, _widgetDeleget->_height);
+}
+
+void Widget::moveWindow(int x, int y, int width, int height)
+{
+	INVALID_POINTER_RETURN(_widgetDeleget);
+	INVALID_POINTER_RETURN(g_display);
+
+	// the new size takes effect with the ConfigureNotify the server sends back.
+	::XMoveResizeWindow(g_display, _widgetDeleget->_window, x, y, width, height);
+	::XFlush(g_display);
+}
+
+int Widget::x()
+{
+	INVALID_POINTER_RETURN_PARAM(_widgetDeleget, 0);
+	return _widgetDeleget->_x;
+}
+
+int Widget::y()
+{
+	INVALID_POINTER_RETURN_PARAM(_widgetDeleget, 0);
+	return _widgetDeleget->_y;
+}
+
+int Widget::width()
+{
+	INVALID_POINTER_RETURN_PARAM(_widgetDeleget, 0);
+	return _widgetDeleget->_width;
+}
+
+int Widget::height()
+{
+	INVALID_POINTER_RETURN_PARAM(_widgetDeleget, 0);
+	return _widgetDeleget->_height;
+}
+
+bool Widget::addView(View* view)
+{
+	INVALID_POINTER_RETURN_FALSE(_widgetDeleget);
+	return _widgetDeleget->_rootView.addView(view);
+}
+
+void Widget::startAnimate()
+{
+	INVALID_POINTER_RETURN(_widgetDeleget);
+	_widgetDeleget->_animating = true;
+	_widgetDeleget->_nextTick = now() + ANIMATE_INTERVAL;
+}
+
+void Widget::stopAnimate()
+{
+	INVALID_POINTER_RETURN(_widgetDeleget);
+	_widgetDeleget->_animating = false;
+}
+
+bool Widget::initCanvas(int canvasType)
+{
+	INVALID_POINTER_RETURN_FALSE(_widgetDeleget);
+
+	// the window is presented from its image, only skia can draw into it.
+	if (ak::SkiaGraphics != canvasType)
+	{
+		return false;
+	}
+
+	_widgetDeleget->_wantsCanvas = true;
+	INVALID_POINTER_RETURN_FALSE(_widgetDeleget->_image);
+
+	_widgetDeleget->_hasFrame = false;
+	return _widgetDeleget->_rootView.initCanvas(_widgetDeleget->_pixels, _widgetDeleget->_image->bytes_per_line);
+}
+
+void Widget::processEvent(XEvent& event)
+{
+	INVALID_POINTER_RETURN(_widgetDeleget);
+
+	if (event.type == g_shmCompletionEvent)
+	{
+		_widgetDeleget->_shmPending = false;
+		return;
+	}
+
+	switch (event.type)
+	{
+	case Expose:
+		{
+			// the image still holds the last frame, exposes copy it instead of drawing again.
+			_widgetDeleget->_exposeRect.join(KRect(event.xexpose.x, event.xexpose.y, event.xexpose.width, event.xexpose.height));
+
+			if (0 == event.xexpose.count)
+			{
+				if (_widgetDeleget->_hasFrame)
+				{
+					_widgetDeleget->present(_widgetDeleget->_exposeRect);
+				}
+				else
+				{
+					drawToWindow();
+				}
+
+				_widgetDeleget->_exposeRect.set(0, 0, 0, 0);
+			}
+		}
+		break;
+
+	case ConfigureNotify:
+		{
+			_widgetDeleget->_x = event.xconfigure.x;
+			_widgetDeleget->_y = event.xconfigure.y;
+
+			if (event.xconfigure.width != _widgetDeleget->_width || event.xconfigure.height != _widgetDeleget->_height)
+			{
+				_widgetDeleget->_width = event.xconfigure.width;
+				_widgetDeleget->_height = event.xconfigure.height;
+				_widgetDeleget->_rootView.setRect(KRect(0, 0, _widgetDeleget->_width, _widgetDeleget->_height));
+
+				// the canvas draws into the old image, which createImage frees. without a new
+				// image it goes too and the window stays blank until a resize succeeds.
+				if (!_widgetDeleget->createImage())
+				{
+					_widgetDeleget->_rootView.releaseCanvas();
+				}
+				else if (_widgetDeleget->_wantsCanvas)
+				{
+					initCanvas(ak::SkiaGraphics);
+				}
+
+				// the expose that follows draws the new size in full.
+				_widgetDeleget->_hasFrame = false;
+			}
+		}
+		break;
+
+	case KeyPress:
+	case KeyRelease:
+		{
+			InputEvent input;
+			memset(&input, 0, sizeof(input));
+			input._type = KeyPress == event.type ? ak::kEventKeyDown : ak::kEventKeyUp;
+			input._flags = eventFlags(event.xkey.state);
+			input._x = event.xkey.x;
+			input._y = event.xkey.y;
+			input._keyCode = ::XLookupKeysym(&event.xkey, 0);
+			input._time = event.xkey.time;
+			_widgetDeleget->_eventHandler.postEvent(input);
+
+			if (KeyPress == event.type)
+			{
+				processKeyDown(input._keyCode);
+			}
+		}
+		break;
+
+	case ButtonPress:
+	case ButtonRelease:
+		{
+			InputEvent input;
+			memset(&input, 0, sizeof(input));
+			input._x = event.xbutton.x;
+			input._y = event.xbutton.y;
+			input._time = event.xbutton.time;
+			input._button = buttonFlag(event.xbutton.button);
+
+			// the state is the one before the event.
+			input._flags = eventFlags(event.xbutton.state);
+
+			if (Button4 == event.xbutton.button || Button5 == event.xbutton.button)
+			{
+				// the wheel presses and releases a button for every notch.
+				if (ButtonRelease == event.type)
+				{
+					break;
+				}
+
+				input._type = ak::kEventMouseWheel;
+				input._wheelDelta = Button4 == event.xbutton.button ? 120 : -120;
+			}
+			else if (0 == input._button)
+			{
+				break;
+			}
+			else if (ButtonPress == event.type)
+			{
+				input._type = ak::kEventMouseDown;
+				input._flags |= input._button;
+			}
+			else
+			{
+				input._type = ak::kEventMouseUp;
+				input._flags &= ~input._button;
+			}
+
+			_widgetDeleget->_eventHandler.postEvent(input);
+		}
+		break;
+
+	case MotionNotify:
+		{
+			InputEvent input;
+			memset(&input, 0, sizeof(input));
+			input._type = ak::kEventMouseMove;
+			input._flags = eventFlags(event.xmotion.state);
+			input._x = event.xmotion.x;
+			input._y = event.xmotion.y;
+			input._time = event.xmotion.time;
+			_widgetDeleget->_eventHandler.postEvent(input);
+		}
+		break;
+
+	case ClientMessage:
+		if ((Atom)event.xclient.data.l[0] == g_deleteWindowAtom)
+		{
+			g_quit = true;
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+bool Widget::processEvents()
+{
+	INVALID_POINTER_RETURN_FALSE(g_display);
+
+	// waits for the connection or the closest animation tick.
+	int timeout = -1;
+	long long current = now();
+	std::map<Window, Widget*>::iterator iter = g_mapWindow2Widget.begin();
+
+	for (; iter != g_mapWindow2Widget.end(); ++iter)
+	{
+		WidgetDelegate* delegate = iter->second->_widgetDeleget;
+
+		if (nullptr != delegate && delegate->_animating)
+		{
+			int wait = delegate->_nextTick > current ? (int)(delegate->_nextTick - current) : 0;
+			timeout = (timeout < 0 || wait < timeout) ? wait : timeout;
+		}
+
+		if (nullptr != delegate && delegate->_eventHandler.hasPendingEvents())
+		{
+			int wait = delegate->_nextInput > current ? (int)(delegate->_nextInput - current) : 0;
+			timeout = (timeout < 0 || wait < timeout) ? wait : timeout;
+		}
+
+		if (nullptr != delegate && delegate->_loadingTiles)
+		{
+			timeout = (timeout < 0 || ANIMATE_INTERVAL < timeout) ? ANIMATE_INTERVAL : timeout;
+		}
+
+		// paints scheduled outside a frame, such as by tiles landing, are drawn right away.
+		if (nullptr != delegate && !delegate->_pendingPaint.isEmpty())
+		{
+			timeout = 0;
+		}
+	}
+
+	if (0 == ::XPending(g_display))
+	{
+		pollfd fd;
+		fd.fd = ConnectionNumber(g_display);
+		fd.events = POLLIN;
+		fd.revents = 0;
+		::poll(&fd, 1, timeout);
+	}
+
+	while (!g_quit && ::XPending(g_display) > 0)
+	{
+		XEvent event;
+		::XNextEvent(g_display, &event);
+
+		// shm completions name the drawable rather than the window.
+		Window window = event.type == g_shmCompletionEvent
+			? ((XShmCompletionEvent*)&event)->drawable : event.xany.window;
+		iter = g_mapWindow2Widget.find(window);
+
+		if (iter != g_mapWindow2Widget.end() && nullptr != iter->second)
+		{
+			iter->second->processEvent(event);
+		}
+	}
+
+	current = now();
+
+	for (iter = g_mapWindow2Widget.begin(); !g_quit && iter != g_mapWindow2Widget.end(); ++iter)
+	{
+		Widget* widget = iter->second;
+		WidgetDelegate* delegate = widget->_widgetDeleget;
+
+		if (nullptr == delegate)
+		{
+			continue;
+		}
+
+		// the views handle the input before the frame, their paints join it.
+		if (delegate->_eventHandler.hasPendingEvents() && delegate->_nextInput <= current)
+		{
+			widget->dispatchEvents();
+		}
+
+		if (delegate->_loadingTiles)
+		{
+			widget->updateTiledImages();
+		}
+
+		if (delegate->_animating && delegate->_nextTick <= current)
+		{
+			delegate->_nextTick = current + ANIMATE_INTERVAL;
+			delegate->_pendingPaint.set(0, 0, 0, 0);
+			widget->onTimer();
+		}
+		else if (!delegate->_pendingPaint.isEmpty())
+		{
+			delegate->_pendingPaint.set(0, 0, 0, 0);
+			widget->drawToWindow();
+		}
+	}
+
+	return !g_quit;
+}
+
+Widget* Widget::createWindow(int x, int y, int width, int height)
+{
+	Widget* widget = new Widget;
+	widget->init(x, y, width, height);
+	return widget;
+}
+
+void Widget::registerClass()
+{
+
+}
+
+void Widget::createRootView()
+{
+
+}
+
+bool Widget::processKeyDown(unsigned long keysym)
+{
+	switch (keysym)
+	{
+	case XK_Escape:
+		g_quit = true;
+		return true;
+
+	default:
+		break;
+	}
+
+	return false;
+}
+
+void Widget::onTimer()
+{
+	INVALID_POINTER_RETURN(_widgetDeleget);
+
+	// animated views schedule the paints of what they move, a tick draws only those.
+	dispatchEvents();
+
+	if (_widgetDeleget->_rootView.hasDamage())
+	{
+		drawToWindow();
+	}
+}
+
+void Widget::drawToWindow()
+{
+	INVALID_POINTER_RETURN(_widgetDeleget);
+	INVALID_POINTER_RETURN(_widgetDeleget->_rootView.getCanvas());
+
+	dispatchEvents();
+
+	// the server may still be reading the last frame out of the shared image.
+	_widgetDeleget->waitForShm();
+	_widgetDeleget->_rootView.OnDraw();
+	updateTiledImages();
+
+	// only the damage of this frame goes to the server.
+	_widgetDeleget->present(_widgetDeleget->_rootView.getDrawnRect());
+	_widgetDeleget->_hasFrame = true;
+}
+
+void Widget::setDebugOverlay(int overlays)
+{
+	INVALID_POINTER_RETURN(_widgetDeleget);
+	_widgetDeleget->_rootView.setDebugOverlay(overlays);
+}
+
+void Widget::getDebugStats(ak::DebugStats& stats)
+{
+	INVALID_POINTER_RETURN(_widgetDeleget);
+	_widgetDeleget->_rootView.getDebugStats(stats);
+}
+
+void Widget::schedualPaint(const KRect& rect)
+{
+	INVALID_POINTER_RETURN(_widgetDeleget);
+	_widgetDeleget->_pendingPaint.join(rect);
+}
+
+EventHandler* Widget::getEventHandler()
+{
+	INVALID_POINTER_RETURN_NULL(_widgetDeleget);
+	return &_widgetDeleget->_eventHandler;
+}
+
+void Widget::dispatchEvents()
+{
+	INVALID_POINTER_RETURN(_widgetDeleget);
+
+	if (!_widgetDeleget->_eventHandler.hasPendingEvents())
+	{
+		return;
+	}
+
+	_widgetDeleget->_nextInput = now() + ANIMATE_INTERVAL;
+	_widgetDeleget->_eventHandler.dispatchEvents(&_widgetDeleget->_rootView);
+}
+
+void Widget::updateTiledImages()
+{
+	INVALID_POINTER_RETURN(_widgetDeleget);
+
+	// the views painted again join the pending paint, drawn by the next pass of the loop.
+	_widgetDeleget->_loadingTiles = _widgetDeleget->_rootView.updateTiledImages();
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,193 @@
+// the sse2 procs blending a solid color through coverage runs and through lcd32 masks give the
+// same pixels as the portable code, over random runs, masks, colors and alignments.
+
+#include "SkBlitRow.h"
+#include "SkColorPriv.h"
+#include "SkBlitRow_opts_SSE2.h"
+#include "TestHelper.h"
+#include <string.h>
+#include <stdio.h>
+
+const int MAX_WIDTH = 600;
+const int MASK_HEIGHT = 3;
+const int TRIAL_COUNT = 2000;
+
+namespace
+{
+	unsigned g_seed = 1;
+
+	unsigned nextRandom()
+	{
+		g_seed = g_seed * 1103515245 + 12345;
+		return g_seed >> 8;
+	}
+
+	unsigned randomByte()
+	{
+		return nextRandom() & 0xFF;
+	}
+
+	// 0 and 255 as often as the values between them, they take their own paths.
+	SkAlpha randomCoverage()
+	{
+		switch (nextRandom() % 4)
+		{
+		case 0:
+			return 0;
+		case 1:
+			return 0xFF;
+		default:
+			return randomByte();
+		}
+	}
+
+	SkColor randomColor(bool opaque)
+	{
+		return SkColorSetARGB(opaque ? 0xFF : randomByte(), randomByte(), randomByte(), randomByte());
+	}
+
+	void fillPixels(SkPMColor* pixels, int count, bool opaque)
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			pixels[i] = SkPreMultiplyColor(randomColor(opaque));
+		}
+	}
+
+	// runs like those of glyph edges and shapes, mostly single pixels between longer spans.
+	void fillRuns(int16_t* runs, SkAlpha* antialias, int width)
+	{
+		int x = 0;
+
+		while (x < width)
+		{
+			int count = 0 == nextRandom() % 3 ? 1 + nextRandom() % 40 : 1;
+			count = count < width - x ? count : width - x;
+			runs[x] = count;
+			antialias[x] = randomCoverage();
+			x += count;
+		}
+
+		runs[width] = 0;
+	}
+
+	// blit_lcd32_row and blit_lcd32_opaque_row of SkBlitMask_D32.cpp, which are not exported.
+	void lcd32Reference(SkPMColor* dst, size_t dstRB, const SkPMColor* mask, size_t maskRB, SkColor color,
+		int width, int height)
+	{
+		int srcA = SkAlpha255To256(SkColorGetA(color));
+		int srcR = SkColorGetR(color);
+		int srcG = SkColorGetG(color);
+		int srcB = SkColorGetB(color);
+
+		for (int y = 0; y < height; ++y)
+		{
+			for (int i = 0; i < width; ++i)
+			{
+				if (0 == mask[i])
+				{
+					continue;
+				}
+
+				int maskR = SkAlpha255To256(SkGetPackedR32(mask[i]));
+				int maskG = SkAlpha255To256(SkGetPackedG32(mask[i]));
+				int maskB = SkAlpha255To256(SkGetPackedB32(mask[i]));
+
+				maskR = maskR * srcA >> 8;
+				maskG = maskG * srcA >> 8;
+				maskB = maskB * srcA >> 8;
+
+				dst[i] = SkPackARGB32(0xFF, SkAlphaBlend(srcR, SkGetPackedR32(dst[i]), maskR),
+					SkAlphaBlend(srcG, SkGetPackedG32(dst[i]), maskG), SkAlphaBlend(srcB, SkGetPackedB32(dst[i]), maskB));
+			}
+
+			dst = (SkPMColor*)((char*)dst + dstRB);
+			mask = (const SkPMColor*)((const char*)mask + maskRB);
+		}
+	}
+
+	bool colorAntiHMatches()
+	{
+		// the extra pixels move the start of the row off the 16 byte alignment.
+		static SkPMColor expected[MAX_WIDTH + 3];
+		static SkPMColor actual[MAX_WIDTH + 3];
+		static int16_t runs[MAX_WIDTH + 1];
+		static SkAlpha antialias[MAX_WIDTH + 1];
+
+		for (int trial = 0; trial < TRIAL_COUNT; ++trial)
+		{
+			int width = 1 + nextRandom() % MAX_WIDTH;
+			int offset = nextRandom() % 4;
+			SkPMColor color = SkPreMultiplyColor(randomColor(0 == trial % 2));
+			fillRuns(runs, antialias, width);
+			fillPixels(expected + offset, width, 0 == trial % 3);
+			memcpy(actual + offset, expected + offset, width * sizeof(SkPMColor));
+
+			SkBlitRow::ColorAntiH32(expected + offset, antialias, runs, color);
+			ColorAntiH32_SSE2(actual + offset, antialias, runs, color);
+
+			if (0 != memcmp(expected + offset, actual + offset, width * sizeof(SkPMColor)))
+			{
+				printf("run blend differs: width %d, offset %d, color %08x\n", width, offset, color);
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool lcd32Matches(bool opaqueColor)
+	{
+		const int rowPixels = MAX_WIDTH + 3;
+		static SkPMColor expected[rowPixels * MASK_HEIGHT];
+		static SkPMColor actual[rowPixels * MASK_HEIGHT];
+		static SkPMColor mask[rowPixels * MASK_HEIGHT];
+
+		for (int trial = 0; trial < TRIAL_COUNT; ++trial)
+		{
+			int width = 1 + nextRandom() % MAX_WIDTH;
+			int offset = nextRandom() % 4;
+			SkColor color = randomColor(opaqueColor);
+			size_t rowBytes = rowPixels * sizeof(SkPMColor);
+
+			// lcd masks only blend onto opaque pixels.
+			fillPixels(expected, rowPixels * MASK_HEIGHT, true);
+			memcpy(actual, expected, sizeof(expected));
+
+			for (int i = 0; i < rowPixels * MASK_HEIGHT; ++i)
+			{
+				mask[i] = 0 == nextRandom() % 4 ? 0 : SkPackARGB32(0, randomCoverage(), randomCoverage(),
+					randomCoverage());
+			}
+
+			lcd32Reference(expected + offset, rowBytes, mask + offset, rowBytes, color, width, MASK_HEIGHT);
+
+			if (opaqueColor)
+			{
+				SkARGB32_LCD32_Opaque_BlitMask_SSE2(actual + offset, rowBytes, mask + offset, rowBytes, color, width,
+					MASK_HEIGHT);
+			}
+			else
+			{
+				SkARGB32_LCD32_BlitMask_SSE2(actual + offset, rowBytes, mask + offset, rowBytes, color, width,
+					MASK_HEIGHT);
+			}
+
+			if (0 != memcmp(expected, actual, sizeof(expected)))
+			{
+				printf("lcd32 blend differs: width %d, offset %d, color %08x\n", width, offset, color);
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
+
+int main()
+{
+	check(colorAntiHMatches(), "ColorAntiH32_SSE2 matches ColorAntiH32");
+	check(lcd32Matches(true), "opaque lcd32 mask blit matches");
+	check(lcd32Matches(false), "translucent lcd32 mask blit matches");
+	return testResult();
+}
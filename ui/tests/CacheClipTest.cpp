@@ -0,0 +1,80 @@
+// a clip set and reset while a layer or picture is recorded stays inside it: what is drawn after
+// resetClip is not clipped, and neither is what the window draws after the cache.
+
+#include "UIDefine.h"
+#include "Canvas.h"
+#include "KRect.h"
+#include "KSolidBrush.h"
+#include "Color.h"
+#include "SkColorPriv.h"
+#include "TestHelper.h"
+
+const int SIZE = 64;
+
+namespace
+{
+	unsigned pixelAt(Canvas* canvas, int x, int y)
+	{
+		const unsigned* pixels = (const unsigned*)canvas->lockBits();
+		unsigned pixel = nullptr == pixels ? 0 : pixels[y * SIZE + x];
+		canvas->unlockBits();
+		return pixel;
+	}
+
+	// draws a small clipped rect, then a rect outside the clip after resetClip.
+	void drawClipped(Canvas* canvas)
+	{
+		KSolidBrush red(Color(255, 255, 0, 0));
+		KSolidBrush blue(Color(255, 0, 0, 255));
+		KRect clip(0, 0, 16, 16);
+		KRect outside(32, 32, 64, 64);
+
+		canvas->setClip(clip, ak::kModeIntersect);
+		canvas->fillRect(&red, clip);
+		canvas->resetClip();
+		canvas->fillRect(&blue, outside);
+	}
+
+	void clear(Canvas* canvas)
+	{
+		KSolidBrush white(Color(255, 255, 255, 255));
+		KRect all(0, 0, SIZE, SIZE);
+		canvas->fillRect(&white, all);
+	}
+}
+
+int main()
+{
+	Canvas* canvas = new Canvas;
+	check(canvas->init(SIZE, SIZE, ak::SkiaGraphics), "canvas");
+	KSolidBrush green(Color(255, 0, 255, 0));
+	KRect corner(48, 0, 64, 16);
+	const unsigned BLUE = SkPackARGB32(0xFF, 0, 0, 0xFF);
+	const unsigned GREEN = SkPackARGB32(0xFF, 0, 0xFF, 0);
+	int layerKey = 0;
+	int pictureKey = 0;
+
+	// frames draw under a damage clip, which puts the clip save count of the window above 1.
+	KRect all(0, 0, SIZE, SIZE);
+	check(canvas->setDamageClip(all), "damage clip");
+	clear(canvas);
+	check(canvas->beginCacheLayer(&layerKey, all), "layer recorded");
+	drawClipped(canvas);
+	check(canvas->endCacheLayer(), "layer ended");
+	canvas->fillRect(&green, corner);
+	check(canvas->drawCacheLayer(&layerKey), "layer drawn");
+	check(BLUE == pixelAt(canvas, 40, 40), "layer drawn outside its reset clip");
+	check(GREEN == pixelAt(canvas, 56, 8), "window drawn outside the layer's clip");
+
+	clear(canvas);
+	check(canvas->beginCachePicture(&pictureKey), "picture recorded");
+	drawClipped(canvas);
+	check(canvas->endCachePicture(), "picture ended");
+	canvas->fillRect(&green, corner);
+	check(canvas->drawCachePicture(&pictureKey), "picture drawn");
+	check(BLUE == pixelAt(canvas, 40, 40), "picture drawn outside its reset clip");
+	check(GREEN == pixelAt(canvas, 56, 8), "window drawn outside the picture's clip");
+
+	delete canvas;
+	return testResult();
+}
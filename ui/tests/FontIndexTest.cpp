@@ -0,0 +1,203 @@
+// the linux font index is written to a cache directory that does not exist yet, read back, kept for
+// fonts that did not change on a rescan, and dropped or parsed again for fonts that did.
+
+#include "SkFontIndex_linux.h"
+#include "TestHelper.h"
+#include <string>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+const char* const SYSTEM_FONT = "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf";
+
+namespace
+{
+	bool copyFile(const char* from, const std::string& to)
+	{
+		FILE* in = fopen(from, "rb");
+		FILE* out = fopen(to.c_str(), "wb");
+		char buffer[4096];
+		size_t read = 0;
+		bool copied = nullptr != in && nullptr != out;
+
+		while (copied && 0 < (read = fread(buffer, 1, sizeof(buffer), in)))
+		{
+			copied = fwrite(buffer, 1, read, out) == read;
+		}
+
+		if (nullptr != in)
+		{
+			fclose(in);
+		}
+
+		if (nullptr != out)
+		{
+			fclose(out);
+		}
+
+		return copied;
+	}
+
+	void writeFile(const std::string& path, const char* content)
+	{
+		FILE* file = fopen(path.c_str(), "wb");
+
+		if (nullptr != file)
+		{
+			fputs(content, file);
+			fclose(file);
+		}
+	}
+
+	const FontIndexFile* findFile(const FontIndex& index, const std::string& dir, const char* name)
+	{
+		for (int i = 0; i < index.fDirs.count(); ++i)
+		{
+			if (index.fDirs[i].fPath.equals(dir.c_str()))
+			{
+				for (int j = 0; j < index.fDirs[i].fFiles.count(); ++j)
+				{
+					if (index.fDirs[i].fFiles[j].fName.equals(name))
+					{
+						return &index.fDirs[i].fFiles[j];
+					}
+				}
+			}
+		}
+
+		return nullptr;
+	}
+
+	bool sameEntries(const FontIndex& a, const FontIndex& b)
+	{
+		if (a.fDirs.count() != b.fDirs.count())
+		{
+			return false;
+		}
+
+		for (int i = 0; i < a.fDirs.count(); ++i)
+		{
+			const FontIndexDir& dirA = a.fDirs[i];
+			const FontIndexDir& dirB = b.fDirs[i];
+
+			if (dirA.fPath != dirB.fPath || dirA.fModified != dirB.fModified ||
+				dirA.fFiles.count() != dirB.fFiles.count() || dirA.fSubdirs.count() != dirB.fSubdirs.count())
+			{
+				return false;
+			}
+
+			for (int j = 0; j < dirA.fFiles.count(); ++j)
+			{
+				const FontIndexFile& fileA = dirA.fFiles[j];
+				const FontIndexFile& fileB = dirB.fFiles[j];
+
+				if (fileA.fName != fileB.fName || fileA.fSize != fileB.fSize || fileA.fModified != fileB.fModified ||
+					fileA.fIsFont != fileB.fIsFont || (fileA.fIsFont && (fileA.fFamily != fileB.fFamily ||
+					fileA.fStyle != fileB.fStyle || fileA.fIsFixedWidth != fileB.fIsFixedWidth)))
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	// every entry of index claims to be a font of the family "Kept", which only survives a rescan
+	// if the entry is kept.
+	void markKept(FontIndex* index)
+	{
+		for (int i = 0; i < index->fDirs.count(); ++i)
+		{
+			for (int j = 0; j < index->fDirs[i].fFiles.count(); ++j)
+			{
+				index->fDirs[i].fFiles[j].fIsFont = true;
+				index->fDirs[i].fFiles[j].fFamily.set("Kept");
+			}
+		}
+	}
+
+	bool isKept(const FontIndexFile* file)
+	{
+		return nullptr != file && file->fIsFont && file->fFamily.equals("Kept");
+	}
+}
+
+int main()
+{
+	if (0 != access(SYSTEM_FONT, R_OK))
+	{
+		printf("no %s, skipped\n", SYSTEM_FONT);
+		return 77;
+	}
+
+	char root[] = "/tmp/FontIndexTestXXXXXX";
+	check(nullptr != mkdtemp(root), "temporary directory");
+	std::string fonts = std::string(root) + "/fonts/";
+	std::string sub = fonts + "sub/";
+	std::string indexPath = std::string(root) + "/cache/nested/skia-font-index";
+	mkdir(fonts.c_str(), 0700);
+	mkdir(sub.c_str(), 0700);
+	check(copyFile(SYSTEM_FONT, fonts + "a.ttf"), "font copied");
+	check(copyFile(SYSTEM_FONT, sub + "b.ttf"), "font copied to a subdirectory");
+	writeFile(fonts + "c.ttf", "not a font");
+
+	// load
+	FontIndex empty;
+	FontIndex first;
+	scan_font_directory(SkString(fonts.c_str()), empty, &first);
+	check(first.fChanged, "first scan changed");
+	check(2 == first.fDirs.count(), "directory and subdirectory scanned");
+	const FontIndexFile* font = findFile(first, fonts, "a.ttf");
+	check(nullptr != font && font->fIsFont && font->fFamily.equals("DejaVu Sans"), "font parsed");
+	check(nullptr != findFile(first, sub, "b.ttf"), "font of the subdirectory parsed");
+	const FontIndexFile* notFont = findFile(first, fonts, "c.ttf");
+	check(nullptr != notFont && !notFont->fIsFont, "file that is not a font recorded");
+
+	write_font_index(indexPath.c_str(), first);
+	FontIndex loaded;
+	check(read_font_index(indexPath.c_str(), &loaded), "index written to a missing cache directory and read");
+	check(sameEntries(first, loaded), "index read as written");
+
+	// refresh
+	markKept(&loaded);
+	FontIndex refreshed;
+	scan_font_directory(SkString(fonts.c_str()), loaded, &refreshed);
+	check(!refreshed.fChanged, "unchanged fonts leave the index unchanged");
+	check(isKept(findFile(refreshed, fonts, "a.ttf")) && isKept(findFile(refreshed, fonts, "c.ttf")) &&
+		isKept(findFile(refreshed, sub, "b.ttf")), "unchanged fonts not parsed again");
+
+	// stale entries, after the clock of the file system ticks.
+	usleep(50000);
+	writeFile(fonts + "c.ttf", "still not a font, but longer");
+	writeFile(fonts + "d.ttf", "not a font either");
+	unlink((sub + "b.ttf").c_str());
+	FontIndex rescanned;
+	scan_font_directory(SkString(fonts.c_str()), refreshed, &rescanned);
+	check(rescanned.fChanged, "changed fonts change the index");
+	check(isKept(findFile(rescanned, fonts, "a.ttf")), "unchanged font of a changed directory kept");
+	notFont = findFile(rescanned, fonts, "c.ttf");
+	check(nullptr != notFont && !notFont->fIsFont, "rewritten font parsed again");
+	check(nullptr != findFile(rescanned, fonts, "d.ttf"), "new font added");
+	check(nullptr == findFile(rescanned, sub, "b.ttf"), "removed font dropped");
+
+	// a cut index is not read.
+	write_font_index(indexPath.c_str(), rescanned);
+	struct stat st;
+	check(0 == stat(indexPath.c_str(), &st) && 0 == truncate(indexPath.c_str(), st.st_size / 2), "index cut");
+	FontIndex cut;
+	check(!read_font_index(indexPath.c_str(), &cut) && 0 == cut.fDirs.count(), "cut index not read");
+
+	unlink(indexPath.c_str());
+	rmdir((std::string(root) + "/cache/nested").c_str());
+	rmdir((std::string(root) + "/cache").c_str());
+	unlink((fonts + "a.ttf").c_str());
+	unlink((fonts + "c.ttf").c_str());
+	unlink((fonts + "d.ttf").c_str());
+	rmdir(sub.c_str());
+	rmdir(fonts.c_str());
+	rmdir(root);
+	return testResult();
+}
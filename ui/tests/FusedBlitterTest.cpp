@@ -0,0 +1,271 @@
+// the fused blitters shade and blend colors and bitmaps into the same pixels as SkARGB32_Shader_Blitter,
+// over random colors, bitmaps, matrices, tile modes, coverage and alignments.
+
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkColorPriv.h"
+#include "SkColorShader.h"
+#include "SkCoreBlitters.h"
+#include "SkMatrix.h"
+#include "SkPaint.h"
+#include "SkShader.h"
+#include "SkXfermode.h"
+#include "TestHelper.h"
+#include <string.h>
+#include <stdio.h>
+
+const int DEVICE_WIDTH = 300;
+const int DEVICE_HEIGHT = 12;
+const int TRIAL_COUNT = 400;
+
+namespace
+{
+	unsigned g_seed = 1;
+
+	unsigned nextRandom()
+	{
+		g_seed = g_seed * 1103515245 + 12345;
+		return g_seed >> 8;
+	}
+
+	unsigned randomByte()
+	{
+		return nextRandom() & 0xFF;
+	}
+
+	// a value between low and high in steps of a sixty fourth, so scales like 0.71 and 1.37 come up.
+	SkScalar randomScalar(float low, float high)
+	{
+		int steps = (int)((high - low) * 64);
+		return SkFloatToScalar(low + (nextRandom() % (steps + 1)) / 64.0f);
+	}
+
+	void fillBitmap(SkBitmap* bitmap, int width, int height, bool opaque)
+	{
+		bitmap->setConfig(SkBitmap::kARGB_8888_Config, width, height);
+		bitmap->allocPixels();
+
+		for (int y = 0; y < height; ++y)
+		{
+			for (int x = 0; x < width; ++x)
+			{
+				*bitmap->getAddr32(x, y) = SkPreMultiplyColor(SkColorSetARGB(opaque ? 0xFF : randomByte(),
+					randomByte(), randomByte(), randomByte()));
+			}
+		}
+
+		bitmap->setIsOpaque(opaque);
+	}
+
+	struct Trial
+	{
+		bool solid;
+		SkShader::TileMode tileMode;
+		bool affine;
+	};
+
+	// draws a rect and a run of partial coverage through blitter.
+	void blit(SkBlitter* blitter, int x, int y, int width, int height)
+	{
+		blitter->blitRect(x, y, width, height);
+
+		SkAlpha antialias[DEVICE_WIDTH + 1];
+		int16_t runs[DEVICE_WIDTH + 1];
+
+		for (int i = 0; i < width; ++i)
+		{
+			antialias[i] = randomByte();
+			runs[i] = 1;
+		}
+
+		runs[width] = 0;
+		blitter->blitAntiH(x, y + height, antialias, runs);
+	}
+
+	// false if the blitter chosen for paint is not fused, or if it differs from the shader blitter.
+	bool fusedMatches(const Trial& trial)
+	{
+		static uint32_t expectedPixels[DEVICE_WIDTH * DEVICE_HEIGHT];
+		static uint32_t actualPixels[DEVICE_WIDTH * DEVICE_HEIGHT];
+		SkBitmap expected;
+		SkBitmap actual;
+		expected.setConfig(SkBitmap::kARGB_8888_Config, DEVICE_WIDTH, DEVICE_HEIGHT);
+		expected.setPixels(expectedPixels);
+		actual.setConfig(SkBitmap::kARGB_8888_Config, DEVICE_WIDTH, DEVICE_HEIGHT);
+		actual.setPixels(actualPixels);
+
+		for (int i = 0; i < DEVICE_WIDTH * DEVICE_HEIGHT; ++i)
+		{
+			expectedPixels[i] = SkPreMultiplyColor(SkColorSetARGB(randomByte(), randomByte(), randomByte(),
+				randomByte()));
+		}
+
+		memcpy(actualPixels, expectedPixels, sizeof(actualPixels));
+
+		// a one pixel bitmap is drawn as a color.
+		SkBitmap bitmap;
+		fillBitmap(&bitmap, 2 + nextRandom() % 40, 1 + nextRandom() % 40, 0 != nextRandom() % 3);
+
+		// the inverse of this matrix is what the matrix procs step through, a scale of 1 would leave a
+		// translate only matrix, which is not fused.
+		SkMatrix matrix;
+		matrix.setScale(randomScalar(0.25f, 4) + SkFloatToScalar(1 / 128.0f), randomScalar(0.25f, 4));
+
+		if (trial.affine)
+		{
+			matrix.postRotate(randomScalar(-180, 180));
+		}
+
+		matrix.postTranslate(randomScalar(-20, 20), randomScalar(-20, 20));
+		SkShader* shader = nullptr;
+
+		if (trial.solid)
+		{
+			shader = SkNEW_ARGS(SkColorShader, (SkColorSetARGB(randomByte(), randomByte(), randomByte(),
+				randomByte())));
+		}
+		else
+		{
+			shader = SkShader::CreateBitmapShader(bitmap, trial.tileMode, trial.tileMode);
+			shader->setLocalMatrix(matrix);
+		}
+
+		SkPaint paint;
+		paint.setShader(shader)->unref();
+
+		// bitmaps are fused only for kMultiply_Mode.
+		paint.setXfermodeMode(trial.solid && 0 == nextRandom() % 2 ? SkXfermode::kSrc_Mode :
+			SkXfermode::kMultiply_Mode);
+
+		if (0 == nextRandom() % 4)
+		{
+			paint.setAlpha(randomByte());
+		}
+
+		int width = 1 + nextRandom() % (DEVICE_WIDTH - 4);
+		int x = nextRandom() % (DEVICE_WIDTH - width);
+		int y = nextRandom() % 4;
+		int height = 1 + nextRandom() % (DEVICE_HEIGHT - y - 1);
+		unsigned seed = g_seed;
+		SkMatrix identity;
+		identity.reset();
+
+		if (!shader->setContext(expected, paint, identity))
+		{
+			return false;
+		}
+
+		SkARGB32_Shader_Blitter* reference = new SkARGB32_Shader_Blitter(expected, paint);
+		blit(reference, x, y, width, height);
+		delete reference;
+
+		// the same coverage again for the fused blitter.
+		g_seed = seed;
+		uint32_t storage[256];
+
+		if (!shader->setContext(actual, paint, identity))
+		{
+			return false;
+		}
+
+		SkBlitter* fused = SkBlitter_ChooseFusedD32(actual, paint, storage, sizeof(storage));
+
+		if (nullptr == fused)
+		{
+			shader->endContext();
+			printf("no fused blitter: solid %d, tile mode %d, affine %d\n", trial.solid, trial.tileMode, trial.affine);
+			return false;
+		}
+
+		blit(fused, x, y, width, height);
+		fused->~SkBlitter();
+
+		int differences = 0;
+
+		for (int i = 0; i < DEVICE_WIDTH * DEVICE_HEIGHT; ++i)
+		{
+			differences += expectedPixels[i] != actualPixels[i] ? 1 : 0;
+		}
+
+		if (0 != differences)
+		{
+			printf("%d pixels differ: solid %d, tile mode %d, affine %d, bitmap %dx%d, scale %g %g, x %d, width %d\n",
+				differences, trial.solid, trial.tileMode, trial.affine, bitmap.width(), bitmap.height(),
+				SkScalarToFloat(matrix.getScaleX()), SkScalarToFloat(matrix.getScaleY()), x, width);
+			return false;
+		}
+
+		return true;
+	}
+
+	// the columns of a bitmap scaled up and clamped at its right end come out in order.
+	bool clampedColumnsInOrder()
+	{
+		const int bitmapWidth = 20;
+		const int deviceWidth = 64;
+		SkBitmap bitmap;
+		bitmap.setConfig(SkBitmap::kARGB_8888_Config, bitmapWidth, 1);
+		bitmap.allocPixels();
+
+		for (int x = 0; x < bitmapWidth; ++x)
+		{
+			*bitmap.getAddr32(x, 0) = SkPackARGB32(0xFF, x * 10, 0, 0);
+		}
+
+		bitmap.setIsOpaque(true);
+		SkBitmap device;
+		device.setConfig(SkBitmap::kARGB_8888_Config, deviceWidth, 1);
+		device.allocPixels();
+		device.eraseColor(0);
+
+		SkMatrix matrix;
+		matrix.setScale(SkFloatToScalar(1.37f), SK_Scalar1);
+		// the first columns are inside the bitmap, the matrix proc maps them two at a time.
+		matrix.postTranslate(SkIntToScalar(-3), 0);
+		SkShader* shader = SkShader::CreateBitmapShader(bitmap, SkShader::kClamp_TileMode,
+			SkShader::kClamp_TileMode);
+		shader->setLocalMatrix(matrix);
+		SkPaint paint;
+		paint.setShader(shader)->unref();
+		SkCanvas canvas(device);
+		canvas.drawPaint(paint);
+
+		for (int x = 1; x < deviceWidth; ++x)
+		{
+			if (SkGetPackedR32(*device.getAddr32(x, 0)) < SkGetPackedR32(*device.getAddr32(x - 1, 0)))
+			{
+				printf("column %d drawn before column %d\n", SkGetPackedR32(*device.getAddr32(x - 1, 0)) / 10,
+					SkGetPackedR32(*device.getAddr32(x, 0)) / 10);
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool allMatch(bool solid, SkShader::TileMode tileMode, bool affine)
+	{
+		Trial trial = { solid, tileMode, affine };
+
+		for (int i = 0; i < TRIAL_COUNT; ++i)
+		{
+			if (!fusedMatches(trial))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
+
+int main()
+{
+	check(clampedColumnsInOrder(), "clamped columns in order");
+	check(allMatch(true, SkShader::kClamp_TileMode, false), "solid color");
+	check(allMatch(false, SkShader::kClamp_TileMode, false), "clamp scale");
+	check(allMatch(false, SkShader::kClamp_TileMode, true), "clamp affine");
+	check(allMatch(false, SkShader::kRepeat_TileMode, false), "repeat scale");
+	check(allMatch(false, SkShader::kRepeat_TileMode, true), "repeat affine");
+	return testResult();
+}
@@ -0,0 +1,136 @@
+// a glyph cache snapshot loads back into the font cache and draws the same text, and a snapshot cut
+// short or of a font that changed since loads nothing it cannot trust, without touching the cache.
+
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkGraphics.h"
+#include "SkPaint.h"
+#include "TestHelper.h"
+#include <string>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+const int WIDTH = 256;
+const int HEIGHT = 96;
+const char* const TEXT = "snapshot glyphs";
+
+// the snapshot starts with a header of six 32 bit fields, followed by the identity of the first
+// typeface, its head table checksum adjustment first.
+const size_t HEADER_SIZE = 6 * 4;
+
+namespace
+{
+	// the text at two sizes, so that the snapshot holds two strikes.
+	void drawText(SkBitmap* bitmap)
+	{
+		bitmap->setConfig(SkBitmap::kARGB_8888_Config, WIDTH, HEIGHT);
+		bitmap->allocPixels();
+		bitmap->eraseColor(SK_ColorWHITE);
+		SkCanvas canvas(*bitmap);
+		SkPaint paint;
+		paint.setAntiAlias(true);
+		paint.setTextSize(SkIntToScalar(18));
+		canvas.drawText(TEXT, strlen(TEXT), SkIntToScalar(4), SkIntToScalar(30), paint);
+		paint.setTextSize(SkIntToScalar(32));
+		canvas.drawText(TEXT, strlen(TEXT), SkIntToScalar(4), SkIntToScalar(80), paint);
+	}
+
+	bool samePixels(const SkBitmap& a, const SkBitmap& b)
+	{
+		SkAutoLockPixels lockA(a);
+		SkAutoLockPixels lockB(b);
+		return 0 == memcmp(a.getPixels(), b.getPixels(), a.getSize());
+	}
+
+	std::string readFile(const char* path)
+	{
+		std::string content;
+		FILE* file = fopen(path, "rb");
+
+		if (nullptr == file)
+		{
+			return content;
+		}
+
+		char buffer[4096];
+		size_t read = 0;
+
+		while (0 < (read = fread(buffer, 1, sizeof(buffer), file)))
+		{
+			content.append(buffer, read);
+		}
+
+		fclose(file);
+		return content;
+	}
+
+	void writeFile(const char* path, const std::string& content)
+	{
+		FILE* file = fopen(path, "wb");
+
+		if (nullptr != file)
+		{
+			fwrite(content.data(), 1, content.size(), file);
+			fclose(file);
+		}
+	}
+
+	// loads the snapshot from an empty font cache, returning the number of strikes it loaded. a load
+	// that fails leaves the cache empty.
+	int loadInto(const char* path, bool* cacheEmpty)
+	{
+		SkGraphics::PurgeFontCache();
+		int count = SkGraphics::LoadFontCacheSnapshot(path);
+		*cacheEmpty = 0 == SkGraphics::GetFontCacheUsed();
+		return count;
+	}
+}
+
+int main()
+{
+	SkGraphics::Init();
+	char path[] = "/tmp/GlyphCacheSnapshotTestXXXXXX";
+	int file = mkstemp(path);
+	check(-1 != file, "temporary file");
+	close(file);
+
+	SkBitmap expected;
+	drawText(&expected);
+	check(SkGraphics::WriteFontCacheSnapshot(path), "snapshot written");
+	std::string snapshot = readFile(path);
+	check(HEADER_SIZE + 4 < snapshot.size(), "snapshot not empty");
+
+	// round trip
+	bool cacheEmpty = false;
+	int strikeCount = loadInto(path, &cacheEmpty);
+	check(2 <= strikeCount && !cacheEmpty, "strikes loaded");
+	SkBitmap actual;
+	drawText(&actual);
+	check(samePixels(expected, actual), "text drawn from the loaded strikes");
+	check(0 == loadInto("/tmp/GlyphCacheSnapshotTest-missing", &cacheEmpty) && cacheEmpty, "missing file");
+
+	// truncated, the strikes cut off are not loaded.
+	size_t lengths[] = { 0, 3, HEADER_SIZE, HEADER_SIZE + 10, snapshot.size() / 2, snapshot.size() - 1 };
+
+	for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); ++i)
+	{
+		writeFile(path, snapshot.substr(0, lengths[i]));
+		int count = loadInto(path, &cacheEmpty);
+		check(count < strikeCount, "truncated snapshot loads fewer strikes");
+		check(0 < count || cacheEmpty, "truncated snapshot leaves the cache empty");
+		drawText(&actual);
+		check(samePixels(expected, actual), "text drawn after a truncated snapshot");
+	}
+
+	// the font of the snapshot is not the font of this name anymore.
+	std::string changed = snapshot;
+	changed[HEADER_SIZE] ^= 0x5A;
+	writeFile(path, changed);
+	check(0 == loadInto(path, &cacheEmpty) && cacheEmpty, "snapshot of a changed font not loaded");
+	drawText(&actual);
+	check(samePixels(expected, actual), "text drawn after a snapshot of a changed font");
+
+	unlink(path);
+	return testResult();
+}
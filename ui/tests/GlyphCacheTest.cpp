@@ -0,0 +1,69 @@
+// the glyphs pinned by the font cache's strikes are counted in the glyph cache subsystem, and a
+// full font cache gives up its least recently used strike rather than all of them.
+
+#include "UIDefine.h"
+#include "Canvas.h"
+#include "KFont.h"
+#include "KFontFamily.h"
+#include "KPoint.h"
+#include "KSolidBrush.h"
+#include "KString.h"
+#include "MemoryTracker.h"
+#include "SkGraphics.h"
+#include "SkGlyphStrike.h"
+#include "SkMatrix.h"
+#include "SkPaint.h"
+#include "graphics/skia/SkiaFontCache.h"
+#include "TestHelper.h"
+
+namespace
+{
+	size_t glyphBytes()
+	{
+		return MemoryTracker::getInstance()->getBytes(ak::kMemoryGlyphCache);
+	}
+}
+
+int main()
+{
+	Canvas* canvas = new Canvas;
+	check(canvas->init(256, 64, ak::SkiaGraphics), "canvas");
+
+	KFontFamily family((wchar_t*)L"sans");
+	KFont font(&family, 24, KFontStyleRegular);
+	KSolidBrush brush(Color(255, 0, 0, 0));
+	KString text((wchar_t*)L"glyphs held by a strike");
+	check(canvas->drawString(text, -1, font, KPoint(4, 40), &brush), "string drawn");
+
+	// skia's list no longer has the cache, the strike does.
+	SkGraphics::PurgeFontCache();
+	size_t held = glyphBytes();
+	check(held > 0, "strike glyphs counted");
+
+	// the strikes give their caches back to skia, which can then purge them.
+	delete canvas;
+	SkGraphics::PurgeFontCache();
+	check(glyphBytes() < held, "strike glyphs uncounted with the canvas");
+
+	// a strike used between the new ones outlives the font cache being filled twice over.
+	SkiaFontCache* fontCache = new SkiaFontCache;
+	SkPaint paint;
+	paint.setTextSize(SkIntToScalar(12));
+	SkGlyphStrike* used = fontCache->getStrike(paint, SkMatrix::I());
+	used->ref();
+	bool kept = true;
+
+	for (int size = 13; size < 13 + 64; ++size)
+	{
+		SkPaint sizedPaint;
+		sizedPaint.setTextSize(SkIntToScalar(size));
+		fontCache->getStrike(sizedPaint, SkMatrix::I());
+		kept = kept && used == fontCache->getStrike(paint, SkMatrix::I());
+	}
+
+	check(kept, "recently used strike kept");
+	used->unref();
+	delete fontCache;
+
+	return testResult();
+}
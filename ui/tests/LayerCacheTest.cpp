@@ -0,0 +1,116 @@
+// a cached layer drawn every frame while its idle tiles are packed on the workers keeps its pixels,
+// and a layer left idle is packed and decoded again to the same pixels.
+
+#include "UIDefine.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkColorPriv.h"
+#include "SkUnPreMultiply.h"
+#include "graphics/skia/SkiaLayerCache.h"
+#include "TestHelper.h"
+#include <unistd.h>
+
+const int LAYER_WIDTH = 1024;
+const int LAYER_HEIGHT = 512;
+const int FRAME_COUNT = 3000;
+
+namespace
+{
+	// stripes of 16 rows, they pack well.
+	SkPMColor stripeColor(int y)
+	{
+		return SkPackARGB32(0xFF, (y / 16) * 8 & 0xFF, 0x40, 0x80);
+	}
+
+	void recordLayer(SkiaLayerCache* cache, const void* key)
+	{
+		SkCanvas* canvas = cache->beginLayer(key, KRect(0, 0, LAYER_WIDTH, LAYER_HEIGHT));
+
+		if (nullptr == canvas)
+		{
+			return;
+		}
+
+		SkPaint paint;
+
+		for (int y = 0; y < LAYER_HEIGHT; y += 16)
+		{
+			paint.setColor(SkUnPreMultiply::PMColorToColor(stripeColor(y)));
+			canvas->drawRect(SkRect::MakeXYWH(0, SkIntToScalar(y), SkIntToScalar(LAYER_WIDTH), 16), paint);
+		}
+
+		cache->endLayer();
+	}
+
+	bool drawnIntact(SkiaLayerCache* cache, const void* key, SkBitmap* target)
+	{
+		target->eraseColor(0);
+		SkCanvas canvas(*target);
+
+		if (!cache->drawLayer(key, &canvas))
+		{
+			return false;
+		}
+
+		for (int y = 0; y < LAYER_HEIGHT; y += 7)
+		{
+			for (int x = 0; x < LAYER_WIDTH; x += 13)
+			{
+				if (stripeColor(y) != *target->getAddr32(x, y))
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+}
+
+int main()
+{
+	SkiaLayerCache* cache = new SkiaLayerCache;
+	int key = 0;
+	SkBitmap target;
+	target.setConfig(SkBitmap::kARGB_8888_Config, LAYER_WIDTH, LAYER_HEIGHT);
+	target.allocPixels();
+
+	recordLayer(cache, &key);
+	cache->setIdleFrames(1);
+	bool intact = true;
+
+	// every frame schedules a pack of each tile and takes it back before the workers are done.
+	for (int frame = 0; frame < FRAME_COUNT && intact; ++frame)
+	{
+		cache->advanceFrame();
+		// lets the workers start, the draw below takes their tiles back while they are packing.
+		usleep(frame % 50);
+		intact = drawnIntact(cache, &key, &target);
+	}
+
+	check(intact, "layer drawn while its tiles are packed");
+
+	size_t rawBytes = 0;
+	size_t packedBytes = 0;
+
+	// tiles still packed from the loop above are scheduled again once their task is done. the bound
+	// is for a loaded machine, an idle one is done in a few milliseconds.
+	for (int wait = 0; wait < 1000; ++wait)
+	{
+		cache->advanceFrame();
+		cache->getMemory(&rawBytes, &packedBytes);
+
+		if (0 == rawBytes)
+		{
+			break;
+		}
+
+		usleep(10000);
+	}
+
+	check(0 == rawBytes && 0 < packedBytes, "idle layer packed");
+	check(drawnIntact(cache, &key, &target), "packed layer decoded");
+
+	delete cache;
+	return testResult();
+}
@@ -0,0 +1,51 @@
+// a mesh with an index past its vertices is refused before either path reads through it.
+
+#include "UIDefine.h"
+#include "graphics/skia/SkiaMeshRenderer.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkPaint.h"
+#include "TestHelper.h"
+
+namespace
+{
+	bool drawMesh(SkiaMeshRenderer* renderer, SkBitmap* device, const SkBitmap& texture,
+		const unsigned short* indices, int indexCount, bool rasterize)
+	{
+		const float vertices[] = { 0, 0, 64, 0, 0, 64, 64, 64 };
+		const float texCoords[] = { 0, 0, 16, 0, 0, 16, 16, 16 };
+		device->eraseColor(0);
+		SkCanvas canvas(*device);
+		SkPaint paint;
+		return renderer->drawMesh(&canvas, texture, vertices, texCoords, 4, indices, indexCount, paint, rasterize);
+	}
+}
+
+int main()
+{
+	SkBitmap texture;
+	texture.setConfig(SkBitmap::kARGB_8888_Config, 16, 16);
+	texture.allocPixels();
+	texture.eraseColor(SK_ColorRED);
+
+	SkBitmap device;
+	device.setConfig(SkBitmap::kARGB_8888_Config, 64, 64);
+	device.allocPixels();
+
+	SkiaMeshRenderer renderer;
+	const unsigned short good[] = { 0, 1, 2, 1, 3, 2 };
+	const unsigned short bad[] = { 0, 1, 2, 1, 3, 60000 };
+
+	for (int rasterize = 0; rasterize < 2; ++rasterize)
+	{
+		check(drawMesh(&renderer, &device, texture, good, 6, 0 != rasterize), "valid mesh draws");
+		check(SK_ColorRED == device.getColor(32, 32), "valid mesh covers the device");
+
+		check(!drawMesh(&renderer, &device, texture, bad, 6, 0 != rasterize), "index past the vertices fails");
+		check(0 == device.getColor(32, 32), "invalid mesh draws nothing");
+
+		check(!drawMesh(&renderer, &device, texture, good, -3, 0 != rasterize), "negative index count fails");
+	}
+
+	return testResult();
+}
@@ -0,0 +1,82 @@
+// a path moved in place must not be measured from the segments cached for it before, and the
+// contours of a path with more points than a segment's 15 bit point index holds are measured
+// from their own points.
+
+#include "SkPath.h"
+#include "SkPathMeasure.h"
+#include "SkMatrix.h"
+#include "TestHelper.h"
+
+namespace
+{
+	// segments keep their t in fixed point, so the positions are only close.
+	bool posAt(SkPathMeasure& measure, SkScalar distance, SkScalar x, SkScalar y)
+	{
+		SkPoint pos;
+		return measure.getPosTan(distance, &pos, nullptr) && SkScalarNearlyEqual(pos.fX, x, 0.01f)
+			&& SkScalarNearlyEqual(pos.fY, y, 0.01f);
+	}
+
+	bool posAt(const SkPath& path, SkScalar distance, SkScalar x, SkScalar y)
+	{
+		SkPathMeasure measure(path, false);
+		return posAt(measure, distance, x, y);
+	}
+}
+
+int main()
+{
+	SkPath path;
+	path.moveTo(0, 0);
+	path.lineTo(100, 0);
+	path.lineTo(100, 100);
+
+	check(posAt(path, 50, 50, 0), "measure before the offset");
+
+	// the path ref is not shared, so the points are offset in place.
+	path.offset(10, 20);
+	check(posAt(path, 50, 60, 20), "measure after the offset");
+
+	SkMatrix matrix;
+	matrix.setScale(2, 2);
+	path.transform(matrix);
+	SkPathMeasure measure(path, false);
+	check(SkScalarNearlyEqual(measure.getLength(), 400), "length after the transform");
+	check(posAt(measure, 150, 170, 40), "measure after the transform");
+
+	// 1200 contours of 30 points, 36000 points in all.
+	SkPath contours;
+
+	for (int i = 0; i < 1200; ++i)
+	{
+		contours.moveTo(0, SkIntToScalar(i * 5));
+
+		for (int x = 1; x < 30; ++x)
+		{
+			contours.lineTo(SkIntToScalar(x), SkIntToScalar(i * 5));
+		}
+	}
+
+	SkPathMeasure contourMeasure(contours, false);
+	contourMeasure.getLength();
+	int contourCount = 1;
+
+	while (contourMeasure.nextContour())
+	{
+		++contourCount;
+	}
+
+	check(1200 == contourCount, "every contour measured");
+	contourMeasure.setPath(&contours, false);
+	contourMeasure.getLength();
+
+	for (int i = 0; i < 1199; ++i)
+	{
+		contourMeasure.nextContour();
+	}
+
+	check(posAt(contourMeasure, SkFloatToScalar(14.5f), SkFloatToScalar(14.5f), 5995),
+		"last contour measured from its points");
+
+	return testResult();
+}
@@ -0,0 +1,76 @@
+// a pdf canvas saves the pages drawn so far, and drawing after a save goes to a new document.
+
+#include "UIDefine.h"
+#include "Canvas.h"
+#include "KRect.h"
+#include "KSolidBrush.h"
+#include "KString.h"
+#include "Color.h"
+#include "TestHelper.h"
+#include <string>
+#include <stdlib.h>
+#include <unistd.h>
+
+namespace
+{
+	std::string readFile(const char* path)
+	{
+		std::string content;
+		FILE* file = fopen(path, "rb");
+
+		if (nullptr == file)
+		{
+			return content;
+		}
+
+		char buffer[4096];
+		size_t read = 0;
+
+		while (0 < (read = fread(buffer, 1, sizeof(buffer), file)))
+		{
+			content.append(buffer, read);
+		}
+
+		fclose(file);
+		return content;
+	}
+
+	// true if the document at path is a pdf of pageCount pages.
+	bool isPdf(const char* path, int pageCount)
+	{
+		std::string content = readFile(path);
+		char count[32] = {0};
+		snprintf(count, sizeof(count), "/Count %d", pageCount);
+		return 0 == content.compare(0, 5, "%PDF-") && std::string::npos != content.find(count);
+	}
+}
+
+int main()
+{
+	char path[] = "/tmp/PdfDocumentTestXXXXXX";
+	int file = mkstemp(path);
+	check(-1 != file, "temporary file");
+	close(file);
+	wchar_t widePath[sizeof(path)] = {0};
+	mbstowcs(widePath, path, sizeof(path));
+	KString pdfPath(widePath);
+
+	Canvas* canvas = new Canvas;
+	check(canvas->init(200, 100, ak::PdfGraphics), "pdf canvas");
+	KSolidBrush brush(Color(255, 0x20, 0x40, 0x80));
+
+	KRect rect(10, 10, 90, 60);
+	canvas->fillRect(&brush, rect);
+	check(canvas->newPage(), "second page");
+	canvas->fillRect(&brush, rect);
+	check(canvas->saveDocument(pdfPath), "two pages saved");
+	check(isPdf(path, 2), "document of two pages");
+
+	canvas->fillRect(&brush, rect);
+	check(canvas->saveDocument(pdfPath), "page drawn after the save saved");
+	check(isPdf(path, 1), "new document of one page");
+
+	delete canvas;
+	unlink(path);
+	return testResult();
+}
@@ -0,0 +1,154 @@
+// a jpeg drawn whole to a pdf page is embedded as is, with the color space its header implies.
+
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkData.h"
+#include "SkImageDecoder.h"
+#include "SkImageRef_GlobalPool.h"
+#include "SkPDFDevice.h"
+#include "SkPDFDocument.h"
+#include "SkStream.h"
+#include "TestHelper.h"
+#include <stdlib.h>
+#include <string>
+
+extern "C"
+{
+#include "jpeglib.h"
+}
+
+const int SIZE = 16;
+
+namespace
+{
+	// a jpeg of inColorSpace pixels stored as jpegColorSpace, with an adobe segment if adobe is set.
+	SkData* makeJpeg(J_COLOR_SPACE inColorSpace, J_COLOR_SPACE jpegColorSpace, int components, bool adobe)
+	{
+		FILE* file = tmpfile();
+
+		if (nullptr == file)
+		{
+			return nullptr;
+		}
+
+		jpeg_compress_struct cinfo;
+		jpeg_error_mgr error;
+		cinfo.err = jpeg_std_error(&error);
+		jpeg_create_compress(&cinfo);
+		jpeg_stdio_dest(&cinfo, file);
+		cinfo.image_width = SIZE;
+		cinfo.image_height = SIZE;
+		cinfo.input_components = components;
+		cinfo.in_color_space = inColorSpace;
+		jpeg_set_defaults(&cinfo);
+		jpeg_set_colorspace(&cinfo, jpegColorSpace);
+		cinfo.write_Adobe_marker = adobe ? TRUE : FALSE;
+		jpeg_start_compress(&cinfo, TRUE);
+
+		JSAMPLE row[SIZE * 4];
+
+		for (int i = 0; i < SIZE * components; ++i)
+		{
+			row[i] = (JSAMPLE)(i % components * 60);
+		}
+
+		while (cinfo.next_scanline < cinfo.image_height)
+		{
+			JSAMPROW rows[1] = { row };
+			jpeg_write_scanlines(&cinfo, rows, 1);
+		}
+
+		jpeg_finish_compress(&cinfo);
+		jpeg_destroy_compress(&cinfo);
+
+		long length = ftell(file);
+		rewind(file);
+		void* bytes = malloc(length);
+		size_t read = fread(bytes, 1, length, file);
+		fclose(file);
+		return SkData::NewFromMalloc(bytes, read);
+	}
+
+	// the pdf of a page with the jpeg drawn at its size, downsampled on pool when there is one.
+	std::string drawToPdf(SkData* jpeg, SkScalar downsampleDpi, bool usePool)
+	{
+		SkMemoryStream* stream = new SkMemoryStream;
+		stream->setData(jpeg);
+		SkImageRef_GlobalPool* pixelRef = new SkImageRef_GlobalPool(stream, SkBitmap::kARGB_8888_Config);
+		stream->unref();
+
+		SkBitmap bitmap;
+		bitmap.setConfig(SkBitmap::kARGB_8888_Config, SIZE, SIZE);
+		bitmap.setIsOpaque(true);
+		bitmap.setPixelRef(pixelRef)->unref();
+
+		SkDynamicMemoryWStream output;
+
+		{
+			SkPDFDocument document;
+			SkMatrix identity;
+			identity.reset();
+			SkISize pageSize = SkISize::Make(SIZE * 4, SIZE * 4);
+			SkPDFDevice* page = new SkPDFDevice(pageSize, pageSize, identity);
+			page->setImageDownsampleDpi(downsampleDpi, usePool ? document.getImagePool() : nullptr);
+
+			SkCanvas canvas(page);
+			canvas.drawBitmap(bitmap, 0, 0);
+			document.appendPage(page);
+			page->unref();
+			document.emitPDF(&output);
+		}
+
+		SkData* pdf = output.copyToData();
+		std::string text((const char*)pdf->data(), pdf->size());
+		pdf->unref();
+		return text;
+	}
+
+	bool contains(const std::string& text, const char* part)
+	{
+		return std::string::npos != text.find(part);
+	}
+}
+
+int main()
+{
+	// downsampling decodes the jpeg, the decoder registers itself with the factory once linked.
+	delete CreateJPEGImageDecoder();
+
+	// jpeg_set_colorspace names the components of an rgb jpeg R, G and B.
+	SkData* ycc = makeJpeg(JCS_RGB, JCS_YCbCr, 3, false);
+	SkData* rgb = makeJpeg(JCS_RGB, JCS_RGB, 3, false);
+	SkData* cmyk = makeJpeg(JCS_CMYK, JCS_CMYK, 4, true);
+	check(nullptr != ycc && nullptr != rgb && nullptr != cmyk, "jpegs encoded");
+
+	if (0 != g_failures)
+	{
+		return 1;
+	}
+
+	std::string yccPdf = drawToPdf(ycc, 0, false);
+	check(contains(yccPdf, "/DCTDecode"), "ycc jpeg embedded as is");
+	check(contains(yccPdf, "/DeviceRGB"), "ycc jpeg in DeviceRGB");
+	check(!contains(yccPdf, "/ColorTransform"), "ycc jpeg transformed by default");
+
+	std::string rgbPdf = drawToPdf(rgb, 0, false);
+	check(contains(rgbPdf, "/DeviceRGB"), "rgb jpeg in DeviceRGB");
+	check(contains(rgbPdf, "/ColorTransform 0"), "rgb jpeg not transformed from YCbCr");
+
+	std::string cmykPdf = drawToPdf(cmyk, 0, false);
+	check(contains(cmykPdf, "/DCTDecode"), "cmyk jpeg embedded as is");
+	check(contains(cmykPdf, "/DeviceCMYK"), "cmyk jpeg in DeviceCMYK");
+	check(contains(cmykPdf, "/Decode [1 0 1 0 1 0 1 0]"), "adobe cmyk jpeg inverted");
+
+	// drawn 16 points wide, 36 dpi keeps 8 pixels, on the document's threads or on this one.
+	std::string pooledPdf = drawToPdf(ycc, SkIntToScalar(36), true);
+	check(contains(pooledPdf, "/Width 8"), "downsampled on the document's threads");
+	std::string inlinePdf = drawToPdf(ycc, SkIntToScalar(36), false);
+	check(contains(inlinePdf, "/Width 8"), "downsampled while drawn");
+
+	ycc->unref();
+	rgb->unref();
+	cmyk->unref();
+	return testResult();
+}
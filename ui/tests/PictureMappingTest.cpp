@@ -0,0 +1,207 @@
+// a mappable picture loads back and draws the same pixels, and a truncated picture or one whose counts
+// and sizes were overwritten fails to load instead of allocating or reading past its data. the
+// flattened paints and the serialized typefaces are read by their own unflatten code, which this
+// does not cover.
+
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkColorPriv.h"
+#include "SkData.h"
+#include "SkGradientShader.h"
+#include "SkGraphics.h"
+#include "SkPaint.h"
+#include "SkPicture.h"
+#include "SkShader.h"
+#include "SkStream.h"
+#include "TestHelper.h"
+#include <string.h>
+
+const int SIZE = 64;
+
+// the tags SkPicturePlayback.cpp writes before the flattened buffer and the typeface table.
+const uint32_t BUFFER_SIZE_TAG = SkSetFourByteTag('a', 'r', 'a', 'y');
+const uint32_t TYPEFACE_TAG = SkSetFourByteTag('t', 'p', 'f', 'c');
+const size_t ALIGNMENT = 16;
+
+namespace
+{
+	void makeBitmap(SkBitmap* bitmap, int size)
+	{
+		bitmap->setConfig(SkBitmap::kARGB_8888_Config, size, size);
+		bitmap->allocPixels();
+	}
+
+	// a bitmap, a gradient and text, so that the picture has bitmap blocks, factories and typefaces,
+	// and a picture drawn in it.
+	void record(SkPicture* picture, const SkBitmap& bitmap)
+	{
+		// the picture keeps a ref to the pictures it draws.
+		SkPicture* inner = new SkPicture;
+		SkCanvas* innerCanvas = inner->beginRecording(SIZE, SIZE);
+		SkPaint paint;
+		paint.setColor(0xFF2080C0);
+		innerCanvas->drawRect(SkRect::MakeXYWH(40, 40, 20, 20), paint);
+		inner->endRecording();
+
+		SkCanvas* canvas = picture->beginRecording(SIZE, SIZE);
+		canvas->clear(SK_ColorWHITE);
+		canvas->drawBitmap(bitmap, 4, 4);
+		SkPoint points[2] = { SkPoint::Make(24, 4), SkPoint::Make(40, 20) };
+		SkColor colors[2] = { SK_ColorRED, SK_ColorBLUE };
+		SkShader* shader = SkGradientShader::CreateLinear(points, colors, nullptr, 2, SkShader::kClamp_TileMode);
+		paint.setShader(shader)->unref();
+		canvas->drawRect(SkRect::MakeXYWH(24, 4, 16, 16), paint);
+		paint.setShader(nullptr);
+		paint.setColor(SK_ColorBLACK);
+		canvas->drawText("map", 3, 4, 56, paint);
+		canvas->drawPicture(*inner);
+		picture->endRecording();
+		inner->unref();
+	}
+
+	void draw(SkPicture* picture, SkBitmap* target)
+	{
+		makeBitmap(target, SIZE);
+		target->eraseColor(0);
+		SkCanvas canvas(*target);
+		picture->draw(&canvas);
+	}
+
+	uint32_t readU32(const SkData* data, size_t offset)
+	{
+		uint32_t value = 0;
+		memcpy(&value, data->bytes() + offset, sizeof(value));
+		return value;
+	}
+
+	struct Range
+	{
+		size_t start;
+		size_t stop;
+	};
+
+	// the flattened buffers, which are 16 byte aligned after their tag and size, and the serialized
+	// typefaces between the typeface count and the trailer.
+	int findPayloads(const SkData* data, Range* ranges, int maxCount)
+	{
+		size_t tablesOffset = readU32(data, data->size() - 8);
+		int count = 0;
+
+		for (size_t offset = 0; offset + 8 <= data->size() && count < maxCount; ++offset)
+		{
+			uint32_t tag = readU32(data, offset);
+
+			if (BUFFER_SIZE_TAG == tag && offset < tablesOffset)
+			{
+				ranges[count].start = (offset + 8 + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+				ranges[count].stop = ranges[count].start + readU32(data, offset + 4);
+				++count;
+			}
+			else if (TYPEFACE_TAG == tag && offset >= tablesOffset)
+			{
+				ranges[count].start = offset + 8;
+				ranges[count].stop = data->size() - 8;
+				++count;
+			}
+		}
+
+		return count;
+	}
+
+	bool inPayload(const Range* ranges, int count, size_t offset)
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			if (offset + 4 > ranges[i].start && offset < ranges[i].stop)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	bool loads(const void* data, size_t size)
+	{
+		SkData* copy = SkData::NewWithCopy(data, size);
+		SkPicture* picture = SkPicture::CreateFromData(copy);
+		copy->unref();
+		SkSafeUnref(picture);
+		return nullptr != picture;
+	}
+}
+
+int main()
+{
+	// registers the factories the gradient is read back with.
+	SkGraphics::Init();
+	SkBitmap bitmap;
+	makeBitmap(&bitmap, 16);
+
+	for (int y = 0; y < 16; ++y)
+	{
+		for (int x = 0; x < 16; ++x)
+		{
+			*bitmap.getAddr32(x, y) = SkPackARGB32(0xFF, x * 16, y * 16, 0x80);
+		}
+	}
+
+	SkPicture picture;
+	record(&picture, bitmap);
+	SkDynamicMemoryWStream stream;
+	picture.serializeMappable(&stream);
+	SkData* data = stream.copyToData();
+
+	// round trip
+	SkPicture* loaded = SkPicture::CreateFromData(data);
+	check(nullptr != loaded, "mappable picture loaded");
+
+	if (nullptr != loaded)
+	{
+		SkBitmap expected;
+		SkBitmap actual;
+		draw(&picture, &expected);
+		draw(loaded, &actual);
+		SkAutoLockPixels lockExpected(expected);
+		SkAutoLockPixels lockActual(actual);
+		check(0 == memcmp(expected.getPixels(), actual.getPixels(), expected.getSize()), "loaded picture drawn");
+		loaded->unref();
+	}
+
+	// truncated
+	bool anyTruncatedLoaded = false;
+
+	for (size_t size = 0; size < data->size(); ++size)
+	{
+		anyTruncatedLoaded |= loads(data->data(), size);
+	}
+
+	check(!anyTruncatedLoaded, "truncated picture not loaded");
+
+	// every four bytes the mapping reads overwritten in turn by counts and sizes too large for the data. the
+	// picture may load when the word was not a count, but must not allocate or read what the data
+	// cannot hold.
+	Range payloads[8];
+	int payloadCount = findPayloads(data, payloads, 8);
+	check(2 <= payloadCount, "flattened buffer and typefaces found");
+	const uint32_t largeValues[] = { 0xFFFFFFFF, 0x7FFFFFF0, 0x00FFFFFF, 0x00010000 };
+	SkAutoMalloc corrupt(data->size());
+
+	for (size_t offset = 0; offset + 4 <= data->size(); ++offset)
+	{
+		if (inPayload(payloads, payloadCount, offset))
+		{
+			continue;
+		}
+
+		for (size_t i = 0; i < sizeof(largeValues) / sizeof(largeValues[0]); ++i)
+		{
+			memcpy(corrupt.get(), data->data(), data->size());
+			memcpy((char*)corrupt.get() + offset, &largeValues[i], 4);
+			loads(corrupt.get(), data->size());
+		}
+	}
+
+	data->unref();
+	return testResult();
+}
@@ -0,0 +1,60 @@
+// a recorded op reuses the paint of the op before it only when the paints are equal, even
+// when a new xfermode is allocated where the last one was.
+
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkPaint.h"
+#include "SkPicture.h"
+#include "SkXfermode.h"
+#include "TestHelper.h"
+#include <string.h>
+
+const int SIZE = 64;
+
+namespace
+{
+	// rects in rows, each with a short lived paint whose xfermode and color change every few ops.
+	void drawRects(SkCanvas* canvas)
+	{
+		canvas->clear(SK_ColorWHITE);
+
+		for (int i = 0; i < 64; ++i)
+		{
+			SkPaint paint;
+			paint.setColor(0 == (i / 3) % 2 ? 0x80FF0000 : 0x800000FF);
+			SkXfermode* xfermode = SkXfermode::Create(0 == (i / 2) % 2 ? SkXfermode::kSrc_Mode :
+				SkXfermode::kMultiply_Mode);
+			SkSafeUnref(paint.setXfermode(xfermode));
+			SkScalar x = SkIntToScalar(i % 8 * 8);
+			SkScalar y = SkIntToScalar(i / 8 * 8);
+			canvas->drawRect(SkRect::MakeXYWH(x, y, 12, 12), paint);
+		}
+	}
+
+	void makeBitmap(SkBitmap* bitmap)
+	{
+		bitmap->setConfig(SkBitmap::kARGB_8888_Config, SIZE, SIZE);
+		bitmap->allocPixels();
+	}
+}
+
+int main()
+{
+	SkBitmap direct;
+	makeBitmap(&direct);
+	SkCanvas directCanvas(direct);
+	drawRects(&directCanvas);
+
+	SkPicture picture;
+	drawRects(picture.beginRecording(SIZE, SIZE));
+	picture.endRecording();
+
+	SkBitmap played;
+	makeBitmap(&played);
+	SkCanvas playedCanvas(played);
+	picture.draw(&playedCanvas);
+
+	check(0 == memcmp(direct.getPixels(), played.getPixels(), direct.getSize()), "picture draws what was recorded");
+
+	return testResult();
+}
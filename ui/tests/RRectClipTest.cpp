@@ -0,0 +1,131 @@
+// an antialiased round rect clip kept analytically covers every pixel the way the mask clip of the
+// same round rect does, and threads asking it for that mask clip at once share one.
+
+#include "SkAAClip.h"
+#include "SkMask.h"
+#include "SkPath.h"
+#include "SkRRect.h"
+#include "SkRRectClip.h"
+#include "SkRunnable.h"
+#include "SkThreadPool.h"
+#include "TestHelper.h"
+
+const int THREAD_COUNT = 8;
+
+namespace
+{
+	SkAlpha analyticCoverage(const SkRRectClip& clip, int x, int y)
+	{
+		const SkRRectClip::Row* row = clip.getRow(y);
+
+		if (nullptr == row)
+		{
+			return 0xFF;
+		}
+
+		const SkIRect& rect = clip.getRect();
+
+		if (x < rect.fLeft + row->fLeftCount)
+		{
+			return clip.getAlpha(row)[x - rect.fLeft];
+		}
+
+		if (x >= rect.fRight - row->fRightCount)
+		{
+			return clip.getAlpha(row)[row->fLeftCount + x - (rect.fRight - row->fRightCount)];
+		}
+
+		return 0xFF;
+	}
+
+	// the largest difference between the analytic coverage and the one of SkAAClip.
+	int coverageDifference(const SkRRect& rrect)
+	{
+		SkIRect bounds;
+		rrect.rect().round(&bounds);
+		SkRRectClip clip(rrect, bounds);
+
+		SkPath path;
+		path.addRRect(rrect);
+		SkRegion region(bounds);
+		SkAAClip aaClip;
+		aaClip.setPath(path, &region, true);
+		SkMask mask;
+		aaClip.copyToMask(&mask);
+
+		int difference = 0;
+
+		for (int y = bounds.fTop; y < bounds.fBottom; ++y)
+		{
+			for (int x = bounds.fLeft; x < bounds.fRight; ++x)
+			{
+				int expected = mask.fBounds.contains(x, y) ? *mask.getAddr8(x, y) : 0;
+				int actual = analyticCoverage(clip, x, y);
+				int delta = expected > actual ? expected - actual : actual - expected;
+				difference = delta > difference ? delta : difference;
+			}
+		}
+
+		SkMask::FreeImage(mask.fImage);
+		return difference;
+	}
+
+	class AAClipTask : public SkRunnable
+	{
+	public:
+		AAClipTask()
+			: _clip(nullptr)
+			, _result(nullptr)
+		{
+
+		}
+
+		virtual void run() override
+		{
+			_result = &_clip->aaClip();
+		}
+
+		const SkRRectClip* _clip;
+		const SkAAClip* _result;
+	};
+}
+
+int main()
+{
+	SkRRect rrect;
+	rrect.setRectXY(SkRect::MakeLTRB(3, 5, 83, 45), 12, 12);
+	check(0 == coverageDifference(rrect), "circular corners");
+
+	rrect.setRectXY(SkRect::MakeLTRB(0, 0, 120, 30), SkFloatToScalar(30.5f), SkFloatToScalar(7.25f));
+	check(0 == coverageDifference(rrect), "steep elliptical corners");
+
+	SkVector radii[4] = { { 4, 4 }, { 20, 9 }, { 0, 0 }, { SkFloatToScalar(2.5f), 16 } };
+	rrect.setRectRadii(SkRect::MakeLTRB(10, 10, 60, 50), radii);
+	check(0 == coverageDifference(rrect), "mixed corners");
+
+	rrect.setRectXY(SkRect::MakeLTRB(0, 0, 20, 20), 10, 10);
+	check(0 == coverageDifference(rrect), "corners meeting at the center");
+
+	rrect.setRectXY(SkRect::MakeLTRB(-7, 2, 33, 17), 9, 6);
+	SkIRect bounds = SkIRect::MakeLTRB(-7, 2, 33, 17);
+	SkRRectClip clip(rrect, bounds);
+	AAClipTask tasks[THREAD_COUNT];
+	SkThreadPool* pool = new SkThreadPool(THREAD_COUNT);
+
+	for (int i = 0; i < THREAD_COUNT; ++i)
+	{
+		tasks[i]._clip = &clip;
+		pool->add(&tasks[i]);
+	}
+
+	// waits for the tasks.
+	delete pool;
+
+	for (int i = 1; i < THREAD_COUNT; ++i)
+	{
+		check(tasks[0]._result == tasks[i]._result, "one mask clip built for every thread");
+	}
+
+	check(tasks[0]._result->getBounds() == bounds, "mask clip of the bounds");
+	return testResult();
+}
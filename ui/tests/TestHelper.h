@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stdio.h>
+
+// each test is a program of its own that includes this once. check prints what failed and goes on,
+// main returns testResult().
+namespace
+{
+	int g_failures = 0;
+
+	void check(bool passed, const char* what)
+	{
+		if (!passed)
+		{
+			printf("FAILED: %s\n", what);
+			++g_failures;
+		}
+	}
+
+	int testResult()
+	{
+		return 0 == g_failures ? 0 : 1;
+	}
+}
@@ -0,0 +1,96 @@
+// a tiled image view paints again once the tiles it drew blurred have loaded.
+
+#include "UIDefine.h"
+#include "RootView.h"
+#include "TileImageView.h"
+#include "TileImageSource.h"
+#include "Canvas.h"
+#include "MemoryTracker.h"
+#include "SkBitmap.h"
+#include "SkColorPriv.h"
+#include "SkImageEncoder.h"
+#include "TestHelper.h"
+#include <stdlib.h>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+	class CountingTileImageView : public TileImageView
+	{
+	public:
+		CountingTileImageView()
+			: _paints(0)
+		{
+
+		}
+
+		int _paints;
+
+	protected:
+		virtual void schedulePaint(KRect* rect = nullptr) override
+		{
+			++_paints;
+			TileImageView::schedulePaint(rect);
+		}
+	};
+
+	// one red tile, the whole pyramid of a 64 x 64 image.
+	bool writePyramid(const std::string& directory)
+	{
+		std::string level = directory + "/0";
+		VALUE_FALSE_RETURN_FALSE(0 == mkdir(level.c_str(), 0700));
+
+		SkBitmap bitmap;
+		bitmap.setConfig(SkBitmap::kARGB_8888_Config, 64, 64);
+		VALUE_FALSE_RETURN_FALSE(bitmap.allocPixels());
+		bitmap.eraseColor(SK_ColorRED);
+		return SkImageEncoder::EncodeFile((level + "/0_0.png").c_str(), bitmap, SkImageEncoder::kPNG_Type, 100);
+	}
+}
+
+int main()
+{
+	char directory[] = "/tmp/kui-tiles-XXXXXX";
+	check(nullptr != mkdtemp(directory) && writePyramid(directory), "pyramid written");
+
+	RootView root;
+	root.setRect(KRect(0, 0, 64, 64));
+	check(root.initCanvas(ak::SkiaGraphics), "root canvas");
+
+	CountingTileImageView* view = new CountingTileImageView;
+	view->setRect(KRect(0, 0, 64, 64));
+	view->setSource(TileImageSource(directory, "png", 64, 64, 64));
+	root.addView(view);
+
+	// drawing starts the load and paints nothing while it runs.
+	view->_paints = 0;
+	root.OnDraw();
+	check(0 == view->_paints, "no paint scheduled from draw");
+
+	for (int i = 0; i < 500 && 0 == view->_paints; ++i)
+	{
+		usleep(10000);
+		root.updateTiledImages();
+	}
+
+	check(1 == view->_paints, "one paint once the tile landed");
+	check(!root.updateTiledImages(), "nothing left loading");
+
+	root.OnDraw();
+	Canvas* canvas = root.getCanvas();
+	SkPMColor* pixels = (SkPMColor*)canvas->lockBits();
+	check(nullptr != pixels && 0xFF == SkGetPackedR32(pixels[32 * 64 + 32]), "tile drawn");
+	canvas->unlockBits();
+
+	delete view;
+	check(0 == MemoryTracker::getInstance()->getBytes(ak::kMemoryTiles), "tiles dropped with the view");
+
+	std::string tile = std::string(directory) + "/0/0_0.png";
+	unlink(tile.c_str());
+	rmdir((std::string(directory) + "/0").c_str());
+	rmdir(directory);
+
+	return testResult();
+}
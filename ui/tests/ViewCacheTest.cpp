@@ -0,0 +1,68 @@
+// the layers, pictures and canvas of a view go when the view is destroyed.
+
+#include "UIDefine.h"
+#include "RootView.h"
+#include "MemoryTracker.h"
+#include "TestHelper.h"
+
+namespace
+{
+	size_t layerBytes()
+	{
+		return MemoryTracker::getInstance()->getBytes(ak::kMemoryLayers);
+	}
+
+	size_t pictureBytes()
+	{
+		return MemoryTracker::getInstance()->getBytes(ak::kMemoryPictures);
+	}
+}
+
+int main()
+{
+	RootView root;
+	root.setRect(KRect(0, 0, 256, 256));
+	check(root.initCanvas(ak::SkiaGraphics), "root canvas");
+
+	View* parent = new View;
+	parent->setRect(KRect(0, 0, 256, 256));
+	View* child = new View;
+	child->setRect(KRect(0, 0, 128, 128));
+	child->setLayerCached(true);
+	parent->addView(child);
+	root.addView(parent);
+
+	// the layer memory is counted when a frame ends.
+	root.OnDraw();
+	check(layerBytes() > 0, "layer cached");
+	check(child == root.hitTest(10, 10), "child hit under its parent");
+
+	// destroying an ancestor drops the layers of the views under it.
+	delete parent;
+	root.OnDraw();
+	check(0 == layerBytes(), "layer dropped with its parent");
+	check(nullptr == child->getParent(), "child left without a parent");
+	check(&root == root.hitTest(10, 10), "root hit once the parent is gone");
+
+	child->setLayerCached(false);
+	child->setPictureCached(true);
+	root.addView(child);
+	root.OnDraw();
+	check(pictureBytes() > 0, "picture cached");
+	check(child == root.hitTest(10, 10), "child hit under the root");
+
+	delete child;
+	check(0 == pictureBytes(), "picture dropped with its view");
+	check(&root == root.hitTest(10, 10), "child removed from the root");
+
+	// a view's own canvas goes with the view.
+	size_t surfaces = MemoryTracker::getInstance()->getBytes(ak::kMemorySurfaces);
+	View* canvasView = new RootView;
+	canvasView->setRect(KRect(0, 0, 64, 64));
+	check(canvasView->initCanvas(ak::SkiaGraphics), "view canvas");
+	check(MemoryTracker::getInstance()->getBytes(ak::kMemorySurfaces) > surfaces, "view canvas counted");
+	delete canvasView;
+	check(MemoryTracker::getInstance()->getBytes(ak::kMemorySurfaces) == surfaces, "view canvas freed with its view");
+
+	return testResult();
+}
@@ -0,0 +1,157 @@
+// shows a widget on the x server of DISPLAY, run by ctest under xvfb-run when it is installed.
+// draws frames damaging a small view and then the whole window, and prints the time
+// each frame takes through the event loop, presenting included, then resizes the window
+// and destroys a captured and focused view.
+
+#include "UIDefine.h"
+#include "widget.h"
+#include "eventHandler.h"
+#include "View.h"
+#include "Canvas.h"
+#include "KSolidBrush.h"
+#include "Color.h"
+#include "TestHelper.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+// ctest reports the test as skipped, see SKIP_RETURN_CODE.
+const int SKIPPED = 77;
+
+const int WINDOW_WIDTH = 640;
+const int WINDOW_HEIGHT = 480;
+const int FRAME_COUNT = 200;
+
+namespace
+{
+	double now()
+	{
+		timeval time;
+		gettimeofday(&time, nullptr);
+		return time.tv_sec * 1000.0 + time.tv_usec / 1000.0;
+	}
+
+	// fills its rect with a color that changes every frame.
+	class FrameView : public View
+	{
+	public:
+		FrameView()
+			: _frames(0)
+		{
+
+		}
+
+		void nextFrame()
+		{
+			schedulePaint();
+		}
+
+		virtual bool draw(Canvas& canvas) override
+		{
+			KRect rect;
+			getRect(rect);
+			KSolidBrush brush(Color(0xFF, _frames & 0xFF, 0x80, 0x40));
+			canvas.fillRect(&brush, rect);
+			++_frames;
+			return View::draw(canvas);
+		}
+
+		int _frames;
+	};
+
+	// runs the loop until view has drawn frames more frames, or a second went by.
+	bool waitForFrames(FrameView* view, int frames)
+	{
+		int target = view->_frames + frames;
+		double deadline = now() + 1000;
+
+		while (view->_frames < target && now() < deadline)
+		{
+			Widget::processEvents();
+		}
+
+		return view->_frames >= target;
+	}
+
+	// milliseconds per frame of view, each frame waits for the last one.
+	double frameTime(FrameView* view)
+	{
+		double start = now();
+		int frames = 0;
+
+		for (; frames < FRAME_COUNT; ++frames)
+		{
+			view->nextFrame();
+
+			if (!waitForFrames(view, 1))
+			{
+				break;
+			}
+		}
+
+		check(FRAME_COUNT == frames, "every scheduled frame drawn");
+		return (now() - start) / FRAME_COUNT;
+	}
+}
+
+int main()
+{
+	if (nullptr == getenv("DISPLAY"))
+	{
+		printf("no DISPLAY, skipped\n");
+		return SKIPPED;
+	}
+
+	Widget* widget = Widget::createWindow(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT);
+
+	if (!widget->initCanvas(ak::SkiaGraphics))
+	{
+		printf("cannot open DISPLAY or its visual is not 32 bit, skipped\n");
+		delete widget;
+		return SKIPPED;
+	}
+
+	FrameView* background = new FrameView;
+	background->setRect(KRect(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT));
+	FrameView* small = new FrameView;
+	small->setRect(KRect(16, 16, 64, 64));
+	background->addView(small);
+	widget->addView(background);
+	widget->show();
+
+	// the first expose draws the window in full.
+	check(waitForFrames(background, 1), "first frame drawn on expose");
+
+	double smallTime = frameTime(small);
+	int backgroundFrames = background->_frames;
+	double fullTime = frameTime(background);
+	check(backgroundFrames + FRAME_COUNT == background->_frames, "full window frames drawn");
+
+	printf("64x64 damage: %.3f ms per frame, %dx%d damage: %.3f ms per frame\n", smallTime, WINDOW_WIDTH,
+		WINDOW_HEIGHT, fullTime);
+
+	// a resize replaces the image and the canvas drawing into it.
+	widget->moveWindow(0, 0, WINDOW_WIDTH / 2, WINDOW_HEIGHT / 2);
+	double deadline = now() + 1000;
+
+	while (WINDOW_WIDTH / 2 != widget->width() && now() < deadline)
+	{
+		Widget::processEvents();
+	}
+
+	check(WINDOW_WIDTH / 2 == widget->width(), "resized");
+	small->nextFrame();
+	check(waitForFrames(small, 1), "frame drawn after the resize");
+
+	// a destroyed view is neither captured nor focused any more.
+	EventHandler* eventHandler = widget->getEventHandler();
+	eventHandler->setCaptureView(small);
+	eventHandler->setFocusView(small);
+	delete small;
+	check(nullptr == eventHandler->getCaptureView(), "capture dropped with its view");
+	check(nullptr == eventHandler->getFocusView(), "focus dropped with its view");
+
+	delete background;
+	delete widget;
+	return testResult();
+}
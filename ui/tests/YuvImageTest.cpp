@@ -0,0 +1,172 @@
+// a yuv frame drawn straight into the device gives the colors of the bt.601 and jpeg matrices, the
+// same pixels as the frame converted into a bitmap and drawn through the canvas.
+
+#include "UIDefine.h"
+#include "YuvImage.h"
+#include "graphics/skia/SkiaYuvRenderer.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkColorPriv.h"
+#include "SkPaint.h"
+#include "TestHelper.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+const int SIZE = 16;
+const int HALF = SIZE / 2;
+
+namespace
+{
+	struct Yuv
+	{
+		int y;
+		int u;
+		int v;
+	};
+
+	// white, black, red and blue in bt.601 studio range, a quadrant of the frame each.
+	const Yuv QUADRANTS[4] = { { 235, 128, 128 }, { 16, 128, 128 }, { 81, 90, 240 }, { 41, 240, 110 } };
+
+	int clamp(float value)
+	{
+		int rounded = (int)(value + 0.5f);
+		return rounded < 0 ? 0 : (rounded > 255 ? 255 : rounded);
+	}
+
+	// the matrices as published, in floating point.
+	SkPMColor expectedColor(const Yuv& yuv, ak::YuvColorSpace colorSpace)
+	{
+		float y = ak::kYuvJpeg == colorSpace ? (float)yuv.y : 1.164f * (yuv.y - 16);
+		float u = (float)(yuv.u - 128);
+		float v = (float)(yuv.v - 128);
+
+		if (ak::kYuvJpeg == colorSpace)
+		{
+			return SkPackARGB32(0xFF, clamp(y + 1.402f * v), clamp(y - 0.344f * u - 0.714f * v), clamp(y + 1.772f * u));
+		}
+
+		return SkPackARGB32(0xFF, clamp(y + 1.596f * v), clamp(y - 0.392f * u - 0.813f * v), clamp(y + 2.017f * u));
+	}
+
+	bool closeTo(SkPMColor a, SkPMColor b)
+	{
+		return abs((int)SkGetPackedR32(a) - (int)SkGetPackedR32(b)) <= 2 &&
+			abs((int)SkGetPackedG32(a) - (int)SkGetPackedG32(b)) <= 2 &&
+			abs((int)SkGetPackedB32(a) - (int)SkGetPackedB32(b)) <= 2 &&
+			0xFF == SkGetPackedA32(a);
+	}
+
+	void fillFrame(YuvImage* image)
+	{
+		int yRowBytes = 0;
+		int uvRowBytes = 0;
+		unsigned char* y = image->getWritablePlane(0, &yRowBytes);
+		unsigned char* u = image->getWritablePlane(1, &uvRowBytes);
+		unsigned char* v = ak::kYuvNV12 == image->getFormat() ? nullptr : image->getWritablePlane(2, nullptr);
+
+		for (int row = 0; row < SIZE; ++row)
+		{
+			for (int column = 0; column < SIZE; ++column)
+			{
+				const Yuv& yuv = QUADRANTS[(row / HALF) * 2 + column / HALF];
+				y[row * yRowBytes + column] = (unsigned char)yuv.y;
+
+				if (0 == row % 2 && 0 == column % 2)
+				{
+					unsigned char* chroma = u + (row / 2) * uvRowBytes;
+
+					if (nullptr == v)
+					{
+						chroma[column] = (unsigned char)yuv.u;
+						chroma[column + 1] = (unsigned char)yuv.v;
+					}
+					else
+					{
+						chroma[column / 2] = (unsigned char)yuv.u;
+						v[(row / 2) * uvRowBytes + column / 2] = (unsigned char)yuv.v;
+					}
+				}
+			}
+		}
+	}
+
+	bool drawFrame(SkiaYuvRenderer* renderer, YuvImage* image, SkBitmap* device, int size, bool rasterize)
+	{
+		device->setConfig(SkBitmap::kARGB_8888_Config, size, size);
+		device->allocPixels();
+		device->eraseColor(0);
+		SkCanvas canvas(*device);
+		SkPaint paint;
+		SkRect dst = SkRect::MakeWH(SkIntToScalar(size), SkIntToScalar(size));
+		return renderer->drawImage(&canvas, image, dst, paint, rasterize);
+	}
+
+	// the middle of each quadrant, where neither path blends with a neighbouring quadrant.
+	bool quadrantsMatch(const SkBitmap& device, ak::YuvColorSpace colorSpace, const Yuv* quadrants)
+	{
+		int quarter = device.width() / 4;
+
+		for (int i = 0; i < 4; ++i)
+		{
+			int x = (i % 2) * device.width() / 2 + quarter;
+			int y = (i / 2) * device.height() / 2 + quarter;
+
+			if (!closeTo(*device.getAddr32(x, y), expectedColor(quadrants[i], colorSpace)))
+			{
+				printf("quadrant %d: %08x, expected %08x\n", i, *device.getAddr32(x, y),
+					expectedColor(quadrants[i], colorSpace));
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool samePixels(const SkBitmap& a, const SkBitmap& b)
+	{
+		SkAutoLockPixels lockA(a);
+		SkAutoLockPixels lockB(b);
+		return 0 == memcmp(a.getPixels(), b.getPixels(), a.getSize());
+	}
+}
+
+int main()
+{
+	const ak::YuvFormat formats[] = { ak::kYuvI420, ak::kYuvNV12 };
+
+	for (size_t i = 0; i < sizeof(formats) / sizeof(formats[0]); ++i)
+	{
+		YuvImage image(SIZE, SIZE, formats[i], ak::kYuvRec601);
+		fillFrame(&image);
+		SkiaYuvRenderer renderer;
+		SkBitmap direct;
+		SkBitmap converted;
+
+		// 1:1
+		check(drawFrame(&renderer, &image, &direct, SIZE, true), "frame drawn into the device");
+		check(drawFrame(&renderer, &image, &converted, SIZE, false), "frame drawn through a bitmap");
+		check(quadrantsMatch(direct, ak::kYuvRec601, QUADRANTS), "bt.601 colors drawn into the device");
+		check(quadrantsMatch(converted, ak::kYuvRec601, QUADRANTS), "bt.601 colors drawn through a bitmap");
+		check(samePixels(direct, converted), "both paths draw the same pixels");
+
+		// scaled up
+		check(drawFrame(&renderer, &image, &direct, SIZE * 2, true), "scaled frame drawn into the device");
+		check(drawFrame(&renderer, &image, &converted, SIZE * 2, false), "scaled frame drawn through a bitmap");
+		check(quadrantsMatch(direct, ak::kYuvRec601, QUADRANTS), "scaled colors drawn into the device");
+		check(quadrantsMatch(converted, ak::kYuvRec601, QUADRANTS), "scaled colors drawn through a bitmap");
+	}
+
+	// full range, the same samples are brighter and more saturated.
+	YuvImage jpeg(SIZE, SIZE, ak::kYuvI420, ak::kYuvJpeg);
+	fillFrame(&jpeg);
+	SkiaYuvRenderer renderer;
+	SkBitmap direct;
+	SkBitmap converted;
+	check(drawFrame(&renderer, &jpeg, &direct, SIZE, true), "jpeg frame drawn into the device");
+	check(drawFrame(&renderer, &jpeg, &converted, SIZE, false), "jpeg frame drawn through a bitmap");
+	check(quadrantsMatch(direct, ak::kYuvJpeg, QUADRANTS), "jpeg colors drawn into the device");
+	check(samePixels(direct, converted), "both paths draw the same jpeg pixels");
+
+	return testResult();
+}
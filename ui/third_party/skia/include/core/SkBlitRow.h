@@ -84,6 +84,20 @@ public:
     //! Public entry-point to return a blit function ptr
     static ColorRectProc ColorRectProcFactory();
 
+    /** Function pointer that blends a single color onto a row of 32-bit
+        pixels through run-length encoded coverage, as passed to
+        SkBlitter::blitAntiH.
+     */
+    typedef void (*ColorAntiHProc)(SkPMColor* dst, const SkAlpha antialias[],
+                                   const int16_t runs[], SkPMColor color);
+
+    /** Blend a single color onto D32 pixels through the coverage runs. */
+    static void ColorAntiH32(SkPMColor* dst, const SkAlpha antialias[],
+                             const int16_t runs[], SkPMColor color);
+
+    //! Public entry-point to return a blit function ptr
+    static ColorAntiHProc ColorAntiHProcFactory();
+
     /** These static functions are called by the Factory and Factory32
         functions, and should return either NULL, or a
         platform-specific function-ptr to be used in place of the
@@ -94,6 +108,7 @@ public:
     static Proc PlatformProcs565(unsigned flags);
     static Proc PlatformProcs4444(unsigned flags);
     static ColorProc PlatformColorProc();
+    static ColorAntiHProc PlatformColorAntiHProc();
 
 private:
     enum {
@@ -25,6 +25,7 @@ class SkBounder;
 class SkDevice;
 class SkDraw;
 class SkDrawFilter;
+class SkGlyphStrike;
 class SkMetaData;
 class SkPicture;
 class SkRRect;
@@ -226,6 +227,13 @@ public:
         kFullColorLayer_SaveFlag    = 0x08,
         /** the layer should clip against the bounds argument */
         kClipToLayer_SaveFlag       = 0x10,
+        /** the caller promises that no pixel is drawn twice until the
+            restore, and that nothing drawn uses a transfer mode other than
+            src-over, as with a single opaque image or a card whose children
+            do not overlap. If the layer paint only has an alpha, no layer is
+            allocated and the alpha is applied to each draw instead.
+         */
+        kModulateAlpha_SaveFlag     = 0x20,
 
         // helper masks for common choices
         kMatrixClip_SaveFlag        = 0x03,
@@ -733,6 +741,23 @@ public:
     virtual void drawText(const void* text, size_t byteLength, SkScalar x,
                           SkScalar y, const SkPaint& paint);
 
+    /** Draw glyph IDs, with origin at (x,y), reading the glyphs from the
+        cache pinned by strike (see SkGlyphStrike). This skips the glyph cache
+        lookup drawText does for every call. The text encoding of the paint is
+        ignored. If the strike doesn't match the paint and the current matrix,
+        or the canvas records or forwards its drawing, this is the same as
+        drawText with kGlyphID_TextEncoding.
+        @param strike   The pinned glyph cache
+        @param glyphs   The glyph IDs to be drawn
+        @param count    The number of glyph IDs
+        @param x        The x-coordinate of the origin of the text being drawn
+        @param y        The y-coordinate of the origin of the text being drawn
+        @param paint    The paint used for the text (e.g. color, size, style)
+    */
+    virtual void drawGlyphs(SkGlyphStrike* strike, const uint16_t glyphs[],
+                            int count, SkScalar x, SkScalar y,
+                            const SkPaint& paint);
+
     /** Draw the text, with each character/glyph origin specified by the pos[]
         array. The origin is interpreted by the Align setting in the paint.
         @param text The text to be drawn
@@ -981,6 +1006,10 @@ protected:
     // is not released or deleted by the caller.
     virtual SkCanvas* canvasForDrawIter();
 
+    // drawGlyphs for subclasses that record or forward drawText.
+    void drawGlyphsAsText(const uint16_t glyphs[], int count, SkScalar x,
+                          SkScalar y, const SkPaint& paint);
+
     // all of the drawBitmap variants call this guy
     void commonDrawBitmap(const SkBitmap&, const SkIRect*, const SkMatrix&,
                           const SkPaint& paint);
@@ -17,6 +17,7 @@
 
 class SkClipStack;
 class SkDraw;
+class SkGlyphStrike;
 struct SkIRect;
 class SkMatrix;
 class SkMetaData;
@@ -177,6 +178,10 @@ protected:
         SkPaint::Hinting    fHinting;
     };
 
+    /** Draws the glyphs through drawText with kGlyphID_TextEncoding. */
+    void drawGlyphsAsText(const SkDraw&, const uint16_t glyphs[], int count,
+                          SkScalar x, SkScalar y, const SkPaint& paint);
+
     /**
      *  Device may filter the text flags for drawing text here. If it wants to
      *  make a change to the specified values, it should write them into the
@@ -261,6 +266,17 @@ protected:
      */
     virtual void drawText(const SkDraw&, const void* text, size_t len,
                           SkScalar x, SkScalar y, const SkPaint& paint);
+    /**
+     *  Draw glyph IDs with the glyph cache pinned by strike. The default
+     *  rasterizes straight from the strike; vector devices, and any device
+     *  when the strike doesn't match paint and the matrix, go through
+     *  drawText with kGlyphID_TextEncoding instead.
+     *  Other devices that override drawText should override this to call
+     *  drawGlyphsAsText.
+     */
+    virtual void drawGlyphs(const SkDraw&, SkGlyphStrike* strike,
+                            const uint16_t glyphs[], int count,
+                            SkScalar x, SkScalar y, const SkPaint& paint);
     virtual void drawPosText(const SkDraw&, const void* text, size_t len,
                              const SkScalar pos[], SkScalar constY,
                              int scalarsPerPos, const SkPaint& paint);
@@ -21,6 +21,7 @@
 class SkBounder;
 class SkClipStack;
 class SkDevice;
+class SkGlyphStrike;
 class SkPath;
 class SkRegion;
 class SkRasterClip;
@@ -50,6 +51,13 @@ public:
     void    drawSprite(const SkBitmap&, int x, int y, const SkPaint&) const;
     void    drawText(const char text[], size_t byteLength, SkScalar x,
                      SkScalar y, const SkPaint& paint) const;
+    /** Draw glyph IDs with the glyph cache pinned by strike, which must match
+     *  paint and the matrix (see SkGlyphStrike::matches). The text encoding
+     *  of paint is ignored.
+     */
+    void    drawGlyphs(SkGlyphStrike* strike, const uint16_t glyphs[],
+                       int count, SkScalar x, SkScalar y,
+                       const SkPaint& paint) const;
     void    drawPosText(const char text[], size_t byteLength,
                         const SkScalar pos[], SkScalar constY,
                         int scalarsPerPosition, const SkPaint& paint) const;
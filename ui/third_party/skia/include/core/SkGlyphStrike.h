@@ -0,0 +1,71 @@
+
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+
+#ifndef SkGlyphStrike_DEFINED
+#define SkGlyphStrike_DEFINED
+
+#include "SkMatrix.h"
+#include "SkPaint.h"
+#include "SkRefCnt.h"
+
+class SkGlyphCache;
+
+/** \class SkGlyphStrike
+
+    A glyph cache pinned for one font state: the typeface, size and text
+    flags of a paint, drawn under the scale and skew of a matrix.
+
+    Drawing text normally builds a descriptor from the paint and matrix,
+    hashes it and looks the cache up under the global glyph cache mutex, for
+    every call. SkCanvas::drawGlyphs with a strike that matches the paint and
+    matrix skips all of that and reads glyphs straight from the pinned cache.
+
+    The cache is detached from the global cache list for the lifetime of the
+    strike, so a strike must only be used by one thread at a time.
+*/
+class SK_API SkGlyphStrike : public SkRefCnt {
+public:
+    SK_DECLARE_INST_COUNT(SkGlyphStrike)
+
+    /** Pins the glyph cache used to draw text with paint under matrix.
+        Only the translation of matrix may differ when the strike is used.
+    */
+    SkGlyphStrike(const SkPaint& paint, const SkMatrix& matrix);
+    virtual ~SkGlyphStrike();
+
+    /** Returns true if text drawn with paint under matrix uses this strike's
+        glyphs. Paints with a path effect, mask filter or rasterizer never
+        match, nor do matrices with perspective.
+    */
+    bool matches(const SkPaint& paint, const SkMatrix& matrix) const;
+
+    /** Converts text in the given encoding to glyph IDs using the strike's
+        character map, which is cached with the glyphs.
+        @return the number of glyphs written to glyphs, which must have room
+                for at least byteLength glyphs.
+    */
+    int textToGlyphs(const void* text, size_t byteLength,
+                     SkPaint::TextEncoding encoding, uint16_t glyphs[]);
+
+    SkGlyphCache* getCache() const { return fCache; }
+
+    /** Returns the bytes of the glyphs and images in the pinned cache, which
+        SkGraphics::VisitFontCaches does not see while the strike holds it.
+    */
+    size_t getMemoryUsed() const;
+
+private:
+    SkPaint         fPaint;
+    SkMatrix        fMatrix;
+    SkGlyphCache*   fCache;
+
+    typedef SkRefCnt INHERITED;
+};
+
+#endif
@@ -10,6 +10,7 @@
 #ifndef SkGraphics_DEFINED
 #define SkGraphics_DEFINED
 
+#include "SkScalar.h"
 #include "SkTypes.h"
 
 class SK_API SkGraphics {
@@ -53,6 +54,16 @@ public:
      */
     static size_t GetFontCacheUsed();
 
+    typedef void (*FontCacheVisitor)(uint32_t fontID, SkScalar textSize,
+                                     size_t bytesUsed, void* context);
+
+    /**
+     *  Call visitor with the font ID, text size and number of bytes used of
+     *  every glyph cache. The visitor is called with the font cache locked,
+     *  so it must not draw or measure text.
+     */
+    static void VisitFontCaches(FontCacheVisitor visitor, void* context);
+
     /**
      *  For debugging purposes, this will attempt to purge the font cache. It
      *  does not change the limit, but will cause subsequent font measures and
@@ -60,6 +71,73 @@ public:
      */
     static void PurgeFontCache();
 
+    /**
+     *  Write the glyphs of the most recently used font caches, up to the
+     *  font cache limit, to the file at path, so that a later process can
+     *  start with them by calling LoadFontCacheSnapshot(). Caches detached
+     *  by their user, e.g. pinned by an SkGlyphStrike, are not written.
+     *
+     *  Returns false if the file could not be written.
+     */
+    static bool WriteFontCacheSnapshot(const char path[]);
+
+    /**
+     *  Add the font caches in a file written by WriteFontCacheSnapshot() to
+     *  the font cache, so that their glyphs are not generated again. Caches
+     *  whose font is missing or has changed since the file was written, and
+     *  caches that are already in the font cache, are skipped.
+     *
+     *  Returns the number of caches added.
+     */
+    static int LoadFontCacheSnapshot(const char path[]);
+
+    /**
+     *  Return the max number of bytes kept by the pool of raster saveLayer
+     *  pixels once their layers are restored.
+     */
+    static size_t GetLayerPoolLimit();
+
+    /**
+     *  Specify the max number of bytes kept by the layer pool, the oldest
+     *  pixels are freed first. 0 frees layers as soon as they are restored.
+     *
+     *  This function returns the previous setting, as if GetLayerPoolLimit()
+     *  had be called before the new limit was set.
+     */
+    static size_t SetLayerPoolLimit(size_t bytes);
+
+    /**
+     *  Return the number of bytes held by the layer pool, not counting the
+     *  layers currently in use.
+     */
+    static size_t GetLayerPoolUsed();
+
+    /**
+     *  Free the pixels held by the layer pool. It does not change the limit.
+     */
+    static void PurgeLayerPool();
+
+    /**
+     *  Return the max number of bytes of contour segments kept by the cache
+     *  of SkPathMeasure.
+     */
+    static size_t GetPathMeasureCacheLimit();
+
+    /**
+     *  Specify the max number of bytes kept by the path measure cache, the
+     *  least recently measured paths are dropped first. 0 measures every
+     *  path from scratch.
+     *
+     *  This function returns the previous setting, as if
+     *  GetPathMeasureCacheLimit() had be called before the new limit was set.
+     */
+    static size_t SetPathMeasureCacheLimit(size_t bytes);
+
+    /**
+     *  Drop every measured path from the cache. It does not change the limit.
+     */
+    static void PurgePathMeasureCache();
+
     /**
      *  Applications with command line options may pass optional state, such
      *  as cache sizes, here, for instance:
@@ -12,18 +12,21 @@
 
 #include "SkStream.h"
 
+/** \class SkMMAPStream
+
+    A memory stream over a file mapped read only. The mapping is held by the
+    stream's SkData, so copyToData() hands out the file without copying it,
+    and the mapping stays valid until the last reference to that data goes
+    away, even after the stream is deleted.
+
+    The stream is empty if the file cannot be mapped.
+*/
 class SkMMAPStream : public SkMemoryStream {
 public:
     SkMMAPStream(const char filename[]);
     virtual ~SkMMAPStream();
 
-    virtual void setMemory(const void* data, size_t length, bool);
 private:
-    void*   fAddr;
-    size_t  fSize;
-
-    void closeMMap();
-
     typedef SkMemoryStream INHERITED;
 };
 
@@ -967,6 +967,11 @@ private:
     friend class Iter;
 
     friend class SkPathStroker;
+
+    // the ID of the points and verbs, shared by copies, see SkPathRef::genID
+    uint32_t getPathRefGenID() const;
+    friend class SkPathMeasure;    // keys its cache on getPathRefGenID()
+
     /*  Append the first contour of path, ignoring path's initial point. If no
         moveTo() call has been made for this contour, the first point is
         automatically set to (0,0).
@@ -13,6 +13,16 @@
 #include "SkPath.h"
 #include "SkTDArray.h"
 
+class SkPathMeasureTable;
+
+/** \class SkPathMeasure
+
+    Measures the contours of a path. The segments of every contour are
+    computed once per path contents and kept in a cache keyed by the
+    generation ID of the path, so measuring the same path again, or a copy of
+    it, e.g. every frame of an animation, does not recompute them. See
+    SkGraphics::SetPathMeasureCacheLimit().
+*/
 class SkPathMeasure : SkNoncopyable {
 public:
     SkPathMeasure();
@@ -44,6 +54,16 @@ public:
     bool SK_WARN_UNUSED_RESULT getPosTan(SkScalar distance, SkPoint* position,
                                          SkVector* tangent);
 
+    /** Computes the position and tangent at each of count distances, pinned
+        like those of getPosTan(). Either positions or tangents may be NULL.
+        Distances close to the previous one, e.g. in increasing order, are
+        found without searching the whole contour.
+        Returns false if there is no path, or a zero-length path was specified, in which case
+        positions and tangents are unchanged.
+    */
+    bool SK_WARN_UNUSED_RESULT getPosTan(const SkScalar distances[], int count,
+                                         SkPoint positions[], SkVector tangents[]);
+
     enum MatrixFlags {
         kGetPosition_MatrixFlag     = 0x01,
         kGetTangent_MatrixFlag      = 0x02,
@@ -80,13 +100,6 @@ public:
 #endif
 
 private:
-    SkPath::Iter    fIter;
-    const SkPath*   fPath;
-    SkScalar        fLength;            // relative to the current contour
-    int             fFirstPtIndex;      // relative to the current contour
-    bool            fIsClosed;          // relative to the current contour
-    bool            fForceClosed;
-
     struct Segment {
         SkScalar    fDistance;  // total distance up to this point
         unsigned    fPtIndex : 15; // index into the fPts array
@@ -95,17 +108,24 @@ private:
 
         SkScalar getScalarT() const;
     };
-    SkTDArray<Segment>  fSegments;
-    SkTDArray<SkPoint>  fPts; // Points used to define the segments
+
+    const SkPath*       fPath;
+    SkPathMeasureTable* fTable;         // owned, built the first time it is needed
+    int                 fContour;       // index of the current contour in fTable
+    SkScalar            fLength;        // relative to the current contour
+    bool                fIsClosed;      // relative to the current contour
+    bool                fForceClosed;
+    const Segment*      fSegments;      // of the current contour, in fTable
+    int                 fSegmentCount;
+    const SkPoint*      fPts;           // Points used to define the segments
+    const Segment*      fLastSegment;   // where the search for the next distance starts
 
     static const Segment* NextSegment(const Segment*);
 
-    void     buildSegments();
-    SkScalar compute_quad_segs(const SkPoint pts[3], SkScalar distance,
-                                int mint, int maxt, int ptIndex);
-    SkScalar compute_cubic_segs(const SkPoint pts[3], SkScalar distance,
-                                int mint, int maxt, int ptIndex);
+    void     nextTableContour();
     const Segment* distanceToSegment(SkScalar distance, SkScalar* t);
+
+    friend class SkPathMeasureTable;
 };
 
 #endif
@@ -16,6 +16,9 @@
 class SkBBoxHierarchy;
 class SkBitmap;
 class SkCanvas;
+class SkData;
+class SkMappableWriter;
+class SkPictureMapping;
 class SkPicturePlayback;
 class SkPictureRecord;
 class SkStream;
@@ -122,6 +125,13 @@ public:
     */
     void draw(SkCanvas* surface);
 
+    /** Return an estimate of the memory held by the recorded ops, paints,
+        paths and matrices of the picture. Bitmap pixels are not included,
+        since they are usually shared with the caller. Returns 0 while the
+        picture is being recorded.
+    */
+    size_t approximateBytesUsed() const;
+
     /** Return the width of the picture's recording canvas. This
         value reflects what was passed to setSize(), and does not necessarily
         reflect the bounds of what has been recorded into the picture.
@@ -142,6 +152,26 @@ public:
      */
     void serialize(SkWStream*, SkSerializationHelpers::EncodeBitmap encoder = NULL) const;
 
+    /**
+     *  Serialize to a stream in a format that CreateFromData() loads without
+     *  copying: the op streams and the pixels of the bitmaps are written as
+     *  16 byte aligned blocks, and the factory and typeface tables of the
+     *  picture and the pictures it draws are written once, at the end.
+     *  Bitmaps are written uncompressed, converted to 8888 if their config
+     *  is not 8888, 565, 4444 or A8.
+     */
+    void serializeMappable(SkWStream*) const;
+
+    /**
+     *  Recreate a picture from data written by serialize() or
+     *  serializeMappable(), such as the data of an SkMMAPStream. The ops and
+     *  bitmaps of a mappable picture reference the data instead of copying
+     *  it, so loading costs little more than parsing the paints and paths.
+     *  Returns NULL if the data is not a valid picture.
+     */
+    static SkPicture* CreateFromData(SkData*,
+                                     SkSerializationHelpers::DecodeBitmap decoder = NULL);
+
     /** Signals that the caller is prematurely done replaying the drawing
         commands. This can be called from a canvas virtual while the picture
         is drawing. Has no effect if the picture is not drawing.
@@ -173,6 +203,10 @@ protected:
     virtual SkBBoxHierarchy* createBBoxHierarchy() const;
 
 private:
+    // mapping is NULL unless the stream is the mapping's, see CreateFromData
+    bool parse(SkStream*, SkPictureMapping* mapping,
+               SkSerializationHelpers::DecodeBitmap decoder);
+    void writeMappable(SkMappableWriter*) const;
 
     friend class SkFlatPicture;
     friend class SkPicturePlayback;
@@ -152,6 +152,16 @@ template <typename T> static inline void SkSafeUnref(T* obj) {
     }
 }
 
+/** Check if the argument is non-null, and if so, call obj->unref(), then set
+    the argument to NULL.
+ */
+template <typename T> static inline void SkSafeSetNull(T*& obj) {
+    if (NULL != obj) {
+        obj->unref();
+        obj = NULL;
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 /**
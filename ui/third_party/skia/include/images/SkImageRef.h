@@ -75,6 +75,11 @@ protected:
     // override this in your subclass to clean up when we're unlocking pixels
     virtual void onUnlockPixels();
 
+    /** Returns the stream the image was decoded from, as long as the pixels
+        have not been changed since (see notifyPixelsChanged()).
+     */
+    virtual SkData* onRefEncodedData() SK_OVERRIDE;
+
     SkImageRef(SkFlattenableReadBuffer&);
     virtual void flatten(SkFlattenableWriteBuffer&) const SK_OVERRIDE;
 
@@ -92,6 +97,7 @@ private:
     int                     fSampleSize;
     bool                    fDoDither;
     bool                    fErrorInDecoding;
+    uint32_t                fEncodedGenerationID;
 
     friend class SkImageRefPool;
 
@@ -29,6 +29,7 @@ class SkPDFGraphicState;
 class SkPDFObject;
 class SkPDFShader;
 class SkPDFStream;
+class SkThreadPool;
 
 // Private classes.
 struct ContentEntry;
@@ -120,6 +121,15 @@ public:
      */
     SK_API void setDrawingArea(DrawingArea drawingArea);
 
+    /** Sets the resolution, in dots per inch, at which images are embedded.
+     *  Images with more pixels than that over the area they are drawn to are
+     *  downsampled on the threads of pool, usually the one of the document
+     *  the page goes to (SkPDFDocument::getImagePool()), which must outlive
+     *  drawing to the device.  Without a pool they are downsampled as they
+     *  are drawn.  0, the default, embeds images at full resolution.
+     */
+    SK_API void setImageDownsampleDpi(SkScalar dpi, SkThreadPool* pool = NULL);
+
     // PDF specific methods.
 
     /** Returns the resource dictionary for this device.
@@ -199,6 +209,8 @@ private:
     SkTScopedPtr<ContentEntry> fMarginContentEntries;
     ContentEntry* fLastMarginContentEntry;
     DrawingArea fDrawingArea;
+    SkScalar fImageDownsampleDpi;
+    SkThreadPool* fImagePool;
 
     const SkClipStack* fClipStack;
 
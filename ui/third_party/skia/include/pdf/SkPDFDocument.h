@@ -20,6 +20,7 @@ class SkPDFDevice;
 class SkPDFDict;
 class SkPDFPage;
 class SkPDFObject;
+class SkThreadPool;
 class SkWStream;
 
 /** \class SkPDFDocument
@@ -69,6 +70,13 @@ public:
     SK_API void getCountOfFontTypes(
         int counts[SkAdvancedTypefaceMetrics::kNotEmbeddable_Font + 1]) const;
 
+    /** Returns the threads that downsample the images drawn to the pages of
+     *  this document, see SkPDFDevice::setImageDownsampleDpi().  They are
+     *  started by the first call, and finish their work and stop when the
+     *  document is deleted.
+     */
+    SK_API SkThreadPool* getImagePool();
+
 private:
     SkTScopedPtr<SkPDFCatalog> fCatalog;
     int64_t fXRefFileOffset;
@@ -81,6 +89,7 @@ private:
     int fSecondPageFirstResourceIndex;
 
     SkPDFDict* fTrailerDict;
+    SkTScopedPtr<SkThreadPool> fImagePool;
 
     /** Output the PDF header to the passed stream.
      *  @param stream    The writable output stream to send the header to.
@@ -171,6 +171,8 @@ public:
                             const SkPaint* paint) SK_OVERRIDE;
     virtual void drawText(const void* text, size_t byteLength, SkScalar x,
                           SkScalar y, const SkPaint& paint) SK_OVERRIDE;
+    virtual void drawGlyphs(SkGlyphStrike*, const uint16_t glyphs[], int count,
+                            SkScalar x, SkScalar y, const SkPaint&) SK_OVERRIDE;
     virtual void drawPosText(const void* text, size_t byteLength,
                              const SkPoint pos[], const SkPaint& paint)
                              SK_OVERRIDE;
@@ -0,0 +1,101 @@
+
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+
+#ifndef SkMeshRasterizer_DEFINED
+#define SkMeshRasterizer_DEFINED
+
+#include "SkBitmap.h"
+#include "SkMatrix.h"
+#include "SkRect.h"
+#include "SkTDArray.h"
+
+/** \class SkMeshRasterizer
+
+    Fills batches of textured triangles straight into a 32 bit raster, for
+    warps and page curls made of many small triangles.
+
+    SkCanvas::drawVertices builds a shader context for every triangle of the
+    batch. The rasterizer instead sets up the affine texture mapping of all
+    the triangles once, then walks each span with a fixed point step in u and
+    v, sampling the texture directly and blending the span with the blit row
+    procs.
+
+    Pixels are covered when their center is inside a triangle, with edges
+    evaluated the same way for the two triangles that share them, so meshes
+    have neither gaps nor doubly blended seams.
+
+    Once setMesh() returns, drawRows() only reads the rasterizer, so
+    disjoint row ranges of the destination may be drawn on several threads
+    at the same time.
+*/
+class SK_API SkMeshRasterizer : SkNoncopyable {
+public:
+    SkMeshRasterizer();
+    ~SkMeshRasterizer();
+
+    /** Sets up the triangles to draw. vertices are mapped by matrix, which
+        must not have perspective, and texs are in texture pixels. If indices
+        is NULL, every three vertices make a triangle.
+
+        The arrays are not referenced after the call returns.
+
+        @return false if the texture or the matrix cannot be rasterized here,
+                in which case the caller should draw with drawVertices.
+    */
+    bool setMesh(const SkBitmap& texture, const SkMatrix& matrix,
+                 const SkPoint vertices[], const SkPoint texs[],
+                 int vertexCount, const uint16_t indices[], int indexCount);
+
+    /** Scales the texture by alpha when blending, 255 by default. */
+    void setAlpha(U8CPU alpha) { fAlpha = SkToU8(alpha); }
+
+    /** Samples the texture bilinearly instead of the nearest pixel. */
+    void setFilterBitmap(bool filter) { fFilterBitmap = filter; }
+
+    /** The device pixels the mesh may cover, empty if nothing is drawn. */
+    const SkIRect& getBounds() const { return fBounds; }
+
+    int countTriangles() const { return fTriangles.count(); }
+
+    /** Draws the mesh into dst, which must be kARGB_8888, inside clip. */
+    void draw(const SkBitmap& dst, const SkIRect& clip) const {
+        this->drawRows(dst, clip, clip.fTop, clip.fBottom);
+    }
+
+    /** Draws only the rows [top, bottom) of the mesh. */
+    void drawRows(const SkBitmap& dst, const SkIRect& clip,
+                  int top, int bottom) const;
+
+private:
+    struct Triangle {
+        // device points, sorted by y then x
+        float   fX[3];
+        float   fY[3];
+        // texture coordinate = fU[0] * x + fU[1] * y + fU[2]
+        float   fU[3];
+        float   fV[3];
+        int     fTop;
+        int     fBottom;
+    };
+
+    SkBitmap                fTexture;
+    bool                    fTextureLocked;
+    SkTDArray<Triangle>     fTriangles;
+    SkIRect                 fBounds;
+    uint8_t                 fAlpha;
+    bool                    fFilterBitmap;
+
+    void reset();
+    bool addTriangle(const SkPoint dev[3], const SkPoint tex[3]);
+    void drawTriangle(const Triangle&, const SkBitmap& dst,
+                      const SkIRect& clip, int top, int bottom,
+                      SkPMColor span[]) const;
+};
+
+#endif
@@ -0,0 +1,66 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkOverdrawCounter_DEFINED
+#define SkOverdrawCounter_DEFINED
+
+#include "SkBitmap.h"
+#include "SkRect.h"
+
+class SkCanvas;
+
+/** \class SkOverdrawCounter
+
+    Counts how many times every pixel is written. Drawing into getCanvas()
+    goes through the normal raster pipeline into an A8 bitmap, but the paint's
+    transfer mode is replaced by one that adds one to every pixel a span
+    covers, so the counts match what the blitters of a real device write.
+    Counts saturate at 255.
+
+    Draw into a real canvas and the counter at the same time with an
+    SkNWayCanvas.
+*/
+class SK_API SkOverdrawCounter {
+public:
+    struct Stats {
+        int     fPixels;        //!< pixels in the area counted
+        int     fDrawnPixels;   //!< pixels written at least once
+        int     fWrites;        //!< total number of pixel writes
+        int     fMaxWrites;     //!< writes to the most drawn pixel
+
+        /** Average number of writes per pixel of the area. */
+        float averageOverdraw() const {
+            return fPixels > 0 ? (float)fWrites / fPixels : 0;
+        }
+    };
+
+    SkOverdrawCounter(int width, int height);
+    ~SkOverdrawCounter();
+
+    /** The canvas that counts. It starts with no clip and an identity matrix,
+        and the counter owns it.
+    */
+    SkCanvas* getCanvas() const { return fCanvas; }
+
+    /** Sets every count to zero. */
+    void reset();
+
+    /** Sums the counts of the pixels of area that are inside the counter. */
+    void getStats(const SkIRect& area, Stats* stats) const;
+
+    /** Draws the counts of area onto canvas, at the same position, as a
+        translucent heatmap: pixels drawn once are left alone, then blue,
+        green, pink and red for four or more extra writes.
+    */
+    void drawHeatmap(SkCanvas* canvas, const SkIRect& area) const;
+
+private:
+    SkBitmap    fCounts;
+    SkCanvas*   fCanvas;
+};
+
+#endif
@@ -0,0 +1,111 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+
+#ifndef SkYUVConverter_DEFINED
+#define SkYUVConverter_DEFINED
+
+#include "SkBitmap.h"
+#include "SkRect.h"
+#include "SkTDArray.h"
+
+/** \class SkYUVConverter
+
+    Draws planar 4:2:0 frames, such as decoded video or camera captures,
+    straight into a 32 bit raster, converting them to RGB and scaling them
+    in a single pass.
+
+    For each row of the destination, the two luma and two chroma rows it
+    falls between are blended a register at a time, then sampled bilinearly
+    across and converted eight pixels at a time, with SSE2 when available.
+    The frame is not copied, and once the converter has seen the frame and
+    destination sizes, drawing allocates nothing for frames up to 4096
+    pixels wide.
+
+    Once setFrame() and setDstRect() return, drawRows() only reads the
+    converter, so disjoint row ranges of the destination may be drawn on
+    several threads at the same time.
+*/
+class SK_API SkYUVConverter : SkNoncopyable {
+public:
+    enum Format {
+        kI420_Format,   //!< Y plane, then U and V planes of half the size
+        kNV12_Format,   //!< Y plane, then one plane of interleaved U and V
+    };
+
+    enum ColorSpace {
+        kRec601_ColorSpace, //!< BT.601 with studio range, as SD video
+        kRec709_ColorSpace, //!< BT.709 with studio range, as HD video
+        kJPEG_ColorSpace,   //!< BT.601 with full range, as JPEG and cameras
+    };
+
+    struct Planes {
+        const uint8_t*  fY;
+        const uint8_t*  fU;     //!< interleaved U and V for kNV12_Format
+        const uint8_t*  fV;     //!< ignored for kNV12_Format
+        size_t          fYRowBytes;
+        size_t          fUVRowBytes;
+    };
+
+    SkYUVConverter();
+
+    /** Sets the frame to draw, width x height luma samples, with chroma
+        planes of half the width and height, rounded up. The planes are
+        not copied, and must not go away before the frame is drawn.
+
+        @return false if the frame is empty or too large to draw.
+    */
+    bool setFrame(Format, ColorSpace, int width, int height, const Planes&);
+
+    /** Scales the frame by alpha when blending, 255 by default. */
+    void setAlpha(U8CPU alpha) { fAlpha = SkToU8(alpha); }
+
+    /** Maps the frame onto rect, in destination pixels. Must be called
+        after setFrame().
+
+        @return false if rect is empty.
+    */
+    bool setDstRect(const SkIRect& rect);
+
+    const SkIRect& getDstRect() const { return fDstRect; }
+
+    /** Draws the frame into dst, which must be kARGB_8888, inside clip. */
+    void draw(const SkBitmap& dst, const SkIRect& clip) const {
+        this->drawRows(dst, clip, clip.fTop, clip.fBottom);
+    }
+
+    /** Draws only the rows [top, bottom) of the frame. */
+    void drawRows(const SkBitmap& dst, const SkIRect& clip,
+                  int top, int bottom) const;
+
+private:
+    // where a destination column or row samples the frame: fIndex0 and
+    // fIndex1 blended by fWeight / 256.
+    struct Sample {
+        int32_t fIndex0;
+        int32_t fIndex1;
+        int32_t fWeight;
+    };
+
+    Format              fFormat;
+    ColorSpace          fColorSpace;
+    int                 fWidth;
+    int                 fHeight;
+    Planes              fPlanes;
+    SkIRect             fDstRect;
+    uint8_t             fAlpha;
+
+    // per column of fDstRect, for fColumnsWidth frame columns
+    SkTDArray<Sample>   fLumaColumns;
+    SkTDArray<Sample>   fChromaColumns;
+    int                 fColumnsWidth;
+
+    int chromaWidth() const { return (fWidth + 1) >> 1; }
+    int chromaHeight() const { return (fHeight + 1) >> 1; }
+};
+
+#endif
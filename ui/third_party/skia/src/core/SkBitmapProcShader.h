@@ -29,6 +29,9 @@ public:
 
     static bool CanDo(const SkBitmap&, TileMode tx, TileMode ty);
 
+    /** The sampling state, valid between setContext() and endContext(). */
+    const SkBitmapProcState& getState() const { return fState; }
+
     // override from flattenable
     virtual bool toDumpString(SkString* str) const;
     SK_DECLARE_PUBLIC_FLATTENABLE_DESERIALIZATION_PROCS(SkBitmapProcShader)
@@ -142,6 +142,43 @@ SkBlitRow::Proc32 SkBlitRow::ColorProcFactory() {
     return proc;
 }
 
+SkBlitRow::ColorAntiHProc SkBlitRow::ColorAntiHProcFactory() {
+    SkBlitRow::ColorAntiHProc proc = PlatformColorAntiHProc();
+    if (NULL == proc) {
+        proc = ColorAntiH32;
+    }
+    SkASSERT(proc);
+    return proc;
+}
+
+void SkBlitRow::ColorAntiH32(SkPMColor* SK_RESTRICT dst,
+                             const SkAlpha* SK_RESTRICT antialias,
+                             const int16_t* SK_RESTRICT runs,
+                             SkPMColor color) {
+    // if the color is opaque, then full coverage takes the fast opaque case
+    unsigned opaqueMask = SkGetPackedA32(color);
+
+    for (;;) {
+        int count = runs[0];
+        SkASSERT(count >= 0);
+        if (count <= 0) {
+            return;
+        }
+        unsigned aa = antialias[0];
+        if (aa) {
+            if ((opaqueMask & aa) == 255) {
+                sk_memset32(dst, color, count);
+            } else {
+                uint32_t sc = SkAlphaMulQ(color, SkAlpha255To256(aa));
+                Color32(dst, dst, count, sc);
+            }
+        }
+        runs += count;
+        antialias += count;
+        dst += count;
+    }
+}
+
 void SkBlitRow::Color32(SkPMColor* SK_RESTRICT dst,
                         const SkPMColor* SK_RESTRICT src,
                         int count, SkPMColor color) {
@@ -950,8 +950,13 @@ SkBlitter* SkBlitter::Choose(const SkBitmap& device,
 
         case SkBitmap::kARGB_8888_Config:
             if (shader) {
-                SK_PLACEMENT_NEW_ARGS(blitter, SkARGB32_Shader_Blitter,
-                                      storage, storageSize, (device, *paint));
+                blitter = SkBlitter_ChooseFusedD32(device, *paint,
+                                                   storage, storageSize);
+                if (NULL == blitter) {
+                    SK_PLACEMENT_NEW_ARGS(blitter, SkARGB32_Shader_Blitter,
+                                          storage, storageSize,
+                                          (device, *paint));
+                }
             } else if (paint->getColor() == SK_ColorBLACK) {
                 SK_PLACEMENT_NEW_ARGS(blitter, SkARGB32_Black_Blitter,
                                       storage, storageSize, (device, *paint));
@@ -54,6 +54,7 @@ SkARGB32_Blitter::SkARGB32_Blitter(const SkBitmap& device, const SkPaint& paint)
     fPMColor = SkPackARGB32(fSrcA, fSrcR, fSrcG, fSrcB);
     fColor32Proc = SkBlitRow::ColorProcFactory();
     fColorRect32Proc = SkBlitRow::ColorRectProcFactory();
+    fColorAntiHProc = SkBlitRow::ColorAntiHProcFactory();
 }
 
 const SkBitmap* SkARGB32_Blitter::justAnOpaqueColor(uint32_t* value) {
@@ -82,29 +83,7 @@ void SkARGB32_Blitter::blitAntiH(int x, int y, const SkAlpha antialias[],
         return;
     }
 
-    uint32_t    color = fPMColor;
-    uint32_t*   device = fDevice.getAddr32(x, y);
-    unsigned    opaqueMask = fSrcA; // if fSrcA is 0xFF, then we will catch the fast opaque case
-
-    for (;;) {
-        int count = runs[0];
-        SkASSERT(count >= 0);
-        if (count <= 0) {
-            return;
-        }
-        unsigned aa = antialias[0];
-        if (aa) {
-            if ((opaqueMask & aa) == 255) {
-                sk_memset32(device, color, count);
-            } else {
-                uint32_t sc = SkAlphaMulQ(color, SkAlpha255To256(aa));
-                fColor32Proc(device, device, count, sc);
-            }
-        }
-        runs += count;
-        antialias += count;
-        device += count;
-    }
+    fColorAntiHProc(fDevice.getAddr32(x, y), antialias, runs, fPMColor);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,461 @@
+
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+
+#include "SkCoreBlitters.h"
+#include "SkBitmapProcShader.h"
+#include "SkColorPriv.h"
+#include "SkShader.h"
+#include "SkTemplatesPriv.h"
+#include "SkXfermode.h"
+
+/*  Fused blitters shade and blend each pixel in one pass, for the paints
+    SkARGB32_Shader_Blitter draws slowest: kMultiply_Mode, which it can only
+    apply through the virtual xfer32, and solid colors with kSrc_Mode.
+
+    SkARGB32_Shader_Blitter calls the virtual shadeSpan into a span buffer,
+    which a bitmap shader fills through a matrix proc, an index buffer and a
+    sample proc, and then reads the span back to blend it. A fused blitter is
+    a template over a source, which samples the bitmap state directly, and a
+    blend, so the per pixel work is inlined.
+
+    Sources and blends reproduce the procs the shader blitter would have
+    used, pixel for pixel. The clamp matrix procs have SSE2 and NEON versions
+    that step in SkFixed where the portable ones step in SkFractionalInt, so
+    the clamp sources take their indices from the state's own matrix proc and
+    fuse only the sampling and the blend.
+
+    Without an xfermode, with kSrc_Mode for bitmaps and for filtered bitmaps
+    the shader blitter's own procs, SSE2 ones included, are faster than a
+    fused loop (ui/bench/FusedBlitterBench), so those are left to it, as are
+    masks and blitV.
+ */
+
+// SkBitmapProcShader::shadeSpan maps this many xy entries per matrix proc
+// call, restarting from the inverse matrix at each call. The bitmap sources
+// restart at the same pixels so they round exactly the same way.
+static const size_t kShadeSpanBufferSize = 128 * sizeof(uint32_t);
+
+///////////////////////////////////////////////////////////////////////////////
+// Tile modes, the TILEX_PROCF of the matrix procs
+
+struct SkRepeatTile {
+    static unsigned Index(SkFixed f, unsigned max) {
+        return ((f & 0xFFFF) * (max + 1)) >> 16;
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Sources: setup() positions the source at a device pixel, then next()
+// returns the count consecutive pixels of the row that follow.
+
+class SkSolidSource {
+public:
+    explicit SkSolidSource(SkShader* shader) {
+        shader->shadeSpan(0, 0, &fColor, 1);
+    }
+
+    int maxRunCount() const { return SK_MaxS32; }
+    void setup(int x, int y, int count) {}
+    SkPMColor next() { return fColor; }
+
+private:
+    SkPMColor fColor;
+};
+
+class SkBitmapSourceBase {
+protected:
+    explicit SkBitmapSourceBase(SkShader* shader)
+        : fState(static_cast<SkBitmapProcShader*>(shader)->getState()) {
+        fPixels = (const char*)fState.fBitmap->getPixels();
+        fRowBytes = fState.fBitmap->rowBytes();
+        fMaxX = fState.fBitmap->width() - 1;
+        fMaxY = fState.fBitmap->height() - 1;
+        fAlphaScale = fState.fAlphaScale;
+        fRunCount = fState.maxCountForBufferSize(kShadeSpanBufferSize);
+    }
+
+    SkPoint mapCenter(int x, int y) const {
+        SkPoint pt;
+        fState.fInvProc(*fState.fInvMatrix, SkIntToScalar(x) + SK_ScalarHalf,
+                        SkIntToScalar(y) + SK_ScalarHalf, &pt);
+        return pt;
+    }
+
+    const SkPMColor* row(unsigned y) const {
+        return (const SkPMColor*)(fPixels + y * fRowBytes);
+    }
+
+    SkPMColor scale(SkPMColor c) const {
+        return 256 == fAlphaScale ? c : SkAlphaMulQ(c, fAlphaScale);
+    }
+
+public:
+    int maxRunCount() const { return fRunCount; }
+
+protected:
+    const SkBitmapProcState& fState;
+    const char*     fPixels;
+    size_t          fRowBytes;
+    unsigned        fMaxX;
+    unsigned        fMaxY;
+    unsigned        fAlphaScale;
+    int             fRunCount;
+};
+
+// RepeatX_RepeatY_nofilter_scale + S32_opaque_D32_nofilter_DX
+template <typename Tile> class SkNoFilterScaleSource : public SkBitmapSourceBase {
+public:
+    explicit SkNoFilterScaleSource(SkShader* shader)
+        : SkBitmapSourceBase(shader)
+        , fDx(fState.fInvSxFractionalInt) {}
+
+    void setup(int x, int y, int count) {
+        SkPoint pt = this->mapCenter(x, y);
+        fRow = this->row(Tile::Index(SkFractionalIntToFixed(
+                            SkScalarToFractionalInt(pt.fY)), fMaxY));
+        fFx = SkScalarToFractionalInt(pt.fX);
+    }
+
+    SkPMColor next() {
+        unsigned x = Tile::Index(SkFractionalIntToFixed(fFx), fMaxX);
+        fFx += fDx;
+        return this->scale(fRow[x]);
+    }
+
+private:
+    const SkPMColor*    fRow;
+    SkFractionalInt     fFx;
+    SkFractionalInt     fDx;
+};
+
+// RepeatX_RepeatY_nofilter_affine + S32_opaque_D32_nofilter_DXDY
+template <typename Tile> class SkNoFilterAffineSource : public SkBitmapSourceBase {
+public:
+    explicit SkNoFilterAffineSource(SkShader* shader)
+        : SkBitmapSourceBase(shader)
+        , fDx(fState.fInvSxFractionalInt)
+        , fDy(fState.fInvKyFractionalInt) {}
+
+    void setup(int x, int y, int count) {
+        SkPoint pt = this->mapCenter(x, y);
+        fFx = SkScalarToFractionalInt(pt.fX);
+        fFy = SkScalarToFractionalInt(pt.fY);
+    }
+
+    SkPMColor next() {
+        unsigned y = Tile::Index(SkFractionalIntToFixed(fFy), fMaxY);
+        unsigned x = Tile::Index(SkFractionalIntToFixed(fFx), fMaxX);
+        fFx += fDx;
+        fFy += fDy;
+        return this->scale(this->row(y)[x]);
+    }
+
+private:
+    SkFractionalInt fFx;
+    SkFractionalInt fFy;
+    SkFractionalInt fDx;
+    SkFractionalInt fDy;
+};
+
+// The matrix proc of the state maps a run into the xy buffer, in the layout
+// the sample procs read, and next() samples it.
+class SkMatrixProcSourceBase : public SkBitmapSourceBase {
+protected:
+    explicit SkMatrixProcSourceBase(SkShader* shader)
+        : SkBitmapSourceBase(shader)
+        , fMatrixProc(fState.getMatrixProc())
+        , fBuffer(kShadeSpanBufferSize / sizeof(uint32_t)) {}
+
+    const uint32_t* map(int x, int y, int count) {
+        fMatrixProc(fState, fBuffer.get(), count, x, y);
+        return fBuffer.get();
+    }
+
+private:
+    SkBitmapProcState::MatrixProc   fMatrixProc;
+    SkAutoTMalloc<uint32_t>         fBuffer;
+};
+
+// ClampX_ClampY_nofilter_scale + S32_opaque_D32_nofilter_DX
+class SkClampNoFilterScaleSource : public SkMatrixProcSourceBase {
+public:
+    explicit SkClampNoFilterScaleSource(SkShader* shader)
+        : SkMatrixProcSourceBase(shader) {}
+
+    void setup(int x, int y, int count) {
+        const uint32_t* xy = this->map(x, y, count);
+        fRow = this->row(xy[0]);
+        fXX = (const uint16_t*)(xy + 1);
+    }
+
+    SkPMColor next() {
+        return this->scale(fRow[*fXX++]);
+    }
+
+private:
+    const SkPMColor*    fRow;
+    const uint16_t*     fXX;
+};
+
+// ClampX_ClampY_nofilter_affine + S32_opaque_D32_nofilter_DXDY
+class SkClampNoFilterAffineSource : public SkMatrixProcSourceBase {
+public:
+    explicit SkClampNoFilterAffineSource(SkShader* shader)
+        : SkMatrixProcSourceBase(shader) {}
+
+    void setup(int x, int y, int count) {
+        fXY = this->map(x, y, count);
+    }
+
+    SkPMColor next() {
+        uint32_t XY = *fXY++;
+        return this->scale(this->row(XY >> 16)[XY & 0xFFFF]);
+    }
+
+private:
+    const uint32_t* fXY;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Blends: Blend() at full coverage, BlendAA() for 0 < aa < 255.
+
+// kSrc_Mode, shaded into the device and blended with blend_srcmode
+struct SkSrcBlend {
+    static SkPMColor Blend(SkPMColor src, SkPMColor dst) {
+        return src;
+    }
+    static SkPMColor BlendAA(SkPMColor src, SkPMColor dst, unsigned aa) {
+        return SkFourByteInterp256(src, dst, SkAlpha255To256(aa));
+    }
+};
+
+// kMultiply_Mode, multiply_modeproc through SkProcXfermode::xfer32
+struct SkMultiplyBlend {
+    static SkPMColor Blend(SkPMColor src, SkPMColor dst) {
+        return SkPackARGB32(
+                SkMulDiv255Round(SkGetPackedA32(src), SkGetPackedA32(dst)),
+                SkMulDiv255Round(SkGetPackedR32(src), SkGetPackedR32(dst)),
+                SkMulDiv255Round(SkGetPackedG32(src), SkGetPackedG32(dst)),
+                SkMulDiv255Round(SkGetPackedB32(src), SkGetPackedB32(dst)));
+    }
+    static SkPMColor BlendAA(SkPMColor src, SkPMColor dst, unsigned aa) {
+        return SkFourByteInterp(Blend(src, dst), dst, aa);
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+template <typename Source, typename Blend>
+class SkARGB32_Fused_Blitter : public SkARGB32_Shader_Blitter {
+public:
+    SkARGB32_Fused_Blitter(const SkBitmap& device, const SkPaint& paint)
+        : INHERITED(device, paint)
+        , fSource(fShader) {}
+
+    virtual void blitH(int x, int y, int width) SK_OVERRIDE {
+        SkASSERT(x >= 0 && y >= 0 && x + width <= fDevice.width());
+        this->blitRun(fDevice.getAddr32(x, y), x, y, width);
+    }
+
+    virtual void blitRect(int x, int y, int width, int height) SK_OVERRIDE {
+        SkASSERT(x >= 0 && y >= 0 &&
+                 x + width <= fDevice.width() && y + height <= fDevice.height());
+
+        uint32_t* device = fDevice.getAddr32(x, y);
+        size_t deviceRB = fDevice.rowBytes();
+        do {
+            this->blitRun(device, x, y, width);
+            y += 1;
+            device = (uint32_t*)((char*)device + deviceRB);
+        } while (--height > 0);
+    }
+
+    virtual void blitAntiH(int x, int y, const SkAlpha antialias[],
+                           const int16_t runs[]) SK_OVERRIDE {
+        uint32_t* device = fDevice.getAddr32(x, y);
+        for (;;) {
+            int count = *runs;
+            if (count <= 0) {
+                break;
+            }
+            int aa = *antialias;
+            if (255 == aa) {
+                this->blitRun(device, x, y, count);
+            } else if (aa) {
+                this->blitRunAA(device, x, y, count, aa);
+            }
+            device += count;
+            runs += count;
+            antialias += count;
+            x += count;
+        }
+    }
+
+private:
+    Source  fSource;
+
+    void blitRun(uint32_t* SK_RESTRICT device, int x, int y, int count) {
+        const int runCount = fSource.maxRunCount();
+        while (count > 0) {
+            int n = SkMin32(count, runCount);
+            fSource.setup(x, y, n);
+            for (int i = 0; i < n; ++i) {
+                device[i] = Blend::Blend(fSource.next(), device[i]);
+            }
+            device += n;
+            x += n;
+            count -= n;
+        }
+    }
+
+    void blitRunAA(uint32_t* SK_RESTRICT device, int x, int y, int count,
+                   unsigned aa) {
+        const int runCount = fSource.maxRunCount();
+        while (count > 0) {
+            int n = SkMin32(count, runCount);
+            fSource.setup(x, y, n);
+            for (int i = 0; i < n; ++i) {
+                device[i] = Blend::BlendAA(fSource.next(), device[i], aa);
+            }
+            device += n;
+            x += n;
+            count -= n;
+        }
+    }
+
+    typedef SkARGB32_Shader_Blitter INHERITED;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+typedef SkBlitter* (*FusedFactory)(const SkBitmap& device, const SkPaint& paint,
+                                   void* storage, size_t storageSize);
+
+template <typename Source, typename Blend>
+SkBlitter* create_fused_blitter(const SkBitmap& device, const SkPaint& paint,
+                                void* storage, size_t storageSize) {
+    typedef SkARGB32_Fused_Blitter<Source, Blend> Blitter;
+    Blitter* blitter;
+    SK_PLACEMENT_NEW_ARGS(blitter, Blitter, storage, storageSize,
+                          (device, paint));
+    return blitter;
+}
+
+enum FusedSource {
+    kSolid_FusedSource,
+    kClampScale_FusedSource,
+    kClampAffine_FusedSource,
+    kRepeatScale_FusedSource,
+    kRepeatAffine_FusedSource,
+
+    kFusedSourceCount
+};
+
+enum FusedBlend {
+    kSrc_FusedBlend,
+    kMultiply_FusedBlend,
+
+    kFusedBlendCount
+};
+
+// the shader blitter shades a bitmap straight into the device for kSrc_Mode
+#define FUSED_BLENDS(Source)                                    \
+    {   NULL,                                                   \
+        create_fused_blitter<Source, SkMultiplyBlend> }
+
+static const FusedFactory gFusedFactories[kFusedSourceCount][kFusedBlendCount] = {
+    {   create_fused_blitter<SkSolidSource, SkSrcBlend>,
+        create_fused_blitter<SkSolidSource, SkMultiplyBlend> },
+    FUSED_BLENDS(SkClampNoFilterScaleSource),
+    FUSED_BLENDS(SkClampNoFilterAffineSource),
+    FUSED_BLENDS(SkNoFilterScaleSource<SkRepeatTile>),
+    FUSED_BLENDS(SkNoFilterAffineSource<SkRepeatTile>),
+};
+
+#undef FUSED_BLENDS
+
+static bool choose_bitmap_source(SkShader* shader, FusedSource* source) {
+    if (SkShader::kDefault_BitmapType != shader->asABitmap(NULL, NULL, NULL)) {
+        return false;
+    }
+
+    // only SkBitmapProcShader reports kDefault_BitmapType
+    const SkBitmapProcState& state =
+            static_cast<SkBitmapProcShader*>(shader)->getState();
+
+    // translate only matrices and perspective use other procs, and the
+    // filter sample procs have SSE2 versions a fused loop does not beat
+    if (SkBitmap::kARGB_8888_Config != state.fBitmap->config() ||
+        state.fInvType <= SkMatrix::kTranslate_Mask ||
+        (state.fInvType & SkMatrix::kPerspective_Mask) ||
+        state.fDoFilter) {
+        return false;
+    }
+
+    int index;
+    if (SkShader::kClamp_TileMode == state.fTileModeX &&
+        SkShader::kClamp_TileMode == state.fTileModeY) {
+        index = kClampScale_FusedSource;
+    } else if (SkShader::kRepeat_TileMode == state.fTileModeX &&
+               SkShader::kRepeat_TileMode == state.fTileModeY) {
+        index = kRepeatScale_FusedSource;
+    } else {
+        return false;
+    }
+
+    if (state.fInvType & SkMatrix::kAffine_Mask) {
+        index += 1;
+    }
+    *source = (FusedSource)index;
+    return true;
+}
+
+static bool choose_blend(const SkPaint& paint, FusedBlend* blend) {
+    // without an xfermode the shader blitter blends with the SkBlitRow procs
+    SkXfermode* xfer = paint.getXfermode();
+    SkXfermode::Mode mode;
+    if (NULL == xfer || !xfer->asMode(&mode)) {
+        return false;
+    }
+    switch (mode) {
+        case SkXfermode::kSrc_Mode:
+            *blend = kSrc_FusedBlend;
+            return true;
+        case SkXfermode::kMultiply_Mode:
+            *blend = kMultiply_FusedBlend;
+            return true;
+        default:
+            return false;
+    }
+}
+
+SkBlitter* SkBlitter_ChooseFusedD32(const SkBitmap& device,
+                                    const SkPaint& paint,
+                                    void* storage, size_t storageSize) {
+    SkShader* shader = paint.getShader();
+    SkASSERT(shader);
+
+    FusedSource source;
+    if (SkShader::kColor_GradientType == shader->asAGradient(NULL)) {
+        source = kSolid_FusedSource;
+    } else if (!choose_bitmap_source(shader, &source)) {
+        return NULL;
+    }
+
+    FusedBlend blend;
+    if (!choose_blend(paint, &blend)) {
+        return NULL;
+    }
+
+    FusedFactory factory = gFusedFactories[source][blend];
+    if (NULL == factory) {
+        return NULL;
+    }
+    return factory(device, paint, storage, storageSize);
+}
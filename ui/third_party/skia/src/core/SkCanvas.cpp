@@ -14,6 +14,7 @@
 #include "SkDraw.h"
 #include "SkDrawFilter.h"
 #include "SkDrawLooper.h"
+#include "SkGlyphStrike.h"
 #include "SkMetaData.h"
 #include "SkPicture.h"
 #include "SkRasterClip.h"
@@ -24,6 +25,7 @@
 #include "SkTextFormatParams.h"
 #include "SkTLazy.h"
 #include "SkUtils.h"
+#include "SkXfermode.h"
 
 SK_DEFINE_INST_COUNT(SkBounder)
 SK_DEFINE_INST_COUNT(SkCanvas)
@@ -199,6 +201,7 @@ public:
     SkMatrix*       fMatrix;        // points to either fMatrixStorage or prev MCRec
     SkRasterClip*   fRasterClip;    // points to either fRegionStorage or prev MCRec
     SkDrawFilter*   fFilter;        // the current filter (or null)
+    U8CPU           fLayerAlpha;    // from kModulateAlpha_SaveFlag layers
 
     DeviceCM*   fLayer;
     /*  If there are any layers in the stack, this points to the top-most
@@ -227,6 +230,7 @@ public:
 
             fFilter = prev->fFilter;
             SkSafeRef(fFilter);
+            fLayerAlpha = prev->fLayerAlpha;
 
             fTopLayer = prev->fTopLayer;
         } else {   // no prev
@@ -235,6 +239,7 @@ public:
             fMatrix     = &fMatrixStorage;
             fRasterClip = &fRasterClipStorage;
             fFilter     = NULL;
+            fLayerAlpha = 0xFF;
             fTopLayer   = NULL;
         }
         fLayer = NULL;
@@ -321,6 +326,7 @@ public:
         fCanvas = canvas;
         fLooper = paint.getLooper();
         fFilter = canvas->getDrawFilter();
+        fLayerAlpha = canvas->fMCRec->fLayerAlpha;
         fPaint = NULL;
         fSaveCount = canvas->getSaveCount();
         fDoClearImageFilter = false;
@@ -342,7 +348,8 @@ public:
             fIsSimple = false;
         } else {
             // can we be marked as simple?
-            fIsSimple = !fFilter && !fDoClearImageFilter;
+            fIsSimple = !fFilter && !fDoClearImageFilter &&
+                        0xFF == fLayerAlpha;
         }
     }
 
@@ -376,6 +383,7 @@ private:
     const SkPaint&  fOrigPaint;
     SkDrawLooper*   fLooper;
     SkDrawFilter*   fFilter;
+    U8CPU           fLayerAlpha;
     const SkPaint*  fPaint;
     int             fSaveCount;
     bool            fDoClearImageFilter;
@@ -388,7 +396,8 @@ private:
 bool AutoDrawLooper::doNext(SkDrawFilter::Type drawType) {
     fPaint = NULL;
     SkASSERT(!fIsSimple);
-    SkASSERT(fLooper || fFilter || fDoClearImageFilter);
+    SkASSERT(fLooper || fFilter || fDoClearImageFilter ||
+             0xFF != fLayerAlpha);
 
     SkPaint* paint = fLazyPaint.set(fOrigPaint);
 
@@ -410,9 +419,13 @@ bool AutoDrawLooper::doNext(SkDrawFilter::Type drawType) {
             fDone = true;
         }
     }
+    if (0xFF != fLayerAlpha) {
+        paint->setAlpha(SkMulDiv255Round(paint->getAlpha(), fLayerAlpha));
+    }
     fPaint = paint;
 
-    // if we only came in here for the imagefilter, mark us as done
+    // if we only came in here for the imagefilter or layer alpha, mark us as
+    // done
     if (!fLooper && !fFilter) {
         fDone = true;
     }
@@ -779,6 +792,23 @@ static bool bounds_affects_clip(SkCanvas::SaveFlags flags) {
     return (flags & SkCanvas::kClipToLayer_SaveFlag) != 0;
 }
 
+// A layer drawn back with paint can be replaced by modulating the alpha of
+// each draw when paint does nothing but fade it.
+static bool can_modulate_alpha(const SkPaint* paint) {
+    if (NULL == paint) {
+        return true;
+    }
+    SkXfermode::Mode mode;
+    SkXfermode* xfer = paint->getXfermode();
+    if (xfer && (!SkXfermode::AsMode(xfer, &mode) ||
+                 SkXfermode::kSrcOver_Mode != mode)) {
+        return false;
+    }
+    return NULL == paint->getShader() && NULL == paint->getColorFilter() &&
+           NULL == paint->getImageFilter() && NULL == paint->getMaskFilter() &&
+           NULL == paint->getLooper() && NULL == paint->getRasterizer();
+}
+
 bool SkCanvas::clipRectBounds(const SkRect* bounds, SaveFlags flags,
                                SkIRect* intersection) {
     SkIRect clipBounds;
@@ -834,6 +864,14 @@ int SkCanvas::internalSaveLayer(const SkRect* bounds, const SkPaint* paint,
         return count;
     }
 
+    if ((flags & kModulateAlpha_SaveFlag) && can_modulate_alpha(paint)) {
+        if (paint) {
+            fMCRec->fLayerAlpha = SkMulDiv255Round(fMCRec->fLayerAlpha,
+                                                   paint->getAlpha());
+        }
+        return count;
+    }
+
     // Kill the imagefilter if our device doesn't allow it
     SkLazyPaint lazyP;
     if (paint && paint->getImageFilter()) {
@@ -864,6 +902,10 @@ int SkCanvas::internalSaveLayer(const SkRect* bounds, const SkPaint* paint,
         return count;
     }
 
+    // the alpha modulated so far fades the layer when it is drawn back by
+    // restore(), so the draws into the layer must not be faded by it too
+    fMCRec->fLayerAlpha = 0xFF;
+
     device->setOrigin(ir.fLeft, ir.fTop);
     DeviceCM* layer = SkNEW_ARGS(DeviceCM, (device, ir.fLeft, ir.fTop, paint, this));
     device->unref();
@@ -1173,16 +1215,61 @@ static bool clipPathHelper(const SkCanvas* canvas, SkRasterClip* currClip,
     }
 }
 
+/**
+ *  Maps rrect to device space if the matrix only scales it up or down and
+ *  moves it, so that it stays a round rect.
+ */
+static bool map_rrect(const SkMatrix& matrix, const SkRRect& rrect,
+                      SkRRect* devRRect) {
+    if (matrix.getType() & ~(SkMatrix::kScale_Mask | SkMatrix::kTranslate_Mask)) {
+        return false;
+    }
+    SkScalar sx = matrix.getScaleX();
+    SkScalar sy = matrix.getScaleY();
+    if (sx <= 0 || sy <= 0) {
+        // a mirror would swap the corners
+        return false;
+    }
+
+    SkRect r;
+    SkVector radii[4];
+    matrix.mapRect(&r, rrect.rect());
+    for (int i = 0; i < 4; ++i) {
+        const SkVector& src = rrect.radii((SkRRect::Corner)i);
+        radii[i].set(SkScalarMul(src.fX, sx), SkScalarMul(src.fY, sy));
+    }
+    devRRect->setRectRadii(r, radii);
+    return true;
+}
+
 bool SkCanvas::clipRRect(const SkRRect& rrect, SkRegion::Op op, bool doAA) {
     if (rrect.isRect()) {
         // call the non-virtual version
         return this->SkCanvas::clipRect(rrect.getBounds(), op, doAA);
-    } else {
-        SkPath path;
-        path.addRRect(rrect);
-        // call the non-virtual version
-        return this->SkCanvas::clipPath(path, op, doAA);
     }
+
+    SkRRect devRRect;
+    if (SkRegion::kIntersect_Op == op && (doAA & fAllowSoftClip) &&
+        map_rrect(*fMCRec->fMatrix, rrect, &devRRect)) {
+        AutoValidateClip avc(this);
+
+        // the raster clip keeps the round rect itself when it can, sparing
+        // it the scan conversion and the mask of every row
+        if (fMCRec->fRasterClip->intersectRRect(devRRect)) {
+            SkPath devPath;
+            devPath.addRRect(devRRect);
+
+            fDeviceCMDirty = true;
+            fLocalBoundsCompareTypeDirty = true;
+            fClipStack.clipDevPath(devPath, op, true);
+            return !fMCRec->fRasterClip->isEmpty();
+        }
+    }
+
+    SkPath path;
+    path.addRRect(rrect);
+    // call the non-virtual version
+    return this->SkCanvas::clipPath(path, op, doAA);
 }
 
 bool SkCanvas::clipPath(const SkPath& path, SkRegion::Op op, bool doAA) {
@@ -1866,6 +1953,41 @@ void SkCanvas::drawText(const void* text, size_t byteLength,
     LOOPER_END
 }
 
+void SkCanvas::drawGlyphs(SkGlyphStrike* strike, const uint16_t glyphs[],
+                          int count, SkScalar x, SkScalar y,
+                          const SkPaint& paint) {
+    if (NULL == strike) {
+        this->drawGlyphsAsText(glyphs, count, x, y, paint);
+        return;
+    }
+
+    CHECK_SHADER_NOSETCONTEXT(paint);
+
+    LOOPER_BEGIN(paint, SkDrawFilter::kText_Type)
+
+    while (iter.next()) {
+        SkDeviceFilteredPaint dfp(iter.fDevice, looper.paint());
+        iter.fDevice->drawGlyphs(iter, strike, glyphs, count, x, y,
+                                 dfp.paint());
+        if (dfp.paint().getFlags() & (SkPaint::kUnderlineText_Flag |
+                                      SkPaint::kStrikeThruText_Flag)) {
+            SkPaint glyphPaint(dfp.paint());
+            glyphPaint.setTextEncoding(SkPaint::kGlyphID_TextEncoding);
+            DrawTextDecorations(iter, glyphPaint, (const char*)glyphs,
+                                count * sizeof(uint16_t), x, y);
+        }
+    }
+
+    LOOPER_END
+}
+
+void SkCanvas::drawGlyphsAsText(const uint16_t glyphs[], int count,
+                                SkScalar x, SkScalar y, const SkPaint& paint) {
+    SkPaint glyphPaint(paint);
+    glyphPaint.setTextEncoding(SkPaint::kGlyphID_TextEncoding);
+    this->drawText(glyphs, count * sizeof(uint16_t), x, y, glyphPaint);
+}
+
 void SkCanvas::drawPosText(const void* text, size_t byteLength,
                            const SkPoint pos[], const SkPaint& paint) {
     CHECK_SHADER_NOSETCONTEXT(paint);
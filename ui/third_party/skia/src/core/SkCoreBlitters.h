@@ -95,6 +95,7 @@ protected:
     SkPMColor              fPMColor;
     SkBlitRow::ColorProc   fColor32Proc;
     SkBlitRow::ColorRectProc fColorRect32Proc;
+    SkBlitRow::ColorAntiHProc fColorAntiHProc;
 
 private:
     unsigned fSrcA, fSrcR, fSrcG, fSrcB;
@@ -188,5 +189,11 @@ extern SkBlitter* SkBlitter_ChooseD565(const SkBitmap& device,
                                        const SkPaint& paint,
                                        void* storage, size_t storageSize);
 
+// Returns a blitter that shades and blends in one pass for the shaders and
+// xfermodes it specializes, or NULL to use SkARGB32_Shader_Blitter.
+extern SkBlitter* SkBlitter_ChooseFusedD32(const SkBitmap& device,
+                                           const SkPaint& paint,
+                                           void* storage, size_t storageSize);
+
 #endif
 
@@ -7,7 +7,9 @@
  */
 #include "SkDevice.h"
 #include "SkDraw.h"
+#include "SkGlyphStrike.h"
 #include "SkImageFilter.h"
+#include "SkLayerPool.h"
 #include "SkMetaData.h"
 #include "SkRasterClip.h"
 #include "SkRect.h"
@@ -77,6 +79,14 @@ SkDevice* SkDevice::onCreateCompatibleDevice(SkBitmap::Config config,
                                              int width, int height,
                                              bool isOpaque,
                                              Usage usage) {
+    if (kSaveLayer_Usage == usage) {
+        // Layers come and go with every opacity group, recycle their pixels.
+        SkBitmap bitmap;
+        bitmap.setConfig(config, width, height);
+        if (SkLayerPool::AllocPixels(&bitmap, isOpaque)) {
+            return SkNEW_ARGS(SkDevice, (bitmap));
+        }
+    }
     return SkNEW_ARGS(SkDevice,(config, width, height, isOpaque));
 }
 
@@ -472,6 +482,25 @@ void SkDevice::drawText(const SkDraw& draw, const void* text, size_t len,
     draw.drawText((const char*)text, len, x, y, paint);
 }
 
+void SkDevice::drawGlyphs(const SkDraw& draw, SkGlyphStrike* strike,
+                          const uint16_t glyphs[], int count,
+                          SkScalar x, SkScalar y, const SkPaint& paint) {
+    if ((this->getDeviceCapabilities() & kVector_Capability) ||
+            !strike->matches(paint, *draw.fMatrix)) {
+        this->drawGlyphsAsText(draw, glyphs, count, x, y, paint);
+        return;
+    }
+    draw.drawGlyphs(strike, glyphs, count, x, y, paint);
+}
+
+void SkDevice::drawGlyphsAsText(const SkDraw& draw, const uint16_t glyphs[],
+                                int count, SkScalar x, SkScalar y,
+                                const SkPaint& paint) {
+    SkPaint glyphPaint(paint);
+    glyphPaint.setTextEncoding(SkPaint::kGlyphID_TextEncoding);
+    this->drawText(draw, glyphs, count * sizeof(uint16_t), x, y, glyphPaint);
+}
+
 void SkDevice::drawPosText(const SkDraw& draw, const void* text, size_t len,
                                const SkScalar xpos[], SkScalar y,
                                int scalarsPerPos, const SkPaint& paint) {
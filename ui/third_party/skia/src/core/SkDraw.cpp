@@ -14,6 +14,7 @@
 #include "SkColorPriv.h"
 #include "SkDevice.h"
 #include "SkFixed.h"
+#include "SkGlyphStrike.h"
 #include "SkMaskFilter.h"
 #include "SkPaint.h"
 #include "SkPathEffect.h"
@@ -1450,8 +1451,8 @@ static void D1G_NoBounder_RectClip(const SkDraw1Glyph& state,
     int top = SkFixedFloor(fy);
     SkASSERT(glyph.fWidth > 0 && glyph.fHeight > 0);
     SkASSERT(NULL == state.fBounder);
-    SkASSERT((NULL == state.fClip && state.fAAClip) ||
-             (state.fClip && NULL == state.fAAClip && state.fClip->isRect()));
+    SkASSERT(NULL == state.fClip ||
+             (NULL == state.fAAClip && state.fClip->isRect()));
 
     left += glyph.fLeft;
     top  += glyph.fTop;
@@ -1614,9 +1615,10 @@ SkDraw1Glyph::Proc SkDraw1Glyph::init(const SkDraw* draw, SkBlitter* blitter,
             return D1G_Bounder;
         }
     } else {    // aaclip
-        fAAClip = &draw->fRC->aaRgn();
+        // the blitter clips, a round rect clip has no SkAAClip to share
+        fAAClip = draw->fRC->isRRect() ? NULL : &draw->fRC->aaRgn();
         fClip = NULL;
-        fClipBounds = fAAClip->getBounds();
+        fClipBounds = draw->fRC->getBounds();
         if (NULL == fBounder) {
             return D1G_NoBounder_RectClip;
         } else {
@@ -1701,15 +1703,15 @@ void SkDraw::drawText(const char text[], size_t byteLength,
         fy += SK_FixedHalf;
     }
 
-    SkAAClipBlitter     aaBlitter;
+    SkAAClipBlitterWrapper wrapper;
     SkAutoBlitterChoose blitterChooser;
     SkBlitter*          blitter = NULL;
     if (needsRasterTextBlit(*this)) {
         blitterChooser.choose(*fBitmap, *matrix, paint);
         blitter = blitterChooser.get();
         if (fRC->isAA()) {
-            aaBlitter.init(blitter, &fRC->aaRgn());
-            blitter = &aaBlitter;
+            wrapper.init(*fRC, blitter);
+            blitter = wrapper.getBlitter();
         }
     }
 
@@ -1730,6 +1732,124 @@ void SkDraw::drawText(const char text[], size_t byteLength,
     }
 }
 
+static void measure_glyphs(SkGlyphCache* cache, const uint16_t glyphs[],
+                           int count, SkVector* stopVector) {
+    SkFixed     x = 0, y = 0;
+    SkAutoKern  autokern;
+
+    for (int i = 0; i < count; i++) {
+        const SkGlyph& glyph = cache->getGlyphIDAdvance(glyphs[i]);
+
+        x += autokern.adjust(glyph) + glyph.fAdvanceX;
+        y += glyph.fAdvanceY;
+    }
+    stopVector->set(SkFixedToScalar(x), SkFixedToScalar(y));
+}
+
+// Same as drawText, except that the glyph cache comes from the strike instead
+// of a descriptor lookup, and the text is already glyph IDs.
+void SkDraw::drawGlyphs(SkGlyphStrike* strike, const uint16_t glyphs[],
+                        int count, SkScalar x, SkScalar y,
+                        const SkPaint& paint) const {
+    SkASSERT(count == 0 || glyphs != NULL);
+
+    SkDEBUGCODE(this->validate();)
+
+    // nothing to draw
+    if (glyphs == NULL || count <= 0 || fRC->isEmpty()) {
+        return;
+    }
+
+    SkASSERT(strike->matches(paint, *fMatrix));
+
+    if (0 == paint.getStrokeWidth() && SkPaint::kStroke_Style == paint.getStyle()) {
+        SkPaint glyphPaint(paint);
+        glyphPaint.setTextEncoding(SkPaint::kGlyphID_TextEncoding);
+        this->drawText_asPaths((const char*)glyphs, count * sizeof(uint16_t),
+                               x, y, glyphPaint);
+        return;
+    }
+
+    const SkMatrix* matrix = fMatrix;
+    SkGlyphCache*   cache = strike->getCache();
+
+    // transform our starting point
+    {
+        SkPoint loc;
+        matrix->mapXY(x, y, &loc);
+        x = loc.fX;
+        y = loc.fY;
+    }
+
+    // need to measure first
+    if (paint.getTextAlign() != SkPaint::kLeft_Align) {
+        SkVector    stop;
+
+        measure_glyphs(cache, glyphs, count, &stop);
+
+        SkScalar    stopX = stop.fX;
+        SkScalar    stopY = stop.fY;
+
+        if (paint.getTextAlign() == SkPaint::kCenter_Align) {
+            stopX = SkScalarHalf(stopX);
+            stopY = SkScalarHalf(stopY);
+        }
+        x -= stopX;
+        y -= stopY;
+    }
+
+    SkFixed fx = SkScalarToFixed(x);
+    SkFixed fy = SkScalarToFixed(y);
+
+    SkFixed fxMask = ~0;
+    SkFixed fyMask = ~0;
+    if (cache->isSubpixel()) {
+        SkAxisAlignment baseline = SkComputeAxisAlignmentForHText(*matrix);
+        if (kX_SkAxisAlignment == baseline) {
+            fyMask = 0;
+        } else if (kY_SkAxisAlignment == baseline) {
+            fxMask = 0;
+        }
+
+    // apply bias here to avoid adding 1/2 the sampling frequency in the loop
+        fx += SK_FixedHalf >> SkGlyph::kSubBits;
+        fy += SK_FixedHalf >> SkGlyph::kSubBits;
+    } else {
+        fx += SK_FixedHalf;
+        fy += SK_FixedHalf;
+    }
+
+    SkAAClipBlitterWrapper wrapper;
+    SkAutoBlitterChoose blitterChooser;
+    SkBlitter*          blitter = NULL;
+    if (needsRasterTextBlit(*this)) {
+        blitterChooser.choose(*fBitmap, *matrix, paint);
+        blitter = blitterChooser.get();
+        if (fRC->isAA()) {
+            wrapper.init(*fRC, blitter);
+            blitter = wrapper.getBlitter();
+        }
+    }
+
+    SkAutoKern          autokern;
+    SkDraw1Glyph        d1g;
+    SkDraw1Glyph::Proc  proc = d1g.init(this, blitter, cache);
+
+    for (int i = 0; i < count; i++) {
+        const SkGlyph& glyph = cache->getGlyphIDMetrics(glyphs[i],
+                                                        fx & fxMask,
+                                                        fy & fyMask);
+
+        fx += autokern.adjust(glyph);
+
+        if (glyph.fWidth) {
+            proc(d1g, fx, fy, glyph);
+        }
+        fx += glyph.fAdvanceX;
+        fy += glyph.fAdvanceY;
+    }
+}
+
 // last parameter is interpreted as SkFixed [x, y]
 // return the fixed position, which may be rounded or not by the caller
 //   e.g. subpixel doesn't round
@@ -1988,19 +2108,29 @@ void SkDraw::drawPosText(const char text[], size_t byteLength,
 static void morphpoints(SkPoint dst[], const SkPoint src[], int count,
                         SkPathMeasure& meas, const SkMatrix& matrix) {
     SkMatrix::MapXYProc proc = matrix.getMapXYProc();
+    SkScalar    distances[3], offsets[3];
+    SkPoint     positions[3];
+    SkVector    tangents[3];
 
+    // x is the distance along the path, y the offset from it
+    SkASSERT(count <= 3);
     for (int i = 0; i < count; i++) {
-        SkPoint pos;
-        SkVector tangent;
-
-        proc(matrix, src[i].fX, src[i].fY, &pos);
-        SkScalar sx = pos.fX;
-        SkScalar sy = pos.fY;
+        proc(matrix, src[i].fX, src[i].fY, &positions[i]);
+        distances[i] = positions[i].fX;
+        offsets[i] = positions[i].fY;
+    }
 
-        if (!meas.getPosTan(sx, &pos, &tangent)) {
-            // set to 0 if the measure failed, so that we just set dst == pos
-            tangent.set(0, 0);
+    if (!meas.getPosTan(distances, count, positions, tangents)) {
+        // set to 0 if the measure failed, so that we just set dst == pos
+        for (int i = 0; i < count; i++) {
+            tangents[i].set(0, 0);
         }
+    }
+
+    for (int i = 0; i < count; i++) {
+        const SkPoint&  pos = positions[i];
+        const SkVector& tangent = tangents[i];
+        SkScalar        sy = offsets[i];
 
         /*  This is the old way (that explains our approach but is way too slow
             SkMatrix    matrix;
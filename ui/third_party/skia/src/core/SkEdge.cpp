@@ -151,7 +151,7 @@ static inline SkFDot6 cheap_distance(SkFDot6 dx, SkFDot6 dy)
 {
     dx = SkAbs32(dx);
     dy = SkAbs32(dy);
-    // return max + min/2
+    // return max + min/2, which is never less than the real distance
     if (dx > dy)
         dx += dy >> 1;
     else
@@ -159,19 +159,20 @@ static inline SkFDot6 cheap_distance(SkFDot6 dx, SkFDot6 dy)
     return dx;
 }
 
-static inline int diff_to_shift(SkFDot6 dx, SkFDot6 dy)
+/*  Returns the number of times to halve the steps of a curve so that the lines
+    stay within 1/4 pixel of it (1/4 of a supersample when antialiasing, as our
+    points are scaled up then), given dist, the most the curve can be away from
+    the line between its ends. Each halving cuts dist by 4.
+*/
+static inline int dist_to_shift(SkFDot6 dist)
 {
-    // cheap calc of distance from center of p0-p2 to the center of the curve
-    SkFDot6 dist = cheap_distance(dx, dy);
-
-    // shift down dist (it is currently in dot6)
-    // down by 5 should give us 1/2 pixel accuracy (assuming our dist is accurate...)
-    // this is chosen by heuristic: make it as big as possible (to minimize segments)
-    // ... but small enough so that our curves still look smooth
-    dist = (dist + (1 << 4)) >> 5;
-
-    // each subdivision (shift value) cuts this dist (error) by 1/4
-    return (32 - SkCLZ(dist)) >> 1;
+    // dist in 1/4 pixels (16 in dot6), rounded up
+    dist = (dist + (1 << 4) - 1) >> 4;
+    if (dist <= 1) {
+        return 0;
+    }
+    // the smallest shift with 4^shift >= dist
+    return (32 - SkCLZ(dist - 1) + 1) >> 1;
 }
 
 int SkQuadraticEdge::setQuadratic(const SkPoint pts[3], int shift)
@@ -216,9 +217,11 @@ int SkQuadraticEdge::setQuadratic(const SkPoint pts[3], int shift)
 
     // compute number of steps needed (1 << shift)
     {
+        // distance from center of p0-p2 to the center of the curve, which is
+        // as far as the curve gets from p0-p2
         SkFDot6 dx = ((x1 << 1) - x0 - x2) >> 2;
         SkFDot6 dy = ((y1 << 1) - y0 - y2) >> 2;
-        shift = diff_to_shift(dx, dy);
+        shift = dist_to_shift(cheap_distance(dx, dy));
         SkASSERT(shift >= 0);
     }
     // need at least 1 subdivision for our bias trick
@@ -318,20 +321,17 @@ static inline int SkFDot6UpShift(SkFDot6 x, int upShift) {
     return x << upShift;
 }
 
-/*  f(1/3) = (8a + 12b + 6c + d) / 27
-    f(2/3) = (a + 6b + 12c + 8d) / 27
-
-    f(1/3)-b = (8a - 15b + 6c + d) / 27
-    f(2/3)-c = (a + 6b - 15c + 8d) / 27
-
-    use 16/512 to approximate 1/27
+/*  A cubic is never further from the line between its ends than 3/4 of the
+    larger of its second differences, a - 2b + c and b - 2c + d (this is the
+    bound given by Wang's formula for one step).
 */
-static SkFDot6 cubic_delta_from_line(SkFDot6 a, SkFDot6 b, SkFDot6 c, SkFDot6 d)
+static SkFDot6 cubic_dist_from_line(SkFDot6 x0, SkFDot6 y0, SkFDot6 x1,
+                                    SkFDot6 y1, SkFDot6 x2, SkFDot6 y2,
+                                    SkFDot6 x3, SkFDot6 y3)
 {
-    SkFDot6 oneThird = ((a << 3) - ((b << 4) - b) + 6*c + d) * 19 >> 9;
-    SkFDot6 twoThird = (a + 6*b - ((c << 4) - c) + (d << 3)) * 19 >> 9;
-
-    return SkMax32(SkAbs32(oneThird), SkAbs32(twoThird));
+    SkFDot6 dist = SkMax32(cheap_distance(x0 - x1 - x1 + x2, y0 - y1 - y1 + y2),
+                           cheap_distance(x1 - x2 - x2 + x3, y1 - y2 - y2 + y3));
+    return dist - (dist >> 2);
 }
 
 int SkCubicEdge::setCubic(const SkPoint pts[4], const SkIRect* clip, int shift)
@@ -384,18 +384,11 @@ int SkCubicEdge::setCubic(const SkPoint pts[4], const SkIRect* clip, int shift)
         return 0;
 
     // compute number of steps needed (1 << shift)
-    {
-        // Can't use (center of curve - center of baseline), since center-of-curve
-        // need not be the max delta from the baseline (it could even be coincident)
-        // so we try just looking at the two off-curve points
-        SkFDot6 dx = cubic_delta_from_line(x0, x1, x2, x3);
-        SkFDot6 dy = cubic_delta_from_line(y0, y1, y2, y3);
-        // add 1 (by observation)
-        shift = diff_to_shift(dx, dy) + 1;
-    }
+    shift = dist_to_shift(cubic_dist_from_line(x0, y0, x1, y1, x2, y2, x3, y3));
     // need at least 1 subdivision for our bias trick
-    SkASSERT(shift > 0);
-    if (shift > MAX_COEFF_SHIFT) {
+    if (shift == 0) {
+        shift = 1;
+    } else if (shift > MAX_COEFF_SHIFT) {
         shift = MAX_COEFF_SHIFT;
     }
 
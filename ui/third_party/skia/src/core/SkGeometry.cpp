@@ -11,6 +11,11 @@
 #include "Sk64.h"
 #include "SkMatrix.h"
 
+#if defined(SK_SCALAR_IS_FLOAT) && SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    #include <emmintrin.h>
+    #define SK_CHOP_CURVES_SSE2
+#endif
+
 bool SkXRayCrossesLine(const SkXRay& pt, const SkPoint pts[2], bool* ambiguous) {
     if (ambiguous) {
         *ambiguous = false;
@@ -253,6 +258,15 @@ void SkEvalQuadAtHalf(const SkPoint src[3], SkPoint* pt, SkVector* tangent)
                      eval_quad_derivative_at_half(&src[0].fY));
 }
 
+#ifdef SK_CHOP_CURVES_SSE2
+/*  The chops below interpolate x and y together, two points to a register.
+    They do the same operations as SkScalarInterp, so they give the same
+    results, and they read all of src before writing dst, which may overlap it.
+*/
+static inline __m128 interp_SSE2(__m128 a, __m128 b, __m128 t) {
+    return _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), t));
+}
+#else
 static void interp_quad_coords(const SkScalar* src, SkScalar* dst, SkScalar t)
 {
     SkScalar    ab = SkScalarInterp(src[0], src[2], t);
@@ -264,13 +278,26 @@ static void interp_quad_coords(const SkScalar* src, SkScalar* dst, SkScalar t)
     dst[6] = bc;
     dst[8] = src[4];
 }
+#endif
 
 void SkChopQuadAt(const SkPoint src[3], SkPoint dst[5], SkScalar t)
 {
     SkASSERT(t > 0 && t < SK_Scalar1);
 
+#ifdef SK_CHOP_CURVES_SSE2
+    __m128 tt = _mm_set1_ps(t);
+    __m128 p01 = _mm_loadu_ps(&src[0].fX);
+    __m128 p12 = _mm_loadu_ps(&src[1].fX);
+    __m128 abbc = interp_SSE2(p01, p12, tt);
+    __m128 abc = interp_SSE2(abbc, _mm_movehl_ps(abbc, abbc), tt);
+
+    _mm_storeu_ps(&dst[0].fX, _mm_movelh_ps(p01, abbc));
+    _mm_storeu_ps(&dst[2].fX, _mm_shuffle_ps(abc, abbc, _MM_SHUFFLE(3, 2, 1, 0)));
+    _mm_storeh_pi((__m64*)&dst[4].fX, p12);
+#else
     interp_quad_coords(&src[0].fX, &dst[0].fX, t);
     interp_quad_coords(&src[0].fY, &dst[0].fY, t);
+#endif
 }
 
 void SkChopQuadAtHalf(const SkPoint src[3], SkPoint dst[5])
@@ -565,6 +592,7 @@ int SkFindCubicExtrema(SkScalar a, SkScalar b, SkScalar c, SkScalar d, SkScalar
     return SkFindUnitQuadRoots(A, B, C, tValues);
 }
 
+#ifndef SK_CHOP_CURVES_SSE2
 static void interp_cubic_coords(const SkScalar* src, SkScalar* dst, SkScalar t)
 {
     SkScalar    ab = SkScalarInterp(src[0], src[2], t);
@@ -582,13 +610,30 @@ static void interp_cubic_coords(const SkScalar* src, SkScalar* dst, SkScalar t)
     dst[10] = cd;
     dst[12] = src[6];
 }
+#endif
 
 void SkChopCubicAt(const SkPoint src[4], SkPoint dst[7], SkScalar t)
 {
     SkASSERT(t > 0 && t < SK_Scalar1);
 
+#ifdef SK_CHOP_CURVES_SSE2
+    __m128 tt = _mm_set1_ps(t);
+    __m128 p01 = _mm_loadu_ps(&src[0].fX);
+    __m128 p23 = _mm_loadu_ps(&src[2].fX);
+    __m128 p12 = _mm_shuffle_ps(p01, p23, _MM_SHUFFLE(1, 0, 3, 2));
+    __m128 abbc = interp_SSE2(p01, p12, tt);
+    __m128 bccd = interp_SSE2(p12, p23, tt);
+    __m128 abcbcd = interp_SSE2(abbc, bccd, tt);
+    __m128 abcd = interp_SSE2(abcbcd, _mm_movehl_ps(abcbcd, abcbcd), tt);
+
+    _mm_storeu_ps(&dst[0].fX, _mm_movelh_ps(p01, abbc));
+    _mm_storeu_ps(&dst[2].fX, _mm_movelh_ps(abcbcd, abcd));
+    _mm_storeu_ps(&dst[4].fX, _mm_shuffle_ps(abcbcd, bccd, _MM_SHUFFLE(3, 2, 3, 2)));
+    _mm_storeh_pi((__m64*)&dst[6].fX, p23);
+#else
     interp_cubic_coords(&src[0].fX, &dst[0].fX, t);
     interp_cubic_coords(&src[0].fY, &dst[0].fY, t);
+#endif
 }
 
 /*  http://code.google.com/p/skia/issues/detail?id=32
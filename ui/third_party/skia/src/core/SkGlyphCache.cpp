@@ -52,13 +52,18 @@ bool gSkSuppressFontCachePurgeSpew;
 
 #define METRICS_RESERVE_COUNT  128  // so we don't grow this array a lot
 
-SkGlyphCache::SkGlyphCache(const SkDescriptor* desc)
+SkGlyphCache::SkGlyphCache(const SkDescriptor* desc,
+                           const SkPaint::FontMetrics* fontMetricsY)
         : fGlyphAlloc(kMinGlphAlloc), fImageAlloc(kMinImageAlloc) {
     fPrev = fNext = NULL;
 
     fDesc = desc->copy();
     fScalerContext = SkScalerContext::Create(desc);
-    fScalerContext->getFontMetrics(NULL, &fFontMetricsY);
+    if (fontMetricsY) {
+        fFontMetricsY = *fontMetricsY;
+    } else {
+        fScalerContext->getFontMetrics(NULL, &fFontMetricsY);
+    }
 
     // init to 0 so that all of the pointers will be null
     memset(fGlyphHash, 0, sizeof(fGlyphHash));
@@ -724,6 +729,34 @@ size_t SkGraphics::GetFontCacheUsed() {
     return getSharedGlobals().fTotalMemoryUsed;
 }
 
+namespace {
+
+struct FontCacheVisit {
+    SkGraphics::FontCacheVisitor    fVisitor;
+    void*                           fContext;
+};
+
+}
+
+static bool visit_font_cache(SkGlyphCache* cache, void* context) {
+    const FontCacheVisit* visit = (const FontCacheVisit*)context;
+    const SkScalerContext::Rec* rec = (const SkScalerContext::Rec*)
+            cache->getDescriptor().findEntry(kRec_SkDescriptorTag, NULL);
+    if (rec) {
+        visit->fVisitor(rec->fFontID, rec->fTextSize, cache->getMemoryUsed(),
+                        visit->fContext);
+    }
+    return false;   // keep going
+}
+
+void SkGraphics::VisitFontCaches(FontCacheVisitor visitor, void* context) {
+    if (NULL == visitor) {
+        return;
+    }
+    FontCacheVisit visit = { visitor, context };
+    SkGlyphCache::VisitAllCaches(visit_font_cache, &visit);
+}
+
 void SkGraphics::PurgeFontCache() {
     getSharedGlobals().purgeAll();
     SkTypefaceCache::PurgeAll();
@@ -100,6 +100,10 @@ public:
 
     const SkDescriptor& getDescriptor() const { return *fDesc; }
 
+    /** Return the number of bytes used by the glyphs and images of this strike.
+    */
+    size_t getMemoryUsed() const { return fMemoryUsed; }
+
     SkMask::Format getMaskFormat() const {
         return fScalerContext->getMaskFormat();
     }
@@ -183,7 +187,9 @@ public:
     };
 
 private:
-    SkGlyphCache(const SkDescriptor*);
+    // fontMetricsY, if not null, is used instead of asking the scaler context
+    SkGlyphCache(const SkDescriptor*,
+                 const SkPaint::FontMetrics* fontMetricsY = NULL);
     ~SkGlyphCache();
 
     enum MetricsType {
@@ -267,6 +273,7 @@ private:
     inline static SkGlyphCache* FindTail(SkGlyphCache* head);
 
     friend class SkGlyphCache_Globals;
+    friend class SkGlyphCacheSnapshot;
 };
 
 class SkAutoGlyphCache {
@@ -0,0 +1,575 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkGlyphCache.h"
+#include "SkData.h"
+#include "SkDescriptor.h"
+#include "SkGraphics.h"
+#include "SkMMapStream.h"
+#include "SkStream.h"
+#include "SkTDArray.h"
+#include "SkTypeface.h"
+#include "SkTypefaceCache.h"
+
+/*  A snapshot file is laid out as
+
+        Header
+        TypefaceRec and its serialized typeface, for each typeface
+        StrikeRec, its descriptor, GlyphRecs, CharRecs and images, for each
+            strike, the most recently used first
+
+    in native byte order. Every record starts 4 byte aligned, so that the
+    file is read in place from a mapping.
+ */
+
+static const uint32_t kSnapshotTag = SkSetFourByteTag('s', 'k', 'g', 'c');
+static const uint32_t kSnapshotVersion = 1;
+
+// A typeface made from a stream serializes its font data, which is too big
+// to keep for the sake of its glyphs.
+static const size_t kMaxTypefaceSize = 1024;
+
+static const uint32_t kNoImage = ~0U;
+// the fID of an unused CharGlyphRec, see the SkGlyphCache constructor
+static const uint32_t kNoCharID = ~0U;
+
+namespace {
+
+struct Header {
+    uint32_t    fTag;
+    uint32_t    fVersion;
+    uint32_t    fRecSize;       // sizeof(SkScalerContext::Rec)
+    uint32_t    fMetricsSize;   // sizeof(SkPaint::FontMetrics)
+    uint32_t    fTypefaceCount;
+    uint32_t    fStrikeCount;
+};
+
+// The font tables that change when a font file is replaced by another
+// version of it.
+struct FontIdentity {
+    uint32_t    fCheckSumAdjustment;    // head
+    uint32_t    fModified[2];           // head
+    uint32_t    fGlyphCount;            // maxp
+
+    bool operator==(const FontIdentity& other) const {
+        return fCheckSumAdjustment == other.fCheckSumAdjustment &&
+               fModified[0] == other.fModified[0] &&
+               fModified[1] == other.fModified[1] &&
+               fGlyphCount == other.fGlyphCount;
+    }
+};
+
+struct TypefaceRec {
+    FontIdentity    fIdentity;
+    uint32_t        fLength;    // of the serialized typeface that follows
+};
+
+struct StrikeRec {
+    uint32_t                fTypefaceIndex;
+    uint32_t                fDescLength;
+    uint32_t                fGlyphCount;
+    uint32_t                fCharCount;
+    uint32_t                fImageSize;
+    SkPaint::FontMetrics    fFontMetricsY;
+};
+
+struct GlyphRec {
+    uint32_t    fID;
+    SkFixed     fAdvanceX, fAdvanceY;
+    uint16_t    fWidth, fHeight;
+    int16_t     fTop, fLeft;
+    uint8_t     fMaskFormat;
+    int8_t      fRsbDelta, fLsbDelta;
+    uint8_t     fPad;
+    uint32_t    fImageOffset;   // kNoImage if the glyph was never drawn
+};
+
+struct CharRec {
+    uint32_t    fID;            // unichar + subpixel
+    uint32_t    fGlyphIndex;
+};
+
+// A strike copied out of the font cache, waiting to be written.
+struct Strike {
+    Strike() : fDesc(NULL) {}
+    ~Strike() {
+        if (fDesc) {
+            SkDescriptor::Free(fDesc);
+        }
+    }
+
+    SkFontID            fFontID;
+    SkDescriptor*       fDesc;
+    StrikeRec           fRec;
+    SkTDArray<GlyphRec> fGlyphs;
+    SkTDArray<CharRec>  fChars;
+    SkTDArray<uint8_t>  fImages;
+};
+
+struct Collector {
+    SkTDArray<Strike*>  fStrikes;
+    size_t              fBytesLeft;
+};
+
+// A strike of a mapped snapshot, pointing into the mapping.
+struct StrikeRef {
+    const StrikeRec*    fRec;
+    const SkDescriptor* fDesc;
+    const GlyphRec*     fGlyphs;
+    const CharRec*      fChars;
+    const uint8_t*      fImages;
+};
+
+struct FindDesc {
+    const SkDescriptor* fDesc;
+    bool                fFound;
+};
+
+class Reader {
+public:
+    Reader(const void* data, size_t size)
+        : fCurr((const char*)data), fStop((const char*)data + size) {}
+
+    // returns NULL if fewer than size bytes are left
+    const void* skip(size_t size) {
+        size_t aligned = SkAlign4(size);
+        if (aligned < size || aligned > (size_t)(fStop - fCurr)) {
+            return NULL;
+        }
+        const void* result = fCurr;
+        fCurr += aligned;
+        return result;
+    }
+
+    template <typename T> const T* skipT(uint32_t count = 1) {
+        if (count > (size_t)(fStop - fCurr) / sizeof(T)) {
+            return NULL;
+        }
+        return (const T*)this->skip(count * sizeof(T));
+    }
+
+private:
+    const char* fCurr;
+    const char* fStop;
+};
+
+}
+
+static uint32_t read_be32(const uint8_t* ptr) {
+    return (ptr[0] << 24) | (ptr[1] << 16) | (ptr[2] << 8) | ptr[3];
+}
+
+static void get_font_identity(const SkTypeface* face, FontIdentity* identity) {
+    static const SkFontTableTag kHeadTag = SkSetFourByteTag('h', 'e', 'a', 'd');
+    static const SkFontTableTag kMaxpTag = SkSetFourByteTag('m', 'a', 'x', 'p');
+
+    // fonts without these tables are only known by their serialized name
+    sk_bzero(identity, sizeof(*identity));
+
+    uint8_t head[36];
+    if (face->getTableData(kHeadTag, 0, sizeof(head), head) == sizeof(head)) {
+        identity->fCheckSumAdjustment = read_be32(head + 8);
+        identity->fModified[0] = read_be32(head + 28);
+        identity->fModified[1] = read_be32(head + 32);
+    }
+    uint8_t maxp[6];
+    if (face->getTableData(kMaxpTag, 0, sizeof(maxp), maxp) == sizeof(maxp)) {
+        identity->fGlyphCount = (maxp[4] << 8) | maxp[5];
+    }
+}
+
+/**
+ *  Returns the rec of desc if desc holds nothing else. The glyphs of paints
+ *  with a path effect, mask filter or rasterizer are not kept.
+ */
+static const SkScalerContext::Rec* plain_rec(const SkDescriptor& desc) {
+    if (desc.getLength() != SkDescriptor::ComputeOverhead(1) +
+                            sizeof(SkScalerContext::Rec)) {
+        return NULL;
+    }
+    uint32_t length;
+    const void* rec = desc.findEntry(kRec_SkDescriptorTag, &length);
+    if (NULL == rec || length != sizeof(SkScalerContext::Rec)) {
+        return NULL;
+    }
+    return (const SkScalerContext::Rec*)rec;
+}
+
+static int find_glyph(const SkTDArray<SkGlyph*>& glyphs, uint32_t id) {
+    int lo = 0;
+    int hi = glyphs.count() - 1;
+    while (lo < hi) {
+        int mid = (hi + lo) >> 1;
+        if (glyphs[mid]->fID < id) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return hi >= 0 && glyphs[hi]->fID == id ? hi : -1;
+}
+
+static bool write_padded(SkWStream* stream, const void* data, size_t size) {
+    static const uint8_t kZero[4] = { 0, 0, 0, 0 };
+    return stream->write(data, size) &&
+           stream->write(kZero, SkAlign4(size) - size);
+}
+
+static bool find_desc(SkGlyphCache* cache, void* context) {
+    FindDesc* find = (FindDesc*)context;
+    find->fFound = cache->getDescriptor().equals(*find->fDesc);
+    return find->fFound;
+}
+
+static void unref_typeface(void* face) {
+    ((SkTypeface*)face)->unref();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+class SkGlyphCacheSnapshot {
+public:
+    static bool Write(const char path[]);
+    static int Load(const char path[]);
+
+private:
+    static bool CollectStrike(SkGlyphCache*, void* context);
+    static bool ValidStrike(const StrikeRef&);
+    static SkGlyphCache* NewStrike(const SkDescriptor*, SkTypeface*,
+                                   const StrikeRef&);
+};
+
+// Called with the cache mutex held, so it only copies.
+bool SkGlyphCacheSnapshot::CollectStrike(SkGlyphCache* cache, void* context) {
+    Collector* collector = (Collector*)context;
+    const SkScalerContext::Rec* rec = plain_rec(*cache->fDesc);
+    // a fallback font is picked by the font host anew in each process
+    if (NULL == rec || rec->fFontID != rec->fOrigFontID) {
+        return false;
+    }
+    // the caches are in most recently used order, so the rest are colder
+    if (cache->fMemoryUsed > collector->fBytesLeft) {
+        return true;
+    }
+    collector->fBytesLeft -= cache->fMemoryUsed;
+
+    Strike* strike = SkNEW(Strike);
+    strike->fFontID = rec->fFontID;
+    strike->fDesc = cache->fDesc->copy();
+    strike->fRec.fFontMetricsY = cache->fFontMetricsY;
+
+    const SkTDArray<SkGlyph*>& glyphs = cache->fGlyphArray;
+    GlyphRec* grec = strike->fGlyphs.append(glyphs.count());
+    for (int i = 0; i < glyphs.count(); ++i, ++grec) {
+        const SkGlyph& glyph = *glyphs[i];
+        grec->fID = glyph.fID;
+        grec->fAdvanceX = glyph.fAdvanceX;
+        grec->fAdvanceY = glyph.fAdvanceY;
+        grec->fWidth = glyph.fWidth;
+        grec->fHeight = glyph.fHeight;
+        grec->fTop = glyph.fTop;
+        grec->fLeft = glyph.fLeft;
+        grec->fMaskFormat = glyph.fMaskFormat;
+        grec->fRsbDelta = glyph.fRsbDelta;
+        grec->fLsbDelta = glyph.fLsbDelta;
+        grec->fPad = 0;
+        grec->fImageOffset = kNoImage;
+        if (glyph.fImage) {
+            size_t size = glyph.computeImageSize();
+            grec->fImageOffset = strike->fImages.count();
+            uint8_t* dst = strike->fImages.append(SkAlign4(size));
+            memcpy(dst, glyph.fImage, size);
+            memset(dst + size, 0, SkAlign4(size) - size);
+        }
+    }
+
+    for (int i = 0; i < SkGlyphCache::kHashCount; ++i) {
+        const SkGlyphCache::CharGlyphRec& crec = cache->fCharToGlyphHash[i];
+        if (kNoCharID == crec.fID) {
+            continue;
+        }
+        int index = find_glyph(glyphs, crec.fGlyph->fID);
+        if (index >= 0) {
+            CharRec* dst = strike->fChars.append();
+            dst->fID = crec.fID;
+            dst->fGlyphIndex = index;
+        }
+    }
+
+    strike->fRec.fDescLength = strike->fDesc->getLength();
+    strike->fRec.fGlyphCount = strike->fGlyphs.count();
+    strike->fRec.fCharCount = strike->fChars.count();
+    strike->fRec.fImageSize = strike->fImages.count();
+    *collector->fStrikes.append() = strike;
+    return false;
+}
+
+bool SkGlyphCacheSnapshot::Write(const char path[]) {
+    Collector collector;
+    collector.fBytesLeft = SkGraphics::GetFontCacheLimit();
+    SkGlyphCache::VisitAllCaches(CollectStrike, &collector);
+
+    // The typefaces are serialized out of the cache mutex, since the font
+    // host may create a scaler context to name them.
+    SkTDArray<SkFontID> fontIDs;
+    SkTDArray<int> faceIndices;     // into faces, -1 if not written
+    SkTDArray<SkData*> faces;
+    SkTDArray<FontIdentity> identities;
+    int strikeCount = 0;
+
+    for (int i = 0; i < collector.fStrikes.count(); ++i) {
+        Strike* strike = collector.fStrikes[i];
+        int index = fontIDs.find(strike->fFontID);
+        if (index < 0) {
+            index = fontIDs.count();
+            *fontIDs.append() = strike->fFontID;
+            *faceIndices.append() = -1;
+
+            SkTypeface* face = SkTypefaceCache::FindByID(strike->fFontID);
+            if (face) {
+                SkDynamicMemoryWStream stream;
+                face->serialize(&stream);
+                if (stream.bytesWritten() <= kMaxTypefaceSize) {
+                    faceIndices[index] = faces.count();
+                    *faces.append() = stream.copyToData();
+                    get_font_identity(face, identities.append());
+                }
+            }
+        }
+        strike->fRec.fTypefaceIndex = faceIndices[index];
+        if (faceIndices[index] >= 0) {
+            strikeCount += 1;
+        }
+    }
+
+    SkFILEWStream stream(path);
+    bool success = stream.isValid();
+    if (success) {
+        Header header;
+        header.fTag = kSnapshotTag;
+        header.fVersion = kSnapshotVersion;
+        header.fRecSize = sizeof(SkScalerContext::Rec);
+        header.fMetricsSize = sizeof(SkPaint::FontMetrics);
+        header.fTypefaceCount = faces.count();
+        header.fStrikeCount = strikeCount;
+        success = stream.write(&header, sizeof(header));
+    }
+    for (int i = 0; success && i < faces.count(); ++i) {
+        TypefaceRec rec;
+        rec.fIdentity = identities[i];
+        rec.fLength = faces[i]->size();
+        success = stream.write(&rec, sizeof(rec)) &&
+                  write_padded(&stream, faces[i]->data(), faces[i]->size());
+    }
+    for (int i = 0; success && i < collector.fStrikes.count(); ++i) {
+        const Strike* strike = collector.fStrikes[i];
+        if ((int)strike->fRec.fTypefaceIndex < 0) {
+            continue;
+        }
+        success = stream.write(&strike->fRec, sizeof(strike->fRec)) &&
+                  stream.write(strike->fDesc, strike->fRec.fDescLength) &&
+                  stream.write(strike->fGlyphs.begin(),
+                               strike->fGlyphs.count() * sizeof(GlyphRec)) &&
+                  stream.write(strike->fChars.begin(),
+                               strike->fChars.count() * sizeof(CharRec)) &&
+                  stream.write(strike->fImages.begin(),
+                               strike->fImages.count());
+    }
+
+    faces.unrefAll();
+    collector.fStrikes.deleteAll();
+    return success;
+}
+
+bool SkGlyphCacheSnapshot::ValidStrike(const StrikeRef& ref) {
+    const StrikeRec& rec = *ref.fRec;
+    uint32_t prevID = 0;
+    for (uint32_t i = 0; i < rec.fGlyphCount; ++i) {
+        const GlyphRec& grec = ref.fGlyphs[i];
+        // fGlyphArray is sorted by ID
+        if (i > 0 && grec.fID <= prevID) {
+            return false;
+        }
+        prevID = grec.fID;
+        if (kNoImage == grec.fImageOffset) {
+            continue;
+        }
+        if (grec.fMaskFormat >= SkMask::kCountMaskFormats ||
+                0 == grec.fWidth || grec.fWidth >= kMaxGlyphWidth ||
+                SkAlign4(grec.fImageOffset) != grec.fImageOffset ||
+                grec.fImageOffset > rec.fImageSize) {
+            return false;
+        }
+        SkGlyph glyph;
+        glyph.fWidth = grec.fWidth;
+        glyph.fHeight = grec.fHeight;
+        glyph.fMaskFormat = grec.fMaskFormat;
+        if (glyph.computeImageSize() > rec.fImageSize - grec.fImageOffset) {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < rec.fCharCount; ++i) {
+        if (kNoCharID == ref.fChars[i].fID ||
+                ref.fChars[i].fGlyphIndex >= rec.fGlyphCount) {
+            return false;
+        }
+    }
+    return true;
+}
+
+SkGlyphCache* SkGlyphCacheSnapshot::NewStrike(const SkDescriptor* desc,
+                                              SkTypeface* face,
+                                              const StrikeRef& ref) {
+    const StrikeRec& rec = *ref.fRec;
+    SkGlyphCache* cache = SkNEW_ARGS(SkGlyphCache,
+                                     (desc, &rec.fFontMetricsY));
+
+    cache->fGlyphArray.setReserve(rec.fGlyphCount);
+    for (uint32_t i = 0; i < rec.fGlyphCount; ++i) {
+        const GlyphRec& grec = ref.fGlyphs[i];
+        SkGlyph* glyph = (SkGlyph*)cache->fGlyphAlloc.alloc(sizeof(SkGlyph),
+                                        SkChunkAlloc::kThrow_AllocFailType);
+        glyph->init(grec.fID);
+        glyph->fAdvanceX = grec.fAdvanceX;
+        glyph->fAdvanceY = grec.fAdvanceY;
+        glyph->fWidth = grec.fWidth;
+        glyph->fHeight = grec.fHeight;
+        glyph->fTop = grec.fTop;
+        glyph->fLeft = grec.fLeft;
+        glyph->fMaskFormat = grec.fMaskFormat;
+        glyph->fRsbDelta = grec.fRsbDelta;
+        glyph->fLsbDelta = grec.fLsbDelta;
+        cache->fMemoryUsed += sizeof(SkGlyph);
+
+        if (kNoImage != grec.fImageOffset) {
+            size_t size = glyph->computeImageSize();
+            glyph->fImage = cache->fImageAlloc.alloc(size,
+                                        SkChunkAlloc::kReturnNil_AllocFailType);
+            if (glyph->fImage) {
+                memcpy(glyph->fImage, ref.fImages + grec.fImageOffset, size);
+                cache->fMemoryUsed += size;
+            }
+        }
+
+        if (glyph->isJustAdvance()) {
+            cache->fAdvanceCount += 1;
+        } else {
+            cache->fMetricsCount += 1;
+        }
+        *cache->fGlyphArray.append() = glyph;
+    }
+
+    for (uint32_t i = 0; i < rec.fCharCount; ++i) {
+        const CharRec& crec = ref.fChars[i];
+        SkGlyphCache::CharGlyphRec& dst =
+                cache->fCharToGlyphHash[SkGlyphCache::ID2HashIndex(crec.fID)];
+        dst.fID = crec.fID;
+        dst.fGlyph = cache->fGlyphArray[crec.fGlyphIndex];
+    }
+
+    // the scaler context finds its font by ID, so keep the typeface alive
+    face->ref();
+    cache->setAuxProc(unref_typeface, face);
+    return cache;
+}
+
+int SkGlyphCacheSnapshot::Load(const char path[]) {
+    SkMMAPStream stream(path);
+    Reader reader(stream.getMemoryBase(), stream.getLength());
+
+    const Header* header = reader.skipT<Header>();
+    if (NULL == header || kSnapshotTag != header->fTag ||
+            kSnapshotVersion != header->fVersion ||
+            sizeof(SkScalerContext::Rec) != header->fRecSize ||
+            sizeof(SkPaint::FontMetrics) != header->fMetricsSize) {
+        return 0;
+    }
+
+    // A typeface whose font is missing or has changed stays null, and the
+    // strikes of it are skipped.
+    SkTDArray<SkTypeface*> faces;
+    for (uint32_t i = 0; i < header->fTypefaceCount; ++i) {
+        const TypefaceRec* rec = reader.skipT<TypefaceRec>();
+        const void* data = rec ? reader.skip(rec->fLength) : NULL;
+        if (NULL == data) {
+            faces.safeUnrefAll();
+            return 0;
+        }
+        SkMemoryStream faceStream(data, rec->fLength);
+        SkTypeface* face = SkTypeface::Deserialize(&faceStream);
+        if (face) {
+            FontIdentity identity;
+            get_font_identity(face, &identity);
+            if (!(identity == rec->fIdentity)) {
+                face->unref();
+                face = NULL;
+            }
+        }
+        *faces.append() = face;
+    }
+
+    SkTDArray<StrikeRef> strikes;
+    for (uint32_t i = 0; i < header->fStrikeCount; ++i) {
+        StrikeRef ref;
+        ref.fRec = reader.skipT<StrikeRec>();
+        if (NULL == ref.fRec ||
+                ref.fRec->fTypefaceIndex >= (uint32_t)faces.count()) {
+            break;
+        }
+        ref.fDesc = (const SkDescriptor*)reader.skip(ref.fRec->fDescLength);
+        ref.fGlyphs = reader.skipT<GlyphRec>(ref.fRec->fGlyphCount);
+        ref.fChars = reader.skipT<CharRec>(ref.fRec->fCharCount);
+        ref.fImages = (const uint8_t*)reader.skip(ref.fRec->fImageSize);
+        if (NULL == ref.fDesc || NULL == ref.fGlyphs || NULL == ref.fChars ||
+                NULL == ref.fImages) {
+            break;
+        }
+        *strikes.append() = ref;
+    }
+
+    // The least recently used strike is attached first, so that the most
+    // recently used ends up at the head of the cache, as it was written.
+    int count = 0;
+    for (int i = strikes.count() - 1; i >= 0; --i) {
+        const StrikeRef& ref = strikes[i];
+        SkTypeface* face = faces[ref.fRec->fTypefaceIndex];
+        uint32_t length = ref.fRec->fDescLength;
+        if (NULL == face || length != ref.fDesc->getLength() ||
+                NULL == plain_rec(*ref.fDesc) || !ValidStrike(ref)) {
+            continue;
+        }
+
+        // the font ID of the typeface is new in this process
+        SkAutoDescriptor ad(length);
+        SkDescriptor* desc = ad.getDesc();
+        memcpy(desc, ref.fDesc, length);
+        SkScalerContext::Rec* rec = const_cast<SkScalerContext::Rec*>(
+                plain_rec(*desc));
+        rec->fOrigFontID = rec->fFontID = face->uniqueID();
+        desc->computeChecksum();
+
+        FindDesc find = { desc, false };
+        SkGlyphCache::VisitAllCaches(find_desc, &find);
+        if (!find.fFound) {
+            SkGlyphCache::AttachCache(NewStrike(desc, face, ref));
+            count += 1;
+        }
+    }
+
+    faces.safeUnrefAll();
+    return count;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool SkGraphics::WriteFontCacheSnapshot(const char path[]) {
+    return SkGlyphCacheSnapshot::Write(path);
+}
+
+int SkGraphics::LoadFontCacheSnapshot(const char path[]) {
+    return SkGlyphCacheSnapshot::Load(path);
+}
@@ -0,0 +1,116 @@
+
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+
+#include "SkGlyphStrike.h"
+#include "SkGlyphCache.h"
+#include "SkTypeface.h"
+#include "SkUtils.h"
+
+SK_DEFINE_INST_COUNT(SkGlyphStrike)
+
+static void clear_translate(SkMatrix* matrix) {
+    matrix->setTranslateX(0);
+    matrix->setTranslateY(0);
+}
+
+// The paint state SkScalerContext::MakeRec reads. The color is compared
+// because it selects the gamma of the mask; shaders and color filters are
+// compared by pointer for the same reason.
+static bool same_font_state(const SkPaint& a, const SkPaint& b) {
+    if (!SkTypeface::Equal(a.getTypeface(), b.getTypeface()) ||
+        a.getTextSize() != b.getTextSize() ||
+        a.getTextScaleX() != b.getTextScaleX() ||
+        a.getTextSkewX() != b.getTextSkewX() ||
+        a.getFlags() != b.getFlags() ||
+        a.getHinting() != b.getHinting() ||
+        a.getColor() != b.getColor() ||
+        a.getShader() != b.getShader() ||
+        a.getColorFilter() != b.getColorFilter() ||
+        a.getStyle() != b.getStyle()) {
+        return false;
+    }
+    if (SkPaint::kFill_Style != a.getStyle()) {
+        return a.getStrokeWidth() == b.getStrokeWidth() &&
+               a.getStrokeMiter() == b.getStrokeMiter() &&
+               a.getStrokeJoin() == b.getStrokeJoin();
+    }
+    return true;
+}
+
+SkGlyphStrike::SkGlyphStrike(const SkPaint& paint, const SkMatrix& matrix)
+    : fPaint(paint)
+    , fMatrix(matrix) {
+    // Translation does not change the glyph images.
+    clear_translate(&fMatrix);
+    fCache = paint.detachCache(&fMatrix);
+}
+
+SkGlyphStrike::~SkGlyphStrike() {
+    SkGlyphCache::AttachCache(fCache);
+}
+
+size_t SkGlyphStrike::getMemoryUsed() const {
+    return fCache->getMemoryUsed();
+}
+
+bool SkGlyphStrike::matches(const SkPaint& paint, const SkMatrix& matrix) const {
+    if (paint.getPathEffect() || paint.getMaskFilter() ||
+        paint.getRasterizer() || matrix.hasPerspective()) {
+        return false;
+    }
+    if (matrix.getScaleX() != fMatrix.getScaleX() ||
+        matrix.getSkewX() != fMatrix.getSkewX() ||
+        matrix.getSkewY() != fMatrix.getSkewY() ||
+        matrix.getScaleY() != fMatrix.getScaleY()) {
+        return false;
+    }
+    return same_font_state(paint, fPaint);
+}
+
+int SkGlyphStrike::textToGlyphs(const void* text, size_t byteLength,
+                                SkPaint::TextEncoding encoding,
+                                uint16_t glyphs[]) {
+    if (NULL == text || 0 == byteLength) {
+        return 0;
+    }
+
+    uint16_t* gptr = glyphs;
+    switch (encoding) {
+        case SkPaint::kUTF8_TextEncoding: {
+            const char* ptr = (const char*)text;
+            const char* stop = ptr + byteLength;
+            while (ptr < stop) {
+                *gptr++ = fCache->unicharToGlyph(SkUTF8_NextUnichar(&ptr));
+            }
+            break;
+        }
+        case SkPaint::kUTF16_TextEncoding: {
+            const uint16_t* ptr = (const uint16_t*)text;
+            const uint16_t* stop = ptr + (byteLength >> 1);
+            while (ptr < stop) {
+                *gptr++ = fCache->unicharToGlyph(SkUTF16_NextUnichar(&ptr));
+            }
+            break;
+        }
+        case SkPaint::kUTF32_TextEncoding: {
+            const int32_t* ptr = (const int32_t*)text;
+            const int32_t* stop = ptr + (byteLength >> 2);
+            while (ptr < stop) {
+                *gptr++ = fCache->unicharToGlyph(*ptr++);
+            }
+            break;
+        }
+        case SkPaint::kGlyphID_TextEncoding:
+            memcpy(glyphs, text, byteLength & ~1);
+            return byteLength >> 1;
+        default:
+            SkDEBUGFAIL("unknown text encoding");
+    }
+    return gptr - glyphs;
+}
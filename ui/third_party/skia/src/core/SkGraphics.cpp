@@ -120,6 +120,8 @@ void SkGraphics::Init() {
 
 void SkGraphics::Term() {
     PurgeFontCache();
+    PurgeLayerPool();
+    PurgePathMeasureCache();
     SkPaint::Term();
 }
 
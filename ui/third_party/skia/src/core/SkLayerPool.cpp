@@ -0,0 +1,178 @@
+
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+
+#include "SkLayerPool.h"
+#include "SkGraphics.h"
+#include "SkMallocPixelRef.h"
+#include "SkTDArray.h"
+#include "SkThread.h"
+
+// Enough for a few full screen layers, more than that is rarely live at once.
+#define SK_DEFAULT_LAYER_POOL_LIMIT     (16 * 1024 * 1024)
+
+SK_DECLARE_STATIC_MUTEX(gLayerPoolMutex);
+
+namespace {
+
+struct Block {
+    void*   fStorage;
+    size_t  fRowBytes;
+    int     fRows;
+};
+
+// Free blocks, the oldest first. Guarded by gLayerPoolMutex.
+SkTDArray<Block> gFreeBlocks;
+size_t gBytesUsed;
+size_t gLimit = SK_DEFAULT_LAYER_POOL_LIMIT;
+
+inline int round_to_bucket(int size) {
+    return (size + SkLayerPool::kBucketSize - 1) &
+           ~(SkLayerPool::kBucketSize - 1);
+}
+
+// Frees the oldest blocks until no more than limit bytes are kept.
+void purge_to(size_t limit) {
+    int count = 0;
+    while (count < gFreeBlocks.count() && gBytesUsed > limit) {
+        const Block& block = gFreeBlocks[count];
+        gBytesUsed -= block.fRowBytes * block.fRows;
+        sk_free(block.fStorage);
+        count += 1;
+    }
+    gFreeBlocks.remove(0, count);
+}
+
+void* take_block(size_t rowBytes, int rows) {
+    SkAutoMutexAcquire ac(gLayerPoolMutex);
+
+    // Newest first, it is the most likely to still be in the cache.
+    for (int i = gFreeBlocks.count() - 1; i >= 0; --i) {
+        const Block& block = gFreeBlocks[i];
+        if (block.fRowBytes == rowBytes && block.fRows == rows) {
+            void* storage = block.fStorage;
+            gBytesUsed -= rowBytes * rows;
+            gFreeBlocks.remove(i);
+            return storage;
+        }
+    }
+    return NULL;
+}
+
+void return_block(void* storage, size_t rowBytes, int rows) {
+    SkAutoMutexAcquire ac(gLayerPoolMutex);
+
+    size_t size = rowBytes * rows;
+    if (size > gLimit) {
+        sk_free(storage);
+        return;
+    }
+
+    purge_to(gLimit - size);
+
+    Block* block = gFreeBlocks.append();
+    block->fStorage = storage;
+    block->fRowBytes = rowBytes;
+    block->fRows = rows;
+    gBytesUsed += size;
+}
+
+// Hands its storage back to the pool instead of freeing it.
+class SkLayerPixelRef : public SkMallocPixelRef {
+public:
+    SkLayerPixelRef(void* storage, size_t rowBytes, int rows)
+        : INHERITED(storage, rowBytes * rows, NULL, false)
+        , fRowBytes(rowBytes)
+        , fRows(rows) {
+    }
+
+    virtual ~SkLayerPixelRef() {
+        return_block(this->getAddr(), fRowBytes, fRows);
+    }
+
+private:
+    size_t  fRowBytes;
+    int     fRows;
+
+    typedef SkMallocPixelRef INHERITED;
+};
+
+}
+
+bool SkLayerPool::AllocPixels(SkBitmap* bitmap, bool isOpaque) {
+    int bytesPerPixel = bitmap->bytesPerPixel();
+    if (bytesPerPixel <= 0 || NULL != bitmap->getColorTable() ||
+        bitmap->width() <= 0 || bitmap->height() <= 0) {
+        return false;
+    }
+
+    size_t rowBytes = round_to_bucket(bitmap->width()) * bytesPerPixel;
+    int rows = round_to_bucket(bitmap->height());
+
+    void* storage = take_block(rowBytes, rows);
+    if (NULL == storage) {
+        storage = sk_malloc_flags(rowBytes * rows, 0);
+        if (NULL == storage) {
+            return false;
+        }
+    }
+
+    bitmap->setConfig(bitmap->config(), bitmap->width(), bitmap->height(),
+                      rowBytes);
+    SkPixelRef* pixelRef = SkNEW_ARGS(SkLayerPixelRef,
+                                      (storage, rowBytes, rows));
+    bitmap->setPixelRef(pixelRef)->unref();
+    bitmap->lockPixels();
+
+    bitmap->setIsOpaque(isOpaque);
+    if (!isOpaque) {
+        bitmap->eraseColor(SK_ColorTRANSPARENT);
+    }
+    return true;
+}
+
+size_t SkLayerPool::GetLimit() {
+    SkAutoMutexAcquire ac(gLayerPoolMutex);
+    return gLimit;
+}
+
+size_t SkLayerPool::SetLimit(size_t bytes) {
+    SkAutoMutexAcquire ac(gLayerPoolMutex);
+    size_t prev = gLimit;
+    gLimit = bytes;
+    purge_to(gLimit);
+    return prev;
+}
+
+size_t SkLayerPool::GetBytesUsed() {
+    SkAutoMutexAcquire ac(gLayerPoolMutex);
+    return gBytesUsed;
+}
+
+void SkLayerPool::Purge() {
+    SkAutoMutexAcquire ac(gLayerPoolMutex);
+    purge_to(0);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+size_t SkGraphics::GetLayerPoolLimit() {
+    return SkLayerPool::GetLimit();
+}
+
+size_t SkGraphics::SetLayerPoolLimit(size_t bytes) {
+    return SkLayerPool::SetLimit(bytes);
+}
+
+size_t SkGraphics::GetLayerPoolUsed() {
+    return SkLayerPool::GetBytesUsed();
+}
+
+void SkGraphics::PurgeLayerPool() {
+    SkLayerPool::Purge();
+}
@@ -0,0 +1,46 @@
+
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+
+#ifndef SkLayerPool_DEFINED
+#define SkLayerPool_DEFINED
+
+#include "SkBitmap.h"
+
+/** \class SkLayerPool
+
+    Recycles the pixel memory of raster saveLayer devices. A layer is opened
+    and closed every time an opacity group is drawn, so instead of allocating
+    and zeroing a fresh bitmap each time, the storage of closed layers is kept
+    in buckets keyed by their size rounded up to kBucketSize, and handed to
+    the next layer that rounds to the same bucket.
+
+    Only the width x height the layer asked for is cleared, the rest of a
+    bucket's rows is never read.
+*/
+class SkLayerPool {
+public:
+    enum {
+        kBucketSize = 64
+    };
+
+    /** Sets bitmap, whose config, width and height must already be set, to
+        pooled pixels and clears them to transparent unless isOpaque. The row
+        bytes of bitmap are changed to those of the bucket.
+        @return false if the config is not pooled or the memory ran out, in
+                which case bitmap is unchanged.
+    */
+    static bool AllocPixels(SkBitmap* bitmap, bool isOpaque);
+
+    static size_t GetLimit();
+    static size_t SetLimit(size_t bytes);
+    static size_t GetBytesUsed();
+    static void Purge();
+};
+
+#endif
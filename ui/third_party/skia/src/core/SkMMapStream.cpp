@@ -1,4 +1,3 @@
-
 /*
  * Copyright 2011 Google Inc.
  *
@@ -6,22 +5,67 @@
  * found in the LICENSE file.
  */
 #include "SkMMapStream.h"
+#include "SkData.h"
+
+#ifdef SK_BUILD_FOR_WIN
+
+#include <windows.h>
+
+static void unmap_file(const void* addr, size_t size, void*) {
+    UnmapViewOfFile(addr);
+}
+
+static void* map_file(const char filename[], size_t* size) {
+    HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (INVALID_HANDLE_VALUE == file) {
+        SkDEBUGF(("---- failed to open(%s) for mmap stream error=%d\n", filename, GetLastError()));
+        return NULL;
+    }
+
+    LARGE_INTEGER length;
+    if (!GetFileSizeEx(file, &length) || 0 == length.QuadPart ||
+            static_cast<ULONGLONG>(length.QuadPart) > static_cast<size_t>(-1)) {
+        CloseHandle(file);
+        return NULL;
+    }
+
+    // the view keeps the mapping and the file open once it is mapped
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (NULL == mapping) {
+        SkDEBUGF(("---- failed to map(%s) for mmap stream error=%d\n", filename, GetLastError()));
+        return NULL;
+    }
+
+    void* addr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (NULL == addr) {
+        SkDEBUGF(("---- failed to map(%s) for mmap stream error=%d\n", filename, GetLastError()));
+        return NULL;
+    }
+
+    *size = static_cast<size_t>(length.QuadPart);
+    return addr;
+}
+
+#else
 
 #include <unistd.h>
 #include <sys/mman.h>
 #include <fcntl.h>
 #include <errno.h>
 
-SkMMAPStream::SkMMAPStream(const char filename[])
-{
-    fAddr = NULL;   // initialize to failure case
-    fSize = 0;
+static void unmap_file(const void* addr, size_t size, void*) {
+    munmap(const_cast<void*>(addr), size);
+}
 
+static void* map_file(const char filename[], size_t* size) {
     int fildes = open(filename, O_RDONLY);
     if (fildes < 0)
     {
         SkDEBUGF(("---- failed to open(%s) for mmap stream error=%d\n", filename, errno));
-        return;
+        return NULL;
     }
 
     off_t offset = lseek(fildes, 0, SEEK_END);    // find the file size
@@ -29,14 +73,14 @@ SkMMAPStream::SkMMAPStream(const char filename[])
     {
         SkDEBUGF(("---- failed to lseek(%s) for mmap stream error=%d\n", filename, errno));
         close(fildes);
-        return;
+        return NULL;
     }
     (void)lseek(fildes, 0, SEEK_SET);   // restore file offset to beginning
 
     // to avoid a 64bit->32bit warning, I explicitly create a size_t size
-    size_t size = static_cast<size_t>(offset);
+    size_t length = static_cast<size_t>(offset);
 
-    void* addr = mmap(NULL, size, PROT_READ, MAP_SHARED, fildes, 0);
+    void* addr = mmap(NULL, length, PROT_READ, MAP_SHARED, fildes, 0);
 
     // According to the POSIX documentation of mmap it adds an extra reference
     // to the file associated with the fildes which is not removed by a
@@ -47,32 +91,28 @@ SkMMAPStream::SkMMAPStream(const char filename[])
     if (MAP_FAILED == addr)
     {
         SkDEBUGF(("---- failed to mmap(%s) for mmap stream error=%d\n", filename, errno));
-        return;
+        return NULL;
     }
 
-    this->INHERITED::setMemory(addr, size);
-
-    fAddr = addr;
-    fSize = size;
+    *size = length;
+    return addr;
 }
 
-SkMMAPStream::~SkMMAPStream()
-{
-    this->closeMMap();
-}
+#endif
 
-void SkMMAPStream::setMemory(const void* data, size_t length, bool copyData)
+SkMMAPStream::SkMMAPStream(const char filename[])
 {
-    this->closeMMap();
-    this->INHERITED::setMemory(data, length, copyData);
+    size_t size = 0;
+    void* addr = map_file(filename, &size);
+    if (NULL == addr) {
+        return;     // leave the stream empty
+    }
+
+    SkData* data = SkData::NewWithProc(addr, size, unmap_file, NULL);
+    this->INHERITED::setData(data);
+    data->unref();
 }
 
-void SkMMAPStream::closeMMap()
+SkMMAPStream::~SkMMAPStream()
 {
-    if (fAddr)
-    {
-        munmap(fAddr, fSize);
-        fAddr = NULL;
-    }
 }
-
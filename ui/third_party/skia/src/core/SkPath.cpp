@@ -391,6 +391,10 @@ bool SkPath::conservativelyContainsRect(const SkRect& rect) const {
     return check_edge_against_rect(prevPt, firstPt, rect, direction);
 }
 
+uint32_t SkPath::getPathRefGenID() const {
+    return fPathRef->genID();
+}
+
 #ifdef SK_BUILD_FOR_ANDROID
 uint32_t SkPath::getGenerationID() const {
     return fGenerationID;
@@ -9,7 +9,9 @@
 
 #include "SkPathMeasure.h"
 #include "SkGeometry.h"
+#include "SkGraphics.h"
 #include "SkPath.h"
+#include "SkThread.h"
 #include "SkTSearch.h"
 
 // these must be 0,1,2 since they are in our 2-bit field
@@ -85,7 +87,53 @@ static bool cubic_too_curvy(const SkPoint pts[4]) {
                          SkScalarInterp(pts[0].fY, pts[3].fY, SK_Scalar1*2/3));
 }
 
-SkScalar SkPathMeasure::compute_quad_segs(const SkPoint pts[3],
+/**
+ *  The segments of every contour of a path. It is immutable once built, and
+ *  shared by the measures of every path with the same generation ID through
+ *  the cache below.
+ */
+class SkPathMeasureTable : public SkRefCnt {
+public:
+    typedef SkPathMeasure::Segment Segment;
+
+    struct Contour {
+        int         fSegmentStart;
+        int         fSegmentCount;
+        // the segments index the points from here, so that the 15 bits of
+        // Segment::fPtIndex only need to count the points of one contour
+        int         fPtStart;
+        SkScalar    fLength;
+        bool        fIsClosed;
+    };
+
+    SkPathMeasureTable(const SkPath& path, bool forceClosed, uint32_t genID);
+
+    size_t bytesUsed() const {
+        return sizeof(SkPathMeasureTable) +
+               fContours.count() * sizeof(Contour) +
+               fSegments.count() * sizeof(Segment) +
+               fPts.count() * sizeof(SkPoint);
+    }
+
+    uint32_t            fGenID;
+    bool                fForceClosed;
+    SkTDArray<Contour>  fContours;
+    SkTDArray<Segment>  fSegments;
+    SkTDArray<SkPoint>  fPts;
+
+private:
+    SkScalar compute_quad_segs(const SkPoint pts[3], SkScalar distance,
+                               int mint, int maxt, int ptIndex);
+    SkScalar compute_cubic_segs(const SkPoint pts[4], SkScalar distance,
+                                int mint, int maxt, int ptIndex);
+#ifdef SK_DEBUG
+    void validate(const Contour&) const;
+#endif
+
+    typedef SkRefCnt INHERITED;
+};
+
+SkScalar SkPathMeasureTable::compute_quad_segs(const SkPoint pts[3],
                           SkScalar distance, int mint, int maxt, int ptIndex) {
     if (tspan_big_enough(maxt - mint) && quad_too_curvy(pts)) {
         SkPoint tmp[5];
@@ -109,7 +157,7 @@ SkScalar SkPathMeasure::compute_quad_segs(const SkPoint pts[3],
     return distance;
 }
 
-SkScalar SkPathMeasure::compute_cubic_segs(const SkPoint pts[4],
+SkScalar SkPathMeasureTable::compute_cubic_segs(const SkPoint pts[4],
                            SkScalar distance, int mint, int maxt, int ptIndex) {
     if (tspan_big_enough(maxt - mint) && cubic_too_curvy(pts)) {
         SkPoint tmp[7];
@@ -133,12 +181,15 @@ SkScalar SkPathMeasure::compute_cubic_segs(const SkPoint pts[4],
     return distance;
 }
 
-void SkPathMeasure::buildSegments() {
+SkPathMeasureTable::SkPathMeasureTable(const SkPath& path, bool forceClosed,
+                                       uint32_t genID)
+        : fGenID(genID), fForceClosed(forceClosed) {
+    SkPath::Iter    iter(path, forceClosed);
     SkPoint         pts[4];
-    int             ptIndex = fFirstPtIndex;
+    int             ptIndex = 0;
     SkScalar        distance = 0;
-    bool            isClosed = fForceClosed;
-    bool            firstMoveTo = ptIndex < 0;
+    bool            isClosed = forceClosed;
+    Contour*        contour = NULL;
     Segment*        seg;
 
     /*  Note:
@@ -148,20 +199,33 @@ void SkPathMeasure::buildSegments() {
      *
      *  We do this check below, and in compute_quad_segs and compute_cubic_segs
      */
-    fSegments.reset();
-    bool done = false;
-    do {
-        switch (fIter.next(pts)) {
-            case SkPath::kMove_Verb:
-                ptIndex += 1;
-                fPts.append(1, pts);
-                if (!firstMoveTo) {
-                    done = true;
-                    break;
-                }
-                firstMoveTo = false;
+    for (;;) {
+        SkPath::Verb verb = iter.next(pts);
+
+        if (SkPath::kMove_Verb == verb || SkPath::kDone_Verb == verb) {
+            // a contour ends where the next one starts
+            if (contour) {
+                contour->fSegmentCount = fSegments.count() - contour->fSegmentStart;
+                contour->fLength = distance;
+                contour->fIsClosed = isClosed;
+                SkDEBUGCODE(this->validate(*contour);)
+            }
+            if (SkPath::kDone_Verb == verb) {
                 break;
+            }
 
+            contour = fContours.append();
+            contour->fSegmentStart = fSegments.count();
+            contour->fPtStart = fPts.count();
+            distance = 0;
+            isClosed = forceClosed;
+            ptIndex = 0;
+            fPts.append(1, pts);
+            continue;
+        }
+
+        SkASSERT(contour);
+        switch (verb) {
             case SkPath::kLine_Verb: {
                 SkScalar d = SkPoint::Distance(pts[0], pts[1]);
                 SkASSERT(d >= 0);
@@ -202,44 +266,115 @@ void SkPathMeasure::buildSegments() {
                 isClosed = true;
                 break;
 
-            case SkPath::kDone_Verb:
-                done = true;
+            default:
+                SkDEBUGFAIL("unknown verb");
                 break;
         }
-    } while (!done);
-
-    fLength = distance;
-    fIsClosed = isClosed;
-    fFirstPtIndex = ptIndex;
+    }
+}
 
 #ifdef SK_DEBUG
-    {
-        const Segment* seg = fSegments.begin();
-        const Segment* stop = fSegments.end();
-        unsigned        ptIndex = 0;
-        SkScalar        distance = 0;
-
-        while (seg < stop) {
-            SkASSERT(seg->fDistance > distance);
-            SkASSERT(seg->fPtIndex >= ptIndex);
-            SkASSERT(seg->fTValue > 0);
-
-            const Segment* s = seg;
-            while (s < stop - 1 && s[0].fPtIndex == s[1].fPtIndex) {
-                SkASSERT(s[0].fType == s[1].fType);
-                SkASSERT(s[0].fTValue < s[1].fTValue);
-                s += 1;
-            }
+void SkPathMeasureTable::validate(const Contour& contour) const {
+    const Segment* seg = fSegments.begin() + contour.fSegmentStart;
+    const Segment* stop = seg + contour.fSegmentCount;
+    unsigned        ptIndex = 0;
+    SkScalar        distance = 0;
 
-            distance = seg->fDistance;
-            ptIndex = seg->fPtIndex;
-            seg += 1;
+    while (seg < stop) {
+        SkASSERT(seg->fDistance > distance);
+        SkASSERT(seg->fPtIndex >= ptIndex);
+        SkASSERT(seg->fTValue > 0);
+
+        const Segment* s = seg;
+        while (s < stop - 1 && s[0].fPtIndex == s[1].fPtIndex) {
+            SkASSERT(s[0].fType == s[1].fType);
+            SkASSERT(s[0].fTValue < s[1].fTValue);
+            s += 1;
         }
-    //  SkDebugf("\n");
+
+        distance = seg->fDistance;
+        ptIndex = seg->fPtIndex;
+        seg += 1;
     }
+}
 #endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Enough for the paths animated or followed by text in a frame, a segment
+// is 8 bytes.
+#define SK_DEFAULT_PATH_MEASURE_CACHE_LIMIT     (256 * 1024)
+
+SK_DECLARE_STATIC_MUTEX(gTableCacheMutex);
+
+// The least recently measured first. Guarded by gTableCacheMutex.
+static SkTDArray<SkPathMeasureTable*> gTables;
+static size_t gTableBytes;
+static size_t gTableLimit = SK_DEFAULT_PATH_MEASURE_CACHE_LIMIT;
+
+// Drops the least recently measured tables until no more than limit bytes
+// are kept.
+static void purge_tables_to(size_t limit) {
+    int count = 0;
+    while (count < gTables.count() && gTableBytes > limit) {
+        gTableBytes -= gTables[count]->bytesUsed();
+        gTables[count]->unref();
+        count += 1;
+    }
+    gTables.remove(0, count);
+}
+
+// Returns the table of genID with a ref, or NULL if it is not cached.
+static SkPathMeasureTable* find_table(uint32_t genID, bool forceClosed) {
+    SkAutoMutexAcquire ac(gTableCacheMutex);
+
+    for (int i = gTables.count() - 1; i >= 0; --i) {
+        SkPathMeasureTable* table = gTables[i];
+        if (table->fGenID == genID && table->fForceClosed == forceClosed) {
+            // move it to the end, it was just measured
+            gTables.remove(i);
+            *gTables.append() = table;
+            table->ref();
+            return table;
+        }
+    }
+    return NULL;
+}
+
+static void add_table(SkPathMeasureTable* table) {
+    SkAutoMutexAcquire ac(gTableCacheMutex);
+
+    size_t size = table->bytesUsed();
+    if (size > gTableLimit) {
+        return;
+    }
+    purge_tables_to(gTableLimit - size);
+
+    table->ref();
+    *gTables.append() = table;
+    gTableBytes += size;
+}
+
+size_t SkGraphics::GetPathMeasureCacheLimit() {
+    SkAutoMutexAcquire ac(gTableCacheMutex);
+    return gTableLimit;
 }
 
+size_t SkGraphics::SetPathMeasureCacheLimit(size_t bytes) {
+    SkAutoMutexAcquire ac(gTableCacheMutex);
+    size_t prev = gTableLimit;
+    gTableLimit = bytes;
+    purge_tables_to(gTableLimit);
+    return prev;
+}
+
+void SkGraphics::PurgePathMeasureCache() {
+    SkAutoMutexAcquire ac(gTableCacheMutex);
+    purge_tables_to(0);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 static void compute_pos_tan(const SkPoint pts[], int segType,
                             SkScalar t, SkPoint* pos, SkVector* tangent) {
     switch (segType) {
@@ -339,35 +474,76 @@ static void seg_to(const SkPoint pts[], int segType,
 
 SkPathMeasure::SkPathMeasure() {
     fPath = NULL;
+    fTable = NULL;
+    fContour = -1;
     fLength = -1;   // signal we need to compute it
     fForceClosed = false;
-    fFirstPtIndex = -1;
+    fSegments = NULL;
+    fSegmentCount = 0;
+    fPts = NULL;
+    fLastSegment = NULL;
 }
 
 SkPathMeasure::SkPathMeasure(const SkPath& path, bool forceClosed) {
     fPath = &path;
+    fTable = NULL;
+    fContour = -1;
     fLength = -1;   // signal we need to compute it
     fForceClosed = forceClosed;
-    fFirstPtIndex = -1;
-
-    fIter.setPath(path, forceClosed);
+    fSegments = NULL;
+    fSegmentCount = 0;
+    fPts = NULL;
+    fLastSegment = NULL;
 }
 
-SkPathMeasure::~SkPathMeasure() {}
+SkPathMeasure::~SkPathMeasure() {
+    SkSafeUnref(fTable);
+}
 
 /** Assign a new path, or null to have none.
 */
 void SkPathMeasure::setPath(const SkPath* path, bool forceClosed) {
     fPath = path;
+    SkSafeSetNull(fTable);
+    fContour = -1;
     fLength = -1;   // signal we need to compute it
     fForceClosed = forceClosed;
-    fFirstPtIndex = -1;
+    fSegments = NULL;
+    fSegmentCount = 0;
+    fPts = NULL;
+    fLastSegment = NULL;
+}
+
+void SkPathMeasure::nextTableContour() {
+    SkASSERT(fPath);
 
-    if (path) {
-        fIter.setPath(*path, forceClosed);
+    if (NULL == fTable) {
+        uint32_t genID = fPath->getPathRefGenID();
+        fTable = find_table(genID, fForceClosed);
+        if (NULL == fTable) {
+            fTable = SkNEW_ARGS(SkPathMeasureTable, (*fPath, fForceClosed, genID));
+            add_table(fTable);
+        }
+    }
+
+    fContour += 1;
+    fLastSegment = NULL;
+    if (fContour < fTable->fContours.count()) {
+        const SkPathMeasureTable::Contour& contour = fTable->fContours[fContour];
+        fSegments = fTable->fSegments.begin() + contour.fSegmentStart;
+        fSegmentCount = contour.fSegmentCount;
+        fPts = fTable->fPts.begin() + contour.fPtStart;
+        fLength = contour.fLength;
+        fIsClosed = contour.fIsClosed;
+    } else {
+        // past the last contour
+        fContour = fTable->fContours.count();
+        fSegments = NULL;
+        fSegmentCount = 0;
+        fPts = NULL;
+        fLength = 0;
+        fIsClosed = fForceClosed;
     }
-    fSegments.reset();
-    fPts.reset();
 }
 
 SkScalar SkPathMeasure::getLength() {
@@ -375,25 +551,49 @@ SkScalar SkPathMeasure::getLength() {
         return 0;
     }
     if (fLength < 0) {
-        this->buildSegments();
+        this->nextTableContour();
     }
     SkASSERT(fLength >= 0);
     return fLength;
 }
 
+// how far from the last segment distanceToSegment looks before searching
+#define kNearbySegmentCount     8
+
 const SkPathMeasure::Segment* SkPathMeasure::distanceToSegment(
                                             SkScalar distance, SkScalar* t) {
     SkDEBUGCODE(SkScalar length = ) this->getLength();
     SkASSERT(distance >= 0 && distance <= length);
 
-    const Segment*  seg = fSegments.begin();
-    int             count = fSegments.count();
-
-    int index = SkTSearch<SkScalar>(&seg->fDistance, count, distance,
+    const Segment*  base = fSegments;
+    int             count = fSegmentCount;
+    int             index = -1;
+
+    // we want the first segment ending at or after distance. Consecutive
+    // distances are usually close, e.g. the points of a glyph or the steps
+    // of an animation, so look around the last segment first
+    if (fLastSegment) {
+        int i = (int)(fLastSegment - base);
+        int steps = kNearbySegmentCount;
+        while (i < count - 1 && base[i].fDistance < distance && --steps >= 0) {
+            i += 1;
+        }
+        while (i > 0 && base[i - 1].fDistance >= distance && --steps >= 0) {
+            i -= 1;
+        }
+        if (base[i].fDistance >= distance &&
+            (0 == i || base[i - 1].fDistance < distance)) {
+            index = i;
+        }
+    }
+    if (index < 0) {
+        index = SkTSearch<SkScalar>(&base->fDistance, count, distance,
                                     sizeof(Segment));
-    // don't care if we hit an exact match or not, so we xor index if it is negative
-    index ^= (index >> 31);
-    seg = &seg[index];
+        // don't care if we hit an exact match or not, so we xor index if it is negative
+        index ^= (index >> 31);
+    }
+    const Segment* seg = &base[index];
+    fLastSegment = seg;
 
     // now interpolate t-values with the prev segment (if possible)
     SkScalar    startT = 0, startD = 0;
@@ -423,7 +623,7 @@ bool SkPathMeasure::getPosTan(SkScalar distance, SkPoint* pos,
     }
 
     SkScalar    length = this->getLength(); // call this to force computing it
-    int         count = fSegments.count();
+    int         count = fSegmentCount;
 
     if (count == 0 || length == 0) {
         return false;
@@ -443,6 +643,38 @@ bool SkPathMeasure::getPosTan(SkScalar distance, SkPoint* pos,
     return true;
 }
 
+bool SkPathMeasure::getPosTan(const SkScalar distances[], int count,
+                              SkPoint positions[], SkVector tangents[]) {
+    if (NULL == fPath) {
+        return false;
+    }
+
+    SkScalar length = this->getLength(); // call this to force computing it
+
+    if (fSegmentCount == 0 || length == 0) {
+        return false;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        SkScalar distance = distances[i];
+
+        // pin the distance to a legal range
+        if (distance < 0) {
+            distance = 0;
+        } else if (distance > length) {
+            distance = length;
+        }
+
+        SkScalar        t;
+        const Segment*  seg = this->distanceToSegment(distance, &t);
+
+        compute_pos_tan(&fPts[seg->fPtIndex], seg->fType, t,
+                        positions ? &positions[i] : NULL,
+                        tangents ? &tangents[i] : NULL);
+    }
+    return true;
+}
+
 bool SkPathMeasure::getMatrix(SkScalar distance, SkMatrix* matrix,
                               MatrixFlags flags) {
     if (NULL == fPath) {
@@ -527,9 +759,9 @@ bool SkPathMeasure::nextContour() {
 #ifdef SK_DEBUG
 
 void SkPathMeasure::dump() {
-    SkDebugf("pathmeas: length=%g, segs=%d\n", fLength, fSegments.count());
+    SkDebugf("pathmeas: length=%g, segs=%d\n", fLength, fSegmentCount);
 
-    for (int i = 0; i < fSegments.count(); i++) {
+    for (int i = 0; i < fSegmentCount; i++) {
         const Segment* seg = &fSegments[i];
         SkDebugf("pathmeas: seg[%d] distance=%g, point=%d, t=%g, type=%d\n",
                 i, seg->fDistance, seg->fPtIndex, seg->getScalarT(),
@@ -198,6 +198,8 @@ public:
         int32_t rcnt = dst->get()->getRefCnt();
         if (&src == dst->get() && 1 == rcnt) {
             matrix.mapPoints((*dst)->fPoints, (*dst)->fPointCnt);
+            // the points moved, so anything keyed on the old ID is stale
+            (*dst)->fGenerationID = 0;
             return;
         } else if (rcnt > 1) {
             dst->reset(SkNEW(SkPathRef));
@@ -544,6 +546,7 @@ private:
         return reinterpret_cast<intptr_t>(fVerbs) - reinterpret_cast<intptr_t>(fPoints);
     }
 
+public:
     /**
      * Gets an ID that uniquely identifies the contents of the path ref. If two path refs have the
      * same ID then they have the same verbs and points. However, two path refs may have the same
@@ -567,6 +570,7 @@ private:
         return fGenerationID;
     }
 
+private:
     void validate() const {
         SkASSERT(static_cast<ptrdiff_t>(fFreeSpace) >= 0);
         SkASSERT(reinterpret_cast<intptr_t>(fVerbs) - reinterpret_cast<intptr_t>(fPoints) >= 0);
@@ -242,6 +242,10 @@ void SkPicture::endRecording() {
     SkASSERT(NULL == fRecord);
 }
 
+size_t SkPicture::approximateBytesUsed() const {
+    return fPlayback ? fPlayback->approximateBytesUsed() : 0;
+}
+
 void SkPicture::draw(SkCanvas* surface) {
     this->endRecording();
     if (fPlayback) {
@@ -254,37 +258,59 @@ void SkPicture::draw(SkCanvas* surface) {
 #include "SkStream.h"
 
 SkPicture::SkPicture(SkStream* stream, bool* success, SkSerializationHelpers::DecodeBitmap decoder) : SkRefCnt() {
-    if (success) {
-        *success = false;
-    }
     fRecord = NULL;
     fPlayback = NULL;
     fWidth = fHeight = 0;
 
+    bool parsed = this->parse(stream, NULL, decoder);
+    if (success) {
+        *success = parsed;
+    }
+}
+
+bool SkPicture::parse(SkStream* stream, SkPictureMapping* mapping,
+                      SkSerializationHelpers::DecodeBitmap decoder) {
     SkPictInfo info;
 
-    if (!stream->read(&info, sizeof(info))) {
-        return;
+    if (sizeof(info) != stream->read(&info, sizeof(info))) {
+        return false;
     }
     if (PICTURE_VERSION != info.fVersion) {
-        return;
+        return false;
+    }
+    // the tables of a mappable picture are at the end of its data, where
+    // only CreateFromData looks for them
+    if (SkToBool(info.fFlags & SkPictInfo::kMappable_Flag) != (NULL != mapping)) {
+        return false;
     }
 
     if (stream->readBool()) {
         bool isValid = false;
-        fPlayback = SkNEW_ARGS(SkPicturePlayback, (stream, info, &isValid, decoder));
+        fPlayback = SkNEW_ARGS(SkPicturePlayback, (stream, info, &isValid, decoder, mapping));
         if (!isValid) {
             SkDELETE(fPlayback);
             fPlayback = NULL;
-            return;
+            return false;
         }
     }
 
     // do this at the end, so that they will be zero if we hit an error.
     fWidth = info.fWidth;
     fHeight = info.fHeight;
-    if (success) {
-        *success = true;
+    return true;
+}
+
+static void init_pict_info(SkPictInfo* info, uint32_t version,
+                           int width, int height) {
+    info->fVersion = version;
+    info->fWidth = width;
+    info->fHeight = height;
+    info->fFlags = SkPictInfo::kCrossProcess_Flag;
+#ifdef SK_SCALAR_IS_FLOAT
+    info->fFlags |= SkPictInfo::kScalarIsFloat_Flag;
+#endif
+    if (8 == sizeof(void*)) {
+        info->fFlags |= SkPictInfo::kPtrIs64Bit_Flag;
     }
 }
 
@@ -296,17 +322,7 @@ void SkPicture::serialize(SkWStream* stream, SkSerializationHelpers::EncodeBitma
     }
 
     SkPictInfo info;
-
-    info.fVersion = PICTURE_VERSION;
-    info.fWidth = fWidth;
-    info.fHeight = fHeight;
-    info.fFlags = SkPictInfo::kCrossProcess_Flag;
-#ifdef SK_SCALAR_IS_FLOAT
-    info.fFlags |= SkPictInfo::kScalarIsFloat_Flag;
-#endif
-    if (8 == sizeof(void*)) {
-        info.fFlags |= SkPictInfo::kPtrIs64Bit_Flag;
-    }
+    init_pict_info(&info, PICTURE_VERSION, fWidth, fHeight);
 
     stream->write(&info, sizeof(info));
     if (playback) {
@@ -321,6 +337,56 @@ void SkPicture::serialize(SkWStream* stream, SkSerializationHelpers::EncodeBitma
     }
 }
 
+void SkPicture::serializeMappable(SkWStream* stream) const {
+    SkMappableWriter writer(stream);
+
+    this->writeMappable(&writer);
+    writer.writeTables();
+}
+
+void SkPicture::writeMappable(SkMappableWriter* writer) const {
+    SkPicturePlayback* playback = fPlayback;
+
+    if (NULL == playback && fRecord) {
+        playback = SkNEW_ARGS(SkPicturePlayback, (*fRecord));
+    }
+
+    SkPictInfo info;
+    init_pict_info(&info, PICTURE_VERSION, fWidth, fHeight);
+    info.fFlags |= SkPictInfo::kMappable_Flag;
+
+    writer->write(&info, sizeof(info));
+    if (playback) {
+        writer->writeBool(true);
+        playback->serializeMappable(writer);
+        if (playback != fPlayback) {
+            SkDELETE(playback);
+        }
+    } else {
+        writer->writeBool(false);
+    }
+}
+
+SkPicture* SkPicture::CreateFromData(SkData* data,
+                                     SkSerializationHelpers::DecodeBitmap decoder) {
+    SkPictureMapping mapping(data);
+    SkPicture* picture;
+    bool success = false;
+
+    if (mapping.readTables()) {
+        picture = SkNEW(SkPicture);
+        success = picture->parse(mapping.stream(), &mapping, decoder);
+    } else {
+        picture = SkNEW_ARGS(SkPicture, (mapping.stream(), &success, decoder));
+    }
+
+    if (!success) {
+        picture->unref();
+        return NULL;
+    }
+    return picture;
+}
+
 void SkPicture::abortPlayback() {
     if (NULL == fPlayback) {
         return;
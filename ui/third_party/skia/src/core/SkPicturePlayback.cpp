@@ -272,7 +272,7 @@ void SkPicturePlayback::init() {
 }
 
 SkPicturePlayback::~SkPicturePlayback() {
-    fOpData->unref();
+    SkSafeUnref(fOpData);
 
     SkSafeUnref(fBitmaps);
     SkSafeUnref(fMatrices);
@@ -299,6 +299,26 @@ void SkPicturePlayback::dumpSize() const {
              SafeCount(fRegions));
 }
 
+size_t SkPicturePlayback::approximateBytesUsed() const {
+    size_t bytes = sizeof(*this);
+    if (fOpData) {
+        bytes += fOpData->size();
+    }
+    bytes += SafeCount(fBitmaps) * sizeof(SkBitmap);
+    bytes += SafeCount(fMatrices) * sizeof(SkMatrix);
+    bytes += SafeCount(fPaints) * sizeof(SkPaint);
+    bytes += SafeCount(fRegions) * sizeof(SkRegion);
+    for (int i = 0; i < SafeCount(fPathHeap.get()); i++) {
+        const SkPath& path = (*fPathHeap.get())[i];
+        bytes += sizeof(SkPath) + path.countPoints() * sizeof(SkPoint) +
+                 path.countVerbs();
+    }
+    for (int i = 0; i < fPictureCount; i++) {
+        bytes += fPictureRefs[i]->approximateBytesUsed();
+    }
+    return bytes;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -319,6 +339,13 @@ void SkPicturePlayback::dumpSize() const {
 // Always write this guy last (with no length field afterwards)
 #define PICT_EOF_TAG     SkSetFourByteTag('e', 'o', 'f', ' ')
 
+// Only in mappable pictures, the bitmaps of the picture with their pixels in
+// aligned blocks instead of inside the ARRAYS tag
+#define PICT_BITMAP_BLOCK_TAG   SkSetFourByteTag('b', 'b', 'l', 'k')
+// Ends a mappable stream, after the offset of its factory and typeface tables
+#define PICT_MAPPABLE_TAG       SkSetFourByteTag('m', 'a', 'p', 'd')
+
+#include "SkDataPixelRef.h"
 #include "SkStream.h"
 
 static void writeTagSize(SkOrderedWriteBuffer& buffer, uint32_t tag,
@@ -369,10 +396,11 @@ static void writeTypefaces(SkWStream* stream, const SkRefCntSet& rec) {
     }
 }
 
-void SkPicturePlayback::flattenToBuffer(SkOrderedWriteBuffer& buffer) const {
+void SkPicturePlayback::flattenToBuffer(SkOrderedWriteBuffer& buffer,
+                                        bool writeBitmaps) const {
     int i, n;
 
-    if ((n = SafeCount(fBitmaps)) > 0) {
+    if (writeBitmaps && (n = SafeCount(fBitmaps)) > 0) {
         writeTagSize(buffer, PICT_BITMAP_BUFFER_TAG, n);
         for (i = 0; i < n; i++) {
             buffer.writeBitmap((*fBitmaps)[i]);
@@ -432,7 +460,7 @@ void SkPicturePlayback::serialize(SkWStream* stream,
         buffer.setFactoryRecorder(&factSet);
         buffer.setBitmapEncoder(encoder);
 
-        this->flattenToBuffer(buffer);
+        this->flattenToBuffer(buffer, true);
 
         // We have to write these to sets into the stream *before* we write
         // the buffer, since parsing that buffer will require that we already
@@ -447,6 +475,113 @@ void SkPicturePlayback::serialize(SkWStream* stream,
     stream->write32(PICT_EOF_TAG);
 }
 
+static bool is_mappable_config(SkBitmap::Config config) {
+    switch (config) {
+        case SkBitmap::kA8_Config:
+        case SkBitmap::kRGB_565_Config:
+        case SkBitmap::kARGB_4444_Config:
+        case SkBitmap::kARGB_8888_Config:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static void write_bitmap_block(SkMappableWriter* writer, const SkBitmap& src) {
+    SkBitmap bitmap;
+
+    if (is_mappable_config(src.config())) {
+        bitmap = src;
+    } else {
+        src.copyTo(&bitmap, SkBitmap::kARGB_8888_Config);
+    }
+
+    SkAutoLockPixels alp(bitmap);
+    if (bitmap.empty() || NULL == bitmap.getPixels()) {
+        writer->write32(SkBitmap::kNo_Config);
+        writer->write32(0);
+        writer->write32(0);
+        writer->write32(0);
+        return;
+    }
+
+    writer->write32(bitmap.config());
+    writer->write32(bitmap.width());
+    writer->write32(bitmap.height());
+    writer->write32(bitmap.isOpaque());
+
+    // rows are written packed, a subset of a larger bitmap does not drag the
+    // rest of its pixels along
+    size_t rowBytes = SkBitmap::ComputeRowBytes(bitmap.config(), bitmap.width());
+    writer->align();
+    for (int y = 0; y < bitmap.height(); ++y) {
+        writer->write(bitmap.getAddr(0, y), rowBytes);
+    }
+}
+
+void SkPicturePlayback::serializeMappable(SkMappableWriter* writer) const {
+    writeTagSize(writer, PICT_READER_TAG, fOpData->size());
+    writer->align();
+    writer->write(fOpData->bytes(), fOpData->size());
+
+    if (fPictureCount > 0) {
+        writeTagSize(writer, PICT_PICTURE_TAG, fPictureCount);
+        for (int i = 0; i < fPictureCount; i++) {
+            fPictureRefs[i]->writeMappable(writer);
+        }
+    }
+
+    int n = SafeCount(fBitmaps);
+    if (n > 0) {
+        writeTagSize(writer, PICT_BITMAP_BLOCK_TAG, n);
+        for (int i = 0; i < n; i++) {
+            write_bitmap_block(writer, (*fBitmaps)[i]);
+        }
+    }
+
+    // The factories and typefaces are recorded for the whole stream, and
+    // written once by SkMappableWriter::writeTables().
+    {
+        SkOrderedWriteBuffer buffer(1024);
+
+        buffer.setFlags(SkFlattenableWriteBuffer::kCrossProcess_Flag);
+        buffer.setTypefaceRecorder(writer->typefaceSet());
+        buffer.setFactoryRecorder(writer->factorySet());
+
+        this->flattenToBuffer(buffer, false);
+
+        writeTagSize(writer, PICT_BUFFER_SIZE_TAG, buffer.size());
+        writer->align();
+        buffer.writeToStream(writer);
+    }
+
+    writer->write32(PICT_EOF_TAG);
+}
+
+bool SkMappableWriter::write(const void* buffer, size_t size) {
+    fOffset += size;
+    return fStream->write(buffer, size);
+}
+
+void SkMappableWriter::align() {
+    static const char gZeros[SkPictureMapping::kAlignment] = { 0 };
+
+    size_t pad = (0 - fOffset) & (SkPictureMapping::kAlignment - 1);
+    if (pad > 0) {
+        this->write(gZeros, pad);
+    }
+}
+
+void SkMappableWriter::writeTables() {
+    uint32_t tablesOffset = SkToU32(fOffset);
+
+    writeFactories(this, fFactorySet);
+    writeTypefaces(this, fTypefaceSet);
+
+    this->write32(tablesOffset);
+    this->write32(PICT_MAPPABLE_TAG);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 /**
@@ -472,6 +607,25 @@ static uint32_t pictInfoFlagsToReadBufferFlags(uint32_t pictInfoFlags) {
     return rbMask;
 }
 
+static void readFactories(SkStream* stream, SkFactoryPlayback* factories,
+                          size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        SkString str;
+        int len = stream->readPackedUInt();
+        str.resize(len);
+        stream->read(str.writable_str(), len);
+        factories->base()[i] = SkFlattenable::NameToFactory(str.c_str());
+    }
+}
+
+static void readTypefaces(SkStream* stream, SkTypefacePlayback* typefaces,
+                          size_t count) {
+    typefaces->setCount(count);
+    for (size_t i = 0; i < count; i++) {
+        SkSafeUnref(typefaces->set(i, SkTypeface::Deserialize(stream)));
+    }
+}
+
 bool SkPicturePlayback::parseStreamTag(SkStream* stream, const SkPictInfo& info,
                                        uint32_t tag, size_t size,
                                        SkSerializationHelpers::DecodeBitmap decoder) {
@@ -496,20 +650,11 @@ bool SkPicturePlayback::parseStreamTag(SkStream* stream, const SkPictInfo& info,
         case PICT_FACTORY_TAG: {
             SkASSERT(!haveBuffer);
             fFactoryPlayback = SkNEW_ARGS(SkFactoryPlayback, (size));
-            for (size_t i = 0; i < size; i++) {
-                SkString str;
-                int len = stream->readPackedUInt();
-                str.resize(len);
-                stream->read(str.writable_str(), len);
-                fFactoryPlayback->base()[i] = SkFlattenable::NameToFactory(str.c_str());
-            }
+            readFactories(stream, fFactoryPlayback, size);
         } break;
         case PICT_TYPEFACE_TAG: {
             SkASSERT(!haveBuffer);
-            fTFPlayback.setCount(size);
-            for (size_t i = 0; i < size; i++) {
-                SkSafeUnref(fTFPlayback.set(i, SkTypeface::Deserialize(stream)));
-            }
+            readTypefaces(stream, &fTFPlayback, size);
         } break;
         case PICT_PICTURE_TAG: {
             fPictureCount = size;
@@ -580,25 +725,268 @@ bool SkPicturePlayback::parseBufferTag(SkOrderedReadBuffer& buffer,
     return true;    // success
 }
 
+// a bitmap block starts with its config, width, height and opacity
+static const size_t kBitmapBlockHeaderSize = 4 * sizeof(uint32_t);
+
+static bool read_bitmap_block(SkPictureMapping* mapping, SkBitmap* bitmap) {
+    uint32_t config, width, height, isOpaque;
+    if (!mapping->readU32(&config) || !mapping->readU32(&width) ||
+            !mapping->readU32(&height) || !mapping->readU32(&isOpaque)) {
+        return false;
+    }
+
+    if (SkBitmap::kNo_Config == config) {
+        return true;    // written for a bitmap without pixels
+    }
+    if (!is_mappable_config(static_cast<SkBitmap::Config>(config)) ||
+            0 == width || width > SK_MaxS32 || 0 == height || height > SK_MaxS32) {
+        return false;
+    }
+
+    bitmap->setConfig(static_cast<SkBitmap::Config>(config), width, height);
+    bitmap->setIsOpaque(SkToBool(isOpaque));
+
+    Sk64 size = bitmap->getSize64();
+    if (!size.is32()) {
+        return false;
+    }
+
+    mapping->skipToAlignment();
+    SkData* pixels = mapping->readBlock(size.get32());
+    if (NULL == pixels) {
+        return false;
+    }
+    bitmap->setPixelRef(SkNEW_ARGS(SkDataPixelRef, (pixels)))->unref();
+    pixels->unref();
+    return true;
+}
+
+bool SkPicturePlayback::parseMappedTag(SkPictureMapping* mapping, const SkPictInfo& info,
+                                       uint32_t tag, size_t size,
+                                       SkSerializationHelpers::DecodeBitmap decoder) {
+    switch (tag) {
+        case PICT_READER_TAG: {
+            mapping->skipToAlignment();
+            SkASSERT(NULL == fOpData);
+            fOpData = mapping->readBlock(size);
+            if (NULL == fOpData) {
+                return false;
+            }
+        } break;
+        case PICT_PICTURE_TAG: {
+            // each picture takes at least its SkPictInfo
+            if (size > mapping->remaining() / sizeof(SkPictInfo)) {
+                return false;
+            }
+            fPictureRefs = SkNEW_ARRAY(SkPicture*, size);
+            for (size_t i = 0; i < size; i++) {
+                // count the picture first, so that it is unreffed if it fails
+                fPictureRefs[i] = SkNEW(SkPicture);
+                fPictureCount = i + 1;
+                if (!fPictureRefs[i]->parse(mapping->stream(), mapping, decoder)) {
+                    return false;
+                }
+            }
+        } break;
+        case PICT_BITMAP_BLOCK_TAG: {
+            if (size > mapping->remaining() / kBitmapBlockHeaderSize) {
+                return false;
+            }
+            fBitmaps = SkTRefArray<SkBitmap>::Create(size);
+            for (size_t i = 0; i < size; ++i) {
+                SkBitmap* bm = &fBitmaps->writableAt(i);
+                if (!read_bitmap_block(mapping, bm)) {
+                    return false;
+                }
+                bm->setImmutable();
+            }
+        } break;
+        case PICT_BUFFER_SIZE_TAG: {
+            mapping->skipToAlignment();
+            const void* storage = mapping->skip(size);
+            if (NULL == storage) {
+                return false;
+            }
+
+            SkOrderedReadBuffer buffer(storage, size);
+            buffer.setFlags(pictInfoFlagsToReadBufferFlags(info.fFlags));
+
+            mapping->setupBuffer(buffer);
+            buffer.setBitmapDecoder(decoder);
+
+            while (!buffer.eof()) {
+                if (buffer.size() - buffer.offset() < 2 * sizeof(uint32_t)) {
+                    return false;
+                }
+                tag = buffer.readUInt();
+                size = buffer.readUInt();
+                // each entry takes at least a byte of the buffer
+                if (size > buffer.size() - buffer.offset() ||
+                        !this->parseBufferTag(buffer, tag, size)) {
+                    return false;
+                }
+            }
+        } break;
+        default:
+            // unlike a stream, a mapping must not have tags this code skips
+            return false;
+    }
+    return true;    // success
+}
+
 SkPicturePlayback::SkPicturePlayback(SkStream* stream, const SkPictInfo& info,
-                                     bool* isValid, SkSerializationHelpers::DecodeBitmap decoder) {
+                                     bool* isValid, SkSerializationHelpers::DecodeBitmap decoder,
+                                     SkPictureMapping* mapping) {
     this->init();
 
     *isValid = false;   // wait until we're done parsing to mark as true
     for (;;) {
-        uint32_t tag = stream->readU32();
+        uint32_t tag, size;
+        if (NULL != mapping) {
+            // unlike a stream, a mapping tells where its data ends
+            if (!mapping->readU32(&tag) ||
+                    (PICT_EOF_TAG != tag && !mapping->readU32(&size))) {
+                return; // we're invalid
+            }
+        } else {
+            tag = stream->readU32();
+            size = PICT_EOF_TAG != tag ? stream->readU32() : 0;
+        }
         if (PICT_EOF_TAG == tag) {
             break;
         }
 
-        uint32_t size = stream->readU32();
-        if (!this->parseStreamTag(stream, info, tag, size, decoder)) {
+        bool parsed = NULL != mapping ?
+                this->parseMappedTag(mapping, info, tag, size, decoder) :
+                this->parseStreamTag(stream, info, tag, size, decoder);
+        if (!parsed) {
             return; // we're invalid
         }
     }
     *isValid = true;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+SkPictureMapping::SkPictureMapping(SkData* data) : fFactoryPlayback(NULL) {
+    // Blocks are aligned from the start of the data, and SkReader32 needs
+    // the op streams at least 4 byte aligned.
+    if (SkIsAlign4(reinterpret_cast<uintptr_t>(data->data()))) {
+        data->ref();
+        fData = data;
+    } else {
+        fData = SkData::NewWithCopy(data->data(), data->size());
+    }
+    fStream.setData(fData);
+}
+
+SkPictureMapping::~SkPictureMapping() {
+    SkDELETE(fFactoryPlayback);
+    fData->unref();
+}
+
+bool SkPictureMapping::readTables() {
+    uint32_t trailer[2];
+    size_t size = fData->size();
+
+    if (size < sizeof(SkPictInfo) + sizeof(trailer)) {
+        return false;
+    }
+    memcpy(trailer, fData->bytes() + size - sizeof(trailer), sizeof(trailer));
+    if (PICT_MAPPABLE_TAG != trailer[1] || trailer[0] > size - sizeof(trailer)) {
+        return false;
+    }
+
+    fStream.seek(trailer[0]);
+    bool success = this->readFactoriesAndTypefaces();
+    // a picture in the old format is parsed from the start
+    return fStream.rewind() && success;
+}
+
+// Every factory name and typeface takes at least a byte, so neither count can
+// be more than the bytes left.
+bool SkPictureMapping::readFactoriesAndTypefaces() {
+    uint32_t tag, count;
+    if (!this->readU32(&tag) || PICT_FACTORY_TAG != tag ||
+            !this->readU32(&count) || count > this->remaining()) {
+        return false;
+    }
+    fFactoryPlayback = SkNEW_ARGS(SkFactoryPlayback, (count));
+    for (uint32_t i = 0; i < count; i++) {
+        size_t length;
+        const void* name;
+        if (!this->readPackedUInt(&length) ||
+                NULL == (name = this->skip(length))) {
+            return false;
+        }
+        SkString str(static_cast<const char*>(name), length);
+        fFactoryPlayback->base()[i] = SkFlattenable::NameToFactory(str.c_str());
+    }
+
+    if (!this->readU32(&tag) || PICT_TYPEFACE_TAG != tag ||
+            !this->readU32(&count) || count > this->remaining()) {
+        return false;
+    }
+    readTypefaces(&fStream, &fTFPlayback, count);
+    return true;
+}
+
+void SkPictureMapping::skipToAlignment() {
+    fStream.skip((0 - fStream.peek()) & (kAlignment - 1));
+}
+
+SkData* SkPictureMapping::readBlock(size_t size) {
+    size_t offset = fStream.peek();
+    if (NULL == this->skip(size)) {
+        return NULL;
+    }
+    return SkData::NewSubset(fData, offset, size);
+}
+
+const void* SkPictureMapping::skip(size_t size) {
+    size_t offset = fStream.peek();
+    if (size > fData->size() - offset) {
+        return NULL;
+    }
+    fStream.skip(size);
+    return fData->bytes() + offset;
+}
+
+bool SkPictureMapping::readU32(uint32_t* value) {
+    const void* src = this->skip(sizeof(*value));
+    if (NULL == src) {
+        return false;
+    }
+    memcpy(value, src, sizeof(*value));
+    return true;
+}
+
+// the encoding of SkWStream::writePackedUInt()
+bool SkPictureMapping::readPackedUInt(size_t* value) {
+    const uint8_t* byte = static_cast<const uint8_t*>(this->skip(1));
+    if (NULL == byte) {
+        return false;
+    }
+    if (0xFE == *byte) {
+        uint16_t value16;
+        const void* src = this->skip(sizeof(value16));
+        if (NULL == src) {
+            return false;
+        }
+        memcpy(&value16, src, sizeof(value16));
+        *value = value16;
+    } else if (0xFF == *byte) {
+        uint32_t value32;
+        if (!this->readU32(&value32)) {
+            return false;
+        }
+        *value = value32;
+    } else {
+        *value = *byte;
+    }
+    return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -22,6 +22,7 @@
 #include "SkRRect.h"
 #include "SkPictureFlat.h"
 #include "SkSerializationHelpers.h"
+#include "SkStream.h"
 
 #ifdef SK_BUILD_FOR_ANDROID
 #include "SkThread.h"
@@ -38,6 +39,7 @@ struct SkPictInfo {
         kCrossProcess_Flag      = 1 << 0,
         kScalarIsFloat_Flag     = 1 << 1,
         kPtrIs64Bit_Flag        = 1 << 2,
+        kMappable_Flag          = 1 << 3,
     };
 
     uint32_t    fVersion;
@@ -58,22 +60,107 @@ struct SkPictCopyInfo {
     SkTDArray<SkFlatData*> paintData;
 };
 
+/**
+ * Writes the pictures of SkPicture::serializeMappable(). It counts the bytes
+ * written so that blocks can be aligned from the start of the stream, and
+ * collects the factories and typefaces of every picture for the tables that
+ * end the stream.
+ */
+class SkMappableWriter : public SkWStream {
+public:
+    explicit SkMappableWriter(SkWStream* stream) : fStream(stream), fOffset(0) {}
+
+    virtual bool write(const void* buffer, size_t size) SK_OVERRIDE;
+    virtual void flush() SK_OVERRIDE { fStream->flush(); }
+
+    // pads with zeros up to the next SkPictureMapping::kAlignment
+    void align();
+
+    SkRefCntSet* typefaceSet() { return &fTypefaceSet; }
+    SkFactorySet* factorySet() { return &fFactorySet; }
+
+    // writes the factory and typeface tables, then the trailer that
+    // SkPictureMapping::readTables() looks for
+    void writeTables();
+
+private:
+    SkWStream*      fStream;
+    size_t          fOffset;
+    SkRefCntSet     fTypefaceSet;
+    SkFactorySet    fFactorySet;
+};
+
+/**
+ * The data that SkPicture::CreateFromData() reads a mappable picture from.
+ * Op streams and pixels are handed out as subsets of the data, and the
+ * tables at its end are shared by all the pictures in it.
+ */
+class SkPictureMapping : SkNoncopyable {
+public:
+    enum {
+        kAlignment = 16
+    };
+
+    explicit SkPictureMapping(SkData*);
+    ~SkPictureMapping();
+
+    // a stream over the whole data, pictures are parsed from it
+    SkMemoryStream* stream() { return &fStream; }
+
+    // reads the tables and rewinds the stream. returns false if the data
+    // was not written by serializeMappable().
+    bool readTables();
+
+    void setupBuffer(SkOrderedReadBuffer& buffer) const {
+        fFactoryPlayback->setupBuffer(buffer);
+        fTFPlayback.setupBuffer(buffer);
+    }
+
+    void skipToAlignment();
+
+    // the next size bytes of the stream, without copying them. returns NULL
+    // if the data ends first.
+    SkData* readBlock(size_t size);
+    const void* skip(size_t size);
+
+    // the bytes left after the stream's position, which bound every count
+    // read from the data
+    size_t remaining() const { return fData->size() - fStream.peek(); }
+
+    // return false, rather than a value read past the end, if the data ends
+    // first
+    bool readU32(uint32_t* value);
+    bool readPackedUInt(size_t* value);
+
+private:
+    bool readFactoriesAndTypefaces();
+
+    SkData*             fData;
+    SkMemoryStream      fStream;
+    SkTypefacePlayback  fTFPlayback;
+    SkFactoryPlayback*  fFactoryPlayback;
+};
+
 class SkPicturePlayback {
 public:
     SkPicturePlayback();
     SkPicturePlayback(const SkPicturePlayback& src, SkPictCopyInfo* deepCopyInfo = NULL);
     explicit SkPicturePlayback(const SkPictureRecord& record, bool deepCopy = false);
     SkPicturePlayback(SkStream*, const SkPictInfo&, bool* isValid,
-                      SkSerializationHelpers::DecodeBitmap decoder);
+                      SkSerializationHelpers::DecodeBitmap decoder,
+                      SkPictureMapping* mapping = NULL);
 
     virtual ~SkPicturePlayback();
 
     void draw(SkCanvas& canvas);
 
     void serialize(SkWStream*, SkSerializationHelpers::EncodeBitmap) const;
+    void serializeMappable(SkMappableWriter*) const;
 
     void dumpSize() const;
 
+    size_t approximateBytesUsed() const;
+
     // Can be called in the middle of playback (the draw() call). WIll abort the
     // drawing and return from draw() after the "current" op code is done
     void abort();
@@ -191,8 +278,10 @@ public:
 private:    // these help us with reading/writing
     bool parseStreamTag(SkStream*, const SkPictInfo&, uint32_t tag, size_t size,
                         SkSerializationHelpers::DecodeBitmap decoder);
+    bool parseMappedTag(SkPictureMapping*, const SkPictInfo&, uint32_t tag, size_t size,
+                        SkSerializationHelpers::DecodeBitmap decoder);
     bool parseBufferTag(SkOrderedReadBuffer&, uint32_t tag, size_t size);
-    void flattenToBuffer(SkOrderedWriteBuffer&) const;
+    void flattenToBuffer(SkOrderedWriteBuffer&, bool writeBitmaps) const;
 
 private:
     // Only used by getBitmap() if the passed in index is SkBitmapHeap::INVALID_SLOT. This empty
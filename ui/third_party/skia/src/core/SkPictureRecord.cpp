@@ -11,10 +11,16 @@
 #include "SkRRect.h"
 #include "SkBBoxHierarchy.h"
 #include "SkPictureStateTree.h"
+#include "SkTLS.h"
 
 #define MIN_WRITER_SIZE 16384
 #define HEAP_BLOCK_SIZE 4096
 
+// The op stream of a typical view fits in the first block, further ones are
+// allocated MIN_WRITER_SIZE at a time. Nested recordings each hold a block.
+#define RECORD_BLOCK_SIZE   (64 * 1024)
+#define MAX_CACHED_BLOCKS   2
+
 enum {
     // just need a value that save or getSaveCount would never return
     kNoInitialSave = -1,
@@ -28,7 +34,8 @@ SkPictureRecord::SkPictureRecord(uint32_t flags, SkDevice* device) :
         fMatrices(&fFlattenableHeap),
         fPaints(&fFlattenableHeap),
         fRegions(&fFlattenableHeap),
-        fWriter(MIN_WRITER_SIZE),
+        fWriter(MIN_WRITER_SIZE, fRecordBlock.get(), RecordBlock::Size()),
+        fLastPaintIndex(0),
         fRecordFlags(flags) {
 #ifdef SK_DEBUG_SIZE
     fPointBytes = fRectBytes = fTextBytes = 0;
@@ -56,6 +63,55 @@ SkPictureRecord::~SkPictureRecord() {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+struct RecordBlockCache {
+    void*   fBlocks[MAX_CACHED_BLOCKS];
+    int     fCount;
+};
+
+static void* CreateRecordBlockCache() {
+    RecordBlockCache* cache = SkNEW(RecordBlockCache);
+    cache->fCount = 0;
+    return cache;
+}
+
+static void DeleteRecordBlockCache(void* ptr) {
+    RecordBlockCache* cache = (RecordBlockCache*)ptr;
+    for (int i = 0; i < cache->fCount; ++i) {
+        sk_free(cache->fBlocks[i]);
+    }
+    SkDELETE(cache);
+}
+
+static RecordBlockCache* get_record_block_cache() {
+    return (RecordBlockCache*)SkTLS::Get(CreateRecordBlockCache,
+                                         DeleteRecordBlockCache);
+}
+
+SkPictureRecord::RecordBlock::RecordBlock() {
+    RecordBlockCache* cache = get_record_block_cache();
+    if (cache->fCount > 0) {
+        fBlock = cache->fBlocks[--cache->fCount];
+    } else {
+        fBlock = sk_malloc_throw(RECORD_BLOCK_SIZE);
+    }
+}
+
+SkPictureRecord::RecordBlock::~RecordBlock() {
+    // the recording may end on another thread, whose cache takes the block
+    RecordBlockCache* cache = get_record_block_cache();
+    if (cache->fCount < MAX_CACHED_BLOCKS) {
+        cache->fBlocks[cache->fCount++] = fBlock;
+    } else {
+        sk_free(fBlock);
+    }
+}
+
+size_t SkPictureRecord::RecordBlock::Size() {
+    return RECORD_BLOCK_SIZE;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 SkDevice* SkPictureRecord::setDevice(SkDevice* device) {
     SkASSERT(!"eeek, don't try to change the device on a recording canvas");
     return this->INHERITED::setDevice(device);
@@ -561,6 +617,11 @@ void SkPictureRecord::drawText(const void* text, size_t byteLength, SkScalar x,
     validate();
 }
 
+void SkPictureRecord::drawGlyphs(SkGlyphStrike*, const uint16_t glyphs[], int count,
+                                 SkScalar x, SkScalar y, const SkPaint& paint) {
+    this->drawGlyphsAsText(glyphs, count, x, y, paint);
+}
+
 void SkPictureRecord::drawPosText(const void* text, size_t byteLength,
                          const SkPoint pos[], const SkPaint& paint) {
     size_t points = paint.countText(text, byteLength);
@@ -731,8 +792,30 @@ void SkPictureRecord::addMatrixPtr(const SkMatrix* matrix) {
     this->addInt(matrix ? fMatrices.find(*matrix) : 0);
 }
 
+// Typefaces and xfermodes are immutable, other effects may be changed between
+// two ops that share them, so only their flattened form can be compared.
+static bool paint_has_mutable_effects(const SkPaint& paint) {
+    return paint.getShader() || paint.getPathEffect() ||
+           paint.getMaskFilter() || paint.getColorFilter() ||
+           paint.getRasterizer() || paint.getLooper() ||
+           paint.getImageFilter() || paint.getAnnotation();
+}
+
 int SkPictureRecord::addPaintPtr(const SkPaint* paint) {
-    int index = paint ? fPaints.find(*paint) : 0;
+    int index = 0;
+    if (paint) {
+        if (fLastPaintIndex > 0 &&
+            !memcmp(paint, fLastPaint.get(), sizeof(SkPaint))) {
+            index = fLastPaintIndex;
+        } else {
+            index = fPaints.find(*paint);
+            if (!paint_has_mutable_effects(*paint)) {
+                fLastXfermode.reset(SkSafeRef(paint->getXfermode()));
+                memcpy(fLastPaint.get(), paint, sizeof(SkPaint));
+                fLastPaintIndex = index;
+            }
+        }
+    }
     this->addInt(index);
     return index;
 }
@@ -59,6 +59,8 @@ public:
                             const SkPaint*) SK_OVERRIDE;
     virtual void drawText(const void* text, size_t byteLength, SkScalar x,
                           SkScalar y, const SkPaint&) SK_OVERRIDE;
+    virtual void drawGlyphs(SkGlyphStrike*, const uint16_t glyphs[], int count,
+                            SkScalar x, SkScalar y, const SkPaint&) SK_OVERRIDE;
     virtual void drawPosText(const void* text, size_t byteLength,
                              const SkPoint pos[], const SkPaint&) SK_OVERRIDE;
     virtual void drawPosTextH(const void* text, size_t byteLength,
@@ -183,6 +185,22 @@ protected:
     SkBitmapHeap* fBitmapHeap;
 
 private:
+    /*  The first block of the op stream. It comes from a per-thread cache, so
+        a thread recording display lists over and over writes most of them
+        without allocating. Declared before fWriter, which writes into it.
+     */
+    class RecordBlock : ::SkNoncopyable {
+    public:
+        RecordBlock();
+        ~RecordBlock();
+
+        void* get() const { return fBlock; }
+        static size_t Size();
+
+    private:
+        void* fBlock;
+    };
+
     SkChunkFlatController fFlattenableHeap;
 
     SkMatrixDictionary fMatrices;
@@ -190,8 +208,21 @@ private:
     SkRegionDictionary fRegions;
 
     SkPathHeap* fPathHeap;  // reference counted
+    RecordBlock fRecordBlock;
     SkWriter32 fWriter;
 
+    // The bytes of the last paint without effects that was added, and its
+    // index. Ops drawn with a paint of the same bytes, which is what
+    // SkPaint::operator== compares, reuse the index without flattening it
+    // again. Paints with effects are always flattened, the effects may have
+    // changed. The bytes are copied rather than the paint, a paint copy refs
+    // and unrefs every effect and costs more than the compare. The typeface
+    // is kept alive by the flattened paint, the xfermode by fLastXfermode, so
+    // no other object can take either address.
+    SkAlignedSStorage<sizeof(SkPaint)> fLastPaint;
+    SkAutoTUnref<SkXfermode> fLastXfermode;
+    int fLastPaintIndex;
+
     // we ref each item in these arrays
     SkTDArray<SkPicture*> fPictureRefs;
 
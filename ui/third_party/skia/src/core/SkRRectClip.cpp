@@ -0,0 +1,400 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkRRectClip.h"
+#include "SkColorPriv.h"
+#include "SkPath.h"
+
+struct CornerInfo {
+    // the pixels the corner may leave uncovered
+    SkIRect fBox;
+    // the coverage of the pixels in the box, 0 outside its bounds
+    SkMask  fMask;
+    // +1 if the corner is to the right of its center, -1 if not
+    int     fDirX;
+};
+
+/**
+ *  Scan converts each corner of rrect the way SkAAClip::setPath() does, with
+ *  the clip limited to the corner's box, so that the coverage of the analytic
+ *  clip is the coverage of the mask clip while costing only the corners.
+ */
+static void init_corners(const SkRRect& rrect, const SkIRect& r,
+                         CornerInfo corners[4]) {
+    static const int gDirX[4] = { -1, 1, 1, -1 };
+    static const int gDirY[4] = { -1, -1, 1, 1 };
+
+    SkPath path;
+    path.addRRect(rrect);
+
+    for (int i = 0; i < 4; ++i) {
+        const SkVector& radii = rrect.radii((SkRRect::Corner)i);
+        CornerInfo& c = corners[i];
+
+        c.fDirX = gDirX[i];
+        c.fMask.fImage = NULL;
+        if (radii.fX <= 0 || radii.fY <= 0) {
+            c.fBox.setEmpty();
+            continue;
+        }
+
+        int w = SkScalarCeilToInt(radii.fX);
+        int h = SkScalarCeilToInt(radii.fY);
+        int left = c.fDirX < 0 ? r.fLeft : r.fRight - w;
+        int top = gDirY[i] < 0 ? r.fTop : r.fBottom - h;
+        c.fBox.setXYWH(left, top, w, h);
+
+        SkRegion box(c.fBox);
+        SkAAClip clip;
+        clip.setPath(path, &box, true);
+        clip.copyToMask(&c.fMask);
+    }
+}
+
+static void free_corners(CornerInfo corners[4]) {
+    for (int i = 0; i < 4; ++i) {
+        SkMask::FreeImage(corners[i].fMask.fImage);
+    }
+}
+
+static SkAlpha corner_coverage(const CornerInfo& c, int x, int y) {
+    if (!c.fMask.fBounds.contains(x, y)) {
+        return 0;
+    }
+    return *c.fMask.getAddr8(x, y);
+}
+
+bool SkRRectClip::CanClip(const SkRRect& rrect) {
+    const SkRect& r = rrect.rect();
+    return r.fLeft == SkScalarFloorToScalar(r.fLeft) &&
+           r.fTop == SkScalarFloorToScalar(r.fTop) &&
+           r.fRight == SkScalarFloorToScalar(r.fRight) &&
+           r.fBottom == SkScalarFloorToScalar(r.fBottom) &&
+           !rrect.isEmpty();
+}
+
+SkRRectClip::SkRRectClip(const SkRRect& rrect, const SkIRect& bounds)
+        : fRRect(rrect), fBounds(bounds), fAAClip(NULL) {
+    SkASSERT(CanClip(rrect));
+    rrect.rect().round(&fRect);
+    SkASSERT(fRect.contains(bounds));
+
+    SkScalar topRadius = SkMaxScalar(rrect.radii(SkRRect::kUpperLeft_Corner).fY,
+                                     rrect.radii(SkRRect::kUpperRight_Corner).fY);
+    SkScalar bottomRadius = SkMaxScalar(rrect.radii(SkRRect::kLowerLeft_Corner).fY,
+                                        rrect.radii(SkRRect::kLowerRight_Corner).fY);
+    fTopRows = SkScalarCeilToInt(topRadius);
+    fBottomRows = SkScalarCeilToInt(bottomRadius);
+    if (fTopRows + fBottomRows > fRect.height()) {
+        fTopRows = fRect.height();
+        fBottomRows = 0;
+    }
+
+    fInteriorLeft = fRect.fLeft;
+    fInteriorRight = fRect.fRight;
+
+    CornerInfo corners[4];
+    init_corners(rrect, fRect, corners);
+
+    int count = fTopRows + fBottomRows;
+    fRows.setCount(count);
+    for (int i = 0; i < count; ++i) {
+        int y = i < fTopRows ? fRect.fTop + i
+                             : fRect.fBottom - fBottomRows + i - fTopRows;
+        this->buildRow(corners, y, &fRows[i]);
+    }
+    free_corners(corners);
+}
+
+SkRRectClip::SkRRectClip(const SkRRectClip& src, int dx, int dy,
+                         const SkIRect& bounds)
+        : fRows(src.fRows), fAlpha(src.fAlpha), fAAClip(NULL) {
+    SkVector radii[4];
+    for (int i = 0; i < 4; ++i) {
+        radii[i] = src.fRRect.radii((SkRRect::Corner)i);
+    }
+    SkRect r = src.fRRect.rect();
+    r.offset(SkIntToScalar(dx), SkIntToScalar(dy));
+    fRRect.setRectRadii(r, radii);
+
+    fRect = src.fRect;
+    fRect.offset(dx, dy);
+    fBounds = bounds;
+    SkASSERT(fRect.contains(bounds));
+
+    fTopRows = src.fTopRows;
+    fBottomRows = src.fBottomRows;
+    fInteriorLeft = src.fInteriorLeft + dx;
+    fInteriorRight = src.fInteriorRight + dx;
+}
+
+SkRRectClip::~SkRRectClip() {
+    SkDELETE(fAAClip);
+}
+
+void SkRRectClip::buildRow(const CornerInfo corners[4], int y, Row* row) {
+    // the corners crossing the row
+    const CornerInfo* rowCorners[4];
+    int cornerCount = 0;
+
+    int leftCount = 0;
+    int rightCount = 0;
+    for (int i = 0; i < 4; ++i) {
+        const SkIRect& box = corners[i].fBox;
+        if (y < box.fTop || y >= box.fBottom) {
+            continue;
+        }
+        rowCorners[cornerCount++] = &corners[i];
+        if (corners[i].fDirX < 0) {
+            leftCount = SkMax32(leftCount, box.width());
+        } else {
+            rightCount = SkMax32(rightCount, box.width());
+        }
+    }
+    if (leftCount + rightCount > fRect.width()) {
+        leftCount = fRect.width();
+        rightCount = 0;
+    }
+
+    row->fLeftCount = leftCount;
+    row->fRightCount = rightCount;
+    row->fAlphaOffset = fAlpha.count();
+
+    SkAlpha* alpha = fAlpha.append(leftCount + rightCount);
+    for (int i = 0; i < leftCount + rightCount; ++i) {
+        int x = i < leftCount ? fRect.fLeft + i
+                              : fRect.fRight - rightCount + i - leftCount;
+        SkAlpha a = 0xFF;
+        for (int j = 0; j < cornerCount; ++j) {
+            const SkIRect& box = rowCorners[j]->fBox;
+            if (x >= box.fLeft && x < box.fRight) {
+                a = SkMin32(a, corner_coverage(*rowCorners[j], x, y));
+            }
+        }
+        alpha[i] = a;
+    }
+
+    fInteriorLeft = SkMax32(fInteriorLeft, fRect.fLeft + leftCount);
+    fInteriorRight = SkMin32(fInteriorRight, fRect.fRight - rightCount);
+}
+
+bool SkRRectClip::quickContains(const SkIRect& r) const {
+    if (!fBounds.contains(r)) {
+        return false;
+    }
+    return (r.fTop >= this->interiorTop() && r.fBottom <= this->interiorBottom()) ||
+           (r.fLeft >= fInteriorLeft && r.fRight <= fInteriorRight);
+}
+
+const SkAAClip& SkRRectClip::aaClip() const {
+    // raster clips are shared by the canvases copying them, which may draw
+    // on different threads.
+    SkAutoMutexAcquire lock(fAAClipMutex);
+    if (NULL == fAAClip) {
+        SkPath path;
+        SkRegion clip(fBounds);
+
+        path.addRRect(fRRect);
+        fAAClip = SkNEW(SkAAClip);
+        fAAClip->setPath(path, &clip, true);
+    }
+    return *fAAClip;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SkRRectClipBlitter::~SkRRectClipBlitter() {
+    sk_free(fScanlineScratch);
+}
+
+void SkRRectClipBlitter::ensureRunsAndAA() {
+    if (NULL == fScanlineScratch) {
+        // add 1 so we can store the terminating run count of 0
+        int count = fClip->getBounds().width() + 1;
+        fScanlineScratch = sk_malloc_throw(count * (sizeof(int16_t) + sizeof(SkAlpha)));
+        fRuns = (int16_t*)fScanlineScratch;
+        fAA = (SkAlpha*)(fRuns + count);
+    }
+}
+
+void SkRRectClipBlitter::blitH(int x, int y, int width) {
+    const SkRRectClip::Row* row = fClip->getRow(y);
+    if (NULL == row || (x >= fClip->interiorLeft() && x + width <= fClip->interiorRight())) {
+        fBlitter->blitH(x, y, width);
+        return;
+    }
+
+    SkAlpha alpha = 0xFF;
+    int16_t runs[2] = { SkToS16(width), 0 };
+    this->blitAntiH(x, y, &alpha, runs);
+}
+
+void SkRRectClipBlitter::blitAntiH(int x, int y, const SkAlpha aa[],
+                                   const int16_t runs[]) {
+    const SkRRectClip::Row* row = fClip->getRow(y);
+    if (NULL == row) {
+        fBlitter->blitAntiH(x, y, aa, runs);
+        return;
+    }
+
+    const SkIRect& rect = fClip->getRect();
+    const SkAlpha* leftAlpha = fClip->getAlpha(row) - rect.fLeft;
+    int innerLeft = rect.fLeft + row->fLeftCount;
+    int innerRight = rect.fRight - row->fRightCount;
+    const SkAlpha* rightAlpha = fClip->getAlpha(row) + row->fLeftCount - innerRight;
+    int stop = fClip->getBounds().fRight;
+
+    this->ensureRunsAndAA();
+
+    int16_t* dstRuns = fRuns;
+    SkAlpha* dstAA = fAA;
+    int cx = x;
+
+    SkASSERT(x >= fClip->getBounds().fLeft);
+    for (;;) {
+        int n = *runs;
+        if (n <= 0 || cx >= stop) {
+            break;
+        }
+        SkAlpha a = *aa;
+        int end = SkMin32(cx + n, stop);
+        runs += n;
+        aa += n;
+
+        for (; cx < end && cx < innerLeft; ++cx) {
+            *dstAA = SkMulDiv255Round(a, leftAlpha[cx]);
+            *dstRuns = 1;
+            dstAA += 1;
+            dstRuns += 1;
+        }
+        if (cx < end && cx < innerRight) {
+            int count = SkMin32(end, innerRight) - cx;
+            *dstAA = a;
+            *dstRuns = SkToS16(count);
+            dstAA += count;
+            dstRuns += count;
+            cx += count;
+        }
+        for (; cx < end; ++cx) {
+            *dstAA = SkMulDiv255Round(a, rightAlpha[cx]);
+            *dstRuns = 1;
+            dstAA += 1;
+            dstRuns += 1;
+        }
+    }
+    *dstRuns = 0;
+
+    if (cx > x) {
+        fBlitter->blitAntiH(x, y, fAA, fRuns);
+    }
+}
+
+void SkRRectClipBlitter::blitV(int x, int y, int height, SkAlpha alpha) {
+    if (x >= fClip->interiorLeft() && x < fClip->interiorRight()) {
+        fBlitter->blitV(x, y, height, alpha);
+        return;
+    }
+
+    int stop = y + height;
+    while (y < stop) {
+        const SkRRectClip::Row* row = fClip->getRow(y);
+        if (NULL == row) {
+            int bottom = SkMin32(stop, fClip->interiorBottom());
+            fBlitter->blitV(x, y, bottom - y, alpha);
+            y = bottom;
+            continue;
+        }
+
+        const SkIRect& rect = fClip->getRect();
+        const SkAlpha* cover = fClip->getAlpha(row);
+        SkAlpha a = alpha;
+        if (x < rect.fLeft + row->fLeftCount) {
+            a = SkMulDiv255Round(alpha, cover[x - rect.fLeft]);
+        } else if (x >= rect.fRight - row->fRightCount) {
+            a = SkMulDiv255Round(alpha, cover[row->fLeftCount + x -
+                                              (rect.fRight - row->fRightCount)]);
+        }
+        if (a) {
+            fBlitter->blitV(x, y, 1, a);
+        }
+        y += 1;
+    }
+}
+
+void SkRRectClipBlitter::blitRect(int x, int y, int width, int height) {
+    if (x >= fClip->interiorLeft() && x + width <= fClip->interiorRight()) {
+        fBlitter->blitRect(x, y, width, height);
+        return;
+    }
+
+    int stop = y + height;
+    int top = SkMax32(y, fClip->interiorTop());
+    int bottom = SkMin32(stop, fClip->interiorBottom());
+
+    // the rows crossing the top corners, then the interior, then the bottom
+    for (; y < stop && y < top; ++y) {
+        this->blitH(x, y, width);
+    }
+    if (y < bottom) {
+        fBlitter->blitRect(x, y, width, bottom - y);
+        y = bottom;
+    }
+    for (; y < stop; ++y) {
+        this->blitH(x, y, width);
+    }
+}
+
+void SkRRectClipBlitter::blitCornerRows(const SkMask& mask, const SkIRect& clip) {
+    if (clip.isEmpty()) {
+        return;
+    }
+    if (clip.fLeft >= fClip->interiorLeft() && clip.fRight <= fClip->interiorRight()) {
+        fBlitter->blitMask(mask, clip);
+        return;
+    }
+
+    if (SkMask::kBW_Format == mask.fFormat || SkMask::kA8_Format == mask.fFormat) {
+        // the base blitter turns these into blitH and blitAntiH calls
+        this->INHERITED::blitMask(mask, clip);
+        return;
+    }
+
+    if (!fAABlitterReady) {
+        fAABlitter.init(fBlitter, &fClip->aaClip());
+        fAABlitterReady = true;
+    }
+    fAABlitter.blitMask(mask, clip);
+}
+
+void SkRRectClipBlitter::blitMask(const SkMask& mask, const SkIRect& clip) {
+    SkASSERT(fClip->getBounds().contains(clip));
+
+    if (fClip->quickContains(clip)) {
+        fBlitter->blitMask(mask, clip);
+        return;
+    }
+
+    int top = SkMax32(clip.fTop, fClip->interiorTop());
+    int bottom = SkMin32(clip.fBottom, fClip->interiorBottom());
+
+    if (top >= bottom) {
+        // only corner rows, or the clip spans the two bands of a short rrect
+        this->blitCornerRows(mask, clip);
+        return;
+    }
+
+    this->blitCornerRows(mask, SkIRect::MakeLTRB(clip.fLeft, clip.fTop,
+                                                 clip.fRight, top));
+    fBlitter->blitMask(mask, SkIRect::MakeLTRB(clip.fLeft, top,
+                                               clip.fRight, bottom));
+    this->blitCornerRows(mask, SkIRect::MakeLTRB(clip.fLeft, bottom,
+                                                 clip.fRight, clip.fBottom));
+}
+
+const SkBitmap* SkRRectClipBlitter::justAnOpaqueColor(uint32_t* value) {
+    return NULL;
+}
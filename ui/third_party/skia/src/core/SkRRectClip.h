@@ -0,0 +1,169 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkRRectClip_DEFINED
+#define SkRRectClip_DEFINED
+
+#include "SkAAClip.h"
+#include "SkBlitter.h"
+#include "SkRRect.h"
+#include "SkTDArray.h"
+#include "SkThread.h"
+
+struct CornerInfo;
+
+/**
+ *  An antialiased round rect clip kept analytically, for SkRasterClip.
+ *
+ *  Only the rows that cross a corner have coverage, and only for the pixels
+ *  in the corner's box: the rest of the bounds is covered. The coverage is
+ *  computed once, so its cost is the area of the corners rather than of the
+ *  clip. The coverage is the one SkAAClip gives the same round rect. The
+ *  clip is immutable once built and is shared by the copies of a raster
+ *  clip.
+ */
+class SkRRectClip : public SkRefCnt {
+public:
+    /**
+     *  rrect is in device space, and bounds is the part of it kept by the
+     *  clip, e.g. after intersecting with a rect. See CanClip().
+     */
+    SkRRectClip(const SkRRect& rrect, const SkIRect& bounds);
+
+    /**
+     *  A copy of src moved by (dx, dy), limited to bounds, which must be
+     *  inside the moved round rect.
+     */
+    SkRRectClip(const SkRRectClip& src, int dx, int dy, const SkIRect& bounds);
+
+    virtual ~SkRRectClip();
+
+    /**
+     *  Returns true if rrect can be clipped to analytically: its rect must
+     *  be integral, so that only its corners need coverage.
+     */
+    static bool CanClip(const SkRRect& rrect);
+
+    const SkRRect& getRRect() const { return fRRect; }
+    const SkIRect& getRect() const { return fRect; }
+    const SkIRect& getBounds() const { return fBounds; }
+
+    struct Row {
+        // the pixels [rect.fLeft, rect.fLeft + fLeftCount) and
+        // [rect.fRight - fRightCount, rect.fRight) take their coverage from
+        // the alpha of the row, in that order. The pixels between them are
+        // covered.
+        int         fLeftCount;
+        int         fRightCount;
+        uint32_t    fAlphaOffset;
+    };
+
+    /**
+     *  Returns the corners crossing row y, or NULL if every pixel of the row
+     *  is covered.
+     */
+    const Row* getRow(int y) const {
+        int index = y - fRect.fTop;
+        if (index < fTopRows) {
+            return &fRows[index];
+        }
+        index = y - (fRect.fBottom - fBottomRows);
+        if (index >= 0) {
+            return &fRows[fTopRows + index];
+        }
+        return NULL;
+    }
+
+    const SkAlpha* getAlpha(const Row* row) const {
+        return fAlpha.begin() + row->fAlphaOffset;
+    }
+
+    // getRow() is NULL for the rows [interiorTop, interiorBottom)
+    int interiorTop() const { return fRect.fTop + fTopRows; }
+    int interiorBottom() const { return fRect.fBottom - fBottomRows; }
+
+    // every row is covered in the columns [interiorLeft, interiorRight)
+    int interiorLeft() const { return fInteriorLeft; }
+    int interiorRight() const { return fInteriorRight; }
+
+    /**
+     *  Returns true if rect is inside the bounds and misses the corners.
+     */
+    bool quickContains(const SkIRect& rect) const;
+
+    /**
+     *  Returns the clip as an SkAAClip, for the few callers that need a mask
+     *  of the whole clip. It is built the first time it is asked for, under
+     *  a lock since the clip may be shared across threads.
+     */
+    const SkAAClip& aaClip() const;
+
+private:
+    SkRRect             fRRect;
+    SkIRect             fRect;
+    SkIRect             fBounds;
+    int                 fTopRows;
+    int                 fBottomRows;
+    int                 fInteriorLeft;
+    int                 fInteriorRight;
+    SkTDArray<Row>      fRows;
+    SkTDArray<SkAlpha>  fAlpha;
+    mutable SkAAClip*   fAAClip;
+    mutable SkMutex     fAAClipMutex;
+
+    void buildRow(const CornerInfo corners[4], int y, Row* row);
+
+    typedef SkRefCnt INHERITED;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ *  Blits through an SkRRectClip. Spans and rects between the corners go
+ *  straight to the wrapped blitter; only the pixels in the corners are
+ *  scaled by their coverage.
+ */
+class SkRRectClipBlitter : public SkBlitter {
+public:
+    SkRRectClipBlitter() : fBlitter(NULL), fClip(NULL), fScanlineScratch(NULL) {}
+    virtual ~SkRRectClipBlitter();
+
+    void init(SkBlitter* blitter, const SkRRectClip* clip) {
+        SkASSERT(clip && !clip->getBounds().isEmpty());
+        fBlitter = blitter;
+        fClip = clip;
+        fAABlitterReady = false;
+    }
+
+    virtual void blitH(int x, int y, int width) SK_OVERRIDE;
+    virtual void blitAntiH(int x, int y, const SkAlpha[],
+                           const int16_t runs[]) SK_OVERRIDE;
+    virtual void blitV(int x, int y, int height, SkAlpha alpha) SK_OVERRIDE;
+    virtual void blitRect(int x, int y, int width, int height) SK_OVERRIDE;
+    virtual void blitMask(const SkMask&, const SkIRect& clip) SK_OVERRIDE;
+    virtual const SkBitmap* justAnOpaqueColor(uint32_t* value) SK_OVERRIDE;
+
+private:
+    SkBlitter*          fBlitter;
+    const SkRRectClip*  fClip;
+
+    // point into fScanlineScratch
+    int16_t*            fRuns;
+    SkAlpha*            fAA;
+    void*               fScanlineScratch;
+
+    // blits the masks that cannot go through blitAntiH
+    SkAAClipBlitter     fAABlitter;
+    bool                fAABlitterReady;
+
+    void ensureRunsAndAA();
+    void blitCornerRows(const SkMask&, const SkIRect& clip);
+
+    typedef SkBlitter INHERITED;
+};
+
+#endif
@@ -9,6 +9,7 @@
 
 
 SkRasterClip::SkRasterClip() {
+    fRRect = NULL;
     fIsBW = true;
     fIsEmpty = true;
     fIsRect = false;
@@ -24,6 +25,7 @@ SkRasterClip::SkRasterClip(const SkRasterClip& src) {
     } else {
         fAA = src.fAA;
     }
+    fRRect = SkSafeRef(src.fRRect);
 
     fIsEmpty = src.isEmpty();
     fIsRect = src.isRect();
@@ -31,6 +33,7 @@ SkRasterClip::SkRasterClip(const SkRasterClip& src) {
 }
 
 SkRasterClip::SkRasterClip(const SkIRect& bounds) : fBW(bounds) {
+    fRRect = NULL;
     fIsBW = true;
     fIsEmpty = this->computeIsEmpty();  // bounds might be empty, so compute
     fIsRect = !fIsEmpty;
@@ -39,19 +42,41 @@ SkRasterClip::SkRasterClip(const SkIRect& bounds) : fBW(bounds) {
 
 SkRasterClip::~SkRasterClip() {
     SkDEBUGCODE(this->validate();)
+    SkSafeUnref(fRRect);
+}
+
+SkRasterClip& SkRasterClip::operator=(const SkRasterClip& src) {
+    AUTO_RASTERCLIP_VALIDATE(src);
+
+    if (this != &src) {
+        fIsBW = src.fIsBW;
+        fBW = src.fBW;
+        fAA = src.fAA;
+        SkRefCnt_SafeAssign(fRRect, src.fRRect);
+        fIsEmpty = src.fIsEmpty;
+        fIsRect = src.fIsRect;
+    }
+    return *this;
 }
 
 bool SkRasterClip::isComplex() const {
+    if (fRRect) {
+        return true;
+    }
     return fIsBW ? fBW.isComplex() : !fAA.isEmpty();
 }
 
 const SkIRect& SkRasterClip::getBounds() const {
+    if (fRRect) {
+        return fRRect->getBounds();
+    }
     return fIsBW ? fBW.getBounds() : fAA.getBounds();
 }
 
 bool SkRasterClip::setEmpty() {
     AUTO_RASTERCLIP_VALIDATE(*this);
 
+    SkSafeSetNull(fRRect);
     fIsBW = true;
     fBW.setEmpty();
     fAA.setEmpty();
@@ -63,6 +88,7 @@ bool SkRasterClip::setEmpty() {
 bool SkRasterClip::setRect(const SkIRect& rect) {
     AUTO_RASTERCLIP_VALIDATE(*this);
 
+    SkSafeSetNull(fRRect);
     fIsBW = true;
     fAA.setEmpty();
     fIsRect = fBW.setRect(rect);
@@ -81,6 +107,8 @@ bool SkRasterClip::setPath(const SkPath& path, const SkRegion& clip, bool doAA)
         if (this->isBW()) {
             this->convertToAA();
         }
+        // the path replaces the round rect
+        SkSafeSetNull(fRRect);
         (void)fAA.setPath(path, &clip, doAA);
     }
     return this->updateCacheAndReturnNonEmpty();
@@ -109,6 +137,22 @@ bool SkRasterClip::setPath(const SkPath& path, const SkRasterClip& clip,
 bool SkRasterClip::op(const SkIRect& rect, SkRegion::Op op) {
     AUTO_RASTERCLIP_VALIDATE(*this);
 
+    if (fRRect) {
+        if (SkRegion::kIntersect_Op != op) {
+            this->convertRRectToAA();
+        } else {
+            SkIRect bounds = fRRect->getBounds();
+            if (!bounds.intersect(rect)) {
+                return this->setEmpty();
+            }
+            if (fRRect->quickContains(bounds)) {
+                return this->setRect(bounds);
+            }
+            this->setRRect(SkNEW_ARGS(SkRRectClip, (*fRRect, 0, 0, bounds)));
+            return true;
+        }
+    }
+
     fIsBW ? fBW.op(rect, op) : fAA.op(rect, op);
     return this->updateCacheAndReturnNonEmpty();
 }
@@ -116,6 +160,9 @@ bool SkRasterClip::op(const SkIRect& rect, SkRegion::Op op) {
 bool SkRasterClip::op(const SkRegion& rgn, SkRegion::Op op) {
     AUTO_RASTERCLIP_VALIDATE(*this);
 
+    if (fRRect) {
+        this->convertRRectToAA();
+    }
     if (fIsBW) {
         (void)fBW.op(rgn, op);
     } else {
@@ -130,6 +177,9 @@ bool SkRasterClip::op(const SkRasterClip& clip, SkRegion::Op op) {
     AUTO_RASTERCLIP_VALIDATE(*this);
     clip.validate();
 
+    if (fRRect) {
+        this->convertRRectToAA();
+    }
     if (this->isBW() && clip.isBW()) {
         (void)fBW.op(clip.fBW, op);
     } else {
@@ -166,7 +216,7 @@ static bool nearly_integral(SkScalar x) {
 bool SkRasterClip::op(const SkRect& r, SkRegion::Op op, bool doAA) {
     AUTO_RASTERCLIP_VALIDATE(*this);
 
-    if (fIsBW && doAA) {
+    if ((fIsBW || fRRect) && doAA) {
         // check that the rect really needs aa, or is it close enought to
         // integer boundaries that we can just treat it as a BW rect?
         if (nearly_integral(r.fLeft) && nearly_integral(r.fTop) &&
@@ -175,6 +225,14 @@ bool SkRasterClip::op(const SkRect& r, SkRegion::Op op, bool doAA) {
         }
     }
 
+    if (fRRect && !doAA) {
+        SkIRect ir;
+        r.round(&ir);
+        return this->op(ir, op);
+    }
+    if (fRRect) {
+        this->convertRRectToAA();
+    }
     if (fIsBW && !doAA) {
         SkIRect ir;
         r.round(&ir);
@@ -204,6 +262,14 @@ void SkRasterClip::translate(int dx, int dy, SkRasterClip* dst) const {
         return;
     }
 
+    if (fRRect) {
+        SkIRect bounds = fRRect->getBounds();
+        bounds.offset(dx, dy);
+        dst->setRRect(SkNEW_ARGS(SkRRectClip, (*fRRect, dx, dy, bounds)));
+        return;
+    }
+
+    SkSafeSetNull(dst->fRRect);
     dst->fIsBW = fIsBW;
     if (fIsBW) {
         fBW.translate(dx, dy, &dst->fBW);
@@ -216,6 +282,9 @@ void SkRasterClip::translate(int dx, int dy, SkRasterClip* dst) const {
 }
 
 bool SkRasterClip::quickContains(const SkIRect& ir) const {
+    if (fRRect) {
+        return fRRect->quickContains(ir);
+    }
     return fIsBW ? fBW.quickContains(ir) : fAA.quickContains(ir);
 }
 
@@ -225,11 +294,59 @@ const SkRegion& SkRasterClip::forceGetBW() {
     AUTO_RASTERCLIP_VALIDATE(*this);
 
     if (!fIsBW) {
-        fBW.setRect(fAA.getBounds());
+        fBW.setRect(this->getBounds());
     }
     return fBW;
 }
 
+bool SkRasterClip::intersectRRect(const SkRRect& devRRect) {
+    AUTO_RASTERCLIP_VALIDATE(*this);
+
+    if (this->isEmpty()) {
+        return true;
+    }
+    if (!fIsRect || !SkRRectClip::CanClip(devRRect)) {
+        return false;
+    }
+
+    SkIRect bounds;
+    devRRect.rect().round(&bounds);
+    if (!bounds.intersect(fBW.getBounds())) {
+        this->setEmpty();
+        return true;
+    }
+
+    SkRRectClip* clip = SkNEW_ARGS(SkRRectClip, (devRRect, bounds));
+    if (clip->quickContains(bounds)) {
+        // the rect misses the corners
+        clip->unref();
+        this->setRect(bounds);
+        return true;
+    }
+    this->setRRect(clip);
+    return true;
+}
+
+// takes ownership of clip, which must not be empty
+void SkRasterClip::setRRect(SkRRectClip* clip) {
+    SkASSERT(clip && !clip->getBounds().isEmpty());
+
+    SkSafeUnref(fRRect);
+    fRRect = clip;
+    fIsBW = false;
+    fBW.setEmpty();
+    fAA.setEmpty();
+    fIsEmpty = false;
+    fIsRect = false;
+}
+
+void SkRasterClip::convertRRectToAA() {
+    SkASSERT(fRRect);
+    fAA = fRRect->aaClip();
+    SkSafeSetNull(fRRect);
+    (void)this->updateCacheAndReturnNonEmpty();
+}
+
 void SkRasterClip::convertToAA() {
     AUTO_RASTERCLIP_VALIDATE(*this);
 
@@ -245,6 +362,9 @@ void SkRasterClip::validate() const {
     if (fIsBW) {
         SkASSERT(fAA.isEmpty());
     }
+    if (fRRect) {
+        SkASSERT(!fIsBW && fAA.isEmpty());
+    }
 
     fBW.validate();
     fAA.validate();
@@ -282,6 +402,12 @@ void SkAAClipBlitterWrapper::init(const SkRasterClip& clip, SkBlitter* blitter)
     if (clip.isBW()) {
         fClipRgn = &clip.bwRgn();
         fBlitter = blitter;
+    } else if (clip.isRRect()) {
+        fBWRgn.setRect(clip.getBounds());
+        fRRectBlitter.init(blitter, clip.rrectClip());
+        // now our return values
+        fClipRgn = &fBWRgn;
+        fBlitter = &fRRectBlitter;
     } else {
         const SkAAClip& aaclip = clip.aaRgn();
         fBWRgn.setRect(aaclip.getBounds());
@@ -10,6 +10,7 @@
 
 #include "SkRegion.h"
 #include "SkAAClip.h"
+#include "SkRRectClip.h"
 
 class SkRasterClip {
 public:
@@ -18,10 +19,23 @@ public:
     SkRasterClip(const SkRasterClip&);
     ~SkRasterClip();
 
+    SkRasterClip& operator=(const SkRasterClip&);
+
     bool isBW() const { return fIsBW; }
     bool isAA() const { return !fIsBW; }
     const SkRegion& bwRgn() const { SkASSERT(fIsBW); return fBW; }
-    const SkAAClip& aaRgn() const { SkASSERT(!fIsBW); return fAA; }
+    const SkAAClip& aaRgn() const {
+        SkASSERT(!fIsBW);
+        return fRRect ? fRRect->aaClip() : fAA;
+    }
+
+    /**
+     *  An AA clip may be a round rect kept analytically, see intersectRRect.
+     *  Blitting through rrectClip() rather than aaRgn() saves building the
+     *  mask of the whole clip.
+     */
+    bool isRRect() const { return NULL != fRRect; }
+    const SkRRectClip* rrectClip() const { SkASSERT(fRRect); return fRRect; }
 
     bool isEmpty() const {
         SkASSERT(this->computeIsEmpty() == fIsEmpty);
@@ -48,6 +62,14 @@ public:
     bool op(const SkRasterClip&, SkRegion::Op);
     bool op(const SkRect&, SkRegion::Op, bool doAA);
 
+    /**
+     *  Intersects the clip with the antialiased round rect in device space,
+     *  keeping it as an SkRRectClip. Returns false if the clip is left
+     *  unchanged because that only works on a rect clip and on a round rect
+     *  whose rect is integral: the caller should intersect with its path.
+     */
+    bool intersectRRect(const SkRRect& devRRect);
+
     void translate(int dx, int dy, SkRasterClip* dst) const;
     void translate(int dx, int dy) {
         this->translate(dx, dy, this);
@@ -80,12 +102,17 @@ public:
 private:
     SkRegion    fBW;
     SkAAClip    fAA;
+    // owned, non-NULL if the clip is a round rect. fIsBW is false then
+    SkRRectClip* fRRect;
     bool        fIsBW;
     // these 2 are caches based on querying the right obj based on fIsBW
     bool        fIsEmpty;
     bool        fIsRect;
 
     bool computeIsEmpty() const {
+        if (fRRect) {
+            return fRRect->getBounds().isEmpty();
+        }
         return fIsBW ? fBW.isEmpty() : fAA.isEmpty();
     }
 
@@ -100,6 +127,8 @@ private:
     }
 
     void convertToAA();
+    void setRRect(SkRRectClip*);
+    void convertRRectToAA();
 };
 
 class SkAutoRasterClipValidate : SkNoncopyable {
@@ -156,6 +185,7 @@ private:
     const SkAAClip* fAAClip;
     SkRegion        fBWRgn;
     SkAAClipBlitter fAABlitter;
+    SkRRectClipBlitter fRRectBlitter;
     // what we return
     const SkRegion* fClipRgn;
     SkBlitter* fBlitter;
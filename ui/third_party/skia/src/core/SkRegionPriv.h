@@ -84,6 +84,9 @@ public:
         return head;
     }
 
+    // the rect sentinel is NULL, and an optimizing compiler may assume this is
+    // never NULL, so only use it to assert on a head known to be allocated.
+    // SkRegion::isComplex() compares the pointer itself.
     bool isComplex() const {
         return this != SkRegion_gEmptyRunHeadPtr && this != SkRegion_gRectRunHeadPtr;
     }
@@ -718,12 +718,8 @@ void SkScan::FillPath(const SkPath& path, const SkRasterClip& clip,
     if (clip.isBW()) {
         FillPath(path, clip.bwRgn(), blitter);
     } else {
-        SkRegion        tmp;
-        SkAAClipBlitter aaBlitter;
-
-        tmp.setRect(clip.getBounds());
-        aaBlitter.init(blitter, &clip.aaRgn());
-        SkScan::FillPath(path, tmp, &aaBlitter);
+        SkAAClipBlitterWrapper wrap(clip, blitter);
+        SkScan::FillPath(path, wrap.getRgn(), wrap.getBlitter());
     }
 }
 
@@ -736,12 +732,8 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRasterClip& clip,
     if (clip.isBW()) {
         AntiFillPath(path, clip.bwRgn(), blitter);
     } else {
-        SkRegion        tmp;
-        SkAAClipBlitter aaBlitter;
-
-        tmp.setRect(clip.getBounds());
-        aaBlitter.init(blitter, &clip.aaRgn());
-        SkScan::AntiFillPath(path, tmp, &aaBlitter, true);
+        SkAAClipBlitterWrapper wrap(clip, blitter);
+        SkScan::AntiFillPath(path, wrap.getRgn(), wrap.getBlitter(), true);
     }
 }
 
@@ -76,13 +76,52 @@ static void backward_insert_edge_based_on_x(SkEdge* edge SkDECLAREPARAM(int, cur
     }
 }
 
+/*  The edges starting on curr_y follow the active edges, sorted by x like
+    them. Rippling each one back costs the number of active edges it passes,
+    so when many start on the same scanline they are merged from the back
+    instead: each one goes after the active edges it passes, starting from
+    where the one after it went, which passes every active edge at most once.
+    Edges of equal x keep their order either way.
+ */
 static void insert_new_edges(SkEdge* newEdge, int curr_y) {
     SkASSERT(newEdge->fFirstY >= curr_y);
 
-    while (newEdge->fFirstY == curr_y) {
-        SkEdge* next = newEdge->fNext;
+    if (newEdge->fFirstY != curr_y) {
+        return;
+    }
+    if (newEdge->fNext->fFirstY != curr_y) {
         backward_insert_edge_based_on_x(newEdge  SkPARAM(curr_y));
-        newEdge = next;
+        return;
+    }
+
+    SkEdge* lastNew = newEdge->fNext;
+    while (lastNew->fNext->fFirstY == curr_y) {
+        lastNew = lastNew->fNext;
+    }
+
+    // unlink the new edges, then put them back from the last
+    SkEdge* insertAfter = newEdge->fPrev;
+    insertAfter->fNext = lastNew->fNext;
+    lastNew->fNext->fPrev = insertAfter;
+
+    SkEdge* edge = lastNew;
+    for (;;) {
+        SkEdge* prevNew = edge->fPrev;
+        SkFixed x = edge->fX;
+
+        // the head edge has the smallest x, so this stops
+        while (insertAfter->fX > x) {
+            insertAfter = insertAfter->fPrev;
+        }
+        edge->fPrev = insertAfter;
+        edge->fNext = insertAfter->fNext;
+        insertAfter->fNext->fPrev = edge;
+        insertAfter->fNext = edge;
+
+        if (edge == newEdge) {
+            break;
+        }
+        edge = prevNew;
     }
 }
 
@@ -407,11 +446,57 @@ static bool operator<(const SkEdge& a, const SkEdge& b) {
 }
 #endif
 
+#ifndef SK_USE_STD_SORT_FOR_EDGES
+/*  Sort the edges into buckets by fFirstY, and then each bucket by fX, which
+    is the same order as operator<. Returns false, leaving list alone, if the
+    edges start on more scanlines than there are edges to fill buckets with.
+ */
+static bool bucket_sort_edges(SkEdge* list[], int count) {
+    int minY = list[0]->fFirstY;
+    int maxY = minY;
+    for (int i = 1; i < count; i++) {
+        minY = SkMin32(minY, list[i]->fFirstY);
+        maxY = SkMax32(maxY, list[i]->fFirstY);
+    }
+    if ((int64_t)maxY - minY >= 2 * (int64_t)count) {
+        return false;
+    }
+    int bucketCount = maxY - minY + 1;
+
+    // ends[b] is where bucket b ends, once the edges are counted into it
+    SkAutoSTArray<256, int> ends(bucketCount + 1);
+    sk_bzero(ends.get(), (bucketCount + 1) * sizeof(int));
+    for (int i = 0; i < count; i++) {
+        ends[list[i]->fFirstY - minY + 1] += 1;
+    }
+    for (int b = 1; b <= bucketCount; b++) {
+        ends[b] += ends[b - 1];
+    }
+
+    SkAutoSTArray<256, SkEdge*> sorted(count);
+    for (int i = 0; i < count; i++) {
+        sorted[ends[list[i]->fFirstY - minY]++] = list[i];
+    }
+    memcpy(list, sorted.get(), count * sizeof(SkEdge*));
+
+    int start = 0;
+    for (int b = 0; b < bucketCount; b++) {
+        if (ends[b] - start > 1) {
+            SkTQSort(list + start, list + ends[b] - 1);
+        }
+        start = ends[b];
+    }
+    return true;
+}
+#endif
+
 static SkEdge* sort_edges(SkEdge* list[], int count, SkEdge** last) {
 #ifdef SK_USE_STD_SORT_FOR_EDGES
     qsort(list, count, sizeof(SkEdge*), edge_compare);
 #else
-    SkTQSort(list, list + count - 1);
+    if (!bucket_sort_edges(list, count)) {
+        SkTQSort(list, list + count - 1);
+    }
 #endif
 
     // now make the edges linked in sorted order
@@ -1778,6 +1778,13 @@ void SkGpuDevice::drawText(const SkDraw& draw, const void* text,
     }
 }
 
+void SkGpuDevice::drawGlyphs(const SkDraw& draw, SkGlyphStrike*,
+                             const uint16_t glyphs[], int count,
+                             SkScalar x, SkScalar y, const SkPaint& paint) {
+    // Text goes through the GPU text context, which keeps its own strikes.
+    this->drawGlyphsAsText(draw, glyphs, count, x, y, paint);
+}
+
 void SkGpuDevice::drawPosText(const SkDraw& draw, const void* text,
                              size_t byteLength, const SkScalar pos[],
                              SkScalar constY, int scalarsPerPos,
@@ -18,6 +18,9 @@
 #include "SkUtils.h"
 
 #include <stdio.h>
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    #include <emmintrin.h>
+#endif
 extern "C" {
     #include "jpeglib.h"
     #include "jerror.h"
@@ -563,6 +566,188 @@ static void Write_Index_YUV(uint8_t* SK_RESTRICT dst,
     }
 }
 
+#ifdef WE_CONVERT_TO_YUV
+
+///////////////////////////////////////////////////////////////////////////////
+
+// 8888 bitmaps skip libjpeg's color conversion and downsampling. Pairs of rows
+// are turned straight into the 4:2:0 Y, Cb and Cr planes, which are handed to
+// jpeg_write_raw_data an iMCU row (16 lines) at a time. The coefficients are
+// the JFIF ones with 15 bits of precision; chroma comes from the sum of each
+// 2x2 block, so it carries 2 more bits than a single pixel.
+
+#define YCC_SHIFT   15
+
+static const int16_t gYWeights[3]  = { 9798, 19235, 3736 };     // r, g, b
+static const int16_t gCbWeights[3] = { -5529, -10855, 16384 };
+static const int16_t gCrWeights[3] = { 16384, -13720, -2664 };
+
+#define Y_ROUND         (1 << (YCC_SHIFT - 1))
+// one less than a half keeps the largest chroma from rounding up to 256.
+#define CHROMA_ROUND    ((128 << (YCC_SHIFT + 2)) + (1 << (YCC_SHIFT + 1)) - 1)
+
+static inline int align_16(int x) {
+    return (x + 15) & ~15;
+}
+
+static inline uint8_t pack_y(uint32_t c) {
+    int y = gYWeights[0] * (int)SkGetPackedR32(c) + gYWeights[1] * (int)SkGetPackedG32(c) +
+            gYWeights[2] * (int)SkGetPackedB32(c);
+    return SkToU8((y + Y_ROUND) >> YCC_SHIFT);
+}
+
+static inline uint8_t pack_chroma(const int16_t weights[3], int r, int g, int b) {
+    return SkToU8((weights[0] * r + weights[1] * g + weights[2] * b + CHROMA_ROUND) >> (YCC_SHIFT + 2));
+}
+
+// Converts columns [x, count) of a pair of rows, x even. Columns past width
+// repeat the last pixel, which is how libjpeg pads the right edge.
+static void rows_to_ycc(const uint32_t* SK_RESTRICT row0, const uint32_t* SK_RESTRICT row1,
+                        int width, int x, int count,
+                        uint8_t* SK_RESTRICT y0, uint8_t* SK_RESTRICT y1,
+                        uint8_t* SK_RESTRICT cb, uint8_t* SK_RESTRICT cr) {
+    for (; x < count; x += 2) {
+        int x0 = SkMin32(x, width - 1);
+        int x1 = SkMin32(x + 1, width - 1);
+        uint32_t c00 = row0[x0], c01 = row0[x1];
+        uint32_t c10 = row1[x0], c11 = row1[x1];
+
+        y0[x] = pack_y(c00);
+        y0[x + 1] = pack_y(c01);
+        y1[x] = pack_y(c10);
+        y1[x + 1] = pack_y(c11);
+
+        int r = SkGetPackedR32(c00) + SkGetPackedR32(c01) + SkGetPackedR32(c10) + SkGetPackedR32(c11);
+        int g = SkGetPackedG32(c00) + SkGetPackedG32(c01) + SkGetPackedG32(c10) + SkGetPackedG32(c11);
+        int b = SkGetPackedB32(c00) + SkGetPackedB32(c01) + SkGetPackedB32(c10) + SkGetPackedB32(c11);
+        cb[x >> 1] = pack_chroma(gCbWeights, r, g, b);
+        cr[x >> 1] = pack_chroma(gCrWeights, r, g, b);
+    }
+}
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+
+// weights of one formula laid out as the bytes of two unpacked pixels, alpha gets 0.
+static __m128i ycc_weights_SSE2(const int16_t weights[3]) {
+    int16_t lanes[8] = { 0 };
+    for (int i = 0; i < 8; i += 4) {
+        lanes[i + SK_R32_SHIFT / 8] = weights[0];
+        lanes[i + SK_G32_SHIFT / 8] = weights[1];
+        lanes[i + SK_B32_SHIFT / 8] = weights[2];
+    }
+    return _mm_loadu_si128((const __m128i*)lanes);
+}
+
+// madd leaves two partial sums per pixel, add them to get one value per pixel.
+static inline __m128i sum_pairs_SSE2(__m128i a, __m128i b) {
+    __m128 even = _mm_shuffle_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b), _MM_SHUFFLE(2, 0, 2, 0));
+    __m128 odd = _mm_shuffle_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b), _MM_SHUFFLE(3, 1, 3, 1));
+    return _mm_add_epi32(_mm_castps_si128(even), _mm_castps_si128(odd));
+}
+
+// Y of 8 pixels, given unpacked as four pairs.
+static inline __m128i pack_y_SSE2(const __m128i px[4], __m128i weights) {
+    const __m128i round = _mm_set1_epi32(Y_ROUND);
+    __m128i y0 = sum_pairs_SSE2(_mm_madd_epi16(px[0], weights), _mm_madd_epi16(px[1], weights));
+    __m128i y1 = sum_pairs_SSE2(_mm_madd_epi16(px[2], weights), _mm_madd_epi16(px[3], weights));
+    y0 = _mm_srai_epi32(_mm_add_epi32(y0, round), YCC_SHIFT);
+    y1 = _mm_srai_epi32(_mm_add_epi32(y1, round), YCC_SHIFT);
+    return _mm_packus_epi16(_mm_packs_epi32(y0, y1), y0);
+}
+
+// one chroma value for each of the four 2x2 sums.
+static inline __m128i pack_chroma_SSE2(__m128i sums01, __m128i sums23, __m128i weights) {
+    const __m128i round = _mm_set1_epi32(CHROMA_ROUND);
+    __m128i c = sum_pairs_SSE2(_mm_madd_epi16(sums01, weights), _mm_madd_epi16(sums23, weights));
+    c = _mm_srai_epi32(_mm_add_epi32(c, round), YCC_SHIFT + 2);
+    c = _mm_packs_epi32(c, c);
+    return _mm_packus_epi16(c, c);
+}
+
+// Converts the first width & ~7 columns, returns how many were done.
+static int rows_to_ycc_SSE2(const uint32_t* SK_RESTRICT row0, const uint32_t* SK_RESTRICT row1,
+                            int width, uint8_t* SK_RESTRICT y0, uint8_t* SK_RESTRICT y1,
+                            uint8_t* SK_RESTRICT cb, uint8_t* SK_RESTRICT cr) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i yWeights = ycc_weights_SSE2(gYWeights);
+    const __m128i cbWeights = ycc_weights_SSE2(gCbWeights);
+    const __m128i crWeights = ycc_weights_SSE2(gCrWeights);
+    int count = width & ~7;
+
+    for (int x = 0; x < count; x += 8) {
+        __m128i px0[4], px1[4], sums[4];
+        __m128i a = _mm_loadu_si128((const __m128i*)(row0 + x));
+        __m128i b = _mm_loadu_si128((const __m128i*)(row0 + x + 4));
+        px0[0] = _mm_unpacklo_epi8(a, zero);
+        px0[1] = _mm_unpackhi_epi8(a, zero);
+        px0[2] = _mm_unpacklo_epi8(b, zero);
+        px0[3] = _mm_unpackhi_epi8(b, zero);
+
+        a = _mm_loadu_si128((const __m128i*)(row1 + x));
+        b = _mm_loadu_si128((const __m128i*)(row1 + x + 4));
+        px1[0] = _mm_unpacklo_epi8(a, zero);
+        px1[1] = _mm_unpackhi_epi8(a, zero);
+        px1[2] = _mm_unpacklo_epi8(b, zero);
+        px1[3] = _mm_unpackhi_epi8(b, zero);
+
+        _mm_storel_epi64((__m128i*)(y0 + x), pack_y_SSE2(px0, yWeights));
+        _mm_storel_epi64((__m128i*)(y1 + x), pack_y_SSE2(px1, yWeights));
+
+        // each register holds two horizontal neighbours, fold the high one onto the low one.
+        for (int i = 0; i < 4; ++i) {
+            sums[i] = _mm_add_epi16(px0[i], px1[i]);
+            sums[i] = _mm_add_epi16(sums[i], _mm_srli_si128(sums[i], 8));
+        }
+        __m128i sums01 = _mm_unpacklo_epi64(sums[0], sums[1]);
+        __m128i sums23 = _mm_unpacklo_epi64(sums[2], sums[3]);
+
+        *(int32_t*)(cb + (x >> 1)) = _mm_cvtsi128_si32(pack_chroma_SSE2(sums01, sums23, cbWeights));
+        *(int32_t*)(cr + (x >> 1)) = _mm_cvtsi128_si32(pack_chroma_SSE2(sums01, sums23, crWeights));
+    }
+
+    return count;
+}
+
+#endif
+
+// Writes a kARGB_8888 bitmap through the raw data interface, cinfo must have
+// been started with raw_data_in set. planes holds 16 rows of align_16(width)
+// luma bytes followed by 8 rows of half that for each chroma plane.
+static void write_raw_8888(jpeg_compress_struct* cinfo, const SkBitmap& bm, uint8_t* planes) {
+    const int width = bm.width();
+    const int height = bm.height();
+    const int lumaStride = align_16(width);
+    const int chromaStride = lumaStride >> 1;
+
+    JSAMPROW yRows[16];
+    JSAMPROW cbRows[8];
+    JSAMPROW crRows[8];
+    for (int i = 0; i < 16; ++i) {
+        yRows[i] = planes + i * lumaStride;
+    }
+    for (int i = 0; i < 8; ++i) {
+        cbRows[i] = planes + 16 * lumaStride + i * chromaStride;
+        crRows[i] = planes + 16 * lumaStride + 8 * chromaStride + i * chromaStride;
+    }
+    JSAMPARRAY image[3] = { yRows, cbRows, crRows };
+
+    for (int y = 0; y < height; y += 16) {
+        for (int i = 0; i < 8; ++i) {
+            // rows past the bottom repeat the last one, as libjpeg does.
+            const uint32_t* row0 = bm.getAddr32(0, SkMin32(y + 2 * i, height - 1));
+            const uint32_t* row1 = bm.getAddr32(0, SkMin32(y + 2 * i + 1, height - 1));
+            int x = 0;
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+            x = rows_to_ycc_SSE2(row0, row1, width, yRows[2 * i], yRows[2 * i + 1], cbRows[i], crRows[i]);
+#endif
+            rows_to_ycc(row0, row1, width, x, lumaStride, yRows[2 * i], yRows[2 * i + 1], cbRows[i], crRows[i]);
+        }
+        (void) jpeg_write_raw_data(cinfo, image, 16);
+    }
+}
+
+#endif
+
 static WriteScanline ChooseWriter(const SkBitmap& bm) {
     switch (bm.config()) {
         case SkBitmap::kARGB_8888_Config:
@@ -601,6 +786,7 @@ protected:
 
         // allocate these before set call setjmp
         SkAutoMalloc    oneRow;
+        SkAutoMalloc    planes;
         SkAutoLockColors ctLocker;
 
         cinfo.err = jpeg_std_error(&sk_err);
@@ -625,6 +811,19 @@ protected:
         jpeg_set_quality(&cinfo, quality, TRUE /* limit to baseline-JPEG values */);
         cinfo.dct_method = JDCT_IFAST;
 
+#ifdef WE_CONVERT_TO_YUV
+        // jpeg_set_defaults picked 2x2 luma sampling for YCbCr, which write_raw_8888 produces.
+        if (SkBitmap::kARGB_8888_Config == bm.config()) {
+            const int lumaStride = align_16(bm.width());
+            cinfo.raw_data_in = TRUE;
+            jpeg_start_compress(&cinfo, TRUE);
+            write_raw_8888(&cinfo, bm, (uint8_t*)planes.reset(16 * lumaStride + 8 * lumaStride));
+            jpeg_finish_compress(&cinfo);
+            jpeg_destroy_compress(&cinfo);
+            return true;
+        }
+#endif
+
         jpeg_start_compress(&cinfo, TRUE);
 
         const int       width = bm.width();
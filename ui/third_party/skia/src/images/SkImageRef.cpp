@@ -7,6 +7,7 @@
  */
 #include "SkImageRef.h"
 #include "SkBitmap.h"
+#include "SkData.h"
 #include "SkFlattenableBuffers.h"
 #include "SkImageDecoder.h"
 #include "SkStream.h"
@@ -31,6 +32,7 @@ SkImageRef::SkImageRef(SkStream* stream, SkBitmap::Config config,
     fDoDither = true;
     fPrev = fNext = NULL;
     fFactory = NULL;
+    fEncodedGenerationID = this->getGenerationID();
 
 #ifdef DUMP_IMAGEREF_LIFECYCLE
     SkDebugf("add ImageRef %p [%d] data=%d\n",
@@ -161,6 +163,41 @@ void SkImageRef::onUnlockPixels() {
     SkASSERT(&gImageRefMutex == this->mutex());
 }
 
+static void unref_stream(const void*, size_t, void* context) {
+    static_cast<SkStream*>(context)->unref();
+}
+
+SkData* SkImageRef::onRefEncodedData() {
+    SkAutoMutexAcquire ac(gImageRefMutex);
+
+    // once the pixels have been written to, the stream no longer matches them
+    if (fErrorInDecoding || this->getGenerationID() != fEncodedGenerationID) {
+        return NULL;
+    }
+
+    size_t length = fStream->getLength();
+    if (0 == length) {
+        return NULL;
+    }
+
+    // a stream in memory is shared, not copied, and the data keeps it alive
+    const void* base = fStream->getMemoryBase();
+    if (base) {
+        fStream->ref();
+        return SkData::NewWithProc(base, length, unref_stream, fStream);
+    }
+
+    // any other stream is read from the position the decoder moves, so it
+    // is copied while decoding is locked out
+    void* buffer = sk_malloc_throw(length);
+    fStream->rewind();
+    if (fStream->read(buffer, length) != length) {
+        sk_free(buffer);
+        return NULL;
+    }
+    return SkData::NewFromMalloc(buffer, length);
+}
+
 size_t SkImageRef::ramUsed() const {
     size_t size = 0;
 
@@ -187,6 +224,7 @@ SkImageRef::SkImageRef(SkFlattenableReadBuffer& buffer)
 
     fPrev = fNext = NULL;
     fFactory = NULL;
+    fEncodedGenerationID = this->getGenerationID();
 }
 
 void SkImageRef::flatten(SkFlattenableWriteBuffer& buffer) const {
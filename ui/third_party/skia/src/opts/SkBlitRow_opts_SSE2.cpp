@@ -762,3 +762,224 @@ void SkBlitLCD16OpaqueRow_SSE2(SkPMColor dst[], const uint16_t src[],
         width--;
     }
 }
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Replicates a 0..256 scale held in each 32-bit lane into both of its 16-bit
+// halves, so the red/blue and alpha/green halves of a pixel share it.
+static inline __m128i SkReplicateScale_SSE2(const __m128i& scale) {
+    return _mm_or_si128(scale, _mm_slli_epi32(scale, 16));
+}
+
+// SSE2 version of SkAlphaMulQ() with a scale per pixel, as replicated by
+// SkReplicateScale_SSE2(). Gives the same results as the portable version.
+static inline __m128i SkAlphaMulQ_SSE2(const __m128i& c, const __m128i& scale) {
+    const __m128i rb_mask = _mm_set1_epi32(0x00FF00FF);
+    __m128i rb = _mm_and_si128(rb_mask, c);
+    __m128i ag = _mm_srli_epi16(c, 8);
+
+    rb = _mm_srli_epi16(_mm_mullo_epi16(rb, scale), 8);
+    ag = _mm_andnot_si128(rb_mask, _mm_mullo_epi16(ag, scale));
+    return _mm_or_si128(rb, ag);
+}
+
+// Blends color onto 4 pixels, each through its own coverage, the same as 4
+// runs of one pixel through SkBlitRow::ColorAntiH32().
+static inline void SkBlendCoverage4_SSE2(SkPMColor* SK_RESTRICT dst,
+                                         const SkAlpha* SK_RESTRICT antialias,
+                                         const __m128i& color) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i c_255 = _mm_set1_epi32(255);
+
+    uint32_t coverage;
+    memcpy(&coverage, antialias, sizeof(coverage));
+    __m128i aa = _mm_cvtsi32_si128(coverage);
+    aa = _mm_unpacklo_epi16(_mm_unpacklo_epi8(aa, zero), zero);
+
+    // sc = SkAlphaMulQ(color, SkAlpha255To256(aa))
+    __m128i src_scale = _mm_add_epi32(aa, _mm_set1_epi32(1));
+    src_scale = SkReplicateScale_SSE2(src_scale);
+    __m128i sc = SkAlphaMulQ_SSE2(color, src_scale);
+
+    // dst = sc + SkAlphaMulQ(dst, 256 - SkAlpha255To256(SkGetPackedA32(sc)))
+    __m128i sc_alpha = _mm_and_si128(_mm_srli_epi32(sc, SK_A32_SHIFT), c_255);
+    __m128i dst_scale = SkReplicateScale_SSE2(_mm_sub_epi32(c_255, sc_alpha));
+    __m128i dst_pixel = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst));
+    __m128i result = _mm_add_epi32(sc, SkAlphaMulQ_SSE2(dst_pixel, dst_scale));
+
+    // pixels without coverage, or whose scaled color rounds to nothing, are
+    // left alone as Color32() does
+    __m128i uncovered = _mm_or_si128(_mm_cmpeq_epi32(aa, zero),
+                                     _mm_cmpeq_epi32(sc, zero));
+    result = _mm_or_si128(_mm_and_si128(uncovered, dst_pixel),
+                          _mm_andnot_si128(uncovered, result));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), result);
+}
+
+/* SSE2 version of SkBlitRow::ColorAntiH32()
+ * portable version is in core/SkBlitRow_D32.cpp
+ */
+void ColorAntiH32_SSE2(SkPMColor* SK_RESTRICT dst,
+                       const SkAlpha* SK_RESTRICT antialias,
+                       const int16_t* SK_RESTRICT runs, SkPMColor color) {
+    // if the color is opaque, then full coverage takes the fast opaque case
+    unsigned opaqueMask = SkGetPackedA32(color);
+    __m128i color_wide = _mm_set1_epi32(color);
+
+    for (;;) {
+        int count = runs[0];
+        SkASSERT(count >= 0);
+        if (count <= 0) {
+            return;
+        }
+
+        // The edges of shallow shapes and of glyphs are runs of single pixels
+        // whose coverage changes every pixel, blend them four at a time.
+        // runs[n] is only read once runs[n - 1] says a pixel follows.
+        if (1 == count && 1 == runs[1] && 1 == runs[2] && 1 == runs[3]) {
+            SkBlendCoverage4_SSE2(dst, antialias, color_wide);
+            runs += 4;
+            antialias += 4;
+            dst += 4;
+            continue;
+        }
+
+        unsigned aa = antialias[0];
+        if (aa) {
+            if ((opaqueMask & aa) == 255) {
+                // runs of full coverage are bulk fills
+                sk_memset32(dst, color, count);
+            } else {
+                SkPMColor sc = SkAlphaMulQ(color, SkAlpha255To256(aa));
+                if (count >= 4) {
+                    Color32_SSE2(dst, dst, count, sc);
+                } else if (sc) {
+                    // too short to pay for the setup of Color32_SSE2
+                    unsigned scale = 256 - SkAlpha255To256(SkGetPackedA32(sc));
+                    for (int i = 0; i < count; i++) {
+                        dst[i] = sc + SkAlphaMulQ(dst[i], scale);
+                    }
+                }
+            }
+        }
+        runs += count;
+        antialias += count;
+        dst += count;
+    }
+}
+
+// Blends the 4 pixels of dst_pixel towards src, per color channel through the
+// matching channel of mask_pixel, the same as blit_lcd32_row() in
+// core/SkBlitMask_D32.cpp. src_alpha is SkAlpha255To256 of the color alpha,
+// or 0 when the color is opaque.
+static inline __m128i SkBlendLCD32_SSE2(const __m128i& src,
+                                        const __m128i& dst_pixel,
+                                        const __m128i& mask_pixel,
+                                        const __m128i& src_alpha,
+                                        bool isOpaque) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i c_1 = _mm_set1_epi16(1);
+    const __m128i c_256 = _mm_set1_epi16(256);
+
+    // SkAlpha255To256 of each mask channel, scaled by the color alpha
+    __m128i scale_lo = _mm_add_epi16(_mm_unpacklo_epi8(mask_pixel, zero), c_1);
+    __m128i scale_hi = _mm_add_epi16(_mm_unpackhi_epi8(mask_pixel, zero), c_1);
+    if (!isOpaque) {
+        scale_lo = _mm_srli_epi16(_mm_mullo_epi16(scale_lo, src_alpha), 8);
+        scale_hi = _mm_srli_epi16(_mm_mullo_epi16(scale_hi, src_alpha), 8);
+    }
+
+    // SkAlphaBlend(src, dst, scale) is dst + ((src - dst) * scale >> 8), which
+    // equals (dst * (256 - scale) + src * scale) >> 8 without going negative.
+    __m128i dst_lo = _mm_unpacklo_epi8(dst_pixel, zero);
+    __m128i dst_hi = _mm_unpackhi_epi8(dst_pixel, zero);
+    __m128i result_lo = _mm_add_epi16(
+            _mm_mullo_epi16(dst_lo, _mm_sub_epi16(c_256, scale_lo)),
+            _mm_mullo_epi16(src, scale_lo));
+    __m128i result_hi = _mm_add_epi16(
+            _mm_mullo_epi16(dst_hi, _mm_sub_epi16(c_256, scale_hi)),
+            _mm_mullo_epi16(src, scale_hi));
+    result_lo = _mm_srli_epi16(result_lo, 8);
+    result_hi = _mm_srli_epi16(result_hi, 8);
+
+    // LCD blitting is only supported if the dst is known/required to be opaque
+    __m128i result = _mm_or_si128(_mm_packus_epi16(result_lo, result_hi),
+                                  _mm_set1_epi32(SK_A32_MASK << SK_A32_SHIFT));
+
+    // pixels with an empty mask are left alone
+    __m128i uncovered = _mm_cmpeq_epi32(mask_pixel, zero);
+    return _mm_or_si128(_mm_and_si128(uncovered, dst_pixel),
+                        _mm_andnot_si128(uncovered, result));
+}
+
+static void SkBlitLCD32Mask_SSE2(void* device, size_t dstRB,
+                                 const void* maskPtr, size_t maskRB,
+                                 SkColor color, int width, int height,
+                                 bool isOpaque) {
+    int srcA = SkAlpha255To256(SkColorGetA(color));
+    int srcR = SkColorGetR(color);
+    int srcG = SkColorGetG(color);
+    int srcB = SkColorGetB(color);
+
+    __m128i src = _mm_set1_epi32(SkPackARGB32(0xFF, srcR, srcG, srcB));
+    src = _mm_unpacklo_epi8(src, _mm_setzero_si128());
+    __m128i src_alpha = _mm_set1_epi16(srcA);
+
+    SkPMColor* dstRow = (SkPMColor*)device;
+    const SkPMColor* maskRow = (const SkPMColor*)maskPtr;
+    do {
+        SkPMColor* dst = dstRow;
+        const SkPMColor* mask = maskRow;
+        int count = width;
+
+        while (count >= 4) {
+            __m128i mask_pixel = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(mask));
+
+            // glyph masks are mostly empty, skip blending those pixels
+            if (0xFFFF != _mm_movemask_epi8(_mm_cmpeq_epi32(mask_pixel,
+                                               _mm_setzero_si128()))) {
+                __m128i* d = reinterpret_cast<__m128i*>(dst);
+                __m128i result = SkBlendLCD32_SSE2(src, _mm_loadu_si128(d),
+                                                   mask_pixel, src_alpha,
+                                                   isOpaque);
+                _mm_storeu_si128(d, result);
+            }
+            dst += 4;
+            mask += 4;
+            count -= 4;
+        }
+
+        if (count > 0) {
+            // finish the row through a copy so no pixel outside it is touched
+            SkPMColor dstTail[4] = { 0, 0, 0, 0 };
+            SkPMColor maskTail[4] = { 0, 0, 0, 0 };
+            memcpy(dstTail, dst, count * sizeof(SkPMColor));
+            memcpy(maskTail, mask, count * sizeof(SkPMColor));
+
+            __m128i* d = reinterpret_cast<__m128i*>(dstTail);
+            __m128i result = SkBlendLCD32_SSE2(src, _mm_loadu_si128(d),
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(maskTail)),
+                    src_alpha, isOpaque);
+            _mm_storeu_si128(d, result);
+            memcpy(dst, dstTail, count * sizeof(SkPMColor));
+        }
+
+        dstRow = (SkPMColor*)((char*)dstRow + dstRB);
+        maskRow = (const SkPMColor*)((const char*)maskRow + maskRB);
+    } while (--height != 0);
+}
+
+void SkARGB32_LCD32_BlitMask_SSE2(void* device, size_t dstRB, const void* mask,
+                                  size_t maskRB, SkColor color,
+                                  int width, int height) {
+    SkBlitLCD32Mask_SSE2(device, dstRB, mask, maskRB, color, width, height,
+                         false);
+}
+
+void SkARGB32_LCD32_Opaque_BlitMask_SSE2(void* device, size_t dstRB,
+                                         const void* mask, size_t maskRB,
+                                         SkColor color, int width, int height) {
+    SkBlitLCD32Mask_SSE2(device, dstRB, mask, maskRB, color, width, height,
+                         true);
+}
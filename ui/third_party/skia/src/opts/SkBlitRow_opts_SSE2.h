@@ -24,6 +24,17 @@ void SkARGB32_A8_BlitMask_SSE2(void* device, size_t dstRB, const void* mask,
                                size_t maskRB, SkColor color,
                                int width, int height);
 
+void ColorAntiH32_SSE2(SkPMColor* SK_RESTRICT dst,
+                       const SkAlpha* SK_RESTRICT antialias,
+                       const int16_t* SK_RESTRICT runs, SkPMColor color);
+
+void SkARGB32_LCD32_BlitMask_SSE2(void* device, size_t dstRB, const void* mask,
+                                  size_t maskRB, SkColor color,
+                                  int width, int height);
+void SkARGB32_LCD32_Opaque_BlitMask_SSE2(void* device, size_t dstRB,
+                                         const void* mask, size_t maskRB,
+                                         SkColor color, int width, int height);
+
 void SkBlitLCD16Row_SSE2(SkPMColor dst[], const uint16_t src[],
                          SkColor color, int width, SkPMColor);
 void SkBlitLCD16OpaqueRow_SSE2(SkPMColor dst[], const uint16_t src[],
@@ -389,6 +389,10 @@ SkBlitRow::ColorProc SkBlitRow::PlatformColorProc() {
     return SK_ARM_NEON_WRAP(Color32_arm);
 }
 
+SkBlitRow::ColorAntiHProc SkBlitRow::PlatformColorAntiHProc() {
+    return NULL;
+}
+
 SkBlitMask::ColorProc SkBlitMask::PlatformColorProcs(SkBitmap::Config dstConfig,
                                                      SkMask::Format maskFormat,
                                                      SkColor color) {
@@ -26,6 +26,10 @@ SkBlitRow::ColorProc SkBlitRow::PlatformColorProc() {
     return NULL;
 }
 
+SkBlitRow::ColorAntiHProc SkBlitRow::PlatformColorAntiHProc() {
+    return NULL;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 SkBlitMask::ColorProc SkBlitMask::PlatformColorProcs(SkBitmap::Config dstConfig,
@@ -168,6 +168,14 @@ SkBlitRow::ColorProc SkBlitRow::PlatformColorProc() {
     }
 }
 
+SkBlitRow::ColorAntiHProc SkBlitRow::PlatformColorAntiHProc() {
+    if (cachedHasSSE2()) {
+        return ColorAntiH32_SSE2;
+    } else {
+        return NULL;
+    }
+}
+
 SkBlitRow::Proc32 SkBlitRow::PlatformProcs32(unsigned flags) {
     if (cachedHasSSE2()) {
         return platform_32_procs[flags];
@@ -180,7 +188,8 @@ SkBlitRow::Proc32 SkBlitRow::PlatformProcs32(unsigned flags) {
 SkBlitMask::ColorProc SkBlitMask::PlatformColorProcs(SkBitmap::Config dstConfig,
                                                      SkMask::Format maskFormat,
                                                      SkColor color) {
-    if (SkMask::kA8_Format != maskFormat) {
+    if (SkMask::kA8_Format != maskFormat &&
+        SkMask::kLCD32_Format != maskFormat) {
         return NULL;
     }
 
@@ -188,9 +197,13 @@ SkBlitMask::ColorProc SkBlitMask::PlatformColorProcs(SkBitmap::Config dstConfig,
     if (cachedHasSSE2()) {
         switch (dstConfig) {
             case SkBitmap::kARGB_8888_Config:
+                if (SkMask::kLCD32_Format == maskFormat) {
+                    proc = (0xFF == SkColorGetA(color)) ?
+                           SkARGB32_LCD32_Opaque_BlitMask_SSE2 :
+                           SkARGB32_LCD32_BlitMask_SSE2;
                 // The SSE2 version is not (yet) faster for black, so we check
                 // for that.
-                if (SK_ColorBLACK != color) {
+                } else if (SK_ColorBLACK != color) {
                     proc = SkARGB32_A8_BlitMask_SSE2;
                 }
                 break;
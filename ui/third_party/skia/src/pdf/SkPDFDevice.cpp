@@ -422,7 +422,10 @@ SkDevice* SkPDFDevice::onCreateCompatibleDevice(SkBitmap::Config config,
     SkMatrix initialTransform;
     initialTransform.reset();
     SkISize size = SkISize::Make(width, height);
-    return SkNEW_ARGS(SkPDFDevice, (size, size, initialTransform));
+    SkPDFDevice* device = SkNEW_ARGS(SkPDFDevice,
+                                     (size, size, initialTransform));
+    device->setImageDownsampleDpi(fImageDownsampleDpi, fImagePool);
+    return device;
 }
 
 
@@ -514,6 +517,8 @@ SkPDFDevice::SkPDFDevice(const SkISize& pageSize, const SkISize& contentSize,
       fContentSize(contentSize),
       fLastContentEntry(NULL),
       fLastMarginContentEntry(NULL),
+      fImageDownsampleDpi(0),
+      fImagePool(NULL),
       fClipStack(NULL) {
     // Skia generally uses the top left as the origin but PDF natively has the
     // origin at the bottom left. This matrix corrects for that.  But that only
@@ -539,6 +544,8 @@ SkPDFDevice::SkPDFDevice(const SkISize& layerSize,
       fExistingClipRegion(existingClipRegion),
       fLastContentEntry(NULL),
       fLastMarginContentEntry(NULL),
+      fImageDownsampleDpi(0),
+      fImagePool(NULL),
       fClipStack(NULL) {
     fInitialTransform.reset();
     this->init();
@@ -995,6 +1002,11 @@ void SkPDFDevice::setLastContentEntry(ContentEntry* contentEntry) {
     }
 }
 
+void SkPDFDevice::setImageDownsampleDpi(SkScalar dpi, SkThreadPool* pool) {
+    fImageDownsampleDpi = dpi;
+    fImagePool = pool;
+}
+
 void SkPDFDevice::setDrawingArea(DrawingArea drawingArea) {
     // A ScopedContentEntry only exists during the course of a draw call, so
     // this can't be called while a ScopedContentEntry exists.
@@ -1607,7 +1619,28 @@ void SkPDFDevice::internalDrawBitmap(const SkMatrix& matrix,
         return;
     }
 
-    SkPDFImage* image = SkPDFImage::CreateImage(bitmap, subset, paint);
+    SkISize downsampleSize;
+    const SkISize* downsample = NULL;
+    if (fImageDownsampleDpi > 0) {
+        // Page units are points, 1/72 of an inch.
+        SkMatrix pageMatrix = matrix;
+        pageMatrix.postConcat(fInitialTransform);
+        SkVector extent[2];
+        extent[0].set(SkIntToScalar(subset.width()), 0);
+        extent[1].set(0, SkIntToScalar(subset.height()));
+        pageMatrix.mapVectors(extent, 2);
+        downsampleSize.set(
+            SkScalarCeilToInt(SkScalarMulDiv(extent[0].length(),
+                                             fImageDownsampleDpi,
+                                             SkIntToScalar(72))),
+            SkScalarCeilToInt(SkScalarMulDiv(extent[1].length(),
+                                             fImageDownsampleDpi,
+                                             SkIntToScalar(72))));
+        downsample = &downsampleSize;
+    }
+
+    SkPDFImage* image = SkPDFImage::CreateImage(bitmap, subset, paint,
+                                                downsample, fImagePool);
     if (!image) {
         return;
     }
@@ -14,6 +14,9 @@
 #include "SkPDFPage.h"
 #include "SkPDFTypes.h"
 #include "SkStream.h"
+#include "SkThreadPool.h"
+
+static const int kImagePoolThreadCount = 4;
 
 // Add the resources, starting at firstIndex to the catalog, removing any dupes.
 // A hash table would be really nice here.
@@ -78,6 +81,10 @@ SkPDFDocument::~SkPDFDocument() {
 
     fDocCatalog->unref();
     SkSafeUnref(fTrailerDict);
+
+    // Waits for the images still being downsampled, they hold their own
+    // references.
+    fImagePool.reset(NULL);
 }
 
 bool SkPDFDocument::emitPDF(SkWStream* stream) {
@@ -276,3 +283,10 @@ void SkPDFDocument::emitFooter(SkWStream* stream, int64_t objCount) {
     stream->writeBigDecAsText(fXRefFileOffset);
     stream->writeText("\n%%EOF");
 }
+
+SkThreadPool* SkPDFDocument::getImagePool() {
+    if (NULL == fImagePool.get()) {
+        fImagePool.reset(new SkThreadPool(kImagePoolThreadCount));
+    }
+    return fImagePool.get();
+}
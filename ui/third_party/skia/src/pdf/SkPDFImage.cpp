@@ -10,14 +10,21 @@
 #include "SkPDFImage.h"
 
 #include "SkBitmap.h"
+#include "SkCanvas.h"
 #include "SkColor.h"
 #include "SkColorPriv.h"
+#include "SkCondVar.h"
+#include "SkData.h"
+#include "SkImageEncoder.h"
 #include "SkPaint.h"
 #include "SkPackBits.h"
 #include "SkPDFCatalog.h"
+#include "SkPixelRef.h"
 #include "SkRect.h"
+#include "SkRunnable.h"
 #include "SkStream.h"
 #include "SkString.h"
+#include "SkThreadPool.h"
 #include "SkUnPreMultiply.h"
 
 namespace {
@@ -246,16 +253,292 @@ SkPDFArray* makeIndexedColorSpace(SkColorTable* table) {
     return result;
 }
 
+// What the DCTDecode filter needs to know about a JPEG beyond its pixels.
+struct JpegHeader {
+    int fWidth;
+    int fHeight;
+    int fComponents;
+    // The color transform of the Adobe APP14 segment: 0 for none (RGB or
+    // CMYK), 1 for YCbCr, 2 for YCCK.  -1 without an Adobe segment.
+    int fAdobeTransform;
+    // Three components named R, G and B, which decoders take as untransformed.
+    bool fRGBComponentIds;
+};
+
+// Reads the markers of a JPEG up to its first scan.  Returns false for
+// anything the PDF DCTDecode filter can't take as is (12 bit samples,
+// arithmetic coding, lossless or hierarchical frames) and for component
+// counts with no PDF color space.
+bool parseJpegHeader(const SkData* data, JpegHeader* header) {
+    const uint8_t* bytes = data->bytes();
+    const size_t length = data->size();
+    if (length < 4 || bytes[0] != 0xFF || bytes[1] != 0xD8) {
+        return false;
+    }
+
+    bool hasFrame = false;
+    header->fAdobeTransform = -1;
+    header->fRGBComponentIds = false;
+
+    size_t offset = 2;
+    while (offset + 4 <= length) {
+        if (bytes[offset] != 0xFF) {
+            return false;
+        }
+        const uint8_t marker = bytes[offset + 1];
+        if (marker == 0xFF) {  // Fill byte.
+            offset++;
+            continue;
+        }
+        offset += 2;
+        if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7)) {
+            continue;  // Markers without a segment.
+        }
+        if (marker == 0xD9 || marker == 0xDA) {
+            // The frame and Adobe segments come before the first scan.
+            return hasFrame;
+        }
+
+        const size_t segment = (bytes[offset] << 8) | bytes[offset + 1];
+        if (segment < 2 || offset + segment > length) {
+            return false;
+        }
+        const uint8_t* payload = bytes + offset + 2;
+        if (marker == 0xC0 || marker == 0xC1 || marker == 0xC2) {
+            if (hasFrame || segment < 8 || payload[0] != 8) {
+                return false;
+            }
+            header->fHeight = (payload[1] << 8) | payload[2];
+            header->fWidth = (payload[3] << 8) | payload[4];
+            header->fComponents = payload[5];
+            if (header->fWidth <= 0 || header->fHeight <= 0 ||
+                    (header->fComponents != 1 && header->fComponents != 3 &&
+                     header->fComponents != 4) ||
+                    segment < 8 + 3 * (size_t)header->fComponents) {
+                return false;
+            }
+            header->fRGBComponentIds = header->fComponents == 3 &&
+                payload[6] == 'R' && payload[9] == 'G' && payload[12] == 'B';
+            hasFrame = true;
+        } else if (marker >= 0xC3 && marker <= 0xCF && marker != 0xC4 &&
+                marker != 0xC8 && marker != 0xCC) {
+            return false;
+        } else if (marker == 0xEE && segment >= 14 &&
+                !memcmp(payload, "Adobe", 5)) {
+            header->fAdobeTransform = payload[11];
+        }
+        offset += segment;
+    }
+    return false;
+}
+
+// Returns the JPEG the bitmap was decoded from if the whole, unmodified
+// bitmap is drawn, NULL otherwise.
+SkData* refJpegData(const SkBitmap& bitmap, const SkIRect& srcRect,
+                    JpegHeader* header) {
+    SkPixelRef* pixelRef = bitmap.pixelRef();
+    if (!pixelRef || !bitmap.isOpaque() ||
+            srcRect != SkIRect::MakeWH(bitmap.width(), bitmap.height())) {
+        return NULL;
+    }
+
+    SkData* data = pixelRef->refEncodedData();
+    if (!data) {
+        return NULL;
+    }
+
+    // The size check also rejects bitmaps that are a subset of the pixel ref
+    // or were decoded with a sample size.
+    if (!parseJpegHeader(data, header) ||
+            header->fWidth != bitmap.width() ||
+            header->fHeight != bitmap.height()) {
+        data->unref();
+        return NULL;
+    }
+    return data;
+}
+
+bool canDownsample(SkBitmap::Config config) {
+    return config == SkBitmap::kIndex8_Config ||
+           config == SkBitmap::kARGB_4444_Config ||
+           config == SkBitmap::kRGB_565_Config ||
+           config == SkBitmap::kARGB_8888_Config;
+}
+
+// Scales source to size.  Large reductions are filtered through the mip
+// levels of the source so that detail averages out instead of aliasing.
+bool resampleBitmap(const SkBitmap& source, const SkISize& size,
+                    SkBitmap* dst) {
+    SkBitmap source32;
+    if (source.config() == SkBitmap::kARGB_8888_Config) {
+        source32 = source;
+    } else if (!source.copyTo(&source32, SkBitmap::kARGB_8888_Config)) {
+        return false;
+    }
+    source32.buildMipMap();
+
+    dst->setConfig(SkBitmap::kARGB_8888_Config, size.width(), size.height());
+    if (!dst->allocPixels()) {
+        return false;
+    }
+    dst->eraseColor(SK_ColorTRANSPARENT);
+
+    SkCanvas canvas(*dst);
+    SkPaint paint;
+    paint.setFilterBitmap(true);
+    paint.setXfermodeMode(SkXfermode::kSrc_Mode);
+    canvas.drawBitmapRect(source32, NULL,
+                          SkRect::MakeWH(SkIntToScalar(size.width()),
+                                         SkIntToScalar(size.height())),
+                          &paint);
+    dst->setIsOpaque(source.isOpaque());
+    return true;
+}
+
+SkStream* encodeJpeg(const SkBitmap& bitmap) {
+    static const int kResampledJpegQuality = 90;
+
+    SkDynamicMemoryWStream jpeg;
+    if (!SkImageEncoder::EncodeStream(&jpeg, bitmap, SkImageEncoder::kJPEG_Type,
+                                      kResampledJpegQuality)) {
+        return NULL;
+    }
+    SkMemoryStream* stream = new SkMemoryStream;
+    stream->setData(jpeg.copyToData())->unref();
+    return stream;
+}
+
+SkStream* createFilledStream(size_t length, uint8_t value) {
+    SkMemoryStream* stream = new SkMemoryStream(length);
+    memset((void*)stream->getMemoryBase(), value, length);
+    return stream;
+}
+
 };  // namespace
 
+// Resamples a bitmap and fills the data of its deferred image and soft mask.
+// The task keeps a reference to both and deletes itself when done.
+class SkPDFImage::ResampleTask : public SkRunnable {
+public:
+    ResampleTask(const SkBitmap& source, const SkISize& size, bool encodeJpeg,
+                 SkPDFImage* image, SkPDFImage* mask)
+        : fSource(source),
+          fSize(size),
+          fEncodeJpeg(encodeJpeg),
+          fImage(image),
+          fMask(mask) {
+        fImage->ref();
+        SkSafeRef(fMask);
+    }
+
+    virtual void run() SK_OVERRIDE {
+        SkStream* imageData = NULL;
+        SkStream* alphaData = NULL;
+        const char* filter = NULL;
+
+        SkBitmap scaled;
+        if (resampleBitmap(fSource, fSize, &scaled)) {
+            if (fEncodeJpeg) {
+                imageData = encodeJpeg(scaled);
+                filter = imageData ? "DCTDecode" : NULL;
+            }
+            if (!imageData) {
+                extractImageData(scaled, SkIRect::MakeWH(fSize.width(),
+                                                         fSize.height()),
+                                 &imageData, &alphaData);
+            }
+        }
+
+        // The dictionaries were written before the pixels were known, so
+        // restore the planes extractImageData leaves out when the image is
+        // fully transparent or fully opaque.
+        const size_t pixelCount = fSize.width() * fSize.height();
+        if (fMask && !alphaData) {
+            alphaData = createFilledStream(pixelCount, imageData ? 0xFF : 0);
+        }
+        if (!imageData) {
+            imageData = createFilledStream(pixelCount * 3, 0);
+        }
+
+        fImage->setDeferredData(imageData, filter);
+        if (fMask) {
+            fMask->setDeferredData(alphaData, NULL);
+        }
+
+        imageData->unref();
+        SkSafeUnref(alphaData);
+        fImage->unref();
+        SkSafeUnref(fMask);
+        delete this;
+    }
+
+private:
+    SkBitmap fSource;
+    SkISize fSize;
+    bool fEncodeJpeg;
+    SkPDFImage* fImage;
+    SkPDFImage* fMask;
+};
+
 // static
 SkPDFImage* SkPDFImage::CreateImage(const SkBitmap& bitmap,
                                     const SkIRect& srcRect,
-                                    const SkPaint& paint) {
+                                    const SkPaint& paint,
+                                    const SkISize* downsampleSize,
+                                    SkThreadPool* pool) {
     if (bitmap.getConfig() == SkBitmap::kNo_Config) {
         return NULL;
     }
 
+    JpegHeader jpegHeader;
+    SkData* jpegData = refJpegData(bitmap, srcRect, &jpegHeader);
+    SkAutoUnref unrefJpegData(jpegData);
+
+    const bool downsample = downsampleSize && !downsampleSize->isEmpty() &&
+        bitmap.pixelRef() && canDownsample(bitmap.getConfig()) &&
+        (downsampleSize->width() < srcRect.width() ||
+         downsampleSize->height() < srcRect.height());
+
+    if (jpegData && !downsample) {
+        return new SkPDFImage(jpegData, jpegHeader.fWidth, jpegHeader.fHeight,
+                              jpegHeader.fComponents,
+                              jpegHeader.fAdobeTransform,
+                              jpegHeader.fRGBComponentIds);
+    }
+
+    if (downsample) {
+        SkBitmap source;
+        if (!bitmap.extractSubset(&source, srcRect)) {
+            return NULL;
+        }
+        // The caller may change the pixels once the draw returns.
+        if (!source.pixelRef()->isImmutable()) {
+            SkBitmap copy;
+            if (!source.copyTo(&copy, source.config())) {
+                return NULL;
+            }
+            source.swap(copy);
+        }
+
+        SkISize size = SkISize::Make(
+            SkMin32(downsampleSize->width(), srcRect.width()),
+            SkMin32(downsampleSize->height(), srcRect.height()));
+        SkPDFImage* image = CreateDeferredImage(size, false, paint);
+        SkPDFImage* mask = NULL;
+        if (!source.isOpaque()) {
+            mask = image->addSMask(CreateDeferredImage(size, true, paint));
+            mask->unref();  // addSMask took its own reference.
+        }
+        ResampleTask* task = new ResampleTask(source, size, jpegData != NULL,
+                                              image, mask);
+        if (pool) {
+            pool->add(task);
+        } else {
+            task->run();
+        }
+        return image;
+    }
+
     SkStream* imageData = NULL;
     SkStream* alphaData = NULL;
     extractImageData(bitmap, srcRect, &imageData, &alphaData);
@@ -278,6 +561,18 @@ SkPDFImage* SkPDFImage::CreateImage(const SkBitmap& bitmap,
 
 SkPDFImage::~SkPDFImage() {
     fResources.unrefAll();
+    delete fDataReady;
+}
+
+void SkPDFImage::emitObject(SkWStream* stream, SkPDFCatalog* catalog,
+                            bool indirect) {
+    this->waitForData();
+    SkPDFStream::emitObject(stream, catalog, indirect);
+}
+
+size_t SkPDFImage::getOutputSize(SkPDFCatalog* catalog, bool indirect) {
+    this->waitForData();
+    return SkPDFStream::getOutputSize(catalog, indirect);
 }
 
 SkPDFImage* SkPDFImage::addSMask(SkPDFImage* mask) {
@@ -293,7 +588,9 @@ void SkPDFImage::getResources(SkTDArray<SkPDFObject*>* resourceList) {
 
 SkPDFImage::SkPDFImage(SkStream* imageData, const SkBitmap& bitmap,
                        const SkIRect& srcRect, bool doingAlpha,
-                       const SkPaint& paint) {
+                       const SkPaint& paint)
+    : fDataReady(NULL),
+      fHasData(true) {
     this->setData(imageData);
     SkBitmap::Config config = bitmap.getConfig();
     bool alphaOnly = (config == SkBitmap::kA1_Config ||
@@ -355,3 +652,85 @@ SkPDFImage::SkPDFImage(SkStream* imageData, const SkBitmap& bitmap,
         insert("Decode", decodeValue.get());
     }
 }
+
+SkPDFImage::SkPDFImage(SkData* jpegData, int width, int height,
+                       int components, int adobeTransform,
+                       bool rgbComponentIds)
+    : fDataReady(NULL),
+      fHasData(true) {
+    insertName("Type", "XObject");
+    insertName("Subtype", "Image");
+    insertInt("Width", width);
+    insertInt("Height", height);
+    if (components == 1) {
+        insertName("ColorSpace", "DeviceGray");
+    } else if (components == 3) {
+        insertName("ColorSpace", "DeviceRGB");
+    } else {
+        insertName("ColorSpace", "DeviceCMYK");
+    }
+    insertInt("BitsPerComponent", 8);
+
+    // DCTDecode follows the transform of an Adobe segment.  Without one it
+    // takes three components as YCbCr, which a JPEG naming them R, G and B
+    // is not.
+    if (adobeTransform < 0 && rgbComponentIds) {
+        SkAutoTUnref<SkPDFDict> decodeParms(new SkPDFDict);
+        decodeParms->insertInt("ColorTransform", 0);
+        insert("DecodeParms", decodeParms.get());
+    }
+
+    // Adobe applications write CMYK and YCCK JPEGs with inverted values.
+    if (components == 4 && adobeTransform >= 0) {
+        SkAutoTUnref<SkPDFArray> decode(new SkPDFArray);
+        decode->reserve(8);
+        for (int i = 0; i < 4; i++) {
+            decode->appendInt(1);
+            decode->appendInt(0);
+        }
+        insert("Decode", decode.get());
+    }
+
+    SkMemoryStream* stream = new SkMemoryStream;
+    stream->setData(jpegData);
+    this->setEncodedData(stream, "DCTDecode");
+    stream->unref();
+}
+
+// static
+SkPDFImage* SkPDFImage::CreateDeferredImage(const SkISize& size, bool alpha,
+                                            const SkPaint& paint) {
+    SkBitmap bitmap;
+    bitmap.setConfig(SkBitmap::kARGB_8888_Config, size.width(), size.height());
+    SkPDFImage* image = new SkPDFImage(NULL, bitmap,
+                                       SkIRect::MakeWH(size.width(),
+                                                       size.height()),
+                                       alpha, paint);
+    image->fDataReady = new SkCondVar;
+    image->fHasData = false;
+    return image;
+}
+
+void SkPDFImage::setDeferredData(SkStream* data, const char filter[]) {
+    SkASSERT(fDataReady);
+    fDataReady->lock();
+    if (filter) {
+        this->setEncodedData(data, filter);
+    } else {
+        this->setData(data);
+    }
+    fHasData = true;
+    fDataReady->broadcast();
+    fDataReady->unlock();
+}
+
+void SkPDFImage::waitForData() {
+    if (NULL == fDataReady) {
+        return;
+    }
+    fDataReady->lock();
+    while (!fHasData) {
+        fDataReady->wait();
+    }
+    fDataReady->unlock();
+}
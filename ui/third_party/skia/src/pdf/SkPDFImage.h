@@ -13,10 +13,14 @@
 #include "SkPDFStream.h"
 #include "SkPDFTypes.h"
 #include "SkRefCnt.h"
+#include "SkSize.h"
 
 class SkBitmap;
+class SkCondVar;
+class SkData;
 class SkPaint;
 class SkPDFCatalog;
+class SkThreadPool;
 struct SkIRect;
 
 /** \class SkPDFImage
@@ -30,15 +34,24 @@ struct SkIRect;
 class SkPDFImage : public SkPDFStream {
 public:
     /** Create a new Image XObject to represent the passed bitmap.
+     *  If the whole bitmap is drawn and its pixel ref still holds the JPEG it
+     *  was decoded from, that JPEG is embedded as is (DCTDecode).
      *  @param bitmap   The image to encode.
      *  @param srcRect  The rectangle to cut out of bitmap.
      *  @param paint    Used to calculate alpha, masks, etc.
+     *  @param downsampleSize  If not NULL and smaller than srcRect, the image
+     *                  is resampled to this size.
+     *  @param pool     Runs the resampling and the extraction of the image
+     *                  data, emitting the image waits for them.  If NULL
+     *                  they run before CreateImage returns.
      *  @return  The image XObject or NUll if there is nothing to draw for
      *           the given parameters.
      */
     static SkPDFImage* CreateImage(const SkBitmap& bitmap,
                                    const SkIRect& srcRect,
-                                   const SkPaint& paint);
+                                   const SkPaint& paint,
+                                   const SkISize* downsampleSize = NULL,
+                                   SkThreadPool* pool = NULL);
 
     virtual ~SkPDFImage();
 
@@ -49,11 +62,20 @@ public:
     SkPDFImage* addSMask(SkPDFImage* mask);
 
     // The SkPDFObject interface.
+    virtual void emitObject(SkWStream* stream, SkPDFCatalog* catalog,
+                            bool indirect);
+    virtual size_t getOutputSize(SkPDFCatalog* catalog, bool indirect);
     virtual void getResources(SkTDArray<SkPDFObject*>* resourceList);
 
 private:
+    class ResampleTask;
+
     SkTDArray<SkPDFObject*> fResources;
 
+    // Only set for images whose data is produced by a ResampleTask.
+    SkCondVar* fDataReady;
+    bool fHasData;
+
     /** Create a PDF image XObject. Entries for the image properties are
      *  automatically added to the stream dictionary.
      *  @param imageData  The final raw bits representing the image.
@@ -65,6 +87,27 @@ private:
      */
     SkPDFImage(SkStream* imageData, const SkBitmap& bitmap,
                const SkIRect& srcRect, bool alpha, const SkPaint& paint);
+
+    /** Create a PDF image XObject from a baseline or progressive JPEG.
+     *  @param jpegData    The JPEG file, embedded unchanged.
+     *  @param width       The width from the JPEG frame header.
+     *  @param height      The height from the JPEG frame header.
+     *  @param components  1 for gray scale, 3 for RGB or YCbCr, 4 for CMYK
+     *                     or YCCK JPEGs.
+     *  @param adobeTransform   The color transform of the Adobe APP14
+     *                     segment, -1 if the JPEG has none.
+     *  @param rgbComponentIds  True if the three components are named R, G
+     *                     and B, which marks them as untransformed.
+     */
+    SkPDFImage(SkData* jpegData, int width, int height, int components,
+               int adobeTransform, bool rgbComponentIds);
+
+    /** Create an image whose data is set later by a ResampleTask.
+     */
+    static SkPDFImage* CreateDeferredImage(const SkISize& size, bool alpha,
+                                           const SkPaint& paint);
+    void setDeferredData(SkStream* data, const char filter[]);
+    void waitForData();
 };
 
 #endif
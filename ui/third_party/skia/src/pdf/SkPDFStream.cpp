@@ -87,6 +87,14 @@ void SkPDFStream::setData(SkStream* stream) {
     fData = stream;
 }
 
+void SkPDFStream::setEncodedData(SkStream* stream, const char filter[]) {
+    SkASSERT(fState == kUnused_State);
+    fData = stream;
+    insertName("Filter", filter);
+    insertInt("Length", fData->getLength());
+    fState = kCompressed_State;
+}
+
 bool SkPDFStream::populate(SkPDFCatalog* catalog) {
     if (fState == kUnused_State) {
         if (!skip_compression(catalog) && SkFlate::HaveFlate()) {
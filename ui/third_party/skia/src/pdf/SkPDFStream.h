@@ -51,6 +51,11 @@ protected:
 
     void setData(SkStream* stream);
 
+    /* Set data that is already encoded with the named filter (e.g. DCTDecode
+     * for a JPEG).  It is emitted as is and never flate compressed.
+     */
+    void setEncodedData(SkStream* stream, const char filter[]);
+
 private:
     enum State {
         kUnused_State,         //!< The stream hasn't been requested yet.
@@ -9,6 +9,7 @@
 
 #include "SkFontHost.h"
 #include "SkFontDescriptor.h"
+#include "SkFontIndex_linux.h"
 #include "SkDescriptor.h"
 #include "SkMMapStream.h"
 #include "SkOSFile.h"
@@ -17,6 +18,7 @@
 #include "SkStream.h"
 #include "SkThread.h"
 #include "SkTSearch.h"
+#include "SkTypefaceCache.h"
 
 #ifndef SK_FONT_FILE_PREFIX
     #define SK_FONT_FILE_PREFIX "/usr/share/fonts/truetype/"
@@ -357,74 +359,42 @@ private:
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
-static bool get_name_and_style(const char path[], SkString* name,
-                               SkTypeface::Style* style, bool* isFixedWidth) {
-    SkMMAPStream stream(path);
-    if (stream.getLength() > 0) {
-        return find_name_and_attributes(&stream, name, style, isFixedWidth);
-    }
-    else {
-        SkFILEStream stream(path);
-        if (stream.getLength() > 0) {
-            return find_name_and_attributes(&stream, name, style, isFixedWidth);
-        }
-    }
-
-    SkDebugf("---- failed to open <%s> as a font\n", path);
-    return false;
-}
-
 // these globals are assigned (once) by load_system_fonts()
 static SkTypeface* gFallBackTypeface;
 static FamilyRec* gDefaultFamily;
 static SkTypeface* gDefaultNormal;
 
-static void load_directory_fonts(const SkString& directory, unsigned int* count) {
-    SkOSFile::Iter  iter(directory.c_str(), ".ttf");
-    SkString        name;
-
-    while (iter.next(&name, false)) {
-        SkString filename(directory);
-        filename.append(name);
-
-        bool isFixedWidth;
-        SkString realname;
-        SkTypeface::Style style = SkTypeface::kNormal; // avoid uninitialized warning
-
-        if (!get_name_and_style(filename.c_str(), &realname, &style, &isFixedWidth)) {
-            SkDebugf("------ can't load <%s> as a font\n", filename.c_str());
-            continue;
-        }
+static void load_indexed_fonts(const FontIndex& index, unsigned int* count) {
+    for (int i = 0; i < index.fDirs.count(); ++i) {
+        const FontIndexDir& dir = index.fDirs[i];
+        for (int j = 0; j < dir.fFiles.count(); ++j) {
+            const FontIndexFile& file = dir.fFiles[j];
+            if (!file.fIsFont) {
+                continue;
+            }
 
-        FamilyRec* family = find_familyrec(realname.c_str());
-        if (family && family->fFaces[style]) {
-            continue;
-        }
+            FamilyRec* family = find_familyrec(file.fFamily.c_str());
+            if (family && family->fFaces[file.fStyle]) {
+                continue;
+            }
 
-        // this constructor puts us into the global gFamilyHead llist
-        FamilyTypeface* tf = SkNEW_ARGS(FileTypeface,
-                                        (style,
-                                         true,  // system-font (cannot delete)
-                                         family, // what family to join
-                                         filename.c_str(),
-                                         isFixedWidth) // filename
-                                        );
+            SkString filename(dir.fPath);
+            filename.append(file.fName);
 
-        if (NULL == family) {
-            add_name(realname.c_str(), tf->getFamily());
-        }
-        *count += 1;
-    }
+            // this constructor puts us into the global gFamilyHead llist
+            FamilyTypeface* tf = SkNEW_ARGS(FileTypeface,
+                                            (file.fStyle,
+                                             true,  // system-font (cannot delete)
+                                             family, // what family to join
+                                             filename.c_str(),
+                                             file.fIsFixedWidth) // filename
+                                            );
 
-    SkOSFile::Iter  dirIter(directory.c_str());
-    while (dirIter.next(&name, true)) {
-        if (name.startsWith(".")) {
-            continue;
+            if (NULL == family) {
+                add_name(file.fFamily.c_str(), tf->getFamily());
+            }
+            *count += 1;
         }
-        SkString dirname(directory);
-        dirname.append(name);
-        dirname.append(SK_FONT_FILE_DIR_SEPERATOR);
-        load_directory_fonts(dirname, count);
     }
 }
 
@@ -436,7 +406,18 @@ static void load_system_fonts() {
 
     SkString baseDirectory(SK_FONT_FILE_PREFIX);
     unsigned int count = 0;
-    load_directory_fonts(baseDirectory, &count);
+
+    SkString indexPath;
+    bool hasIndexPath = get_font_index_path(&indexPath);
+    FontIndex prevIndex, index;
+    if (hasIndexPath) {
+        read_font_index(indexPath.c_str(), &prevIndex);
+    }
+    scan_font_directory(baseDirectory, prevIndex, &index);
+    load_indexed_fonts(index, &count);
+    if (hasIndexPath && index.fChanged) {
+        write_font_index(indexPath.c_str(), index);
+    }
 
     if (0 == count) {
         SkNEW(EmptyTypeface);
@@ -548,6 +529,14 @@ SkTypeface* SkFontHost::CreateTypeface(const SkTypeface* familyFace,
         tf = find_best_face(gDefaultFamily, style);
     }
 
+    // SkGraphics::WriteFontCacheSnapshot() finds the typefaces of the glyph
+    // caches by ID. System fonts live as long as the process, so the cache
+    // never purges them.
+    if (tf && ((FamilyTypeface*)tf)->isSysFont() &&
+            NULL == SkTypefaceCache::FindByID(tf->uniqueID())) {
+        SkTypefaceCache::Add(tf, tf->style());
+    }
+
     SkSafeRef(tf);
     return tf;
 }
@@ -0,0 +1,388 @@
+/*
+ * Copyright 2006 The Android Open Source Project
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkFontIndex_linux.h"
+#include "SkMMapStream.h"
+#include "SkOSFile.h"
+#include "SkStream.h"
+#include "SkTSort.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifndef SK_FONT_FILE_DIR_SEPERATOR
+    #define SK_FONT_FILE_DIR_SEPERATOR "/"
+#endif
+#ifndef SK_FONT_INDEX_FILE_NAME
+    #define SK_FONT_INDEX_FILE_NAME "skia-font-index"
+#endif
+
+bool find_name_and_attributes(SkStream* stream, SkString* name,
+                              SkTypeface::Style* style, bool* isFixedWidth);
+
+static const uint32_t kFontIndexTag = SkSetFourByteTag('s', 'k', 'f', 'i');
+static const uint32_t kFontIndexVersion = 1;
+static const uint32_t kMaxFontIndexString = 4096;
+
+static bool get_name_and_style(const char path[], SkString* name,
+                               SkTypeface::Style* style, bool* isFixedWidth) {
+    SkMMAPStream stream(path);
+    if (stream.getLength() > 0) {
+        return find_name_and_attributes(&stream, name, style, isFixedWidth);
+    }
+    else {
+        SkFILEStream stream(path);
+        if (stream.getLength() > 0) {
+            return find_name_and_attributes(&stream, name, style, isFixedWidth);
+        }
+    }
+
+    SkDebugf("---- failed to open <%s> as a font\n", path);
+    return false;
+}
+
+bool get_font_index_path(SkString* path) {
+    const char* dir = getenv("XDG_CACHE_HOME");
+    if (dir && *dir) {
+        path->set(dir);
+    } else {
+        dir = getenv("HOME");
+        if (NULL == dir || 0 == *dir) {
+            return false;
+        }
+        path->set(dir);
+        path->append(SK_FONT_FILE_DIR_SEPERATOR ".cache");
+    }
+    path->append(SK_FONT_FILE_DIR_SEPERATOR SK_FONT_INDEX_FILE_NAME);
+    return true;
+}
+
+// modified is in nanoseconds, so that two changes in a second tell apart
+static bool get_file_stats(const char path[], int64_t* modified,
+                           uint32_t* size) {
+    struct stat st;
+    if (0 != stat(path, &st)) {
+        return false;
+    }
+    *modified = (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+    if (size) {
+        *size = (uint32_t)st.st_size;
+    }
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static bool dir_path_less(const FontIndex& index, const int a, const int b) {
+    return strcmp(index.fDirs[a].fPath.c_str(),
+                  index.fDirs[b].fPath.c_str()) < 0;
+}
+
+static bool file_name_less(const FontIndexDir& dir, const int a, const int b) {
+    return strcmp(dir.fFiles[a].fName.c_str(),
+                  dir.fFiles[b].fName.c_str()) < 0;
+}
+
+// Called once all of index is added, the sorted indices stay valid as long as
+// fDirs and fFiles are not changed.
+static void sort_font_index(FontIndex* index) {
+    index->fSortedDirs.setCount(index->fDirs.count());
+    for (int i = 0; i < index->fDirs.count(); ++i) {
+        FontIndexDir& dir = index->fDirs[i];
+        dir.fSortedFiles.setCount(dir.fFiles.count());
+        for (int j = 0; j < dir.fFiles.count(); ++j) {
+            dir.fSortedFiles[j] = j;
+        }
+        if (dir.fFiles.count() > 1) {
+            const FontIndexDir& constDir = dir;
+            SkQSort(constDir, dir.fSortedFiles.begin(),
+                    dir.fSortedFiles.end() - 1, file_name_less);
+        }
+        index->fSortedDirs[i] = i;
+    }
+    if (index->fDirs.count() > 1) {
+        const FontIndex& constIndex = *index;
+        SkQSort(constIndex, index->fSortedDirs.begin(),
+                index->fSortedDirs.end() - 1, dir_path_less);
+    }
+}
+
+static const FontIndexDir* find_index_dir(const FontIndex& index,
+                                          const SkString& path) {
+    int lo = 0;
+    int hi = index.fSortedDirs.count();
+    while (lo < hi) {
+        int mid = (lo + hi) >> 1;
+        const FontIndexDir& dir = index.fDirs[index.fSortedDirs[mid]];
+        int cmp = strcmp(dir.fPath.c_str(), path.c_str());
+        if (0 == cmp) {
+            return &dir;
+        }
+        if (cmp < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return NULL;
+}
+
+static const FontIndexFile* find_index_file(const FontIndexDir* dir,
+                                            const FontIndexFile& file) {
+    if (NULL == dir) {
+        return NULL;
+    }
+    int lo = 0;
+    int hi = dir->fSortedFiles.count();
+    while (lo < hi) {
+        int mid = (lo + hi) >> 1;
+        const FontIndexFile& other = dir->fFiles[dir->fSortedFiles[mid]];
+        int cmp = strcmp(other.fName.c_str(), file.fName.c_str());
+        if (0 == cmp) {
+            return other.fSize == file.fSize &&
+                   other.fModified == file.fModified ? &other : NULL;
+        }
+        if (cmp < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static bool read_u32(SkStream* stream, uint32_t* value) {
+    return stream->read(value, sizeof(*value)) == sizeof(*value);
+}
+
+static bool read_s64(SkStream* stream, int64_t* value) {
+    return stream->read(value, sizeof(*value)) == sizeof(*value);
+}
+
+static bool read_string(SkStream* stream, SkString* string) {
+    uint32_t length;
+    if (!read_u32(stream, &length) || length > kMaxFontIndexString) {
+        return false;
+    }
+    string->resize(length);
+    return stream->read(string->writable_str(), length) == length;
+}
+
+static bool write_string(SkWStream* stream, const SkString& string) {
+    return stream->write32(string.size()) &&
+           stream->write(string.c_str(), string.size());
+}
+
+static bool read_font_index_dir(SkStream* stream, FontIndexDir* dir) {
+    uint32_t count;
+    if (!read_string(stream, &dir->fPath) ||
+            !read_s64(stream, &dir->fModified) || !read_u32(stream, &count)) {
+        return false;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        FontIndexFile& file = dir->fFiles.push_back();
+        uint32_t isFont, style, isFixedWidth;
+        if (!read_string(stream, &file.fName) ||
+                !read_u32(stream, &file.fSize) ||
+                !read_s64(stream, &file.fModified) ||
+                !read_u32(stream, &isFont) ||
+                !read_string(stream, &file.fFamily) ||
+                !read_u32(stream, &style) || style > SkTypeface::kBoldItalic ||
+                !read_u32(stream, &isFixedWidth)) {
+            return false;
+        }
+        file.fIsFont = SkToBool(isFont);
+        file.fStyle = (SkTypeface::Style)style;
+        file.fIsFixedWidth = SkToBool(isFixedWidth);
+    }
+    if (!read_u32(stream, &count)) {
+        return false;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        if (!read_string(stream, &dir->fSubdirs.push_back())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool read_font_index(const char path[], FontIndex* index) {
+    SkFILEStream stream(path);
+    if (!stream.isValid()) {
+        return false;
+    }
+
+    uint32_t tag, version, count;
+    if (!read_u32(&stream, &tag) || kFontIndexTag != tag ||
+            !read_u32(&stream, &version) || kFontIndexVersion != version ||
+            !read_u32(&stream, &count)) {
+        return false;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        if (!read_font_index_dir(&stream, &index->fDirs.push_back())) {
+            index->fDirs.reset();
+            return false;
+        }
+    }
+    sort_font_index(index);
+    return true;
+}
+
+static bool write_font_index_dir(SkWStream* stream, const FontIndexDir& dir) {
+    bool success = write_string(stream, dir.fPath) &&
+                   stream->write(&dir.fModified, sizeof(dir.fModified)) &&
+                   stream->write32(dir.fFiles.count());
+    for (int i = 0; success && i < dir.fFiles.count(); ++i) {
+        const FontIndexFile& file = dir.fFiles[i];
+        success = write_string(stream, file.fName) &&
+                  stream->write32(file.fSize) &&
+                  stream->write(&file.fModified, sizeof(file.fModified)) &&
+                  stream->write32(file.fIsFont) &&
+                  write_string(stream, file.fFamily) &&
+                  stream->write32(file.fStyle) &&
+                  stream->write32(file.fIsFixedWidth);
+    }
+    success = success && stream->write32(dir.fSubdirs.count());
+    for (int i = 0; success && i < dir.fSubdirs.count(); ++i) {
+        success = write_string(stream, dir.fSubdirs[i]);
+    }
+    return success;
+}
+
+// Each directory leading to path, like mkdir -p; a fresh home has no .cache.
+static bool make_parent_dirs(const char path[]) {
+    const char* sep = strchr(path + 1, SK_FONT_FILE_DIR_SEPERATOR[0]);
+    for (; sep; sep = strchr(sep + 1, SK_FONT_FILE_DIR_SEPERATOR[0])) {
+        SkString dir(path, sep - path);
+        if (!sk_mkdir(dir.c_str())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Written next to the index and renamed over it, so that a process reading
+// the index meanwhile never sees half of it.
+void write_font_index(const char path[], const FontIndex& index) {
+    if (!make_parent_dirs(path)) {
+        return;
+    }
+    SkString tmpPath(path);
+    tmpPath.appendf(".%d", (int)getpid());
+
+    bool success;
+    {
+        SkFILEWStream stream(tmpPath.c_str());
+        success = stream.isValid() &&
+                  stream.write32(kFontIndexTag) &&
+                  stream.write32(kFontIndexVersion) &&
+                  stream.write32(index.fDirs.count());
+        for (int i = 0; success && i < index.fDirs.count(); ++i) {
+            success = write_font_index_dir(&stream, index.fDirs[i]);
+        }
+    }
+    if (!success || 0 != rename(tmpPath.c_str(), path)) {
+        remove(tmpPath.c_str());
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+/*  Add the font file name of directory to dir. Its entry in prevDir is kept
+    if the file has the same size and modification time, otherwise the file
+    is opened again.
+ */
+static void index_file(const SkString& directory, const SkString& name,
+                       const FontIndexDir* prevDir, FontIndex* index,
+                       FontIndexDir* dir) {
+    SkString filename(directory);
+    filename.append(name);
+
+    FontIndexFile file;
+    file.fName = name;
+    if (!get_file_stats(filename.c_str(), &file.fModified, &file.fSize)) {
+        index->fChanged = true;
+        return;
+    }
+
+    const FontIndexFile* prevFile = find_index_file(prevDir, file);
+    if (prevFile) {
+        file = *prevFile;
+    } else {
+        index->fChanged = true;
+        file.fStyle = SkTypeface::kNormal; // avoid uninitialized warning
+        file.fIsFont = get_name_and_style(filename.c_str(), &file.fFamily,
+                                          &file.fStyle, &file.fIsFixedWidth);
+        if (!file.fIsFont) {
+            SkDebugf("------ can't load <%s> as a font\n", filename.c_str());
+        }
+    }
+    dir->fFiles.push_back(file);
+}
+
+static void scan_directory(const SkString& directory, const FontIndex& prev,
+                           FontIndex* index) {
+    const FontIndexDir* prevDir = find_index_dir(prev, directory);
+    int64_t modified;
+    if (!get_file_stats(directory.c_str(), &modified, NULL)) {
+        if (prevDir) {
+            index->fChanged = true;
+        }
+        return;
+    }
+
+    int dirIndex = index->fDirs.count();
+    FontIndexDir& dir = index->fDirs.push_back();
+    dir.fPath = directory;
+    dir.fModified = modified;
+
+    if (prevDir && prevDir->fModified == modified) {
+        // a font rewritten in place does not change its directory
+        for (int i = 0; i < prevDir->fFiles.count(); ++i) {
+            index_file(directory, prevDir->fFiles[i].fName, prevDir, index,
+                       &dir);
+        }
+        dir.fSubdirs = prevDir->fSubdirs;
+    } else {
+        index->fChanged = true;
+
+        SkOSFile::Iter  iter(directory.c_str(), ".ttf");
+        SkString        name;
+
+        while (iter.next(&name, false)) {
+            index_file(directory, name, prevDir, index, &dir);
+        }
+
+        SkOSFile::Iter  dirIter(directory.c_str());
+        while (dirIter.next(&name, true)) {
+            if (name.startsWith(".")) {
+                continue;
+            }
+            dir.fSubdirs.push_back(name);
+        }
+    }
+
+    // dir moves as the subdirectories are added
+    SkTArray<SkString> subdirs(index->fDirs[dirIndex].fSubdirs);
+    for (int i = 0; i < subdirs.count(); ++i) {
+        SkString dirname(directory);
+        dirname.append(subdirs[i]);
+        dirname.append(SK_FONT_FILE_DIR_SEPERATOR);
+        scan_directory(dirname, prev, index);
+    }
+}
+
+void scan_font_directory(const SkString& directory, const FontIndex& prev,
+                         FontIndex* index) {
+    scan_directory(directory, prev, index);
+    sort_font_index(index);
+}
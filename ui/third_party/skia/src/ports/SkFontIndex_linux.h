@@ -0,0 +1,78 @@
+/*
+ * Copyright 2006 The Android Open Source Project
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SKFONTINDEX_LINUX_H_
+#define SKFONTINDEX_LINUX_H_
+
+#include "SkString.h"
+#include "SkTArray.h"
+#include "SkTDArray.h"
+#include "SkTypeface.h"
+
+/**
+ * The name and style of every font under SK_FONT_FILE_PREFIX are kept in an
+ * index file between runs, so that load_system_fonts() only opens the fonts
+ * of the directories that changed since. Adding, removing or renaming a font
+ * changes the modification time of its directory. In a changed directory, a
+ * font keeps its entry if its size and modification time are the same.
+ */
+struct FontIndexFile {
+    SkString            fName;      // in its directory
+    uint32_t            fSize;
+    int64_t             fModified;
+    bool                fIsFont;    // the rest is only valid if true
+    SkString            fFamily;
+    SkTypeface::Style   fStyle;
+    bool                fIsFixedWidth;
+};
+
+struct FontIndexDir {
+    SkString                fPath;
+    int64_t                 fModified;
+    SkTArray<FontIndexFile> fFiles;
+    SkTArray<SkString>      fSubdirs;
+    // indices of fFiles sorted by name, to look up the files of a rescan
+    SkTDArray<int>          fSortedFiles;
+};
+
+struct FontIndex {
+    FontIndex() : fChanged(false) {}
+
+    // in the order they are scanned, a directory before its subdirectories
+    SkTArray<FontIndexDir>  fDirs;
+    // indices of fDirs sorted by path, to look up the directories of a rescan
+    SkTDArray<int>          fSortedDirs;
+    bool                    fChanged;
+};
+
+/**
+ * Sets path to $XDG_CACHE_HOME/skia-font-index, or to
+ * $HOME/.cache/skia-font-index. Returns false if neither is set.
+ */
+bool get_font_index_path(SkString* path);
+
+/**
+ * Reads the index written at path. Returns false, leaving index empty, if the
+ * file is missing, of another version or cut short.
+ */
+bool read_font_index(const char path[], FontIndex* index);
+
+/**
+ * Writes index to path, creating the directories of path that are missing.
+ */
+void write_font_index(const char path[], const FontIndex& index);
+
+/**
+ * Adds directory, which ends with a separator, and its subdirectories to
+ * index. A directory is only listed again if it changed since prev was
+ * scanned or read, and only its new and changed fonts are opened. index is
+ * ready to be the prev of a later scan.
+ */
+void scan_font_directory(const SkString& directory, const FontIndex& prev,
+                         FontIndex* index);
+
+#endif /* SKFONTINDEX_LINUX_H_ */
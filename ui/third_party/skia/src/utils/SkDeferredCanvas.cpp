@@ -930,6 +930,11 @@ void SkDeferredCanvas::drawText(const void* text, size_t byteLength,
     this->recordedDrawCommand();
 }
 
+void SkDeferredCanvas::drawGlyphs(SkGlyphStrike*, const uint16_t glyphs[], int count,
+                                  SkScalar x, SkScalar y, const SkPaint& paint) {
+    this->drawGlyphsAsText(glyphs, count, x, y, paint);
+}
+
 void SkDeferredCanvas::drawPosText(const void* text, size_t byteLength,
                                    const SkPoint pos[], const SkPaint& paint) {
     AutoImmediateDrawIfNeeded autoDraw(*this, &paint);
@@ -410,6 +410,11 @@ void SkDumpCanvas::drawText(const void* text, size_t byteLength, SkScalar x,
                byteLength, SkScalarToFloat(x), SkScalarToFloat(y));
 }
 
+void SkDumpCanvas::drawGlyphs(SkGlyphStrike*, const uint16_t glyphs[], int count,
+                              SkScalar x, SkScalar y, const SkPaint& paint) {
+    this->drawGlyphsAsText(glyphs, count, x, y, paint);
+}
+
 void SkDumpCanvas::drawPosText(const void* text, size_t byteLength,
                                 const SkPoint pos[], const SkPaint& paint) {
     SkString str;
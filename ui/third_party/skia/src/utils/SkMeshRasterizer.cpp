@@ -0,0 +1,391 @@
+
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+
+#include "SkMeshRasterizer.h"
+#include "SkBitmapProcState_filter.h"
+#include "SkBlitRow.h"
+#include "SkColorPriv.h"
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    #include <emmintrin.h>
+#endif
+
+// Textures are addressed in 16.16 fixed point, so their dimensions are kept
+// well inside 15 bits; larger ones go through drawVertices.
+static const int kMaxTextureSize = 16383;
+
+// Device coordinates are pinned to this before they are converted to ints.
+static const float kMaxDeviceCoord = (float)(1 << 20);
+
+// Pixels sampled per call to the blit row proc.
+static const int kSpanCount = 256;
+
+static inline float pin_float(float value, float min, float max) {
+    return value < min ? min : (value > max ? max : value);
+}
+
+static inline float min_float(float a, float b) {
+    return a < b ? a : b;
+}
+
+static inline float max_float(float a, float b) {
+    return a > b ? a : b;
+}
+
+static inline float pin_coord(float value) {
+    return pin_float(value, -kMaxDeviceCoord, kMaxDeviceCoord);
+}
+
+// The first pixel whose center is at or after value.
+static inline int first_center(float value) {
+    return (int)ceilf(pin_coord(value) - 0.5f);
+}
+
+static inline SkFixed texture_to_fixed(float value) {
+    static const float kMax = (float)(kMaxTextureSize + 2);
+    return (SkFixed)(pin_float(value, -2.0f, kMax) * 65536.0f);
+}
+
+typedef void (*SampleProc)(const SkBitmap& texture, SkFixed u, SkFixed du,
+                           SkFixed v, SkFixed dv, SkPMColor span[], int count);
+
+static void sample_nearest(const SkBitmap& texture, SkFixed u, SkFixed du,
+                           SkFixed v, SkFixed dv, SkPMColor span[], int count) {
+    const char* pixels = (const char*)texture.getPixels();
+    size_t rowBytes = texture.rowBytes();
+    int maxX = texture.width() - 1;
+    int maxY = texture.height() - 1;
+
+    for (int i = 0; i < count; ++i) {
+        int x = SkClampMax(u >> 16, maxX);
+        int y = SkClampMax(v >> 16, maxY);
+        span[i] = ((const SkPMColor*)(pixels + y * rowBytes))[x];
+        u += du;
+        v += dv;
+    }
+}
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+
+// Clamps each lane to [0, max].
+static inline __m128i clamp_SSE2(__m128i value, __m128i max) {
+    value = _mm_andnot_si128(_mm_srai_epi32(value, 31), value);
+    __m128i over = _mm_cmpgt_epi32(value, max);
+    return _mm_or_si128(_mm_and_si128(over, max),
+                        _mm_andnot_si128(over, value));
+}
+
+// Steps four pixels of u and v at a time and turns them into pixel offsets.
+// SSE2 has no gather, so the texels themselves are loaded one by one.
+static void sample_nearest_SSE2(const SkBitmap& texture, SkFixed u, SkFixed du,
+                                SkFixed v, SkFixed dv, SkPMColor span[],
+                                int count) {
+    const SkPMColor* pixels = (const SkPMColor*)texture.getPixels();
+    const __m128i maxX = _mm_set1_epi32(texture.width() - 1);
+    const __m128i maxY = _mm_set1_epi32(texture.height() - 1);
+    const __m128i rowPixels = _mm_set1_epi32(texture.rowBytesAsPixels());
+    const __m128i stepU = _mm_set1_epi32(du << 2);
+    const __m128i stepV = _mm_set1_epi32(dv << 2);
+
+    __m128i uu = _mm_setr_epi32(u, u + du, u + 2 * du, u + 3 * du);
+    __m128i vv = _mm_setr_epi32(v, v + dv, v + 2 * dv, v + 3 * dv);
+
+    while (count >= 4) {
+        __m128i x = clamp_SSE2(_mm_srai_epi32(uu, 16), maxX);
+        __m128i y = clamp_SSE2(_mm_srai_epi32(vv, 16), maxY);
+
+        // y * rowPixels fits in 32 bits, multiply the even and odd lanes.
+        __m128i even = _mm_mul_epu32(y, rowPixels);
+        __m128i odd = _mm_mul_epu32(_mm_srli_epi64(y, 32), rowPixels);
+        __m128i offset = _mm_unpacklo_epi32(
+                _mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+        offset = _mm_add_epi32(offset, x);
+
+        int32_t offsets[4];
+        _mm_storeu_si128((__m128i*)offsets, offset);
+        span[0] = pixels[offsets[0]];
+        span[1] = pixels[offsets[1]];
+        span[2] = pixels[offsets[2]];
+        span[3] = pixels[offsets[3]];
+
+        uu = _mm_add_epi32(uu, stepU);
+        vv = _mm_add_epi32(vv, stepV);
+        span += 4;
+        count -= 4;
+    }
+
+    if (count > 0) {
+        sample_nearest(texture, _mm_cvtsi128_si32(uu), du,
+                       _mm_cvtsi128_si32(vv), dv, span, count);
+    }
+}
+
+#endif
+
+static void sample_filter(const SkBitmap& texture, SkFixed u, SkFixed du,
+                          SkFixed v, SkFixed dv, SkPMColor span[], int count) {
+    const char* pixels = (const char*)texture.getPixels();
+    size_t rowBytes = texture.rowBytes();
+    int maxX = texture.width() - 1;
+    int maxY = texture.height() - 1;
+
+    // filter around the texel centers
+    u -= SK_FixedHalf;
+    v -= SK_FixedHalf;
+
+    for (int i = 0; i < count; ++i) {
+        int x = u >> 16;
+        int y = v >> 16;
+        int x0 = SkClampMax(x, maxX);
+        int x1 = SkClampMax(x + 1, maxX);
+        const SkPMColor* row0 = (const SkPMColor*)(pixels +
+                                        SkClampMax(y, maxY) * rowBytes);
+        const SkPMColor* row1 = (const SkPMColor*)(pixels +
+                                        SkClampMax(y + 1, maxY) * rowBytes);
+
+        Filter_32_opaque((u >> 12) & 0xF, (v >> 12) & 0xF,
+                         row0[x0], row0[x1], row1[x0], row1[x1], &span[i]);
+        u += du;
+        v += dv;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SkMeshRasterizer::SkMeshRasterizer()
+    : fTextureLocked(false)
+    , fAlpha(0xFF)
+    , fFilterBitmap(false) {
+    fBounds.setEmpty();
+}
+
+SkMeshRasterizer::~SkMeshRasterizer() {
+    this->reset();
+}
+
+void SkMeshRasterizer::reset() {
+    if (fTextureLocked) {
+        fTexture.unlockPixels();
+        fTextureLocked = false;
+    }
+    fTexture.reset();
+    fTriangles.rewind();
+    fBounds.setEmpty();
+}
+
+bool SkMeshRasterizer::setMesh(const SkBitmap& texture, const SkMatrix& matrix,
+                               const SkPoint vertices[], const SkPoint texs[],
+                               int vertexCount, const uint16_t indices[],
+                               int indexCount) {
+    this->reset();
+
+    if (SkBitmap::kARGB_8888_Config != texture.config() ||
+        texture.width() > kMaxTextureSize ||
+        texture.height() > kMaxTextureSize ||
+        matrix.hasPerspective()) {
+        return false;
+    }
+    if (texture.empty() || vertexCount < 3) {
+        return true;
+    }
+
+    fTexture = texture;
+    fTexture.lockPixels();
+    fTextureLocked = true;
+    if (NULL == fTexture.getPixels()) {
+        this->reset();
+        return false;
+    }
+
+    int triangleCount = (indices ? indexCount : vertexCount) / 3;
+    fTriangles.setReserve(triangleCount);
+
+    for (int i = 0; i < triangleCount; ++i) {
+        int index[3];
+        bool valid = true;
+        for (int j = 0; j < 3; ++j) {
+            index[j] = indices ? indices[i * 3 + j] : i * 3 + j;
+            valid &= index[j] < vertexCount;
+        }
+        if (!valid) {
+            continue;
+        }
+
+        SkPoint dev[3], tex[3];
+        for (int j = 0; j < 3; ++j) {
+            matrix.mapXY(vertices[index[j]].fX, vertices[index[j]].fY,
+                         &dev[j]);
+            tex[j] = texs[index[j]];
+        }
+        this->addTriangle(dev, tex);
+    }
+    return true;
+}
+
+bool SkMeshRasterizer::addTriangle(const SkPoint dev[3], const SkPoint tex[3]) {
+    double x[3], y[3], u[3], v[3];
+    for (int i = 0; i < 3; ++i) {
+        if (!SkScalarIsFinite(dev[i].fX) || !SkScalarIsFinite(dev[i].fY) ||
+            !SkScalarIsFinite(tex[i].fX) || !SkScalarIsFinite(tex[i].fY)) {
+            return false;
+        }
+        x[i] = pin_coord(SkScalarToFloat(dev[i].fX));
+        y[i] = pin_coord(SkScalarToFloat(dev[i].fY));
+        u[i] = SkScalarToFloat(tex[i].fX);
+        v[i] = SkScalarToFloat(tex[i].fY);
+    }
+
+    // Solve the affine map from device to texture space.
+    double dx1 = x[1] - x[0], dy1 = y[1] - y[0];
+    double dx2 = x[2] - x[0], dy2 = y[2] - y[0];
+    double det = dx1 * dy2 - dx2 * dy1;
+    if (0 == det) {
+        return false;
+    }
+
+    Triangle* tri = fTriangles.append();
+    double du1 = u[1] - u[0], du2 = u[2] - u[0];
+    double dv1 = v[1] - v[0], dv2 = v[2] - v[0];
+    double a = (du1 * dy2 - du2 * dy1) / det;
+    double b = (du2 * dx1 - du1 * dx2) / det;
+    tri->fU[0] = (float)a;
+    tri->fU[1] = (float)b;
+    tri->fU[2] = (float)(u[0] - a * x[0] - b * y[0]);
+    a = (dv1 * dy2 - dv2 * dy1) / det;
+    b = (dv2 * dx1 - dv1 * dx2) / det;
+    tri->fV[0] = (float)a;
+    tri->fV[1] = (float)b;
+    tri->fV[2] = (float)(v[0] - a * x[0] - b * y[0]);
+
+    // Sort the points by y then x, so an edge shared with a neighbor is
+    // always walked from the same end and gives the same span boundaries.
+    int order[3] = { 0, 1, 2 };
+    for (int i = 0; i < 2; ++i) {
+        for (int j = 0; j < 2 - i; ++j) {
+            int p = order[j], q = order[j + 1];
+            if (y[q] < y[p] || (y[q] == y[p] && x[q] < x[p])) {
+                SkTSwap(order[j], order[j + 1]);
+            }
+        }
+    }
+    for (int i = 0; i < 3; ++i) {
+        tri->fX[i] = (float)x[order[i]];
+        tri->fY[i] = (float)y[order[i]];
+    }
+
+    tri->fTop = first_center(tri->fY[0]);
+    tri->fBottom = first_center(tri->fY[2]);
+    if (tri->fTop >= tri->fBottom) {
+        fTriangles.pop();
+        return false;
+    }
+
+    float left = min_float(min_float(tri->fX[0], tri->fX[1]), tri->fX[2]);
+    float right = max_float(max_float(tri->fX[0], tri->fX[1]), tri->fX[2]);
+    SkIRect bounds;
+    bounds.set(first_center(left), tri->fTop, first_center(right),
+               tri->fBottom);
+    fBounds.join(bounds);
+    return true;
+}
+
+void SkMeshRasterizer::drawRows(const SkBitmap& dst, const SkIRect& clip,
+                                int top, int bottom) const {
+    SkASSERT(SkBitmap::kARGB_8888_Config == dst.config());
+
+    SkIRect rows;
+    rows.set(clip.fLeft, SkMax32(top, clip.fTop),
+             clip.fRight, SkMin32(bottom, clip.fBottom));
+    if (rows.isEmpty() || !SkIRect::Intersects(rows, fBounds)) {
+        return;
+    }
+
+    SkPMColor span[kSpanCount];
+    const Triangle* tri = fTriangles.begin();
+    const Triangle* stop = fTriangles.end();
+    for (; tri < stop; ++tri) {
+        this->drawTriangle(*tri, dst, clip, rows.fTop, rows.fBottom, span);
+    }
+}
+
+void SkMeshRasterizer::drawTriangle(const Triangle& tri, const SkBitmap& dst,
+                                    const SkIRect& clip, int top, int bottom,
+                                    SkPMColor span[]) const {
+    top = SkMax32(top, tri.fTop);
+    bottom = SkMin32(bottom, tri.fBottom);
+    if (top >= bottom) {
+        return;
+    }
+
+    SampleProc sample;
+    if (fFilterBitmap) {
+        sample = sample_filter;
+    } else {
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+        sample = sample_nearest_SSE2;
+#else
+        sample = sample_nearest;
+#endif
+    }
+
+    unsigned flags = 0;
+    if (!fTexture.isOpaque()) {
+        flags |= SkBlitRow::kSrcPixelAlpha_Flag32;
+    }
+    if (fAlpha < 0xFF) {
+        flags |= SkBlitRow::kGlobalAlpha_Flag32;
+    }
+    SkBlitRow::Proc32 blit = SkBlitRow::Factory32(flags);
+
+    // slopes of the long edge 0-2 and the short edges 0-1 and 1-2
+    const float* x = tri.fX;
+    const float* y = tri.fY;
+    float slope02 = (x[2] - x[0]) / (y[2] - y[0]);
+    float slope01 = y[1] > y[0] ? (x[1] - x[0]) / (y[1] - y[0]) : 0;
+    float slope12 = y[2] > y[1] ? (x[2] - x[1]) / (y[2] - y[1]) : 0;
+
+    for (int row = top; row < bottom; ++row) {
+        float center = row + 0.5f;
+        float longX = x[0] + (center - y[0]) * slope02;
+        float shortX = center < y[1] ? x[0] + (center - y[0]) * slope01
+                                     : x[1] + (center - y[1]) * slope12;
+
+        int left = SkMax32(first_center(min_float(longX, shortX)), clip.fLeft);
+        int right = SkMin32(first_center(max_float(longX, shortX)), clip.fRight);
+        int count = right - left;
+        if (count <= 0) {
+            continue;
+        }
+
+        // texture coordinates at the centers of the first and last pixels
+        float firstX = left + 0.5f;
+        float lastX = right - 0.5f;
+        float rowU = tri.fU[1] * center + tri.fU[2];
+        float rowV = tri.fV[1] * center + tri.fV[2];
+        SkFixed u = texture_to_fixed(tri.fU[0] * firstX + rowU);
+        SkFixed v = texture_to_fixed(tri.fV[0] * firstX + rowV);
+        SkFixed du = 0, dv = 0;
+        if (count > 1) {
+            du = (texture_to_fixed(tri.fU[0] * lastX + rowU) - u) / (count - 1);
+            dv = (texture_to_fixed(tri.fV[0] * lastX + rowV) - v) / (count - 1);
+        }
+
+        uint32_t* device = dst.getAddr32(left, row);
+        while (count > 0) {
+            int n = SkMin32(count, kSpanCount);
+            sample(fTexture, u, du, v, dv, span, n);
+            blit(device, span, n, fAlpha);
+            device += n;
+            u += du * n;
+            v += dv * n;
+            count -= n;
+        }
+    }
+}
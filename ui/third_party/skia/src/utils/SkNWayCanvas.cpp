@@ -251,6 +251,11 @@ void SkNWayCanvas::drawText(const void* text, size_t byteLength, SkScalar x,
     }
 }
 
+void SkNWayCanvas::drawGlyphs(SkGlyphStrike*, const uint16_t glyphs[], int count,
+                              SkScalar x, SkScalar y, const SkPaint& paint) {
+    this->drawGlyphsAsText(glyphs, count, x, y, paint);
+}
+
 void SkNWayCanvas::drawPosText(const void* text, size_t byteLength,
                                const SkPoint pos[], const SkPaint& paint) {
     Iter iter(fList);
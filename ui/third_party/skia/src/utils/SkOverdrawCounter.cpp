@@ -0,0 +1,151 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkOverdrawCounter.h"
+#include "SkCanvas.h"
+#include "SkColorPriv.h"
+#include "SkDrawFilter.h"
+#include "SkXfermode.h"
+
+namespace {
+
+// Adds one to every covered destination pixel, whatever the source is.
+class CountingXfermode : public SkXfermode {
+public:
+    CountingXfermode() {}
+
+    virtual void xfer32(SkPMColor dst[], const SkPMColor src[], int count,
+                        const SkAlpha aa[]) const SK_OVERRIDE {
+        for (int i = 0; i < count; ++i) {
+            if (NULL == aa || aa[i]) {
+                unsigned n = SkGetPackedA32(dst[i]);
+                n += (n < 255);
+                dst[i] = SkPackARGB32(n, 0, 0, 0);
+            }
+        }
+    }
+
+    virtual void xferA8(SkAlpha dst[], const SkPMColor src[], int count,
+                        const SkAlpha aa[]) const SK_OVERRIDE {
+        for (int i = 0; i < count; ++i) {
+            if (NULL == aa || aa[i]) {
+                dst[i] += (dst[i] < 255);
+            }
+        }
+    }
+
+    SK_DECLARE_UNFLATTENABLE_OBJECT()
+
+private:
+    typedef SkXfermode INHERITED;
+};
+
+// Keeps the geometry and coverage of every draw, but writes counts instead
+// of colors. Shaders and color filters are dropped since the source does not
+// matter; mask filters stay because they change which pixels are covered.
+class CountingDrawFilter : public SkDrawFilter {
+public:
+    CountingDrawFilter() : fMode(SkNEW(CountingXfermode)) {}
+    virtual ~CountingDrawFilter() { fMode->unref(); }
+
+    virtual bool filter(SkPaint* paint, Type) SK_OVERRIDE {
+        paint->setShader(NULL);
+        paint->setColorFilter(NULL);
+        paint->setColor(SK_ColorBLACK);
+        paint->setXfermode(fMode);
+        return true;
+    }
+
+private:
+    SkXfermode* fMode;
+};
+
+// Heatmap colors by count, premultiplied, index 0 and 1 are not drawn.
+const SkPMColor gHeatColors[] = {
+    0,
+    0,
+    SkPackARGB32(0x80, 0x00, 0x00, 0x80),   // blue
+    SkPackARGB32(0x80, 0x00, 0x80, 0x00),   // green
+    SkPackARGB32(0x80, 0x80, 0x40, 0x60),   // pink
+    SkPackARGB32(0x80, 0x80, 0x00, 0x00),   // red
+};
+
+const int kHeatColorCount = SK_ARRAY_COUNT(gHeatColors);
+
+}  // namespace
+
+SkOverdrawCounter::SkOverdrawCounter(int width, int height) {
+    fCounts.setConfig(SkBitmap::kA8_Config, width, height);
+    fCounts.allocPixels();
+    this->reset();
+
+    fCanvas = SkNEW_ARGS(SkCanvas, (fCounts));
+    SkSafeUnref(fCanvas->setDrawFilter(SkNEW(CountingDrawFilter)));
+}
+
+SkOverdrawCounter::~SkOverdrawCounter() {
+    SkDELETE(fCanvas);
+}
+
+void SkOverdrawCounter::reset() {
+    if (fCounts.getPixels()) {
+        sk_bzero(fCounts.getPixels(), fCounts.getSafeSize());
+        fCounts.notifyPixelsChanged();
+    }
+}
+
+void SkOverdrawCounter::getStats(const SkIRect& area, Stats* stats) const {
+    SkASSERT(stats);
+    stats->fPixels = 0;
+    stats->fDrawnPixels = 0;
+    stats->fWrites = 0;
+    stats->fMaxWrites = 0;
+
+    SkIRect r = area;
+    if (NULL == fCounts.getPixels() ||
+        !r.intersect(0, 0, fCounts.width(), fCounts.height())) {
+        return;
+    }
+
+    stats->fPixels = r.width() * r.height();
+    for (int y = r.fTop; y < r.fBottom; ++y) {
+        const uint8_t* row = fCounts.getAddr8(r.fLeft, y);
+        for (int x = 0; x < r.width(); ++x) {
+            unsigned n = row[x];
+            if (n) {
+                stats->fDrawnPixels += 1;
+                stats->fWrites += n;
+                stats->fMaxWrites = SkMax32(stats->fMaxWrites, n);
+            }
+        }
+    }
+}
+
+void SkOverdrawCounter::drawHeatmap(SkCanvas* canvas,
+                                    const SkIRect& area) const {
+    SkIRect r = area;
+    if (NULL == canvas || NULL == fCounts.getPixels() ||
+        !r.intersect(0, 0, fCounts.width(), fCounts.height())) {
+        return;
+    }
+
+    SkBitmap heat;
+    heat.setConfig(SkBitmap::kARGB_8888_Config, r.width(), r.height());
+    if (!heat.allocPixels()) {
+        return;
+    }
+
+    for (int y = 0; y < r.height(); ++y) {
+        const uint8_t* row = fCounts.getAddr8(r.fLeft, r.fTop + y);
+        SkPMColor* dst = heat.getAddr32(0, y);
+        for (int x = 0; x < r.width(); ++x) {
+            dst[x] = gHeatColors[SkMin32(row[x], kHeatColorCount - 1)];
+        }
+    }
+
+    canvas->drawBitmap(heat, SkIntToScalar(r.fLeft), SkIntToScalar(r.fTop));
+}
@@ -112,6 +112,12 @@ public:
                           const SkPaint& paint) SK_OVERRIDE {
         this->addBitmapFromPaint(paint);
     }
+    virtual void drawGlyphs(const SkDraw&, SkGlyphStrike*,
+                            const uint16_t glyphs[], int count,
+                            SkScalar x, SkScalar y,
+                            const SkPaint& paint) SK_OVERRIDE {
+        this->addBitmapFromPaint(paint);
+    }
     virtual void drawPosText(const SkDraw&, const void* text, size_t len,
                              const SkScalar pos[], SkScalar constY,
                              int, const SkPaint& paint) SK_OVERRIDE {
@@ -124,6 +124,11 @@ void SkProxyCanvas::drawText(const void* text, size_t byteLength, SkScalar x,
     fProxy->drawText(text, byteLength, x, y, paint);
 }
 
+void SkProxyCanvas::drawGlyphs(SkGlyphStrike*, const uint16_t glyphs[], int count,
+                               SkScalar x, SkScalar y, const SkPaint& paint) {
+    this->drawGlyphsAsText(glyphs, count, x, y, paint);
+}
+
 void SkProxyCanvas::drawPosText(const void* text, size_t byteLength,
                                 const SkPoint pos[], const SkPaint& paint) {
     fProxy->drawPosText(text, byteLength, pos, paint);
@@ -0,0 +1,417 @@
+/*
+ * Copyright 2013 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+
+#include "SkYUVConverter.h"
+#include "SkBlitRow.h"
+#include "SkColorPriv.h"
+#include "SkTemplates.h"
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    #include <emmintrin.h>
+#endif
+
+// Frames are sampled in 16.16 fixed point.
+static const int kMaxFrameSize = 16383;
+
+// Larger destinations are left to the caller, as each of their columns has
+// its samples precomputed.
+static const int kMaxDstSize = 32767;
+
+// Pixels converted per call to the blit row proc when blending.
+static const int kSpanCount = 256;
+
+// The blended luma and chroma rows of frames up to 4096 pixels wide.
+static const int kRowStorage = 8192;
+
+/*  The conversion is done in 16 bits: each sample less its offset is scaled
+    up by 128 and multiplied by a coefficient in 3.13, keeping the high 16
+    bits of the product, which leaves the channels in 12.4.
+*/
+struct Coefficients {
+    int16_t fYOffset;
+    int16_t fY;
+    int16_t fRV;
+    int16_t fGU;
+    int16_t fGV;
+    int16_t fBU;
+};
+
+static const Coefficients gCoefficients[] = {
+    { 16, 9539, 13075, -3209, -6660, 16525 },   // kRec601_ColorSpace
+    { 16, 9539, 14686, -1747, -4366, 17305 },   // kRec709_ColorSpace
+    {  0, 8192, 11485, -2819, -5850, 14516 },   // kJPEG_ColorSpace
+};
+
+static inline int mul_hi(int a, int b) {
+    return (a * b) >> 16;
+}
+
+static inline SkPMColor yuv_to_pmcolor(int y, int u, int v,
+                                       const Coefficients& k) {
+    int luma = mul_hi((y - k.fYOffset) << 7, k.fY) + 8;
+    u = (u - 128) << 7;
+    v = (v - 128) << 7;
+
+    int r = (luma + mul_hi(v, k.fRV)) >> 4;
+    int g = (luma + mul_hi(u, k.fGU) + mul_hi(v, k.fGV)) >> 4;
+    int b = (luma + mul_hi(u, k.fBU)) >> 4;
+    return SkPackARGB32(0xFF, SkClampMax(r, 255), SkClampMax(g, 255),
+                        SkClampMax(b, 255));
+}
+
+/*  The center of destination pixel index, of count, in the frame whose side
+    has size luma samples, taking chroma samples to be centered between two
+    luma samples each way.
+*/
+static void map_sample(int index, int count, int size, bool chroma,
+                       int32_t* index0, int32_t* index1, int32_t* weight) {
+    SkFixed s = (SkFixed)(((int64_t)(2 * index + 1) * size << 16) /
+                          (2 * count)) - SK_FixedHalf;
+    if (chroma) {
+        s = ((s + SK_FixedHalf) >> 1) - SK_FixedHalf;
+        size = (size + 1) >> 1;
+    }
+
+    int i = s >> 16;
+    if (s <= 0) {
+        *index0 = *index1 = 0;
+        *weight = 0;
+    } else if (i >= size - 1) {
+        *index0 = *index1 = size - 1;
+        *weight = 0;
+    } else {
+        *index0 = i;
+        *index1 = i + 1;
+        *weight = (s >> 8) & 0xFF;
+    }
+}
+
+static inline int sample(const uint8_t row[], int step, int32_t index0,
+                         int32_t index1, int32_t weight) {
+    return (row[index0 * step] * (256 - weight) +
+            row[index1 * step] * weight + 128) >> 8;
+}
+
+// dst[i] = a[i] blended with b[i] by weight / 256, for i in [from, to)
+static void blend_rows(const uint8_t a[], const uint8_t b[], int weight,
+                       uint8_t dst[], int from, int to) {
+    int i = from;
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    // a * (256 - weight) + b * weight + 128 fits in 16 unsigned bits
+    __m128i wa = _mm_set1_epi16(256 - weight);
+    __m128i wb = _mm_set1_epi16(weight);
+    __m128i half = _mm_set1_epi16(128);
+    __m128i zero = _mm_setzero_si128();
+
+    for (; i + 16 <= to; i += 16) {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+        __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(va, zero), wa),
+                                   _mm_mullo_epi16(_mm_unpacklo_epi8(vb, zero), wb));
+        __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(va, zero), wa),
+                                   _mm_mullo_epi16(_mm_unpackhi_epi8(vb, zero), wb));
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, half), 8);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, half), 8);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(lo, hi));
+    }
+#endif
+    for (; i < to; ++i) {
+        dst[i] = (a[i] * (256 - weight) + b[i] * weight + 128) >> 8;
+    }
+}
+
+// The row of plane that a destination row samples, blended into storage if
+// it falls between two rows.
+static const uint8_t* frame_row(const uint8_t plane[], size_t rowBytes,
+                                int32_t index0, int32_t index1, int32_t weight,
+                                uint8_t storage[], int from, int to) {
+    const uint8_t* row0 = plane + index0 * rowBytes;
+    if (0 == weight) {
+        return row0;
+    }
+    blend_rows(row0, plane + index1 * rowBytes, weight, storage, from, to);
+    return storage;
+}
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+static inline __m128i pack_pixels_SSE2(__m128i r, __m128i g, __m128i b,
+                                       __m128i alpha) {
+    __m128i pixels = _mm_or_si128(alpha, _mm_slli_epi32(r, SK_R32_SHIFT));
+    pixels = _mm_or_si128(pixels, _mm_slli_epi32(g, SK_G32_SHIFT));
+    return _mm_or_si128(pixels, _mm_slli_epi32(b, SK_B32_SHIFT));
+}
+
+// The same as yuv_to_pmcolor, for the eight samples in y, u and v.
+static void convert8_SSE2(__m128i y, __m128i u, __m128i v,
+                          const Coefficients& k, SkPMColor dst[]) {
+    __m128i luma = _mm_slli_epi16(_mm_sub_epi16(y, _mm_set1_epi16(k.fYOffset)), 7);
+    luma = _mm_add_epi16(_mm_mulhi_epi16(luma, _mm_set1_epi16(k.fY)),
+                         _mm_set1_epi16(8));
+    u = _mm_slli_epi16(_mm_sub_epi16(u, _mm_set1_epi16(128)), 7);
+    v = _mm_slli_epi16(_mm_sub_epi16(v, _mm_set1_epi16(128)), 7);
+
+    __m128i r = _mm_add_epi16(luma, _mm_mulhi_epi16(v, _mm_set1_epi16(k.fRV)));
+    __m128i g = _mm_add_epi16(luma, _mm_mulhi_epi16(u, _mm_set1_epi16(k.fGU)));
+    g = _mm_add_epi16(g, _mm_mulhi_epi16(v, _mm_set1_epi16(k.fGV)));
+    __m128i b = _mm_add_epi16(luma, _mm_mulhi_epi16(u, _mm_set1_epi16(k.fBU)));
+
+    __m128i zero = _mm_setzero_si128();
+    __m128i max = _mm_set1_epi16(255);
+    r = _mm_min_epi16(_mm_max_epi16(_mm_srai_epi16(r, 4), zero), max);
+    g = _mm_min_epi16(_mm_max_epi16(_mm_srai_epi16(g, 4), zero), max);
+    b = _mm_min_epi16(_mm_max_epi16(_mm_srai_epi16(b, 4), zero), max);
+
+    __m128i alpha = _mm_set1_epi32((int)(0xFFU << SK_A32_SHIFT));
+    _mm_storeu_si128((__m128i*)dst,
+                     pack_pixels_SSE2(_mm_unpacklo_epi16(r, zero),
+                                      _mm_unpacklo_epi16(g, zero),
+                                      _mm_unpacklo_epi16(b, zero), alpha));
+    _mm_storeu_si128((__m128i*)(dst + 4),
+                     pack_pixels_SSE2(_mm_unpackhi_epi16(r, zero),
+                                      _mm_unpackhi_epi16(g, zero),
+                                      _mm_unpackhi_epi16(b, zero), alpha));
+}
+#endif
+
+// Samples count columns of row into dst.
+template <typename Sample>
+static void sample_row(const uint8_t row[], int step, const Sample columns[],
+                       uint8_t dst[], int count) {
+    for (int i = 0; i < count; ++i) {
+        dst[i] = sample(row, step, columns[i].fIndex0, columns[i].fIndex1,
+                        columns[i].fWeight);
+    }
+}
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+// Eight chroma samples, from every step-th byte of row.
+static inline __m128i load_chroma8_SSE2(const uint8_t row[], int step) {
+    if (1 == step) {
+        return _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)row),
+                                 _mm_setzero_si128());
+    }
+    return _mm_and_si128(_mm_loadu_si128((const __m128i*)row),
+                         _mm_set1_epi16(0xFF));
+}
+
+/*  The chroma of the columns [2m, 2m + 16) of a frame drawn as wide as it is.
+    Column 2m is (c[m - 1] + 3c[m] + 2) / 4 and column 2m + 1 is
+    (3c[m] + c[m + 1] + 2) / 4, the same as their samples give.
+*/
+static void upsample_chroma16_SSE2(const uint8_t row[], int step, int m,
+                                   uint8_t dst[]) {
+    __m128i prev = load_chroma8_SSE2(row + (m - 1) * step, step);
+    __m128i cur = load_chroma8_SSE2(row + m * step, step);
+    __m128i next = load_chroma8_SSE2(row + (m + 1) * step, step);
+
+    cur = _mm_add_epi16(_mm_add_epi16(cur, _mm_slli_epi16(cur, 1)),
+                        _mm_set1_epi16(2));
+    __m128i even = _mm_srli_epi16(_mm_add_epi16(prev, cur), 2);
+    __m128i odd = _mm_srli_epi16(_mm_add_epi16(next, cur), 2);
+    _mm_storeu_si128((__m128i*)dst,
+                     _mm_packus_epi16(_mm_unpacklo_epi16(even, odd),
+                                      _mm_unpackhi_epi16(even, odd)));
+}
+#endif
+
+// sample_row for the chroma of a frame drawn as wide as it is, whose first
+// column is x.
+template <typename Sample>
+static void upsample_chroma_row(const uint8_t row[], int step,
+                                const Sample columns[], int x, int chromaWidth,
+                                uint8_t dst[], int count) {
+    int i = 0;
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    // from an even column with chroma on its left, while the loads stay in row
+    for (; i < count && ((x + i) & 1 || x + i < 2); ++i) {
+        dst[i] = sample(row, step, columns[i].fIndex0, columns[i].fIndex1,
+                        columns[i].fWeight);
+    }
+    for (; i + 16 <= count && ((x + i) >> 1) + 9 < chromaWidth; i += 16) {
+        upsample_chroma16_SSE2(row, step, (x + i) >> 1, dst + i);
+    }
+#endif
+    sample_row(row, step, columns + i, dst + i, count - i);
+}
+
+static void convert_span(const uint8_t y[], const uint8_t u[],
+                         const uint8_t v[], const Coefficients& k,
+                         SkPMColor dst[], int count) {
+    int i = 0;
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    __m128i zero = _mm_setzero_si128();
+
+    for (; i + 8 <= count; i += 8) {
+        convert8_SSE2(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(y + i)), zero),
+                      _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(u + i)), zero),
+                      _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(v + i)), zero),
+                      k, dst + i);
+    }
+#endif
+    for (; i < count; ++i) {
+        dst[i] = yuv_to_pmcolor(y[i], u[i], v[i], k);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SkYUVConverter::SkYUVConverter()
+    : fFormat(kI420_Format)
+    , fColorSpace(kRec601_ColorSpace)
+    , fWidth(0)
+    , fHeight(0)
+    , fAlpha(0xFF)
+    , fColumnsWidth(0) {
+    sk_bzero(&fPlanes, sizeof(fPlanes));
+    fDstRect.setEmpty();
+}
+
+bool SkYUVConverter::setFrame(Format format, ColorSpace colorSpace,
+                              int width, int height, const Planes& planes) {
+    fWidth = fHeight = 0;
+    fDstRect.setEmpty();
+
+    if (width <= 0 || height <= 0 ||
+        width > kMaxFrameSize || height > kMaxFrameSize) {
+        return false;
+    }
+    if (NULL == planes.fY || NULL == planes.fU ||
+        (kI420_Format == format && NULL == planes.fV)) {
+        return false;
+    }
+
+    fFormat = format;
+    fColorSpace = colorSpace;
+    fWidth = width;
+    fHeight = height;
+    fPlanes = planes;
+    return true;
+}
+
+bool SkYUVConverter::setDstRect(const SkIRect& rect) {
+    SkASSERT(fWidth > 0);
+
+    if (rect.isEmpty() || rect.width() > kMaxDstSize ||
+        rect.height() > kMaxDstSize) {
+        fDstRect.setEmpty();
+        return false;
+    }
+    fDstRect = rect;
+
+    // a frame drawn at the same size every time keeps its columns
+    int count = rect.width();
+    if (fLumaColumns.count() != count || fColumnsWidth != fWidth) {
+        fLumaColumns.setCount(count);
+        fChromaColumns.setCount(count);
+        for (int i = 0; i < count; ++i) {
+            Sample& luma = fLumaColumns[i];
+            Sample& chroma = fChromaColumns[i];
+            map_sample(i, count, fWidth, false,
+                       &luma.fIndex0, &luma.fIndex1, &luma.fWeight);
+            map_sample(i, count, fWidth, true,
+                       &chroma.fIndex0, &chroma.fIndex1, &chroma.fWeight);
+        }
+        fColumnsWidth = fWidth;
+    }
+    return true;
+}
+
+void SkYUVConverter::drawRows(const SkBitmap& dst, const SkIRect& clip,
+                              int top, int bottom) const {
+    SkASSERT(SkBitmap::kARGB_8888_Config == dst.config());
+
+    SkIRect area = fDstRect;
+    if (!area.intersect(clip) ||
+        !area.intersect(area.fLeft, top, area.fRight, bottom) ||
+        !area.intersect(0, 0, dst.width(), dst.height())) {
+        return;
+    }
+
+    int count = area.width();
+    const Sample* lumaColumns = fLumaColumns.begin() + (area.fLeft - fDstRect.fLeft);
+    const Sample* chromaColumns = fChromaColumns.begin() + (area.fLeft - fDstRect.fLeft);
+
+    // only the columns the area samples are blended, in bytes of the planes
+    int uvStep = kNV12_Format == fFormat ? 2 : 1;
+    int lumaFrom = lumaColumns[0].fIndex0;
+    int lumaTo = lumaColumns[count - 1].fIndex1 + 1;
+    int chromaFrom = chromaColumns[0].fIndex0 * uvStep;
+    int chromaTo = (chromaColumns[count - 1].fIndex1 + 1) * uvStep;
+
+    // luma, then U and V, or the interleaved U and V
+    int chromaBytes = this->chromaWidth();
+    SkAutoSTArray<kRowStorage, uint8_t> storage(fWidth + 2 * chromaBytes);
+    uint8_t* lumaStorage = storage.get();
+    uint8_t* uStorage = lumaStorage + fWidth;
+    uint8_t* vStorage = uStorage + chromaBytes;
+
+    const Coefficients& k = gCoefficients[fColorSpace];
+    SkBlitRow::Proc32 blend = NULL;
+    if (fAlpha < 0xFF) {
+        blend = SkBlitRow::Factory32(SkBlitRow::kGlobalAlpha_Flag32);
+    }
+
+    // a frame as wide as the destination has its luma read in place
+    bool scaledAcross = fDstRect.width() != fWidth;
+    uint8_t ySpan[kSpanCount];
+    uint8_t uSpan[kSpanCount];
+    uint8_t vSpan[kSpanCount];
+    SkPMColor span[kSpanCount];
+
+    for (int y = area.fTop; y < area.fBottom; ++y) {
+        Sample luma, chroma;
+        map_sample(y - fDstRect.fTop, fDstRect.height(), fHeight, false,
+                   &luma.fIndex0, &luma.fIndex1, &luma.fWeight);
+        map_sample(y - fDstRect.fTop, fDstRect.height(), fHeight, true,
+                   &chroma.fIndex0, &chroma.fIndex1, &chroma.fWeight);
+
+        const uint8_t* yRow = frame_row(fPlanes.fY, fPlanes.fYRowBytes,
+                                        luma.fIndex0, luma.fIndex1,
+                                        luma.fWeight, lumaStorage,
+                                        lumaFrom, lumaTo);
+        const uint8_t* uRow = frame_row(fPlanes.fU, fPlanes.fUVRowBytes,
+                                        chroma.fIndex0, chroma.fIndex1,
+                                        chroma.fWeight, uStorage,
+                                        chromaFrom, chromaTo);
+        const uint8_t* vRow;
+        if (kNV12_Format == fFormat) {
+            vRow = uRow + 1;
+        } else {
+            vRow = frame_row(fPlanes.fV, fPlanes.fUVRowBytes, chroma.fIndex0,
+                             chroma.fIndex1, chroma.fWeight, vStorage,
+                             chromaFrom, chromaTo);
+        }
+
+        SkPMColor* row = dst.getAddr32(area.fLeft, y);
+        for (int x = 0; x < count; x += kSpanCount) {
+            int n = SkMin32(count - x, kSpanCount);
+            const uint8_t* ySamples = yRow + lumaColumns[x].fIndex0;
+            if (scaledAcross) {
+                sample_row(yRow, 1, lumaColumns + x, ySpan, n);
+                ySamples = ySpan;
+            }
+            if (scaledAcross) {
+                sample_row(uRow, uvStep, chromaColumns + x, uSpan, n);
+                sample_row(vRow, uvStep, chromaColumns + x, vSpan, n);
+            } else {
+                int column = area.fLeft - fDstRect.fLeft + x;
+                upsample_chroma_row(uRow, uvStep, chromaColumns + x, column,
+                                    this->chromaWidth(), uSpan, n);
+                upsample_chroma_row(vRow, uvStep, chromaColumns + x, column,
+                                    this->chromaWidth(), vSpan, n);
+            }
+
+            if (NULL == blend) {
+                convert_span(ySamples, uSpan, vSpan, k, row + x, n);
+            } else {
+                convert_span(ySamples, uSpan, vSpan, k, span, n);
+                blend(row + x, span, n, fAlpha);
+            }
+        }
+    }
+}
@@ -16,6 +16,10 @@
 #include "jpeglib.h"
 #include "jdct.h"		/* Private declarations for DCT subsystem */
 
+#ifdef FDCT_SSE2
+#include <emmintrin.h>
+#endif
+
 
 /* Private subobject for this module */
 
@@ -31,6 +35,11 @@ typedef struct {
    */
   DCTELEM * divisors[NUM_QUANT_TBLS];
 
+#ifdef FDCT_SSE2
+  /* 1/divisor for each entry, quantization multiplies instead of dividing. */
+  float * reciprocals[NUM_QUANT_TBLS];
+#endif
+
 #ifdef DCT_FLOAT_SUPPORTED
   /* Same as above for the floating-point case. */
   float_DCT_method_ptr do_float_dct;
@@ -164,10 +173,86 @@ start_pass_fdctmgr (j_compress_ptr cinfo)
       ERREXIT(cinfo, JERR_NOT_COMPILED);
       break;
     }
+#ifdef FDCT_SSE2
+    if (cinfo->dct_method != JDCT_FLOAT) {
+      float * rtbl;
+
+      if (fdct->reciprocals[qtblno] == NULL) {
+	fdct->reciprocals[qtblno] = (float *)
+	  (*cinfo->mem->alloc_small) ((j_common_ptr) cinfo, JPOOL_IMAGE,
+				      DCTSIZE2 * SIZEOF(float));
+      }
+      rtbl = fdct->reciprocals[qtblno];
+      dtbl = fdct->divisors[qtblno];
+      for (i = 0; i < DCTSIZE2; i++) {
+	rtbl[i] = 1.0f / (float) dtbl[i];
+      }
+    }
+#endif
   }
 }
 
 
+#ifdef FDCT_SSE2
+
+/*
+ * Load one block, applying unsigned->signed conversion.
+ */
+
+LOCAL(void)
+load_block_sse2 (JSAMPARRAY sample_data, JDIMENSION start_col,
+		 DCTELEM * workspace)
+{
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i center = _mm_set1_epi16(CENTERJSAMPLE);
+  __m128i samples, sign;
+  int elemr;
+
+  for (elemr = 0; elemr < DCTSIZE; elemr++) {
+    samples = _mm_loadl_epi64((const __m128i *) (sample_data[elemr] + start_col));
+    samples = _mm_sub_epi16(_mm_unpacklo_epi8(samples, zero), center);
+    sign = _mm_srai_epi16(samples, 15);
+    _mm_storeu_si128((__m128i *) workspace, _mm_unpacklo_epi16(samples, sign));
+    _mm_storeu_si128((__m128i *) (workspace + 4), _mm_unpackhi_epi16(samples, sign));
+    workspace += DCTSIZE;
+  }
+}
+
+
+/*
+ * Quantize one block, four coefficients at a time.
+ * The dividend is below 2^17 and the divisor below 2^12, so the relative
+ * error of the float product cannot move it across an integer once half a
+ * unit is added; truncation then gives the same quotient as the division in
+ * forward_DCT.
+ */
+
+LOCAL(void)
+quantize_sse2 (const DCTELEM * workspace, const DCTELEM * divisors,
+	       const float * reciprocals, JCOEFPTR output_ptr)
+{
+  const __m128 half = _mm_set1_ps(0.5f);
+  __m128i temp[2], sign, qval;
+  int i, j;
+
+  for (i = 0; i < DCTSIZE2; i += 8) {
+    for (j = 0; j < 2; j++) {
+      temp[j] = _mm_loadu_si128((const __m128i *) (workspace + i + j * 4));
+      qval = _mm_loadu_si128((const __m128i *) (divisors + i + j * 4));
+      sign = _mm_srai_epi32(temp[j], 31);
+      temp[j] = _mm_sub_epi32(_mm_xor_si128(temp[j], sign), sign);
+      temp[j] = _mm_add_epi32(temp[j], _mm_srai_epi32(qval, 1));
+      temp[j] = _mm_cvttps_epi32(_mm_mul_ps(_mm_add_ps(_mm_cvtepi32_ps(temp[j]), half),
+					    _mm_loadu_ps(reciprocals + i + j * 4)));
+      temp[j] = _mm_sub_epi32(_mm_xor_si128(temp[j], sign), sign);
+    }
+    _mm_storeu_si128((__m128i *) (output_ptr + i), _mm_packs_epi32(temp[0], temp[1]));
+  }
+}
+
+#endif /* FDCT_SSE2 */
+
+
 /*
  * Perform forward DCT on one or more blocks of a component.
  *
@@ -189,9 +274,19 @@ forward_DCT (j_compress_ptr cinfo, jpeg_component_info * compptr,
   DCTELEM * divisors = fdct->divisors[compptr->quant_tbl_no];
   DCTELEM workspace[DCTSIZE2];	/* work area for FDCT subroutine */
   JDIMENSION bi;
+#ifdef FDCT_SSE2
+  float * reciprocals = fdct->reciprocals[compptr->quant_tbl_no];
+#endif
 
   sample_data += start_row;	/* fold in the vertical offset once */
 
+#ifdef FDCT_SSE2
+  for (bi = 0; bi < num_blocks; bi++, start_col += DCTSIZE) {
+    load_block_sse2(sample_data, start_col, workspace);
+    (*do_dct) (workspace);
+    quantize_sse2(workspace, divisors, reciprocals, coef_blocks[bi]);
+  }
+#else
   for (bi = 0; bi < num_blocks; bi++, start_col += DCTSIZE) {
     /* Load data into workspace, applying unsigned->signed conversion */
     { register DCTELEM *workspaceptr;
@@ -261,6 +356,7 @@ forward_DCT (j_compress_ptr cinfo, jpeg_component_info * compptr,
       }
     }
   }
+#endif /* FDCT_SSE2 */
 }
 
 
@@ -380,6 +476,9 @@ jinit_forward_dct (j_compress_ptr cinfo)
   /* Mark divisor tables unallocated */
   for (i = 0; i < NUM_QUANT_TBLS; i++) {
     fdct->divisors[i] = NULL;
+#ifdef FDCT_SSE2
+    fdct->reciprocals[i] = NULL;
+#endif
 #ifdef DCT_FLOAT_SUPPORTED
     fdct->float_divisors[i] = NULL;
 #endif
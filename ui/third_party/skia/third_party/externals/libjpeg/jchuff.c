@@ -289,6 +289,34 @@ dump_buffer (working_state * state)
 }
 
 
+/* Number of bits needed for a coefficient magnitude, by table lookup on
+ * its low or high byte rather than one shift per bit.  Magnitudes are below
+ * 2^16 since coefficients are stored as JCOEF.
+ */
+
+static const unsigned char jpeg_nbits_table[256] = {
+  0, 1, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4,
+  5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+  6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+  6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+  7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+  7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+  7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+  7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+  8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8,
+  8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8,
+  8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8,
+  8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8,
+  8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8,
+  8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8,
+  8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8,
+  8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8
+};
+
+#define JPEG_NBITS(x) \
+  ((x) < 256 ? jpeg_nbits_table[x] : 8 + jpeg_nbits_table[(x) >> 8])
+
+
 /* Outputting bits to the file */
 
 /* Only the right 24 bits of put_buffer are used; the valid bits are
@@ -336,6 +364,33 @@ emit_bits (working_state * state, unsigned int code, int size)
 }
 
 
+/* Emit a Huffman symbol and the nbits of value that follow it.  Both go
+ * out in one emit_bits call when they fit in its 16 bits, which is the
+ * common case for the short codes of frequent symbols.
+ */
+
+INLINE
+LOCAL(boolean)
+emit_symbol_bits (working_state * state, c_derived_tbl * tbl, int symbol,
+		  unsigned int value, int nbits)
+{
+  int size = tbl->ehufsi[symbol];
+
+  if (size != 0 && size + nbits <= 16) {
+    value &= (((unsigned int) 1) << nbits) - 1;
+    return emit_bits(state, (tbl->ehufco[symbol] << nbits) | value,
+		     size + nbits);
+  }
+
+  if (! emit_bits(state, tbl->ehufco[symbol], size))
+    return FALSE;
+  if (nbits)			/* emit_bits rejects calls with size 0 */
+    if (! emit_bits(state, value, nbits))
+      return FALSE;
+  return TRUE;
+}
+
+
 LOCAL(boolean)
 flush_bits (working_state * state)
 {
@@ -369,26 +424,18 @@ encode_one_block (working_state * state, JCOEFPTR block, int last_dc_val,
   }
   
   /* Find the number of bits needed for the magnitude of the coefficient */
-  nbits = 0;
-  while (temp) {
-    nbits++;
-    temp >>= 1;
-  }
+  nbits = JPEG_NBITS(temp);
   /* Check for out-of-range coefficient values.
    * Since we're encoding a difference, the range limit is twice as much.
    */
   if (nbits > MAX_COEF_BITS+1)
     ERREXIT(state->cinfo, JERR_BAD_DCT_COEF);
   
-  /* Emit the Huffman-coded symbol for the number of bits */
-  if (! emit_bits(state, dctbl->ehufco[nbits], dctbl->ehufsi[nbits]))
-    return FALSE;
-
-  /* Emit that number of bits of the value, if positive, */
+  /* Emit the Huffman-coded symbol for the number of bits, followed by */
+  /* that number of bits of the value, if positive, */
   /* or the complement of its magnitude, if negative. */
-  if (nbits)			/* emit_bits rejects calls with size 0 */
-    if (! emit_bits(state, (unsigned int) temp2, nbits))
-      return FALSE;
+  if (! emit_symbol_bits(state, dctbl, nbits, (unsigned int) temp2, nbits))
+    return FALSE;
 
   /* Encode the AC coefficients per section F.1.2.2 */
   
@@ -413,21 +460,16 @@ encode_one_block (working_state * state, JCOEFPTR block, int last_dc_val,
       }
       
       /* Find the number of bits needed for the magnitude of the coefficient */
-      nbits = 1;		/* there must be at least one 1 bit */
-      while ((temp >>= 1))
-	nbits++;
+      nbits = JPEG_NBITS(temp);
       /* Check for out-of-range coefficient values */
       if (nbits > MAX_COEF_BITS)
 	ERREXIT(state->cinfo, JERR_BAD_DCT_COEF);
       
-      /* Emit Huffman symbol for run length / number of bits */
-      i = (r << 4) + nbits;
-      if (! emit_bits(state, actbl->ehufco[i], actbl->ehufsi[i]))
-	return FALSE;
-
-      /* Emit that number of bits of the value, if positive, */
+      /* Emit Huffman symbol for run length / number of bits, followed by */
+      /* that number of bits of the value, if positive, */
       /* or the complement of its magnitude, if negative. */
-      if (! emit_bits(state, (unsigned int) temp2, nbits))
+      i = (r << 4) + nbits;
+      if (! emit_symbol_bits(state, actbl, i, (unsigned int) temp2, nbits))
 	return FALSE;
       
       r = 0;
@@ -583,11 +625,7 @@ htest_one_block (j_compress_ptr cinfo, JCOEFPTR block, int last_dc_val,
     temp = -temp;
   
   /* Find the number of bits needed for the magnitude of the coefficient */
-  nbits = 0;
-  while (temp) {
-    nbits++;
-    temp >>= 1;
-  }
+  nbits = JPEG_NBITS(temp);
   /* Check for out-of-range coefficient values.
    * Since we're encoding a difference, the range limit is twice as much.
    */
@@ -616,9 +654,7 @@ htest_one_block (j_compress_ptr cinfo, JCOEFPTR block, int last_dc_val,
 	temp = -temp;
       
       /* Find the number of bits needed for the magnitude of the coefficient */
-      nbits = 1;		/* there must be at least one 1 bit */
-      while ((temp >>= 1))
-	nbits++;
+      nbits = JPEG_NBITS(temp);
       /* Check for out-of-range coefficient values */
       if (nbits > MAX_COEF_BITS)
 	ERREXIT(cinfo, JERR_BAD_DCT_COEF);
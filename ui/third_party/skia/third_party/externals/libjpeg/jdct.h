@@ -35,6 +35,20 @@ typedef INT32 DCTELEM;		/* must have 32 bits */
 typedef JMETHOD(void, forward_DCT_method_ptr, (DCTELEM * data));
 typedef JMETHOD(void, float_DCT_method_ptr, (FAST_FLOAT * data));
 
+/*
+ * With 8-bit samples every intermediate value of the fast integer forward
+ * DCT fits in 16 bits, so eight rows or columns can be processed at once with
+ * SSE2; jcdctmgr.c also loads and quantizes blocks with SSE2 then.  The
+ * results are bit-exact with the plain C code.  SSE2 is assumed whenever the
+ * compiler is allowed to generate it.
+ */
+
+#if BITS_IN_JSAMPLE == 8
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FDCT_SSE2
+#endif
+#endif
+
 
 /*
  * An inverse DCT routine is given a pointer to the input JBLOCK and a pointer
@@ -106,6 +106,152 @@
 #define MULTIPLY(var,const)  ((DCTELEM) DESCALE((var) * (const), CONST_BITS))
 
 
+#ifdef FDCT_SSE2
+
+#include <emmintrin.h>
+
+/* MULTIPLY on eight 16-bit lanes.  The full 32-bit products are rebuilt
+ * from their low and high halves so the truncation matches the C code.
+ */
+
+LOCAL(__m128i)
+multiply_sse2 (__m128i var, __m128i constant)
+{
+  __m128i lo = _mm_mullo_epi16(var, constant);
+  __m128i hi = _mm_mulhi_epi16(var, constant);
+  __m128i prod0 = _mm_srai_epi32(_mm_unpacklo_epi16(lo, hi), CONST_BITS);
+  __m128i prod1 = _mm_srai_epi32(_mm_unpackhi_epi16(lo, hi), CONST_BITS);
+
+  return _mm_packs_epi32(prod0, prod1);
+}
+
+
+/* Transpose an 8x8 block of 16-bit values held in eight registers. */
+
+LOCAL(void)
+transpose_sse2 (__m128i * r)
+{
+  __m128i a0 = _mm_unpacklo_epi16(r[0], r[1]);
+  __m128i a1 = _mm_unpackhi_epi16(r[0], r[1]);
+  __m128i a2 = _mm_unpacklo_epi16(r[2], r[3]);
+  __m128i a3 = _mm_unpackhi_epi16(r[2], r[3]);
+  __m128i a4 = _mm_unpacklo_epi16(r[4], r[5]);
+  __m128i a5 = _mm_unpackhi_epi16(r[4], r[5]);
+  __m128i a6 = _mm_unpacklo_epi16(r[6], r[7]);
+  __m128i a7 = _mm_unpackhi_epi16(r[6], r[7]);
+
+  __m128i b0 = _mm_unpacklo_epi32(a0, a2);
+  __m128i b1 = _mm_unpackhi_epi32(a0, a2);
+  __m128i b2 = _mm_unpacklo_epi32(a1, a3);
+  __m128i b3 = _mm_unpackhi_epi32(a1, a3);
+  __m128i b4 = _mm_unpacklo_epi32(a4, a6);
+  __m128i b5 = _mm_unpackhi_epi32(a4, a6);
+  __m128i b6 = _mm_unpacklo_epi32(a5, a7);
+  __m128i b7 = _mm_unpackhi_epi32(a5, a7);
+
+  r[0] = _mm_unpacklo_epi64(b0, b4);
+  r[1] = _mm_unpackhi_epi64(b0, b4);
+  r[2] = _mm_unpacklo_epi64(b1, b5);
+  r[3] = _mm_unpackhi_epi64(b1, b5);
+  r[4] = _mm_unpacklo_epi64(b2, b6);
+  r[5] = _mm_unpackhi_epi64(b2, b6);
+  r[6] = _mm_unpacklo_epi64(b3, b7);
+  r[7] = _mm_unpackhi_epi64(b3, b7);
+}
+
+
+/* One pass of the AA&N butterfly, r[k] holds element k of eight vectors. */
+
+LOCAL(void)
+fdct_pass_sse2 (__m128i * r)
+{
+  const __m128i c_0_382683433 = _mm_set1_epi16((short) FIX_0_382683433);
+  const __m128i c_0_541196100 = _mm_set1_epi16((short) FIX_0_541196100);
+  const __m128i c_0_707106781 = _mm_set1_epi16((short) FIX_0_707106781);
+  const __m128i c_1_306562965 = _mm_set1_epi16((short) FIX_1_306562965);
+  __m128i tmp0, tmp1, tmp2, tmp3, tmp4, tmp5, tmp6, tmp7;
+  __m128i tmp10, tmp11, tmp12, tmp13;
+  __m128i z1, z2, z3, z4, z5, z11, z13;
+
+  tmp0 = _mm_add_epi16(r[0], r[7]);
+  tmp7 = _mm_sub_epi16(r[0], r[7]);
+  tmp1 = _mm_add_epi16(r[1], r[6]);
+  tmp6 = _mm_sub_epi16(r[1], r[6]);
+  tmp2 = _mm_add_epi16(r[2], r[5]);
+  tmp5 = _mm_sub_epi16(r[2], r[5]);
+  tmp3 = _mm_add_epi16(r[3], r[4]);
+  tmp4 = _mm_sub_epi16(r[3], r[4]);
+
+  /* Even part */
+
+  tmp10 = _mm_add_epi16(tmp0, tmp3);
+  tmp13 = _mm_sub_epi16(tmp0, tmp3);
+  tmp11 = _mm_add_epi16(tmp1, tmp2);
+  tmp12 = _mm_sub_epi16(tmp1, tmp2);
+
+  r[0] = _mm_add_epi16(tmp10, tmp11);
+  r[4] = _mm_sub_epi16(tmp10, tmp11);
+
+  z1 = multiply_sse2(_mm_add_epi16(tmp12, tmp13), c_0_707106781);
+  r[2] = _mm_add_epi16(tmp13, z1);
+  r[6] = _mm_sub_epi16(tmp13, z1);
+
+  /* Odd part */
+
+  tmp10 = _mm_add_epi16(tmp4, tmp5);
+  tmp11 = _mm_add_epi16(tmp5, tmp6);
+  tmp12 = _mm_add_epi16(tmp6, tmp7);
+
+  z5 = multiply_sse2(_mm_sub_epi16(tmp10, tmp12), c_0_382683433);
+  z2 = _mm_add_epi16(multiply_sse2(tmp10, c_0_541196100), z5);
+  z4 = _mm_add_epi16(multiply_sse2(tmp12, c_1_306562965), z5);
+  z3 = multiply_sse2(tmp11, c_0_707106781);
+
+  z11 = _mm_add_epi16(tmp7, z3);
+  z13 = _mm_sub_epi16(tmp7, z3);
+
+  r[5] = _mm_add_epi16(z13, z2);
+  r[3] = _mm_sub_epi16(z13, z2);
+  r[1] = _mm_add_epi16(z11, z4);
+  r[7] = _mm_sub_epi16(z11, z4);
+}
+
+
+/*
+ * Perform the forward DCT on one block of samples.
+ * The rows are turned into columns so that both passes work on whole
+ * registers, and turned back before the column pass.
+ */
+
+GLOBAL(void)
+jpeg_fdct_ifast (DCTELEM * data)
+{
+  __m128i r[DCTSIZE];
+  __m128i sign;
+  int i;
+
+  for (i = 0; i < DCTSIZE; i++) {
+    r[i] = _mm_packs_epi32(_mm_loadu_si128((const __m128i *) (data + i * DCTSIZE)),
+			   _mm_loadu_si128((const __m128i *) (data + i * DCTSIZE + 4)));
+  }
+
+  /* Pass 1: process rows. */
+  transpose_sse2(r);
+  fdct_pass_sse2(r);
+
+  /* Pass 2: process columns. */
+  transpose_sse2(r);
+  fdct_pass_sse2(r);
+
+  for (i = 0; i < DCTSIZE; i++) {
+    sign = _mm_srai_epi16(r[i], 15);
+    _mm_storeu_si128((__m128i *) (data + i * DCTSIZE), _mm_unpacklo_epi16(r[i], sign));
+    _mm_storeu_si128((__m128i *) (data + i * DCTSIZE + 4), _mm_unpackhi_epi16(r[i], sign));
+  }
+}
+
+#else /* ! FDCT_SSE2 */
+
 /*
  * Perform the forward DCT on one block of samples.
  */
@@ -221,4 +367,6 @@ jpeg_fdct_ifast (DCTELEM * data)
   }
 }
 
+#endif /* FDCT_SSE2 */
+
 #endif /* DCT_IFAST_SUPPORTED */